@@ -0,0 +1,428 @@
+/**
+ * @file bcnp_bench.cpp
+ * @brief Google Benchmark suite for the BCNP encode/parse/dispatch hot paths.
+ *
+ * Uses the test schema types (tests/test_schema.json) so numbers do not
+ * depend on a robot's message set. Throughput is reported as items/s
+ * (messages or packets) and bytes/s; per-packet benchmarks also report
+ * latency percentiles (p50_ns, p99_ns, p999_ns counters).
+ *
+ * Run:
+ *   ./bcnp_bench                                   # console table
+ *   ./bcnp_bench --benchmark_format=json           # JSON to stdout
+ *   ./bcnp_bench --benchmark_out=bcnp.json --benchmark_out_format=json
+ *   ./bcnp_bench --benchmark_filter=StreamParser   # one group
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <bcnp/message_types.h>
+#include "bcnp/dispatcher.h"
+#include "bcnp/message_queue.h"
+#include "bcnp/packet.h"
+#include "bcnp/stream_parser.h"
+#include "bcnp/telemetry_accumulator.h"
+#include "bcnp/transport/tcp_posix.h"
+#include "bcnp/transport/udp_posix.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Wire sizes for the test schema (bcnp_core is built against the main schema)
+std::size_t BenchWireSize(bcnp::MessageTypeId typeId) {
+    switch (typeId) {
+        case bcnp::MessageTypeId::TestCmd: return bcnp::TestCmd::kWireSize;
+        case bcnp::MessageTypeId::EncoderData: return bcnp::EncoderData::kWireSize;
+        case bcnp::MessageTypeId::DrivetrainState: return bcnp::DrivetrainState::kWireSize;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Per-iteration latency samples reported as percentile counters.
+ *
+ * Samples are capped so long runs do not grow without bound; the cap is
+ * far above what the default benchmark time produces for per-packet work.
+ */
+class LatencySamples {
+public:
+    static constexpr std::size_t kMaxSamples = 1u << 20;
+
+    LatencySamples() { m_samples.reserve(1u << 16); }
+
+    void Add(Clock::duration elapsed) {
+        if (m_samples.size() < kMaxSamples) {
+            m_samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+    void Report(benchmark::State& state) {
+        if (m_samples.empty()) {
+            return;
+        }
+        std::sort(m_samples.begin(), m_samples.end());
+        const auto at = [this](double quantile) {
+            const auto index = static_cast<std::size_t>(quantile * static_cast<double>(m_samples.size() - 1));
+            return static_cast<double>(m_samples[index]);
+        };
+        state.counters["p50_ns"] = at(0.50);
+        state.counters["p99_ns"] = at(0.99);
+        state.counters["p999_ns"] = at(0.999);
+    }
+
+private:
+    std::vector<int64_t> m_samples;
+};
+
+std::vector<uint8_t> EncodeCommands(std::size_t count) {
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    for (std::size_t i = 0; i < count; ++i) {
+        packet.messages.push_back({static_cast<float>(i) * 0.01f, -0.5f, 20});
+    }
+    std::vector<uint8_t> encoded;
+    bcnp::EncodeTypedPacket(packet, encoded);
+    return encoded;
+}
+
+// A stream of packets, each holding messagesPerPacket TestCmd messages
+std::vector<uint8_t> MakeStream(std::size_t packets, std::size_t messagesPerPacket) {
+    const std::vector<uint8_t> packet = EncodeCommands(messagesPerPacket);
+    std::vector<uint8_t> stream;
+    stream.reserve(packet.size() * packets);
+    for (std::size_t i = 0; i < packets; ++i) {
+        stream.insert(stream.end(), packet.begin(), packet.end());
+    }
+    return stream;
+}
+
+// ============================================================================
+// CRC and encoding
+// ============================================================================
+
+void BM_ComputeCrc32(benchmark::State& state) {
+    std::vector<uint8_t> data(static_cast<std::size_t>(state.range(0)));
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 31u);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bcnp::ComputeCrc32(data.data(), data.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_ComputeCrc32)->Arg(16)->Arg(256)->Arg(1472)->Arg(64 * 1024);
+
+void BM_EncodeTypedPacket(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    for (std::size_t i = 0; i < count; ++i) {
+        packet.messages.push_back({static_cast<float>(i) * 0.01f, -0.5f, 20});
+    }
+    std::vector<uint8_t> output(bcnp::PacketSizeFor<bcnp::TestCmd>(count));
+    std::size_t written = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bcnp::EncodeTypedPacket(packet, output.data(), output.size(), written));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * written));
+}
+BENCHMARK(BM_EncodeTypedPacket)->Arg(1)->Arg(16)->Arg(256);
+
+/// Per-message Encode() vs EncodeUnchecked() (range(0) = 1 for unchecked)
+void BM_EncodeMessage(benchmark::State& state) {
+    const bool unchecked = state.range(0) != 0;
+    bcnp::DrivetrainState msg{1.25f, -0.5f, 1000, -1000, 123456};
+    uint8_t out[bcnp::DrivetrainState::kWireSize];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(msg);   // Input opaque to the optimizer: no precomputed result
+        if (unchecked) {
+            msg.EncodeUnchecked(out);
+            benchmark::DoNotOptimize(out);
+        } else {
+            benchmark::DoNotOptimize(msg.Encode(out, sizeof(out)));
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_EncodeMessage)->Arg(0)->Arg(1);
+
+/// Per-message Decode() vs DecodeUnchecked() (range(0) = 1 for unchecked)
+void BM_DecodeMessage(benchmark::State& state) {
+    const bool unchecked = state.range(0) != 0;
+    uint8_t in[bcnp::DrivetrainState::kWireSize];
+    bcnp::DrivetrainState{1.25f, -0.5f, 1000, -1000, 123456}.EncodeUnchecked(in);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(in);   // Input opaque to the optimizer: no precomputed result
+        benchmark::ClobberMemory();
+        if (unchecked) {
+            benchmark::DoNotOptimize(bcnp::DrivetrainState::DecodeUnchecked(in));
+        } else {
+            benchmark::DoNotOptimize(bcnp::DrivetrainState::Decode(in, sizeof(in)));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_DecodeMessage)->Arg(0)->Arg(1);
+
+// ============================================================================
+// StreamParser
+// ============================================================================
+
+/// Whole packets per Push(): the zero-copy direct path
+void BM_StreamParserPush_Aligned(benchmark::State& state) {
+    const auto messagesPerPacket = static_cast<std::size_t>(state.range(0));
+    const std::vector<uint8_t> packet = EncodeCommands(messagesPerPacket);
+    std::size_t packets = 0;
+    bcnp::StreamParser parser([&](const bcnp::PacketView&) { ++packets; }, {}, 64 * 1024);
+    parser.SetWireSizeFunction(&BenchWireSize);
+    LatencySamples latency;
+
+    for (auto _ : state) {
+        const auto start = Clock::now();
+        parser.Push(packet.data(), packet.size());
+        latency.Add(Clock::now() - start);
+    }
+    latency.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messagesPerPacket));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packet.size()));
+    state.counters["packets"] = static_cast<double>(packets);
+}
+BENCHMARK(BM_StreamParserPush_Aligned)->Arg(1)->Arg(16)->Arg(256);
+
+/// Stream split into small chunks that straddle frame boundaries (ring path)
+void BM_StreamParserPush_Fragmented(benchmark::State& state) {
+    const auto chunkSize = static_cast<std::size_t>(state.range(0));
+    const std::vector<uint8_t> stream = MakeStream(64, 4);
+    bcnp::StreamParser parser([](const bcnp::PacketView& view) { benchmark::DoNotOptimize(&view); },
+                              {}, 64 * 1024);
+    parser.SetWireSizeFunction(&BenchWireSize);
+
+    for (auto _ : state) {
+        for (std::size_t offset = 0; offset < stream.size(); offset += chunkSize) {
+            parser.Push(stream.data() + offset, std::min(chunkSize, stream.size() - offset));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 64 * 4));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+}
+BENCHMARK(BM_StreamParserPush_Fragmented)->Arg(7)->Arg(64)->Arg(1000);
+
+/// Every fourth packet has a bad CRC and is followed by a noise burst (resync path)
+void BM_StreamParserPush_Corrupted(benchmark::State& state) {
+    const std::vector<uint8_t> packet = EncodeCommands(4);
+    std::vector<uint8_t> stream;
+    std::size_t valid = 0;
+    for (std::size_t i = 0; i < 64; ++i) {
+        std::vector<uint8_t> copy = packet;
+        if (i % 4 == 3) {
+            copy[bcnp::kHeaderSizeV3] ^= 0x5A;
+            copy.insert(copy.end(), 48, uint8_t{0xA5});
+        } else {
+            ++valid;
+        }
+        stream.insert(stream.end(), copy.begin(), copy.end());
+    }
+    bcnp::StreamParser parser([](const bcnp::PacketView& view) { benchmark::DoNotOptimize(&view); },
+                              [](const bcnp::StreamParser::ErrorInfo&) {}, 64 * 1024);
+    parser.SetWireSizeFunction(&BenchWireSize);
+
+    for (auto _ : state) {
+        parser.Push(stream.data(), stream.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * valid * 4));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+    state.counters["resyncs"] = static_cast<double>(parser.ResyncCount());
+}
+BENCHMARK(BM_StreamParserPush_Corrupted);
+
+// ============================================================================
+// Dispatch and queueing
+// ============================================================================
+
+void BM_DispatcherPushBytes(benchmark::State& state) {
+    const auto messagesPerPacket = static_cast<std::size_t>(state.range(0));
+    const std::vector<uint8_t> packet = EncodeCommands(messagesPerPacket);
+    bcnp::PacketDispatcher dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    float sink = 0.0f;
+    dispatcher.RegisterHandler<bcnp::TestCmd>([&](const bcnp::PacketView& view) {
+        for (auto it = view.begin_as<bcnp::TestCmd>(); it != view.end_as<bcnp::TestCmd>(); ++it) {
+            sink += (*it).value1;
+        }
+    });
+    LatencySamples latency;
+
+    for (auto _ : state) {
+        const auto start = Clock::now();
+        dispatcher.PushBytes(packet.data(), packet.size());
+        latency.Add(Clock::now() - start);
+    }
+    benchmark::DoNotOptimize(sink);
+    latency.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messagesPerPacket));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packet.size()));
+}
+BENCHMARK(BM_DispatcherPushBytes)->Arg(1)->Arg(16);
+
+/// One control-loop tick: a packet's worth of commands arrives, then Update()
+void BM_MessageQueueUpdate(benchmark::State& state) {
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    bcnp::MessageQueue<bcnp::TestCmd> queue;
+    auto now = Clock::now();
+    LatencySamples latency;
+
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) {
+            queue.Push({0.1f, 0.2f, 5});
+        }
+        queue.NotifyReceived(now);
+        now += std::chrono::milliseconds(20);
+        const auto start = Clock::now();
+        queue.Update(now);
+        latency.Add(Clock::now() - start);
+        benchmark::DoNotOptimize(queue.ActiveMessage());
+    }
+    latency.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch));
+}
+BENCHMARK(BM_MessageQueueUpdate)->Arg(1)->Arg(4)->Arg(16);
+
+/// Update() after a stall with a full backlog: the stale run is dropped in one step
+void BM_MessageQueueStallRecovery(benchmark::State& state) {
+    const auto backlog = static_cast<std::size_t>(state.range(0));
+    bcnp::MessageQueueConfig config;
+    config.capacity = backlog;
+    bcnp::MessageQueue<bcnp::TestCmd> queue(config);
+    auto now = Clock::now();
+    LatencySamples latency;
+
+    for (auto _ : state) {
+        queue.Clear();
+        for (std::size_t i = 0; i < backlog; ++i) {
+            queue.Push({0.1f, 0.2f, 5});
+        }
+        queue.NotifyReceived(now);
+        queue.Update(now);
+        now += std::chrono::milliseconds(5 * backlog);
+        queue.NotifyReceived(now);
+        const auto start = Clock::now();
+        queue.Update(now);
+        latency.Add(Clock::now() - start);
+        benchmark::DoNotOptimize(queue.ActiveMessage());
+    }
+    latency.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_MessageQueueStallRecovery)->Arg(16)->Arg(200)->Arg(1000);
+
+// ============================================================================
+// TelemetryAccumulator
+// ============================================================================
+
+/// Record() into a full ring: each sample overwrites the oldest in O(1), whatever the depth
+void BM_TelemetryRecordOverflow(benchmark::State& state) {
+    bcnp::TelemetryAccumulatorConfig config;
+    config.maxBufferedMessages = static_cast<std::size_t>(state.range(0));
+    bcnp::TelemetryAccumulator<bcnp::DrivetrainState, std::vector<bcnp::DrivetrainState>> telemetry(config);
+    bcnp::DrivetrainState sample{1.25f, -0.5f, 1000, -1000, 0};
+    for (std::size_t i = 0; i < telemetry.Capacity(); ++i) {
+        telemetry.Record(sample);
+    }
+
+    for (auto _ : state) {
+        ++sample.timestampMs;
+        benchmark::DoNotOptimize(telemetry.Record(sample));
+    }
+    const auto metrics = telemetry.GetMetrics();
+    state.counters["overflows"] = static_cast<double>(metrics.bufferOverflows);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_TelemetryRecordOverflow)->RangeMultiplier(8)->Range(8, 32768);
+
+// ============================================================================
+// Loopback transports
+// ============================================================================
+
+bool ConnectTcpPair(bcnp::TcpPosixAdapter& server, bcnp::TcpPosixAdapter& client) {
+    std::vector<uint8_t> rx(1024);
+    for (int i = 0; i < 400; ++i) {
+        server.ReceiveChunk(rx.data(), rx.size());
+        client.ReceiveChunk(rx.data(), rx.size());
+        if (server.IsHandshakeComplete() && client.IsHandshakeComplete()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+/// Send one packet and spin until the peer has parsed it (one-way latency)
+template<typename Sender, typename Receiver>
+void RunLoopback(benchmark::State& state, Sender& sender, Receiver& receiver, std::size_t messagesPerPacket) {
+    const std::vector<uint8_t> packet = EncodeCommands(messagesPerPacket);
+    std::size_t parsed = 0;
+    bcnp::StreamParser parser([&](const bcnp::PacketView&) { ++parsed; }, {}, 64 * 1024);
+    parser.SetWireSizeFunction(&BenchWireSize);
+    std::vector<uint8_t> rx(64 * 1024);
+    LatencySamples latency;
+
+    for (auto _ : state) {
+        const std::size_t target = parsed + 1;
+        const auto start = Clock::now();
+        if (!sender.SendBytes(packet.data(), packet.size())) {
+            state.SkipWithError("SendBytes failed");
+            break;
+        }
+        const auto deadline = start + std::chrono::seconds(1);
+        while (parsed < target) {
+            const std::size_t bytes = receiver.ReceiveChunk(rx.data(), rx.size());
+            parser.Push(rx.data(), bytes);
+            if (Clock::now() > deadline) {
+                break;
+            }
+        }
+        if (parsed < target) {
+            state.SkipWithError("Packet not received within 1 s");
+            break;
+        }
+        latency.Add(Clock::now() - start);
+    }
+    latency.Report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * messagesPerPacket));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * packet.size()));
+}
+
+void BM_TcpLoopback(benchmark::State& state) {
+    bcnp::TcpPosixAdapter server(12610);
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", 12610);
+    if (!server.IsValid() || !client.IsValid() || !ConnectTcpPair(server, client)) {
+        state.SkipWithError("TCP loopback connection failed");
+        return;
+    }
+    RunLoopback(state, client, server, static_cast<std::size_t>(state.range(0)));
+}
+BENCHMARK(BM_TcpLoopback)->Arg(1)->Arg(64)->UseRealTime();
+
+void BM_UdpLoopback(benchmark::State& state) {
+    bcnp::UdpPosixAdapter a(12612, "127.0.0.1", 12613);
+    bcnp::UdpPosixAdapter b(12613, "127.0.0.1", 12612);
+    if (!a.IsValid() || !b.IsValid()) {
+        state.SkipWithError("UDP loopback sockets failed");
+        return;
+    }
+    RunLoopback(state, a, b, static_cast<std::size_t>(state.range(0)));
+}
+BENCHMARK(BM_UdpLoopback)->Arg(1)->Arg(64)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
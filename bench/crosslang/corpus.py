@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""
+BCNP cross-language benchmark corpus generator.
+
+Builds one deterministic packet stream from a schema (the test schema by
+default) so the C++, JNI and Python harnesses measure identical bytes.
+
+Usage:
+    python3 bench/crosslang/corpus.py --out /tmp/bcnp-corpus
+    python3 bench/crosslang/corpus.py --schema schema/messages.json --packets 5000 --out DIR
+
+Output directory:
+    corpus.bin        Packets back to back, exactly as a peer would send them
+    layout.txt        One line per message type: "<typeId> <wireSize> <w1,w2,...>"
+    manifest.json     Counts, sizes and the CRC32 of corpus.bin (checked by report.py)
+    bcnp_messages.py  Python bindings for the schema (used by python_bench.py)
+
+Field values sit on the fixed-point grid (integer / scale), so every
+binding's rounding mode re-encodes them to the same bytes.
+"""
+
+import argparse
+import importlib.util
+import json
+import sys
+import zlib
+from pathlib import Path
+
+REPO_ROOT = Path(__file__).resolve().parents[2]
+DEFAULT_SCHEMA = REPO_ROOT / "tests" / "test_schema.json"
+
+FORMAT = "bcnp-crosslang/1"
+
+# Messages per packet by traffic class: commands are small, telemetry is batched
+COUNT_RANGES = ((1, 4), (1, 1), (8, 64), (1, 16))
+
+
+def load_module(name: str, path: Path):
+    spec = importlib.util.spec_from_file_location(name, path)
+    module = importlib.util.module_from_spec(spec)
+    sys.modules[name] = module
+    spec.loader.exec_module(module)
+    return module
+
+
+class XorShift32:
+    """Tiny PRNG with the same sequence on every Python version."""
+
+    def __init__(self, seed: int):
+        self.state = (seed or 1) & 0xFFFFFFFF
+
+    def next(self) -> int:
+        x = self.state
+        x ^= (x << 13) & 0xFFFFFFFF
+        x ^= x >> 17
+        x ^= (x << 5) & 0xFFFFFFFF
+        self.state = x
+        return x
+
+    def range(self, low: int, high: int) -> int:
+        """Uniform-ish integer in [low, high]."""
+        return low + self.next() % (high - low + 1)
+
+
+def field_value(rng: XorShift32, field: dict, codegen) -> object:
+    ftype = field["type"]
+    if ftype == "float32":
+        scale = field.get("scale", 10000)
+        return rng.range(-100 * scale, 100 * scale) / scale
+    width, _, signed, _ = codegen.TYPE_INFO[ftype]
+    bits = width * 8
+    if signed:
+        return rng.range(-(1 << (bits - 1)), (1 << (bits - 1)) - 1)
+    return rng.range(0, (1 << bits) - 1)
+
+
+def generate(schema_path: Path, out_dir: Path, packets: int, seed: int) -> dict:
+    codegen = load_module("bcnp_codegen", REPO_ROOT / "schema" / "bcnp_codegen.py")
+    schema = json.loads(schema_path.read_text())
+    out_dir.mkdir(parents=True, exist_ok=True)
+    codegen.generate_python_bindings(schema, out_dir)
+    bindings = load_module("bcnp_messages", out_dir / "bcnp_messages.py")
+
+    rng = XorShift32(seed)
+    messages = schema["messages"]
+    stream = bytearray()
+    per_type = {msg["name"]: {"typeId": msg["id"], "packets": 0, "messages": 0} for msg in messages}
+    total_messages = 0
+    max_packet = 0
+    for index in range(packets):
+        msg = messages[index % len(messages)]
+        low, high = COUNT_RANGES[index % len(COUNT_RANGES)]
+        count = rng.range(low, high)
+        cls = bindings.MESSAGE_REGISTRY[msg["id"]]
+        batch = [cls(**{f["name"]: field_value(rng, f, codegen) for f in msg["fields"]}) for _ in range(count)]
+        packet = bindings.encode_packet(msg["id"], batch)
+        stream += packet
+        per_type[msg["name"]]["packets"] += 1
+        per_type[msg["name"]]["messages"] += count
+        total_messages += count
+        max_packet = max(max_packet, len(packet))
+
+    (out_dir / "corpus.bin").write_bytes(bytes(stream))
+    layout = []
+    for msg in messages:
+        widths = [codegen.TYPE_INFO[f["type"]][0] for f in msg["fields"]]
+        layout.append(f"{msg['id']} {codegen.compute_message_size(msg)} {','.join(map(str, widths))}")
+    (out_dir / "layout.txt").write_text("\n".join(layout) + "\n")
+
+    manifest = {
+        "format": FORMAT,
+        "schema": str(schema_path),
+        "schemaHash": f"0x{codegen.compute_schema_hash(schema):08X}",
+        "seed": seed,
+        "packets": packets,
+        "messages": total_messages,
+        "bytes": len(stream),
+        "maxPacketSize": max_packet,
+        "crc32": f"0x{zlib.crc32(stream) & 0xFFFFFFFF:08X}",
+        "types": per_type,
+    }
+    (out_dir / "manifest.json").write_text(json.dumps(manifest, indent=2) + "\n")
+    return manifest
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the BCNP cross-language benchmark corpus")
+    parser.add_argument("--schema", type=Path, default=DEFAULT_SCHEMA, help="Schema JSON (default: test schema)")
+    parser.add_argument("--packets", type=int, default=2000, help="Packets in the stream")
+    parser.add_argument("--seed", type=int, default=1, help="PRNG seed")
+    parser.add_argument("--out", type=Path, required=True, help="Output directory")
+    args = parser.parse_args()
+
+    manifest = generate(args.schema, args.out, args.packets, args.seed)
+    print(f"Corpus: {manifest['packets']} packets, {manifest['messages']} messages, "
+          f"{manifest['bytes']} bytes, crc32 {manifest['crc32']}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,380 @@
+/**
+ * @file crosslang_bench.cpp
+ * @brief Native C++ half of the BCNP cross-language benchmark.
+ *
+ * Runs the operations defined in python_bench.py (encode, decode, parse,
+ * tcp_rtt, udp_rtt) on the corpus written by corpus.py and writes a result
+ * file in the same JSON format, so report.py can put the C++ core, the JNI
+ * bindings and pure Python side by side. Built against the test schema
+ * types; the corpus must be generated from tests/test_schema.json.
+ *
+ * Run:
+ *   ./bcnp_crosslang_bench --corpus /tmp/bcnp-corpus --out /tmp/bcnp-corpus/cpp.json
+ */
+
+#include <bcnp/message_types.h>
+#include "bcnp/packet.h"
+#include "bcnp/stream_parser.h"
+#include "bcnp/transport/tcp_posix.h"
+#include "bcnp/transport/udp_posix.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const char* kFormat = "bcnp-crosslang/1";
+
+struct Options {
+    std::string corpusDir;
+    std::string outPath;
+    double minTime{1.0};
+    std::size_t chunk{4096};
+    std::size_t rttSamples{2000};
+    uint16_t basePort{12620};   ///< TCP uses basePort, UDP basePort + 1 and + 2
+};
+
+/// One packet of the corpus
+struct CorpusPacket {
+    std::size_t offset;
+    std::size_t size;
+    bcnp::MessageTypeId type;
+    uint16_t count;
+};
+
+struct Corpus {
+    std::vector<uint8_t> bytes;
+    std::vector<CorpusPacket> packets;
+    std::size_t messages{0};
+};
+
+template<typename MsgType>
+struct Tag {
+    using Type = MsgType;
+};
+
+/// Call fn(Tag<MsgType>{}) for a test schema type; false for unknown IDs
+template<typename Fn>
+bool VisitType(bcnp::MessageTypeId typeId, Fn&& fn) {
+    switch (typeId) {
+        case bcnp::MessageTypeId::TestCmd: fn(Tag<bcnp::TestCmd>{}); return true;
+        case bcnp::MessageTypeId::DrivetrainState: fn(Tag<bcnp::DrivetrainState>{}); return true;
+        case bcnp::MessageTypeId::EncoderData: fn(Tag<bcnp::EncoderData>{}); return true;
+        case bcnp::MessageTypeId::ProximityAlert: fn(Tag<bcnp::ProximityAlert>{}); return true;
+        default: return false;
+    }
+}
+
+std::size_t CorpusWireSize(bcnp::MessageTypeId typeId) {
+    std::size_t size = 0;
+    VisitType(typeId, [&](auto tag) { size = decltype(tag)::Type::kWireSize; });
+    return size;
+}
+
+Corpus LoadCorpus(const std::string& dir) {
+    std::ifstream in(dir + "/corpus.bin", std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open " + dir + "/corpus.bin");
+    }
+    Corpus corpus;
+    corpus.bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    std::size_t offset = 0;
+    while (offset < corpus.bytes.size()) {
+        const uint8_t* data = corpus.bytes.data() + offset;
+        const auto type = static_cast<bcnp::MessageTypeId>(bcnp::detail::LoadU16(&data[bcnp::kHeaderMsgTypeIndex]));
+        const uint16_t count = bcnp::detail::LoadU16(&data[bcnp::kHeaderMsgCountIndex]);
+        const std::size_t wireSize = CorpusWireSize(type);
+        if (wireSize == 0) {
+            throw std::runtime_error("corpus holds a type outside the test schema (regenerate it with tests/test_schema.json)");
+        }
+        const std::size_t size = bcnp::kHeaderSizeV3 + count * wireSize + bcnp::kChecksumSize;
+        corpus.packets.push_back({offset, size, type, count});
+        corpus.messages += count;
+        offset += size;
+    }
+    return corpus;
+}
+
+/// Run body() until minTime seconds have elapsed (at least once)
+std::pair<std::size_t, double> TimedPasses(const std::function<void()>& body, double minTime) {
+    std::size_t passes = 0;
+    const auto start = Clock::now();
+    while (true) {
+        body();
+        ++passes;
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        if (elapsed >= minTime) {
+            return {passes, elapsed};
+        }
+    }
+}
+
+/// Result entry as a JSON object body (keys shared with python_bench.py)
+std::string Throughput(const char* op, std::pair<std::size_t, double> run, const Corpus& corpus,
+                       const std::string& extra = {}) {
+    const auto [passes, seconds] = run;
+    const double packets = static_cast<double>(corpus.packets.size() * passes);
+    const double messages = static_cast<double>(corpus.messages * passes);
+    const double bytes = static_cast<double>(corpus.bytes.size() * passes);
+    std::ostringstream out;
+    out << "{\"op\": \"" << op << "\", \"passes\": " << passes << ", \"seconds\": " << seconds
+        << ", \"packetsPerSec\": " << packets / seconds << ", \"messagesPerSec\": " << messages / seconds
+        << ", \"mbPerSec\": " << bytes / seconds / 1e6 << ", \"nsPerMessage\": " << seconds * 1e9 / messages
+        << extra << "}";
+    return out.str();
+}
+
+std::string Latency(const char* op, std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    const auto at = [&](double quantile) {
+        return samples[static_cast<std::size_t>(quantile * static_cast<double>(samples.size() - 1))] * 1e6;
+    };
+    double sum = 0;
+    for (double s : samples) {
+        sum += s;
+    }
+    std::ostringstream out;
+    out << "{\"op\": \"" << op << "\", \"samples\": " << samples.size() << ", \"p50Us\": " << at(0.50)
+        << ", \"p99Us\": " << at(0.99) << ", \"maxUs\": " << samples.back() * 1e6
+        << ", \"meanUs\": " << sum / static_cast<double>(samples.size()) * 1e6 << "}";
+    return out.str();
+}
+
+/// Typed copy of the corpus: one vector of TypedPacket per message type
+class TypedCorpus {
+public:
+    explicit TypedCorpus(const Corpus& corpus) {
+        for (const CorpusPacket& packet : corpus.packets) {
+            VisitType(packet.type, [&](auto tag) {
+                using MsgType = typename decltype(tag)::Type;
+                auto view = bcnp::DecodePacketViewAs<MsgType>(corpus.bytes.data() + packet.offset, packet.size);
+                if (view.error != bcnp::PacketError::None) {
+                    throw std::runtime_error("corpus packet failed to decode");
+                }
+                auto& packets = std::get<std::vector<bcnp::TypedPacket<MsgType>>>(m_packets);
+                m_order.emplace_back(packet.type, packets.size());
+                packets.push_back(bcnp::DecodeTypedPacket<MsgType>(view.view.unwrap()).unwrap());
+            });
+        }
+    }
+
+    /// Encode every packet back to back into @p out (sized to the corpus)
+    std::size_t EncodeAll(std::vector<uint8_t>& out) const {
+        std::size_t offset = 0;
+        for (const auto& [type, index] : m_order) {
+            VisitType(type, [&, index = index](auto tag) {
+                using MsgType = typename decltype(tag)::Type;
+                const auto& packet = std::get<std::vector<bcnp::TypedPacket<MsgType>>>(m_packets)[index];
+                std::size_t written = 0;
+                if (!bcnp::EncodeTypedPacket(packet, out.data() + offset, out.size() - offset, written)) {
+                    throw std::runtime_error("EncodeTypedPacket failed");
+                }
+                offset += written;
+            });
+        }
+        return offset;
+    }
+
+private:
+    std::tuple<std::vector<bcnp::TypedPacket<bcnp::TestCmd>>,
+               std::vector<bcnp::TypedPacket<bcnp::DrivetrainState>>,
+               std::vector<bcnp::TypedPacket<bcnp::EncoderData>>,
+               std::vector<bcnp::TypedPacket<bcnp::ProximityAlert>>> m_packets;
+    std::vector<std::pair<bcnp::MessageTypeId, std::size_t>> m_order;
+};
+
+std::string BenchEncode(const Corpus& corpus, double minTime) {
+    const TypedCorpus typed(corpus);
+    std::vector<uint8_t> out(corpus.bytes.size());
+    if (typed.EncodeAll(out) != out.size() || out != corpus.bytes) {
+        throw std::runtime_error("encode output differs from corpus.bin");
+    }
+    return Throughput("encode", TimedPasses([&]() { typed.EncodeAll(out); }, minTime), corpus);
+}
+
+std::string BenchDecode(const Corpus& corpus, double minTime) {
+    std::size_t decoded = 0;
+    const auto run = TimedPasses([&]() {
+        for (const CorpusPacket& packet : corpus.packets) {
+            VisitType(packet.type, [&](auto tag) {
+                using MsgType = typename decltype(tag)::Type;
+                auto view = bcnp::DecodePacketViewAs<MsgType>(corpus.bytes.data() + packet.offset, packet.size);
+                if (view.error != bcnp::PacketError::None) {
+                    throw std::runtime_error("corpus packet failed to decode");
+                }
+                decoded += bcnp::DecodeTypedPacket<MsgType>(view.view.unwrap()).unwrap().messages.size();
+            });
+        }
+    }, minTime);
+    if (decoded != corpus.messages * run.first) {
+        throw std::runtime_error("decode message count mismatch");
+    }
+    return Throughput("decode", run, corpus);
+}
+
+std::string BenchParse(const Corpus& corpus, double minTime, std::size_t chunk) {
+    std::size_t packets = 0;
+    std::size_t messages = 0;
+    bcnp::StreamParser parser([&](const bcnp::PacketView& view) {
+        ++packets;
+        messages += view.header.messageCount;
+    }, {}, 64 * 1024);
+    parser.SetWireSizeFunction(&CorpusWireSize);
+    const auto run = TimedPasses([&]() {
+        for (std::size_t offset = 0; offset < corpus.bytes.size(); offset += chunk) {
+            parser.Push(corpus.bytes.data() + offset, std::min(chunk, corpus.bytes.size() - offset));
+        }
+    }, minTime);
+    std::ostringstream extra;
+    extra << ", \"chunk\": " << chunk << ", \"parsedPackets\": " << packets / run.first
+          << ", \"parsedMessages\": " << messages / run.first;
+    return Throughput("parse", run, corpus, extra.str());
+}
+
+/// Receive on @p adapter until @p parser has produced one more packet
+template<typename Adapter>
+void ReceivePacket(Adapter& adapter, bcnp::StreamParser& parser, const std::size_t& parsed, std::vector<uint8_t>& rx) {
+    const std::size_t target = parsed + 1;
+    const auto deadline = Clock::now() + std::chrono::seconds(1);
+    while (parsed < target) {
+        parser.Push(rx.data(), adapter.ReceiveChunk(rx.data(), rx.size()));
+        if (Clock::now() > deadline) {
+            throw std::runtime_error("round trip timed out");
+        }
+    }
+}
+
+/// Ping-pong corpus packets, both ends on this thread (same method as python_bench.py)
+template<typename Adapter>
+std::string RunRoundTrips(const char* op, Adapter& client, Adapter& server, const Corpus& corpus, std::size_t samples) {
+    std::size_t clientParsed = 0;
+    std::size_t serverParsed = 0;
+    bcnp::StreamParser clientParser([&](const bcnp::PacketView&) { ++clientParsed; }, {}, 64 * 1024);
+    bcnp::StreamParser serverParser([&](const bcnp::PacketView&) { ++serverParsed; }, {}, 64 * 1024);
+    clientParser.SetWireSizeFunction(&CorpusWireSize);
+    serverParser.SetWireSizeFunction(&CorpusWireSize);
+    std::vector<uint8_t> rx(64 * 1024);
+    std::vector<double> times;
+    times.reserve(samples);
+    for (std::size_t i = 0; i < samples; ++i) {
+        const CorpusPacket& packet = corpus.packets[i % corpus.packets.size()];
+        const uint8_t* data = corpus.bytes.data() + packet.offset;
+        const auto start = Clock::now();
+        if (!client.SendBytes(data, packet.size)) {
+            throw std::runtime_error("SendBytes failed");
+        }
+        ReceivePacket(server, serverParser, serverParsed, rx);
+        if (!server.SendBytes(data, packet.size)) {
+            throw std::runtime_error("SendBytes failed");
+        }
+        ReceivePacket(client, clientParser, clientParsed, rx);
+        times.push_back(std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return Latency(op, std::move(times));
+}
+
+std::string BenchTcpRtt(const Corpus& corpus, const Options& options) {
+    bcnp::TcpPosixAdapter server(options.basePort);
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", options.basePort);
+    std::vector<uint8_t> rx(1024);
+    for (int i = 0; i < 400 && !(server.IsHandshakeComplete() && client.IsHandshakeComplete()); ++i) {
+        server.ReceiveChunk(rx.data(), rx.size());
+        client.ReceiveChunk(rx.data(), rx.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if (!server.IsHandshakeComplete() || !client.IsHandshakeComplete()) {
+        throw std::runtime_error("TCP loopback connection failed");
+    }
+    return RunRoundTrips("tcp_rtt", client, server, corpus, options.rttSamples);
+}
+
+std::string BenchUdpRtt(const Corpus& corpus, const Options& options) {
+    const auto portA = static_cast<uint16_t>(options.basePort + 1);
+    const auto portB = static_cast<uint16_t>(options.basePort + 2);
+    bcnp::UdpPosixAdapter a(portA, "127.0.0.1", portB);
+    bcnp::UdpPosixAdapter b(portB, "127.0.0.1", portA);
+    if (!a.IsValid() || !b.IsValid()) {
+        throw std::runtime_error("UDP loopback sockets failed");
+    }
+    return RunRoundTrips("udp_rtt", a, b, corpus, options.rttSamples);
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string key = argv[i];
+        const char* value = argv[i + 1];
+        if (key == "--corpus") {
+            options.corpusDir = value;
+        } else if (key == "--out") {
+            options.outPath = value;
+        } else if (key == "--min-time") {
+            options.minTime = std::atof(value);
+        } else if (key == "--chunk") {
+            options.chunk = static_cast<std::size_t>(std::strtoul(value, nullptr, 10));
+        } else if (key == "--rtt-samples") {
+            options.rttSamples = static_cast<std::size_t>(std::strtoul(value, nullptr, 10));
+        } else if (key == "--port") {
+            options.basePort = static_cast<uint16_t>(std::strtoul(value, nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && !options.corpusDir.empty() && !options.outPath.empty() &&
+           options.chunk > 0 && options.rttSamples > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0] << " --corpus DIR --out FILE [--min-time SEC] [--chunk BYTES]"
+                  << " [--rtt-samples N] [--port BASE]" << std::endl;
+        return 2;
+    }
+    try {
+        const Corpus corpus = LoadCorpus(options.corpusDir);
+        const std::vector<std::string> results = {
+            BenchEncode(corpus, options.minTime),
+            BenchDecode(corpus, options.minTime),
+            BenchParse(corpus, options.minTime, options.chunk),
+            BenchTcpRtt(corpus, options),
+            BenchUdpRtt(corpus, options),
+        };
+
+        std::ofstream out(options.outPath);
+        char crc[16];
+        std::snprintf(crc, sizeof(crc), "0x%08X", bcnp::ComputeCrc32(corpus.bytes.data(), corpus.bytes.size()));
+        out << "{\n  \"format\": \"" << kFormat << "\",\n  \"binding\": \"cpp\",\n"
+            << "  \"implementation\": \"C++ " << bcnp::Crc32Implementation() << " CRC\",\n"
+            << "  \"corpus\": {\"crc32\": \"" << crc << "\", \"packets\": " << corpus.packets.size()
+            << ", \"messages\": " << corpus.messages << ", \"bytes\": " << corpus.bytes.size() << "},\n"
+            << "  \"results\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            out << "    " << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+            std::cout << results[i] << std::endl;
+        }
+        out << "  ]\n}\n";
+    } catch (const std::exception& e) {
+        std::cerr << "bcnp_crosslang_bench: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""
+Pure-Python half of the BCNP cross-language benchmark.
+
+Measures the generated Python bindings (bcnp_messages.py, written next to
+the corpus by corpus.py) on the shared corpus and writes a result file in
+the common format read by report.py.
+
+Usage:
+    python3 bench/crosslang/python_bench.py --corpus /tmp/bcnp-corpus --out /tmp/bcnp-corpus/python.json
+
+Operations (same definitions in every harness):
+    encode   Typed messages -> packets (header, fields, CRC); checked against corpus.bin
+    decode   Packets at known offsets -> typed messages (header and CRC validated)
+    parse    corpus.bin pushed through a stream parser in --chunk byte chunks
+    tcp_rtt  Ping-pong of corpus packets over loopback TCP, both ends on one thread
+    udp_rtt  Same over loopback UDP
+"""
+
+import argparse
+import importlib.util
+import json
+import platform
+import socket
+import struct
+import time
+import zlib
+from pathlib import Path
+
+FORMAT = "bcnp-crosslang/1"
+HEADER_SIZE = 7
+CRC_SIZE = 4
+
+
+def load_bindings(corpus_dir: Path):
+    spec = importlib.util.spec_from_file_location("bcnp_messages", corpus_dir / "bcnp_messages.py")
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+def load_layout(corpus_dir: Path) -> dict:
+    """typeId -> wire size, from layout.txt."""
+    sizes = {}
+    for line in (corpus_dir / "layout.txt").read_text().splitlines():
+        if line.strip():
+            type_id, wire_size, _ = line.split(" ", 2)
+            sizes[int(type_id)] = int(wire_size)
+    return sizes
+
+
+def split_packets(stream: bytes, wire_sizes: dict) -> list:
+    """Offsets of the back-to-back packets in the corpus."""
+    packets, offset = [], 0
+    while offset < len(stream):
+        type_id, count = struct.unpack_from(">HH", stream, offset + 3)
+        size = HEADER_SIZE + count * wire_sizes[type_id] + CRC_SIZE
+        packets.append((offset, size))
+        offset += size
+    return packets
+
+
+class StreamParser:
+    """Incremental parser with the C++ StreamParser's framing and resync rules."""
+
+    def __init__(self, bindings, wire_sizes: dict, on_packet):
+        self.bindings = bindings
+        self.wire_sizes = wire_sizes
+        self.on_packet = on_packet
+        self.buffer = bytearray()
+        self.packets = 0
+        self.errors = 0
+
+    def push(self, data) -> None:
+        self.buffer += data
+        buf = self.buffer
+        start = 0
+        while len(buf) - start >= HEADER_SIZE:
+            major, minor, _, type_id, count = struct.unpack_from(">BBBHH", buf, start)
+            wire_size = self.wire_sizes.get(type_id)
+            if major != self.bindings.PROTOCOL_MAJOR or minor != self.bindings.PROTOCOL_MINOR or wire_size is None:
+                self.errors += 1
+                start += 1
+                continue
+            end = start + HEADER_SIZE + count * wire_size
+            if len(buf) < end + CRC_SIZE:
+                break
+            crc = struct.unpack_from(">I", buf, end)[0]
+            if crc != self.bindings.crc32(buf[start:end]):
+                self.errors += 1
+                start += 1
+                continue
+            self.packets += 1
+            if self.on_packet:
+                self.on_packet(type_id, count, buf[start + HEADER_SIZE:end])
+            start = end + CRC_SIZE
+        if start:
+            del buf[:start]
+
+
+def timed_passes(body, min_time: float) -> tuple:
+    """Run body() until min_time has elapsed (at least once); returns (passes, seconds)."""
+    passes = 0
+    start = time.perf_counter()
+    while True:
+        body()
+        passes += 1
+        elapsed = time.perf_counter() - start
+        if elapsed >= min_time:
+            return passes, elapsed
+
+
+def throughput(op: str, passes: int, seconds: float, manifest: dict) -> dict:
+    packets = manifest["packets"] * passes
+    messages = manifest["messages"] * passes
+    nbytes = manifest["bytes"] * passes
+    return {
+        "op": op,
+        "passes": passes,
+        "seconds": seconds,
+        "packetsPerSec": packets / seconds,
+        "messagesPerSec": messages / seconds,
+        "mbPerSec": nbytes / seconds / 1e6,
+        "nsPerMessage": seconds * 1e9 / messages,
+    }
+
+
+def latency(op: str, samples: list) -> dict:
+    samples = sorted(samples)
+    at = lambda q: samples[int(q * (len(samples) - 1))] * 1e6
+    return {
+        "op": op,
+        "samples": len(samples),
+        "p50Us": at(0.50),
+        "p99Us": at(0.99),
+        "maxUs": samples[-1] * 1e6,
+        "meanUs": sum(samples) / len(samples) * 1e6,
+    }
+
+
+def bench_encode(bindings, stream, packets, manifest, min_time):
+    typed = []
+    for offset, size in packets:
+        _, type_id, messages = bindings.decode_packet(stream[offset:offset + size])
+        typed.append((type_id, messages))
+    if b"".join(bindings.encode_packet(t, m) for t, m in typed) != stream:
+        raise RuntimeError("encode output differs from corpus.bin")
+
+    def body():
+        for type_id, messages in typed:
+            bindings.encode_packet(type_id, messages)
+
+    return throughput("encode", *timed_passes(body, min_time), manifest)
+
+
+def bench_decode(bindings, stream, packets, manifest, min_time):
+    views = [stream[offset:offset + size] for offset, size in packets]
+
+    def body():
+        for packet in views:
+            if bindings.decode_packet(packet) is None:
+                raise RuntimeError("corpus packet failed to decode")
+
+    return throughput("decode", *timed_passes(body, min_time), manifest)
+
+
+def bench_parse(bindings, wire_sizes, stream, manifest, min_time, chunk):
+    seen = [0, 0]
+
+    def on_packet(type_id, count, payload):
+        seen[0] += 1
+        seen[1] += count
+
+    parser = StreamParser(bindings, wire_sizes, on_packet)
+
+    def body():
+        for offset in range(0, len(stream), chunk):
+            parser.push(stream[offset:offset + chunk])
+
+    result = throughput("parse", *timed_passes(body, min_time), manifest)
+    result["chunk"] = chunk
+    result["parsedPackets"] = seen[0] // result["passes"]
+    result["parsedMessages"] = seen[1] // result["passes"]
+    return result
+
+
+def receive_packet(sock, parser, udp: bool) -> None:
+    target = parser.packets + 1
+    while parser.packets < target:
+        data = sock.recv(65536)
+        if not data and not udp:
+            raise RuntimeError("peer closed")
+        parser.push(data)
+
+
+def run_rtt(op, client, server, bindings, wire_sizes, stream, packets, samples, udp):
+    server_parser = StreamParser(bindings, wire_sizes, None)
+    client_parser = StreamParser(bindings, wire_sizes, None)
+    times = []
+    for i in range(samples):
+        offset, size = packets[i % len(packets)]
+        packet = stream[offset:offset + size]
+        start = time.perf_counter()
+        client.sendall(packet)   # One datagram per call on UDP
+        receive_packet(server, server_parser, udp)
+        server.sendall(packet)
+        receive_packet(client, client_parser, udp)
+        times.append(time.perf_counter() - start)
+    return latency(op, times)
+
+
+def bench_tcp_rtt(bindings, wire_sizes, stream, packets, samples):
+    listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listener.bind(("127.0.0.1", 0))
+    listener.listen(1)
+    client = socket.create_connection(listener.getsockname())
+    server, _ = listener.accept()
+    for sock in (client, server):
+        sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    try:
+        return run_rtt("tcp_rtt", client, server, bindings, wire_sizes, stream, packets, samples, udp=False)
+    finally:
+        for sock in (client, server, listener):
+            sock.close()
+
+
+def bench_udp_rtt(bindings, wire_sizes, stream, packets, samples):
+    a = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    b = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    a.bind(("127.0.0.1", 0))
+    b.bind(("127.0.0.1", 0))
+    a.connect(b.getsockname())
+    b.connect(a.getsockname())
+    try:
+        return run_rtt("udp_rtt", a, b, bindings, wire_sizes, stream, packets, samples, udp=True)
+    finally:
+        a.close()
+        b.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pure-Python BCNP cross-language benchmark")
+    parser.add_argument("--corpus", type=Path, required=True, help="Directory written by corpus.py")
+    parser.add_argument("--out", type=Path, required=True, help="Result JSON file")
+    parser.add_argument("--min-time", type=float, default=1.0, help="Seconds per throughput operation")
+    parser.add_argument("--chunk", type=int, default=4096, help="Bytes per stream parser push")
+    parser.add_argument("--rtt-samples", type=int, default=2000, help="Round trips per transport")
+    args = parser.parse_args()
+
+    bindings = load_bindings(args.corpus)
+    manifest = json.loads((args.corpus / "manifest.json").read_text())
+    wire_sizes = load_layout(args.corpus)
+    stream = (args.corpus / "corpus.bin").read_bytes()
+    packets = split_packets(stream, wire_sizes)
+
+    results = [
+        bench_encode(bindings, stream, packets, manifest, args.min_time),
+        bench_decode(bindings, stream, packets, manifest, args.min_time),
+        bench_parse(bindings, wire_sizes, stream, manifest, args.min_time, args.chunk),
+        bench_tcp_rtt(bindings, wire_sizes, stream, packets, args.rtt_samples),
+        bench_udp_rtt(bindings, wire_sizes, stream, packets, args.rtt_samples),
+    ]
+    report = {
+        "format": FORMAT,
+        "binding": "python",
+        "implementation": f"{platform.python_implementation()} {platform.python_version()}",
+        "corpus": {
+            "crc32": f"0x{zlib.crc32(stream) & 0xFFFFFFFF:08X}",
+            "packets": len(packets),
+            "messages": manifest["messages"],
+            "bytes": len(stream),
+        },
+        "results": results,
+    }
+    args.out.write_text(json.dumps(report, indent=2) + "\n")
+    for result in results:
+        print(json.dumps(result))
+
+
+if __name__ == "__main__":
+    main()
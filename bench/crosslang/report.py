@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+Merge BCNP cross-language benchmark results into one report.
+
+Reads the result files written by crosslang_bench (cpp), CrossLangBench
+(jni) and python_bench.py (python), checks that they all measured the
+corpus described by manifest.json, and prints a Markdown comparison with
+each binding's cost relative to the C++ core.
+
+Usage:
+    python3 bench/crosslang/report.py --corpus /tmp/bcnp-corpus \\
+        /tmp/bcnp-corpus/cpp.json /tmp/bcnp-corpus/jni.json /tmp/bcnp-corpus/python.json \\
+        [--json combined.json] [--markdown report.md]
+"""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+
+FORMAT = "bcnp-crosslang/1"
+THROUGHPUT_OPS = ("encode", "decode", "parse")
+LATENCY_OPS = ("tcp_rtt", "udp_rtt")
+BASELINE = "cpp"
+
+
+def load_results(paths: list, manifest: dict) -> list:
+    runs = []
+    for path in paths:
+        run = json.loads(Path(path).read_text())
+        if run.get("format") != FORMAT:
+            raise SystemExit(f"{path}: not a {FORMAT} result file")
+        corpus = run["corpus"]
+        for key in ("crc32", "packets", "messages", "bytes"):
+            if corpus[key] != manifest[key]:
+                raise SystemExit(f"{path}: measured a different corpus ({key} {corpus[key]} != {manifest[key]})")
+        parse = next((r for r in run["results"] if r["op"] == "parse"), None)
+        if parse and (parse["parsedPackets"], parse["parsedMessages"]) != (manifest["packets"], manifest["messages"]):
+            raise SystemExit(f"{path}: stream parser saw {parse['parsedPackets']} packets, "
+                             f"{parse['parsedMessages']} messages (expected {manifest['packets']}, "
+                             f"{manifest['messages']})")
+        runs.append(run)
+    return runs
+
+
+def by_op(run: dict) -> dict:
+    return {result["op"]: result for result in run["results"]}
+
+
+def format_rate(value: float) -> str:
+    for unit, scale in (("G", 1e9), ("M", 1e6), ("k", 1e3)):
+        if value >= scale:
+            return f"{value / scale:.2f}{unit}"
+    return f"{value:.0f}"
+
+
+def render_markdown(manifest: dict, runs: list) -> str:
+    baseline = next((by_op(run) for run in runs if run["binding"] == BASELINE), None)
+    lines = [
+        "# BCNP cross-language benchmark",
+        "",
+        f"Corpus: {manifest['packets']} packets, {manifest['messages']} messages, {manifest['bytes']} bytes "
+        f"(schema {manifest['schemaHash']}, crc32 {manifest['crc32']})",
+        "",
+        "| Binding | Implementation |",
+        "|---|---|",
+    ]
+    lines += [f"| {run['binding']} | {run['implementation']} |" for run in runs]
+
+    lines += ["", "## Throughput", "",
+              "| Operation | Binding | Messages/s | MB/s | ns/message | vs C++ |",
+              "|---|---|---:|---:|---:|---:|"]
+    for op in THROUGHPUT_OPS:
+        for run in runs:
+            result = by_op(run).get(op)
+            if not result:
+                continue
+            ratio = ""
+            if baseline and op in baseline:
+                ratio = f"{result['nsPerMessage'] / baseline[op]['nsPerMessage']:.1f}x"
+            lines.append(f"| {op} | {run['binding']} | {format_rate(result['messagesPerSec'])} | "
+                         f"{result['mbPerSec']:.1f} | {result['nsPerMessage']:.1f} | {ratio} |")
+
+    lines += ["", "## Round-trip latency (loopback, both ends on one thread)", "",
+              "| Transport | Binding | p50 us | p99 us | max us | vs C++ p50 |",
+              "|---|---|---:|---:|---:|---:|"]
+    for op in LATENCY_OPS:
+        for run in runs:
+            result = by_op(run).get(op)
+            if not result:
+                continue
+            ratio = ""
+            if baseline and op in baseline:
+                ratio = f"{result['p50Us'] / baseline[op]['p50Us']:.1f}x"
+            lines.append(f"| {op.split('_')[0]} | {run['binding']} | {result['p50Us']:.1f} | "
+                         f"{result['p99Us']:.1f} | {result['maxUs']:.1f} | {ratio} |")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Merge BCNP cross-language benchmark results")
+    parser.add_argument("results", nargs="+", type=Path, help="Result files from the harnesses")
+    parser.add_argument("--corpus", type=Path, required=True, help="Directory written by corpus.py")
+    parser.add_argument("--json", type=Path, help="Also write the merged results as JSON")
+    parser.add_argument("--markdown", type=Path, help="Write the report here instead of stdout")
+    args = parser.parse_args()
+
+    manifest = json.loads((args.corpus / "manifest.json").read_text())
+    runs = load_results(args.results, manifest)
+    report = render_markdown(manifest, runs)
+    if args.markdown:
+        args.markdown.write_text(report)
+    else:
+        sys.stdout.write(report)
+    if args.json:
+        args.json.write_text(json.dumps({"format": FORMAT, "corpus": manifest, "runs": runs}, indent=2) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,32 @@
+#!/usr/bin/env sh
+# Generate the corpus, run every available harness and print the merged report.
+#
+#   bench/crosslang/run.sh <cmake build dir> [output dir]
+#
+# The JNI harness runs when BCNP_JNI_LIB_DIR names a directory holding a
+# libbcnp_jni built from tests/test_schema.json and gradle is on PATH.
+set -eu
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+BUILD=${1:?usage: run.sh <cmake build dir> [output dir]}
+OUT=${2:-${BUILD}/crosslang}
+
+python3 "$ROOT/bench/crosslang/corpus.py" --out "$OUT"
+"$BUILD/bcnp_crosslang_bench" --corpus "$OUT" --out "$OUT/cpp.json"
+RESULTS="$OUT/cpp.json"
+
+if [ -n "${BCNP_JNI_LIB_DIR:-}" ] && command -v gradle >/dev/null 2>&1; then
+    (cd "$ROOT/java" && gradle -q crossLangBench -PjniLibDir="$BCNP_JNI_LIB_DIR" \
+        -PbenchArgs="--corpus $OUT --out $OUT/jni.json")
+    RESULTS="$RESULTS $OUT/jni.json"
+else
+    echo "Skipping JNI harness (set BCNP_JNI_LIB_DIR and install gradle)" >&2
+fi
+
+python3 "$ROOT/bench/crosslang/python_bench.py" --corpus "$OUT" --out "$OUT/python.json"
+RESULTS="$RESULTS $OUT/python.json"
+
+# shellcheck disable=SC2086
+python3 "$ROOT/bench/crosslang/report.py" --corpus "$OUT" --json "$OUT/report.json" \
+    --markdown "$OUT/report.md" $RESULTS
+cat "$OUT/report.md"
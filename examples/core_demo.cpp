@@ -44,8 +44,10 @@ int main() {
     // 2. Setup Transport (Server) - handshake enabled by default
     bcnp::TcpPosixAdapter serverAdapter(kPort);
     
-    // 3. Setup Driver (Connects Transport -> Dispatcher)
+    // 3. Setup Driver (Connects Transport -> Dispatcher). The I/O thread wakes
+    //    as soon as the socket is readable, independent of the loop period below.
     bcnp::DispatcherDriver driver(dispatcher, serverAdapter);
+    driver.Start();
 
     // Example: If you have defined a message type in your schema, you can register
     // handlers like this:
@@ -60,9 +62,6 @@ int main() {
 
     // 4. Main Loop
     while (g_running) {
-        // Poll network
-        driver.PollOnce();
-
         auto now = std::chrono::steady_clock::now();
         
         // Check connection status
@@ -85,6 +84,7 @@ int main() {
         std::this_thread::sleep_for(100ms);
     }
 
+    driver.Stop();
     std::cout << "[Server] Demo finished.\n";
     return 0;
 }
@@ -1,8 +1,9 @@
 // AUTO-GENERATED by bcnp_codegen.py - DO NOT EDIT
 // Schema version: 3.2
-// Schema hash: 0x5667F881
+// Schema hash: 0x542146D8
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -12,6 +13,24 @@
 #include <limits>
 #include <optional>
 #include <variant>
+#include <vector>
+
+// Batch codec SIMD selection (define BCNP_NO_SIMD to force the scalar kernels)
+#if !defined(BCNP_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__))
+#define BCNP_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#define BCNP_SIMD_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX__)
+#define BCNP_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+#elif !defined(BCNP_NO_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#define BCNP_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
 
 namespace bcnp {
 
@@ -21,7 +40,7 @@ namespace bcnp {
 
 constexpr uint8_t kProtocolMajorV3 = 3;
 constexpr uint8_t kProtocolMinorV3 = 2;
-constexpr uint32_t kSchemaHash = 0x5667F881U;
+constexpr uint32_t kSchemaHash = 0x542146D8U;
 
 // Handshake packet structure: "BCNP" (4 bytes) + schema hash (4 bytes)
 constexpr std::size_t kHandshakeSize = 8;
@@ -97,8 +116,214 @@ inline float DequantizeFloat(int32_t fixed, float scale) {
     return static_cast<float>(static_cast<double>(fixed) / static_cast<double>(scale));
 }
 
+/// QuantizeFloat() for a finite value without the llround() call (same result)
+inline int32_t QuantizeFloatUnchecked(float value, float scale) {
+    const double scaled = static_cast<double>(value) * static_cast<double>(scale);
+    const double clamped = std::clamp(scaled,
+        static_cast<double>(std::numeric_limits<int32_t>::min()),
+        static_cast<double>(std::numeric_limits<int32_t>::max()));
+    const auto truncated = static_cast<int32_t>(clamped);
+    const double frac = clamped - static_cast<double>(truncated);   // Exact within int32 range
+    return truncated + static_cast<int32_t>(frac >= 0.5) - static_cast<int32_t>(frac <= -0.5);
+}
+
+// ----------------------------------------------------------------------------
+// Batch kernels used by the generated DecodeBatch()/EncodeBatch().
+// Results are bit-identical to Decode()/Encode(): dequantization divides in
+// double like DequantizeFloat, quantization reproduces llround on the clamp.
+// ----------------------------------------------------------------------------
+
+/// Messages processed per DecodeBatch()/EncodeBatch() block
+constexpr std::size_t kBatchBlock = 16;
+
+/// Load `words` big-endian 32-bit words from `in` into host order
+inline void LoadBlockU32(const uint8_t* in, uint32_t* out, std::size_t words) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_SSSE3)
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= words; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(v, swap));
+    }
+#elif defined(BCNP_SIMD_SSE2)
+    for (; i + 4 <= words; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+    }
+#elif defined(BCNP_SIMD_NEON)
+    for (; i + 4 <= words; i += 4) {
+        vst1q_u32(out + i, vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in + i * 4))));
+    }
+#endif
+    for (; i < words; ++i) {
+        out[i] = LoadU32(in + i * 4);
+    }
+}
+
+/// Store `words` host-order 32-bit words to `out` as big-endian
+inline void StoreBlockU32(const uint32_t* in, uint8_t* out, std::size_t words) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_SSSE3)
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= words; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), _mm_shuffle_epi8(v, swap));
+    }
+#elif defined(BCNP_SIMD_SSE2)
+    for (; i + 4 <= words; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), v);
+    }
+#elif defined(BCNP_SIMD_NEON)
+    for (; i + 4 <= words; i += 4) {
+        vst1q_u8(out + i * 4, vrev32q_u8(vreinterpretq_u8_u32(vld1q_u32(in + i))));
+    }
+#endif
+    for (; i < words; ++i) {
+        StoreU32(in[i], out + i * 4);
+    }
+}
+
+/// DequantizeFloat() over `n` values
+inline void DequantizeBlock(const int32_t* in, std::size_t n, float scale, float* out) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_AVX)
+    const __m256d s4 = _mm256_set1_pd(static_cast<double>(scale));
+    for (; i + 4 <= n; i += 4) {
+        const __m256d d = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+        _mm_storeu_ps(out + i, _mm256_cvtpd_ps(_mm256_div_pd(d, s4)));
+    }
+#endif
+#if defined(BCNP_SIMD_SSE2)
+    const __m128d s2 = _mm_set1_pd(static_cast<double>(scale));
+    for (; i + 2 <= n; i += 2) {
+        const __m128d d = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+        _mm_storel_pi(reinterpret_cast<__m64*>(out + i), _mm_cvtpd_ps(_mm_div_pd(d, s2)));
+    }
+#elif defined(BCNP_SIMD_NEON)
+    const float64x2_t s2 = vdupq_n_f64(static_cast<double>(scale));
+    for (; i + 2 <= n; i += 2) {
+        const float64x2_t d = vcvtq_f64_s64(vmovl_s32(vld1_s32(in + i)));
+        vst1_f32(out + i, vcvt_f32_f64(vdivq_f64(d, s2)));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = DequantizeFloat(in[i], scale);
+    }
+}
+
+/// QuantizeFloat() over `n` values; false if any value is not finite
+inline bool QuantizeBlock(const float* in, std::size_t n, float scale, int32_t* out) {
+    std::size_t i = 0;
+    constexpr double kMin = static_cast<double>(std::numeric_limits<int32_t>::min());
+    constexpr double kMax = static_cast<double>(std::numeric_limits<int32_t>::max());
+#if defined(BCNP_SIMD_AVX)
+    {
+        const __m256d s = _mm256_set1_pd(static_cast<double>(scale));
+        const __m256d lo = _mm256_set1_pd(kMin);
+        const __m256d hi = _mm256_set1_pd(kMax);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d one = _mm256_set1_pd(1.0);
+        for (; i + 4 <= n; i += 4) {
+            const __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(in + i));
+            if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_sub_pd(x, x), _mm256_setzero_pd(), _CMP_EQ_OQ)) != 0xF) {
+                return false;
+            }
+            const __m256d v = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(x, s), lo), hi);
+            const __m256d t = _mm256_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m256d frac = _mm256_sub_pd(v, t);
+            const __m256d up = _mm256_and_pd(_mm256_cmp_pd(frac, half, _CMP_GE_OQ), one);
+            const __m256d down = _mm256_and_pd(_mm256_cmp_pd(frac, _mm256_sub_pd(_mm256_setzero_pd(), half), _CMP_LE_OQ), one);
+            const __m256d r = _mm256_sub_pd(_mm256_add_pd(t, up), down);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvttpd_epi32(r));
+        }
+    }
+#endif
+#if defined(BCNP_SIMD_SSE2)
+    {
+        const __m128d s = _mm_set1_pd(static_cast<double>(scale));
+        const __m128d lo = _mm_set1_pd(kMin);
+        const __m128d hi = _mm_set1_pd(kMax);
+        const __m128d half = _mm_set1_pd(0.5);
+        const __m128d negHalf = _mm_set1_pd(-0.5);
+        const __m128d one = _mm_set1_pd(1.0);
+        for (; i + 2 <= n; i += 2) {
+            const __m128d x = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i))));
+            if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_sub_pd(x, x), _mm_setzero_pd())) != 0x3) {
+                return false;
+            }
+            const __m128d v = _mm_min_pd(_mm_max_pd(_mm_mul_pd(x, s), lo), hi);
+            const __m128d t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(v));
+            const __m128d frac = _mm_sub_pd(v, t);
+            const __m128d up = _mm_and_pd(_mm_cmpge_pd(frac, half), one);
+            const __m128d down = _mm_and_pd(_mm_cmple_pd(frac, negHalf), one);
+            const __m128d r = _mm_sub_pd(_mm_add_pd(t, up), down);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_cvttpd_epi32(r));
+        }
+    }
+#elif defined(BCNP_SIMD_NEON)
+    {
+        const float64x2_t s = vdupq_n_f64(static_cast<double>(scale));
+        const float64x2_t lo = vdupq_n_f64(kMin);
+        const float64x2_t hi = vdupq_n_f64(kMax);
+        const float64x2_t half = vdupq_n_f64(0.5);
+        const float64x2_t negHalf = vdupq_n_f64(-0.5);
+        const float64x2_t one = vdupq_n_f64(1.0);
+        const float64x2_t zero = vdupq_n_f64(0.0);
+        for (; i + 2 <= n; i += 2) {
+            const float64x2_t x = vcvt_f64_f32(vld1_f32(in + i));
+            const uint64x2_t finite = vceqq_f64(vsubq_f64(x, x), zero);
+            if ((vgetq_lane_u64(finite, 0) & vgetq_lane_u64(finite, 1)) == 0) {
+                return false;
+            }
+            const float64x2_t v = vminq_f64(vmaxq_f64(vmulq_f64(x, s), lo), hi);
+            const float64x2_t t = vrndq_f64(v);
+            const float64x2_t frac = vsubq_f64(v, t);
+            const float64x2_t up = vbslq_f64(vcgeq_f64(frac, half), one, zero);
+            const float64x2_t down = vbslq_f64(vcleq_f64(frac, negHalf), one, zero);
+            const float64x2_t r = vsubq_f64(vaddq_f64(t, up), down);
+            vst1_s32(out + i, vmovn_s64(vcvtq_s64_f64(r)));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (!std::isfinite(in[i])) return false;
+        out[i] = QuantizeFloat(in[i], scale);
+    }
+    return true;
+}
+
+
 } // namespace detail
 
+/// Bit set selecting message fields for column decoding (bit i = field i)
+using FieldMask = uint64_t;
+
+/// Select every field of a message
+constexpr FieldMask kAllFields = ~FieldMask{0};
+
+/// Wire byte width of each field in order, for the compressed (delta) encoding
+struct FieldLayout {
+    const uint8_t* widths{nullptr};
+    std::size_t count{0};   ///< 0 = unknown message type
+};
+
+/// Wire type of a message field
+enum class FieldType : uint8_t { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32 };
+
+/// Compile-time description of one field (see <Message>::kFields)
+struct FieldDescriptor {
+    const char* name;
+    FieldType type;
+    uint16_t offset;   ///< Byte offset within the message
+    uint8_t width;     ///< Wire bytes
+    float scale;       ///< Fixed-point scale for Float32, 1 otherwise
+};
+
 // ============================================================================
 // Message Structs
 // ============================================================================
@@ -116,17 +341,40 @@ struct MessageInfo {
 // No messages defined - add message types to your schema and regenerate
 inline constexpr std::array<MessageInfo, 0> kMessageRegistry = {{}};
 
+/// Largest message type ID defined by the schema
+inline constexpr uint16_t kMaxMessageTypeId = 0;
+
+/// Wire size per type ID (0 = unknown type)
+inline constexpr std::array<uint16_t, 1> kWireSizeTable = {{0}};
+
+/// kMessageRegistry index per type ID (kNoMessageIndex = unknown type)
+inline constexpr uint16_t kNoMessageIndex = 0xFFFF;
+inline constexpr std::array<uint16_t, 1> kMessageIndexTable = {{kNoMessageIndex}};
+
+/// Wire size for a message type, or 0 if the type is unknown
+inline constexpr std::size_t GetWireSize(MessageTypeId typeId) {
+    const auto index = static_cast<uint16_t>(typeId);
+    return index < kWireSizeTable.size() ? kWireSizeTable[index] : 0;
+}
+
 inline std::optional<MessageInfo> GetMessageInfo(MessageTypeId typeId) {
-    for (const auto& info : kMessageRegistry) {
-        if (info.typeId == typeId) return info;
+    const auto index = static_cast<uint16_t>(typeId);
+    if (index >= kMessageIndexTable.size() || kMessageIndexTable[index] == kNoMessageIndex) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    return kMessageRegistry[kMessageIndexTable[index]];
 }
 
 inline std::optional<MessageInfo> GetMessageInfo(uint16_t typeId) {
     return GetMessageInfo(static_cast<MessageTypeId>(typeId));
 }
 
+/// Field widths for a message type (count 0 if the type is unknown)
+inline FieldLayout GetFieldLayout(MessageTypeId typeId) {
+    (void)typeId;
+    return {};
+}
+
 // ============================================================================
 // Handshake Utilities
 // ============================================================================
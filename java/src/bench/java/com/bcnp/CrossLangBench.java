@@ -0,0 +1,381 @@
+package com.bcnp;
+
+import java.io.IOException;
+import java.net.InetSocketAddress;
+import java.net.StandardSocketOptions;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.channels.ByteChannel;
+import java.nio.channels.DatagramChannel;
+import java.nio.channels.ServerSocketChannel;
+import java.nio.channels.SocketChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Locale;
+import java.util.Map;
+import java.util.zip.CRC32;
+
+/**
+ * JNI half of the BCNP cross-language benchmark.
+ *
+ * Runs the operations defined in bench/crosslang/python_bench.py (encode,
+ * decode, parse, tcp_rtt, udp_rtt) on the corpus written by corpus.py and
+ * writes a result file in the same JSON format for report.py.
+ *
+ * The native library must be built from the same schema as the corpus;
+ * the harness compares BcnpJNI.getMessageWireSize() with layout.txt and
+ * exits if they differ.
+ *
+ * Usage:
+ * <pre>
+ *   gradle crossLangBench -PjniLibDir=/path/to/lib \
+ *       -PbenchArgs="--corpus /tmp/bcnp-corpus --out /tmp/bcnp-corpus/jni.json"
+ * </pre>
+ */
+public final class CrossLangBench {
+
+    private static final String FORMAT = "bcnp-crosslang/1";
+    private static final int HEADER = BcnpJNI.HEADER_SIZE;
+    private static final int CRC = BcnpJNI.CRC_SIZE;
+
+    /** Message layout from layout.txt */
+    private static final class Layout {
+        final int wireSize;
+        final int[] widths;
+
+        Layout(int wireSize, int[] widths) {
+            this.wireSize = wireSize;
+            this.widths = widths;
+        }
+    }
+
+    private final ByteBuffer corpus;
+    private final int corpusBytes;
+    private final Map<Integer, Layout> layouts;
+    private final int[] offsets;
+    private final int[] sizes;
+    private final int[] types;
+    private final int[] counts;
+    private final long messages;
+    private final double minTime;
+    private long sink;
+
+    private CrossLangBench(Path dir, double minTime) throws IOException {
+        byte[] bytes = Files.readAllBytes(dir.resolve("corpus.bin"));
+        this.corpus = ByteBuffer.allocateDirect(bytes.length).order(ByteOrder.BIG_ENDIAN);
+        this.corpus.put(bytes).clear();
+        this.corpusBytes = bytes.length;
+        this.minTime = minTime;
+
+        this.layouts = new HashMap<>();
+        for (String line : Files.readAllLines(dir.resolve("layout.txt"), StandardCharsets.UTF_8)) {
+            String[] parts = line.trim().split(" ");
+            if (parts.length < 2) {
+                continue;
+            }
+            int[] widths = parts.length > 2
+                ? Arrays.stream(parts[2].split(",")).mapToInt(Integer::parseInt).toArray()
+                : new int[0];
+            layouts.put(Integer.parseInt(parts[0]), new Layout(Integer.parseInt(parts[1]), widths));
+        }
+        for (Map.Entry<Integer, Layout> entry : layouts.entrySet()) {
+            int nativeSize = BcnpJNI.getMessageWireSize(entry.getKey());
+            if (nativeSize != entry.getValue().wireSize) {
+                throw new IllegalStateException("Native library schema differs from the corpus (type "
+                    + entry.getKey() + ": native size " + nativeSize + ", corpus " + entry.getValue().wireSize
+                    + "); build bcnp_jni from the corpus schema");
+            }
+        }
+
+        List<int[]> packets = new ArrayList<>();
+        long total = 0;
+        for (int offset = 0; offset < corpusBytes; ) {
+            int type = corpus.getShort(offset + 3) & 0xFFFF;
+            int count = corpus.getShort(offset + 5) & 0xFFFF;
+            int size = HEADER + count * layouts.get(type).wireSize + CRC;
+            packets.add(new int[] {offset, size, type, count});
+            total += count;
+            offset += size;
+        }
+        this.offsets = packets.stream().mapToInt(p -> p[0]).toArray();
+        this.sizes = packets.stream().mapToInt(p -> p[1]).toArray();
+        this.types = packets.stream().mapToInt(p -> p[2]).toArray();
+        this.counts = packets.stream().mapToInt(p -> p[3]).toArray();
+        this.messages = total;
+    }
+
+    // ========================================================================
+    // Timing and result formatting (keys shared with python_bench.py)
+    // ========================================================================
+
+    @FunctionalInterface
+    private interface Pass {
+        void run() throws IOException;
+    }
+
+    /** Runs pass until minTime seconds have elapsed (at least once); returns {passes, nanos} */
+    private long[] timedPasses(Pass pass) throws IOException {
+        long passes = 0;
+        long start = System.nanoTime();
+        while (true) {
+            pass.run();
+            passes++;
+            long elapsed = System.nanoTime() - start;
+            if (elapsed >= (long) (minTime * 1e9)) {
+                return new long[] {passes, elapsed};
+            }
+        }
+    }
+
+    private String throughput(String op, long[] run, String extra) {
+        double seconds = run[1] / 1e9;
+        double packets = (double) offsets.length * run[0];
+        double msgs = (double) messages * run[0];
+        double bytes = (double) corpusBytes * run[0];
+        return String.format(Locale.ROOT,
+            "{\"op\": \"%s\", \"passes\": %d, \"seconds\": %.6f, \"packetsPerSec\": %.1f, "
+                + "\"messagesPerSec\": %.1f, \"mbPerSec\": %.3f, \"nsPerMessage\": %.3f%s}",
+            op, run[0], seconds, packets / seconds, msgs / seconds, bytes / seconds / 1e6,
+            seconds * 1e9 / msgs, extra);
+    }
+
+    private static String latency(String op, long[] nanos) {
+        Arrays.sort(nanos);
+        double sum = 0;
+        for (long n : nanos) {
+            sum += n;
+        }
+        return String.format(Locale.ROOT,
+            "{\"op\": \"%s\", \"samples\": %d, \"p50Us\": %.3f, \"p99Us\": %.3f, \"maxUs\": %.3f, \"meanUs\": %.3f}",
+            op, nanos.length, nanos[(int) (0.50 * (nanos.length - 1))] / 1e3,
+            nanos[(int) (0.99 * (nanos.length - 1))] / 1e3, nanos[nanos.length - 1] / 1e3,
+            sum / nanos.length / 1e3);
+    }
+
+    /** Big-endian field read, as the generated flyweight getters do */
+    private static int readField(ByteBuffer buffer, int offset, int width) {
+        switch (width) {
+            case 1: return buffer.get(offset);
+            case 2: return buffer.getShort(offset);
+            default: return buffer.getInt(offset);
+        }
+    }
+
+    private static void writeField(ByteBuffer buffer, int offset, int width, int value) {
+        switch (width) {
+            case 1: buffer.put(offset, (byte) value); break;
+            case 2: buffer.putShort(offset, (short) value); break;
+            default: buffer.putInt(offset, value); break;
+        }
+    }
+
+    // ========================================================================
+    // Operations
+    // ========================================================================
+
+    /** Field values -> staging payload (flyweight setters) -> BcnpJNI.encodePacket */
+    private String benchEncode() throws IOException {
+        int[][] fields = new int[offsets.length][];
+        int maxPayload = 0;
+        for (int p = 0; p < offsets.length; p++) {
+            Layout layout = layouts.get(types[p]);
+            fields[p] = new int[counts[p] * layout.widths.length];
+            int pos = offsets[p] + HEADER;
+            int k = 0;
+            for (int m = 0; m < counts[p]; m++) {
+                for (int width : layout.widths) {
+                    fields[p][k++] = readField(corpus, pos, width);
+                    pos += width;
+                }
+            }
+            maxPayload = Math.max(maxPayload, sizes[p] - HEADER - CRC);
+        }
+        ByteBuffer staging = ByteBuffer.allocateDirect(Math.max(maxPayload, 1)).order(ByteOrder.BIG_ENDIAN);
+        ByteBuffer out = ByteBuffer.allocateDirect(corpusBytes).order(ByteOrder.BIG_ENDIAN);
+
+        Pass pass = () -> {
+            int written = 0;
+            for (int p = 0; p < offsets.length; p++) {
+                int[] widths = layouts.get(types[p]).widths;
+                int pos = 0;
+                int k = 0;
+                for (int m = 0; m < counts[p]; m++) {
+                    for (int width : widths) {
+                        writeField(staging, pos, width, fields[p][k++]);
+                        pos += width;
+                    }
+                }
+                int n = BcnpJNI.encodePacket(out, written, corpusBytes - written, types[p], 0, staging, 0, pos, counts[p]);
+                if (n < 0) {
+                    throw new IllegalStateException("encodePacket failed: " + n);
+                }
+                written += n;
+            }
+        };
+        pass.run();
+        if (!out.duplicate().clear().equals(corpus.duplicate().clear())) {
+            throw new IllegalStateException("encode output differs from corpus.bin");
+        }
+        return throughput("encode", timedPasses(pass), "");
+    }
+
+    /** BcnpJNI.decodePacket per packet, then every field read through the payload slice */
+    private String benchDecode() throws IOException {
+        BcnpResult result = new BcnpResult();
+        BcnpSlice payload = new BcnpSlice();
+        Pass pass = () -> {
+            for (int p = 0; p < offsets.length; p++) {
+                if (!BcnpJNI.decodePacket(corpus, offsets[p], sizes[p], result, payload)) {
+                    throw new IllegalStateException("corpus packet failed to decode: " + result.getErrorString());
+                }
+                int[] widths = layouts.get(result.getMessageType()).widths;
+                int pos = payload.offset();
+                for (int m = 0; m < result.getMessageCount(); m++) {
+                    for (int width : widths) {
+                        sink += readField(corpus, pos, width);
+                        pos += width;
+                    }
+                }
+            }
+        };
+        return throughput("decode", timedPasses(pass), "");
+    }
+
+    /** corpus.bin through a native StreamParser, one parseBatch() crossing per chunk */
+    private String benchParse(int chunk) throws IOException {
+        long[] seen = new long[2];
+        PacketView view = new PacketView();
+        try (StreamParser parser = new StreamParser(64 * 1024)) {
+            PacketBatch batch = new PacketBatch(chunk + 64 * 1024, 4096);
+            Pass pass = () -> {
+                for (int offset = 0; offset < corpusBytes; offset += chunk) {
+                    int n = parser.parseBatch(corpus, offset, Math.min(chunk, corpusBytes - offset), batch);
+                    for (int i = 0; i < n; i++) {
+                        batch.get(i, view);
+                        seen[0]++;
+                        seen[1] += view.getMessageCount();
+                    }
+                }
+            };
+            long[] run = timedPasses(pass);
+            return throughput("parse", run, String.format(Locale.ROOT,
+                ", \"chunk\": %d, \"parsedPackets\": %d, \"parsedMessages\": %d",
+                chunk, seen[0] / run[0], seen[1] / run[0]));
+        }
+    }
+
+    /** Read from a blocking channel until the parser produced one more packet */
+    private static void receivePacket(ByteChannel channel, ByteBuffer rx, StreamParser parser,
+                                      BcnpResult result, BcnpSlice payload) throws IOException {
+        while (true) {
+            rx.clear();
+            int n = channel.read(rx);
+            if (n < 0) {
+                throw new IOException("peer closed");
+            }
+            parser.push(rx, 0, n);
+            if (parser.pop(result, payload)) {
+                return;
+            }
+        }
+    }
+
+    /** Ping-pong corpus packets, both ends on this thread (same method as python_bench.py) */
+    private String roundTrips(String op, ByteChannel client, ByteChannel server, int samples) throws IOException {
+        ByteBuffer rx = ByteBuffer.allocateDirect(64 * 1024);
+        BcnpResult result = new BcnpResult();
+        BcnpSlice payload = new BcnpSlice();
+        long[] nanos = new long[samples];
+        try (StreamParser clientParser = new StreamParser(64 * 1024);
+             StreamParser serverParser = new StreamParser(64 * 1024)) {
+            for (int i = 0; i < samples; i++) {
+                int p = i % offsets.length;
+                ByteBuffer packet = corpus.duplicate();
+                long start = System.nanoTime();
+                packet.limit(offsets[p] + sizes[p]).position(offsets[p]);
+                client.write(packet);
+                receivePacket(server, rx, serverParser, result, payload);
+                packet.limit(offsets[p] + sizes[p]).position(offsets[p]);
+                server.write(packet);
+                receivePacket(client, rx, clientParser, result, payload);
+                nanos[i] = System.nanoTime() - start;
+            }
+        }
+        return latency(op, nanos);
+    }
+
+    private String benchTcpRtt(int samples) throws IOException {
+        try (ServerSocketChannel listener = ServerSocketChannel.open()) {
+            listener.bind(new InetSocketAddress("127.0.0.1", 0));
+            try (SocketChannel client = SocketChannel.open(listener.getLocalAddress());
+                 SocketChannel server = listener.accept()) {
+                client.setOption(StandardSocketOptions.TCP_NODELAY, true);
+                server.setOption(StandardSocketOptions.TCP_NODELAY, true);
+                return roundTrips("tcp_rtt", client, server, samples);
+            }
+        }
+    }
+
+    private String benchUdpRtt(int samples) throws IOException {
+        try (DatagramChannel a = DatagramChannel.open(); DatagramChannel b = DatagramChannel.open()) {
+            a.bind(new InetSocketAddress("127.0.0.1", 0));
+            b.bind(new InetSocketAddress("127.0.0.1", 0));
+            a.connect(b.getLocalAddress());
+            b.connect(a.getLocalAddress());
+            return roundTrips("udp_rtt", a, b, samples);
+        }
+    }
+
+    public static void main(String[] args) throws IOException {
+        Map<String, String> options = new HashMap<>();
+        options.put("--min-time", "1.0");
+        options.put("--chunk", "4096");
+        options.put("--rtt-samples", "2000");
+        for (int i = 0; i + 1 < args.length; i += 2) {
+            options.put(args[i], args[i + 1]);
+        }
+        if (!options.containsKey("--corpus") || !options.containsKey("--out") || args.length % 2 != 0) {
+            System.err.println("usage: CrossLangBench --corpus DIR --out FILE [--min-time SEC] [--chunk BYTES]"
+                + " [--rtt-samples N]");
+            System.exit(2);
+        }
+
+        CrossLangBench bench = new CrossLangBench(Paths.get(options.get("--corpus")),
+            Double.parseDouble(options.get("--min-time")));
+        int rttSamples = Integer.parseInt(options.get("--rtt-samples"));
+        List<String> results = List.of(
+            bench.benchEncode(),
+            bench.benchDecode(),
+            bench.benchParse(Integer.parseInt(options.get("--chunk"))),
+            bench.benchTcpRtt(rttSamples),
+            bench.benchUdpRtt(rttSamples));
+
+        byte[] bytes = new byte[bench.corpusBytes];
+        bench.corpus.duplicate().clear().get(bytes);
+        CRC32 crc = new CRC32();
+        crc.update(bytes);
+
+        StringBuilder json = new StringBuilder();
+        json.append("{\n  \"format\": \"").append(FORMAT).append("\",\n  \"binding\": \"jni\",\n")
+            .append("  \"implementation\": \"Java ").append(System.getProperty("java.version")).append(" JNI\",\n")
+            .append(String.format(Locale.ROOT,
+                "  \"corpus\": {\"crc32\": \"0x%08X\", \"packets\": %d, \"messages\": %d, \"bytes\": %d},\n",
+                crc.getValue(), bench.offsets.length, bench.messages, bench.corpusBytes))
+            .append("  \"results\": [\n");
+        for (int i = 0; i < results.size(); i++) {
+            json.append("    ").append(results.get(i)).append(i + 1 < results.size() ? ",\n" : "\n");
+            System.out.println(results.get(i));
+        }
+        json.append("  ]\n}\n");
+        Files.write(Paths.get(options.get("--out")), json.toString().getBytes(StandardCharsets.UTF_8));
+        if (bench.sink == 42) {
+            System.out.println();   // Keeps decoded field reads observable
+        }
+    }
+}
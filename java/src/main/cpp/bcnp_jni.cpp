@@ -4,18 +4,81 @@
  * 
  * Bridges the Java BcnpJNI class to the C++ bcnp_core library.
  * Uses DirectByteBuffers for zero-copy data sharing.
+ * 
+ * Class and method handles are resolved once in JNI_OnLoad; the per-call
+ * paths only invoke them.
  */
 
 #include <jni.h>
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 #include "bcnp/packet.h"
+#include "bcnp/stream_parser.h"
 
 // JNI function naming: Java_com_bcnp_BcnpJNI_<methodName>
 
+namespace {
+
+/// Handles cached at load time (GetMethodID is a string lookup per call otherwise)
+struct JniCache {
+    jclass resultClass{nullptr};
+    jclass sliceClass{nullptr};
+    jmethodID resultSetOk{nullptr};
+    jmethodID resultSetError{nullptr};
+    jmethodID sliceWrap{nullptr};
+};
+
+JniCache g_jni;
+
+/// Ints per descriptor written by streamParserParseBatch (must match PacketBatch.DESCRIPTOR_INTS)
+constexpr std::size_t kDescriptorInts = 4;
+
+jclass CacheClass(JNIEnv* env, const char* name) {
+    jclass local = env->FindClass(name);
+    if (!local) {
+        return nullptr;
+    }
+    auto global = static_cast<jclass>(env->NewGlobalRef(local));
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+} // namespace
+
 extern "C" {
 
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void*) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8) != JNI_OK) {
+        return JNI_ERR;
+    }
+    g_jni.resultClass = CacheClass(env, "com/bcnp/BcnpResult");
+    g_jni.sliceClass = CacheClass(env, "com/bcnp/BcnpSlice");
+    if (!g_jni.resultClass || !g_jni.sliceClass) {
+        return JNI_ERR;
+    }
+    g_jni.resultSetOk = env->GetMethodID(g_jni.resultClass, "setOk", "(III)V");
+    g_jni.resultSetError = env->GetMethodID(g_jni.resultClass, "setError", "(II)V");
+    g_jni.sliceWrap = env->GetMethodID(g_jni.sliceClass, "wrap", "(Ljava/nio/ByteBuffer;II)V");
+    if (!g_jni.resultSetOk || !g_jni.resultSetError || !g_jni.sliceWrap) {
+        return JNI_ERR;
+    }
+    return JNI_VERSION_1_8;
+}
+
+JNIEXPORT void JNICALL JNI_OnUnload(JavaVM* vm, void*) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_8) != JNI_OK) {
+        return;
+    }
+    env->DeleteGlobalRef(g_jni.resultClass);
+    env->DeleteGlobalRef(g_jni.sliceClass);
+    g_jni = JniCache{};
+}
+
 /**
  * Helper to get direct buffer address and validate.
  */
@@ -42,34 +105,25 @@ JNIEXPORT jboolean JNICALL Java_com_bcnp_BcnpJNI_decodePacket(
     // Decode using C++ library
     bcnp::DecodeViewResult decodeResult = bcnp::DecodePacketView(data, static_cast<std::size_t>(length));
     
-    // Get result class and methods
-    jclass resultClass = env->GetObjectClass(result);
-    jmethodID setOkMethod = env->GetMethodID(resultClass, "setOk", "(III)V");
-    jmethodID setErrorMethod = env->GetMethodID(resultClass, "setError", "(II)V");
-    
     if (decodeResult.error != bcnp::PacketError::None || decodeResult.view.is_none()) {
         // Set error in result object
         int errorCode = static_cast<int>(decodeResult.error);
-        env->CallVoidMethod(result, setErrorMethod, errorCode, static_cast<jint>(decodeResult.bytesConsumed));
+        env->CallVoidMethod(result, g_jni.resultSetError, errorCode, static_cast<jint>(decodeResult.bytesConsumed));
         return JNI_FALSE;
     }
     
     // Success - populate result and payload slice
     const auto& view = decodeResult.view.unwrap();
-    env->CallVoidMethod(result, setOkMethod,
+    env->CallVoidMethod(result, g_jni.resultSetOk,
         static_cast<jint>(decodeResult.bytesConsumed),
         static_cast<jint>(view.header.messageType),
         static_cast<jint>(view.header.messageCount));
     
-    // Populate payload slice
-    jclass sliceClass = env->GetObjectClass(payloadSlice);
-    jmethodID wrapMethod = env->GetMethodID(sliceClass, "wrap", "(Ljava/nio/ByteBuffer;II)V");
-    
     // Calculate payload offset within the original buffer
     jint payloadOffset = offset + bcnp::kHeaderSizeV3;
     jint payloadLength = static_cast<jint>(view.payload.size());
     
-    env->CallVoidMethod(payloadSlice, wrapMethod, buffer, payloadOffset, payloadLength);
+    env->CallVoidMethod(payloadSlice, g_jni.sliceWrap, buffer, payloadOffset, payloadLength);
     
     return JNI_TRUE;
 }
@@ -96,7 +150,7 @@ JNIEXPORT jint JNICALL Java_com_bcnp_BcnpJNI_encodePacket(
     
     // Calculate expected packet size
     std::size_t headerSize = bcnp::kHeaderSizeV3;
-    std::size_t crcSize = bcnp::kCrcSize;
+    std::size_t crcSize = bcnp::kChecksumSize;
     std::size_t totalSize = headerSize + static_cast<std::size_t>(payloadLength) + crcSize;
     
     if (totalSize > static_cast<std::size_t>(maxLength)) {
@@ -113,23 +167,17 @@ JNIEXPORT jint JNICALL Java_com_bcnp_BcnpJNI_encodePacket(
     dest[0] = bcnp::kProtocolMajor;
     dest[1] = bcnp::kProtocolMinor;
     dest[2] = header.flags;
-    dest[3] = static_cast<uint8_t>((header.messageType >> 8) & 0xFF);
-    dest[4] = static_cast<uint8_t>(header.messageType & 0xFF);
-    dest[5] = static_cast<uint8_t>((header.messageCount >> 8) & 0xFF);
-    dest[6] = static_cast<uint8_t>(header.messageCount & 0xFF);
+    bcnp::detail::StoreU16(static_cast<uint16_t>(header.messageType), &dest[bcnp::kHeaderMsgTypeIndex]);
+    bcnp::detail::StoreU16(header.messageCount, &dest[bcnp::kHeaderMsgCountIndex]);
     
     // Copy payload
     if (payloadLength > 0) {
         std::memcpy(dest + headerSize, payloadData, static_cast<std::size_t>(payloadLength));
     }
     
-    // Compute and write CRC
+    // Compute and write CRC (big-endian like every other field)
     std::size_t dataLen = headerSize + static_cast<std::size_t>(payloadLength);
-    uint32_t crc = bcnp::ComputeCrc32(dest, dataLen);
-    dest[dataLen + 0] = static_cast<uint8_t>(crc & 0xFF);
-    dest[dataLen + 1] = static_cast<uint8_t>((crc >> 8) & 0xFF);
-    dest[dataLen + 2] = static_cast<uint8_t>((crc >> 16) & 0xFF);
-    dest[dataLen + 3] = static_cast<uint8_t>((crc >> 24) & 0xFF);
+    bcnp::detail::StoreU32(bcnp::ComputeCrc32(dest, dataLen), &dest[dataLen]);
     
     return static_cast<jint>(totalSize);
 }
@@ -158,18 +206,34 @@ JNIEXPORT jint JNICALL Java_com_bcnp_BcnpJNI_getMessageWireSize(
     return info ? static_cast<jint>(info->wireSize) : 0;
 }
 
-// StreamParser handle storage (simplified, in production use proper handle management)
-#include "bcnp/stream_parser.h"
-#include <vector>
+/**
+ * Destination of streamParserParseBatch: frames are copied into a Java
+ * direct ByteBuffer arena and described by (offset, type, count, length).
+ */
+struct BatchTarget {
+    uint8_t* arena{nullptr};
+    std::size_t arenaCapacity{0};
+    std::size_t arenaUsed{0};
+    jint* descriptors{nullptr};
+    std::size_t maxPackets{0};
+    std::size_t packets{0};
+};
 
+// StreamParser handle storage (simplified, in production use proper handle management)
 struct JavaStreamParser {
     std::vector<bcnp::PacketView> pendingPackets;
+    BatchTarget* batch{nullptr};   // Set for the duration of streamParserParseBatch
+    uint64_t droppedPackets{0};
     bcnp::StreamParser* parser;
     
     JavaStreamParser(int capacity) {
         parser = new bcnp::StreamParser(
             [this](const bcnp::PacketView& pkt) {
-                pendingPackets.push_back(pkt);
+                if (batch) {
+                    CopyToBatch(pkt);
+                } else {
+                    pendingPackets.push_back(pkt);
+                }
             },
             [](const bcnp::StreamParser::ErrorInfo&) {},
             static_cast<std::size_t>(capacity));
@@ -178,6 +242,33 @@ struct JavaStreamParser {
     ~JavaStreamParser() {
         delete parser;
     }
+
+    /// Header (compressed flag already cleared) + fixed-width payload, or a drop when full
+    void CopyToBatch(const bcnp::PacketView& pkt) {
+        const std::size_t payloadSize = pkt.payload.size();
+        const std::size_t frameSize = bcnp::kHeaderSizeV3 + payloadSize;
+        if (batch->packets == batch->maxPackets || frameSize > batch->arenaCapacity - batch->arenaUsed) {
+            ++droppedPackets;
+            return;
+        }
+        uint8_t* out = batch->arena + batch->arenaUsed;
+        out[bcnp::kHeaderMajorIndex] = pkt.header.major;
+        out[bcnp::kHeaderMinorIndex] = pkt.header.minor;
+        out[bcnp::kHeaderFlagsIndex] = pkt.header.flags;
+        bcnp::detail::StoreU16(static_cast<uint16_t>(pkt.header.messageType), &out[bcnp::kHeaderMsgTypeIndex]);
+        bcnp::detail::StoreU16(pkt.header.messageCount, &out[bcnp::kHeaderMsgCountIndex]);
+        if (payloadSize > 0) {
+            std::memcpy(out + bcnp::kHeaderSizeV3, pkt.payload.data(), payloadSize);
+        }
+
+        jint* descriptor = batch->descriptors + batch->packets * kDescriptorInts;
+        descriptor[0] = static_cast<jint>(batch->arenaUsed);
+        descriptor[1] = static_cast<jint>(pkt.header.messageType);
+        descriptor[2] = static_cast<jint>(pkt.header.messageCount);
+        descriptor[3] = static_cast<jint>(payloadSize);
+        batch->arenaUsed += frameSize;
+        ++batch->packets;
+    }
 };
 
 JNIEXPORT jlong JNICALL Java_com_bcnp_BcnpJNI_createStreamParser(
@@ -220,22 +311,63 @@ JNIEXPORT jboolean JNICALL Java_com_bcnp_BcnpJNI_streamParserPop(
     
     const auto& view = jsp->pendingPackets.front();
     
-    // Populate result
-    jclass resultClass = env->GetObjectClass(result);
-    jmethodID setOkMethod = env->GetMethodID(resultClass, "setOk", "(III)V");
-    
     // Note: bytesConsumed is not meaningful here, set to payload size
-    env->CallVoidMethod(result, setOkMethod,
+    env->CallVoidMethod(result, g_jni.resultSetOk,
         static_cast<jint>(view.payload.size()),
         static_cast<jint>(view.header.messageType),
         static_cast<jint>(view.header.messageCount));
     
-    // Note: payload slice cannot point to internal ring buffer (it's not a DirectByteBuffer)
-    // For proper implementation, we would need to copy to a DirectByteBuffer
-    // This is a limitation of the current design, may need rework
+    // Note: payload slice cannot point to internal ring buffer (it's not a DirectByteBuffer);
+    // use streamParserParseBatch() to receive payloads in a Java-visible arena
     
     jsp->pendingPackets.erase(jsp->pendingPackets.begin());
     return JNI_TRUE;
 }
 
+/**
+ * Push bytes and copy every completed frame into a direct ByteBuffer arena.
+ * 
+ * One call per received chunk replaces a push plus one pop per packet.
+ * Frames that do not fit the arena or descriptor table are dropped and
+ * counted (streamParserDroppedPackets).
+ * 
+ * @return Frames written, or -1 if a buffer is not direct or too small
+ */
+JNIEXPORT jint JNICALL Java_com_bcnp_BcnpJNI_streamParserParseBatch(
+    JNIEnv* env, jclass cls,
+    jlong handle, jobject buffer, jint offset, jint length,
+    jobject arena, jint arenaLength, jobject descriptors, jint maxPackets)
+{
+    if (!handle || offset < 0 || length < 0 || arenaLength < 0 || maxPackets < 0) return -1;
+    uint8_t* data = GetBufferAddress(env, buffer, offset);
+    uint8_t* arenaData = GetBufferAddress(env, arena, 0);
+    auto* descriptorData = reinterpret_cast<jint*>(GetBufferAddress(env, descriptors, 0));
+    if (!data || !arenaData || !descriptorData ||
+        env->GetDirectBufferCapacity(buffer) < static_cast<jlong>(offset) + length ||
+        env->GetDirectBufferCapacity(arena) < arenaLength ||
+        env->GetDirectBufferCapacity(descriptors) <
+            static_cast<jlong>(maxPackets) * static_cast<jlong>(kDescriptorInts * sizeof(jint))) {
+        return -1;
+    }
+
+    auto* jsp = reinterpret_cast<JavaStreamParser*>(handle);
+    BatchTarget target;
+    target.arena = arenaData;
+    target.arenaCapacity = static_cast<std::size_t>(arenaLength);
+    target.descriptors = descriptorData;
+    target.maxPackets = static_cast<std::size_t>(maxPackets);
+
+    jsp->batch = &target;
+    jsp->parser->Push(data, static_cast<std::size_t>(length));
+    jsp->batch = nullptr;
+    return static_cast<jint>(target.packets);
+}
+
+JNIEXPORT jlong JNICALL Java_com_bcnp_BcnpJNI_streamParserDroppedPackets(
+    JNIEnv* env, jclass cls, jlong handle)
+{
+    if (!handle) return 0;
+    return static_cast<jlong>(reinterpret_cast<JavaStreamParser*>(handle)->droppedPackets);
+}
+
 } // extern "C"
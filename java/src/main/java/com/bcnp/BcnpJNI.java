@@ -114,6 +114,35 @@ public final class BcnpJNI {
     public static native boolean streamParserPop(
         long handle, BcnpResult result, BcnpSlice payloadSlice);
     
+    /**
+     * Push bytes and copy every completed packet into a batch arena in one call.
+     * 
+     * Each packet is written to the arena as its 7-byte header followed by the
+     * fixed-width payload, and described by {@link PacketBatch#DESCRIPTOR_INTS}
+     * native-order ints: arena offset, message type, message count, payload length.
+     * 
+     * @param handle Native StreamParser handle
+     * @param buffer Direct ByteBuffer containing data
+     * @param offset Starting offset
+     * @param length Number of bytes to push
+     * @param arena Direct ByteBuffer receiving the packets
+     * @param arenaLength Usable bytes of the arena
+     * @param descriptors Direct ByteBuffer for the descriptor table
+     * @param maxPackets Descriptor slots available
+     * @return Packets written, or -1 if a buffer is invalid
+     */
+    public static native int streamParserParseBatch(
+        long handle, ByteBuffer buffer, int offset, int length,
+        ByteBuffer arena, int arenaLength, ByteBuffer descriptors, int maxPackets);
+    
+    /**
+     * Packets dropped by streamParserParseBatch because the batch was full.
+     * 
+     * @param handle Native StreamParser handle
+     * @return Total dropped packets
+     */
+    public static native long streamParserDroppedPackets(long handle);
+    
     // Private constructor - utility class
     private BcnpJNI() {}
 }
@@ -0,0 +1,99 @@
+package com.bcnp;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Reusable destination for {@link StreamParser#parseBatch}.
+ * 
+ * Owns a direct ByteBuffer arena that native code copies validated packets
+ * into, plus a descriptor table of (offset, type, count, payload length)
+ * per packet. Views wrap the arena directly, so reading a batch allocates
+ * nothing and makes no further JNI calls.
+ * 
+ * Size the arena for the largest chunk pushed plus the parser's buffer
+ * capacity; packets that do not fit are dropped and counted by
+ * {@link StreamParser#droppedPackets()}.
+ * 
+ * Usage:
+ * <pre>
+ *   PacketBatch batch = new PacketBatch(16384, 256);
+ *   PacketView view = new PacketView();
+ *   int n = parser.parseBatch(rx, 0, received, batch);
+ *   for (int i = 0; i &lt; n; i++) {
+ *       batch.get(i, view);
+ *   }
+ * </pre>
+ */
+public final class PacketBatch {
+    
+    /** Ints per packet descriptor (must match bcnp_jni.cpp) */
+    public static final int DESCRIPTOR_INTS = 4;
+    
+    private static final int OFFSET = 0;
+    private static final int TYPE = 1;
+    private static final int COUNT = 2;
+    private static final int LENGTH = 3;
+    
+    private final ByteBuffer arena;
+    private final ByteBuffer descriptors;
+    private final int maxPackets;
+    private int count;
+    
+    /**
+     * @param arenaCapacity Bytes available for packet headers and payloads
+     * @param maxPackets Packets a single parseBatch() call can return
+     */
+    public PacketBatch(int arenaCapacity, int maxPackets) {
+        this.arena = ByteBuffer.allocateDirect(arenaCapacity).order(ByteOrder.BIG_ENDIAN);
+        this.descriptors = ByteBuffer.allocateDirect(maxPackets * DESCRIPTOR_INTS * Integer.BYTES)
+            .order(ByteOrder.nativeOrder());
+        this.maxPackets = maxPackets;
+        this.count = 0;
+    }
+    
+    /**
+     * @return Packets in the batch
+     */
+    public int size() {
+        return count;
+    }
+    
+    /**
+     * Point a view at packet {@code index} (zero-allocation).
+     * 
+     * @param index Packet index (0-based)
+     * @param view Reusable view to populate
+     */
+    public void get(int index, PacketView view) {
+        if (index < 0 || index >= count) {
+            throw new IndexOutOfBoundsException("Packet index " + index + " out of range [0, " + count + ")");
+        }
+        int base = index * DESCRIPTOR_INTS * Integer.BYTES;
+        int offset = descriptors.getInt(base + OFFSET * Integer.BYTES);
+        int type = descriptors.getInt(base + TYPE * Integer.BYTES);
+        int messageCount = descriptors.getInt(base + COUNT * Integer.BYTES);
+        int length = descriptors.getInt(base + LENGTH * Integer.BYTES);
+        int flags = arena.get(offset + 2) & 0xFF;
+        view.wrap(arena, offset, offset + BcnpJNI.HEADER_SIZE, length, type, messageCount, flags);
+    }
+    
+    /**
+     * Empty the batch (parseBatch() does this implicitly).
+     */
+    public void clear() {
+        count = 0;
+    }
+    
+    ByteBuffer arena() { return arena; }
+    ByteBuffer descriptors() { return descriptors; }
+    int arenaCapacity() { return arena.capacity(); }
+    int maxPackets() { return maxPackets; }
+    
+    void setCount(int count) {
+        if (count < 0 || count > maxPackets) {
+            throw new IllegalArgumentException("Batch count " + count + " out of range [0, " + maxPackets + "]");
+        }
+        this.count = count;
+    }
+}
@@ -86,6 +86,38 @@ public final class StreamParser implements AutoCloseable {
         }
     }
     
+    /**
+     * Push bytes and collect every completed packet into a batch.
+     * 
+     * One JNI crossing per chunk instead of one per packet; the batch's
+     * views read the packets in place from its arena.
+     * 
+     * @param buffer Direct ByteBuffer containing data
+     * @param offset Offset within the buffer
+     * @param length Number of bytes to push
+     * @param batch Reusable batch (cleared first)
+     * @return Number of packets in the batch
+     */
+    public int parseBatch(ByteBuffer buffer, int offset, int length, PacketBatch batch) {
+        if (nativeHandle == 0) {
+            throw new IllegalStateException("StreamParser has been closed");
+        }
+        int count = BcnpJNI.streamParserParseBatch(nativeHandle, buffer, offset, length,
+            batch.arena(), batch.arenaCapacity(), batch.descriptors(), batch.maxPackets());
+        if (count < 0) {
+            throw new IllegalArgumentException("parseBatch requires direct ByteBuffers");
+        }
+        batch.setCount(count);
+        return count;
+    }
+    
+    /**
+     * @return Packets dropped by parseBatch() because a batch was full
+     */
+    public long droppedPackets() {
+        return nativeHandle == 0 ? 0 : BcnpJNI.streamParserDroppedPackets(nativeHandle);
+    }
+    
     /**
      * Release native resources.
      */
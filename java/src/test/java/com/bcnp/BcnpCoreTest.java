@@ -162,4 +162,43 @@ class BcnpCoreTest {
         view.getMessage(1, 4, msgSlice);
         assertEquals(0xABCDEF01 & 0xFFFFFFFFL, msgSlice.getInt(0) & 0xFFFFFFFFL);
     }
+    
+    // ========================================================================
+    // PacketBatch Tests
+    // ========================================================================
+    
+    @Test
+    @DisplayName("PacketBatch: Views read packets in place from the arena")
+    void testPacketBatchViews() {
+        PacketBatch batch = new PacketBatch(64, 2);
+        assertEquals(0, batch.size());
+        
+        // Lay out what native code writes: header + payload, then its descriptor
+        batch.arena().put(0, (byte) 3).put(1, (byte) 2).put(2, (byte) 0x01);
+        batch.arena().putInt(7, 0x12345678);
+        batch.arena().putInt(11, 0x0BADF00D);
+        batch.descriptors().putInt(0, 0).putInt(4, 10).putInt(8, 2).putInt(12, 8);
+        batch.arena().putShort(22, (short) 0x7FFF);
+        batch.descriptors().putInt(16, 15).putInt(20, 12).putInt(24, 1).putInt(28, 2);
+        batch.setCount(2);
+        
+        PacketView view = new PacketView();
+        BcnpSlice msg = new BcnpSlice();
+        batch.get(0, view);
+        assertEquals(10, view.getMessageType());
+        assertEquals(2, view.getMessageCount());
+        assertEquals(0x01, view.getFlags());
+        view.getMessage(1, 4, msg);
+        assertEquals((byte) 0x0B, msg.get(0));
+        assertEquals((byte) 0x0D, msg.get(3));
+        
+        batch.get(1, view);
+        assertEquals(12, view.getMessageType());
+        assertEquals(2, view.getPayloadLength());
+        
+        assertThrows(IndexOutOfBoundsException.class, () -> batch.get(2, view));
+        assertThrows(IllegalArgumentException.class, () -> batch.setCount(3));
+        batch.clear();
+        assertEquals(0, batch.size());
+    }
 }
@@ -74,6 +74,31 @@ def compute_schema_hash(schema: dict) -> int:
     return compute_crc32(canonical.encode("utf-8"))
 
 
+# Type IDs up to this value get flat lookup tables; larger (sparse) IDs use a switch.
+MAX_DENSE_TYPE_ID = 1023
+
+
+FIELD_TYPE_ENUM = {
+    "int8": "Int8",
+    "uint8": "UInt8",
+    "int16": "Int16",
+    "uint16": "UInt16",
+    "int32": "Int32",
+    "uint32": "UInt32",
+    "float32": "Float32",
+}
+
+
+def field_offsets(msg: dict) -> list:
+    """Byte offset of each field within the message, in order."""
+    offsets = []
+    offset = 0
+    for field in msg["fields"]:
+        offsets.append(offset)
+        offset += TYPE_INFO[field["type"]][0]
+    return offsets
+
+
 def compute_message_size(msg: dict) -> int:
     """Compute wire size of a message in bytes."""
     size = 0
@@ -81,6 +106,402 @@ def compute_message_size(msg: dict) -> int:
         size += TYPE_INFO[field["type"]][0]
     return size
 
+# SIMD selection for the generated batch kernels. Compile-time only: the
+# header is included from many targets, so it follows each target's flags.
+SIMD_PREAMBLE = [
+    "// Batch codec SIMD selection (define BCNP_NO_SIMD to force the scalar kernels)",
+    "#if !defined(BCNP_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__))",
+    "#define BCNP_SIMD_SSE2 1",
+    "#include <emmintrin.h>",
+    "#if defined(__SSSE3__)",
+    "#define BCNP_SIMD_SSSE3 1",
+    "#include <tmmintrin.h>",
+    "#endif",
+    "#if defined(__AVX__)",
+    "#define BCNP_SIMD_AVX 1",
+    "#include <immintrin.h>",
+    "#endif",
+    "#elif !defined(BCNP_NO_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)",
+    "#define BCNP_SIMD_NEON 1",
+    "#include <arm_neon.h>",
+    "#endif",
+]
+
+SIMD_KERNELS = r"""// ----------------------------------------------------------------------------
+// Batch kernels used by the generated DecodeBatch()/EncodeBatch().
+// Results are bit-identical to Decode()/Encode(): dequantization divides in
+// double like DequantizeFloat, quantization reproduces llround on the clamp.
+// ----------------------------------------------------------------------------
+
+/// Messages processed per DecodeBatch()/EncodeBatch() block
+constexpr std::size_t kBatchBlock = 16;
+
+/// Load `words` big-endian 32-bit words from `in` into host order
+inline void LoadBlockU32(const uint8_t* in, uint32_t* out, std::size_t words) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_SSSE3)
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= words; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(v, swap));
+    }
+#elif defined(BCNP_SIMD_SSE2)
+    for (; i + 4 <= words; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+    }
+#elif defined(BCNP_SIMD_NEON)
+    for (; i + 4 <= words; i += 4) {
+        vst1q_u32(out + i, vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in + i * 4))));
+    }
+#endif
+    for (; i < words; ++i) {
+        out[i] = LoadU32(in + i * 4);
+    }
+}
+
+/// Store `words` host-order 32-bit words to `out` as big-endian
+inline void StoreBlockU32(const uint32_t* in, uint8_t* out, std::size_t words) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_SSSE3)
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= words; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), _mm_shuffle_epi8(v, swap));
+    }
+#elif defined(BCNP_SIMD_SSE2)
+    for (; i + 4 <= words; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), v);
+    }
+#elif defined(BCNP_SIMD_NEON)
+    for (; i + 4 <= words; i += 4) {
+        vst1q_u8(out + i * 4, vrev32q_u8(vreinterpretq_u8_u32(vld1q_u32(in + i))));
+    }
+#endif
+    for (; i < words; ++i) {
+        StoreU32(in[i], out + i * 4);
+    }
+}
+
+/// DequantizeFloat() over `n` values
+inline void DequantizeBlock(const int32_t* in, std::size_t n, float scale, float* out) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_AVX)
+    const __m256d s4 = _mm256_set1_pd(static_cast<double>(scale));
+    for (; i + 4 <= n; i += 4) {
+        const __m256d d = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+        _mm_storeu_ps(out + i, _mm256_cvtpd_ps(_mm256_div_pd(d, s4)));
+    }
+#endif
+#if defined(BCNP_SIMD_SSE2)
+    const __m128d s2 = _mm_set1_pd(static_cast<double>(scale));
+    for (; i + 2 <= n; i += 2) {
+        const __m128d d = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+        _mm_storel_pi(reinterpret_cast<__m64*>(out + i), _mm_cvtpd_ps(_mm_div_pd(d, s2)));
+    }
+#elif defined(BCNP_SIMD_NEON)
+    const float64x2_t s2 = vdupq_n_f64(static_cast<double>(scale));
+    for (; i + 2 <= n; i += 2) {
+        const float64x2_t d = vcvtq_f64_s64(vmovl_s32(vld1_s32(in + i)));
+        vst1_f32(out + i, vcvt_f32_f64(vdivq_f64(d, s2)));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = DequantizeFloat(in[i], scale);
+    }
+}
+
+/// QuantizeFloat() over `n` values; false if any value is not finite
+inline bool QuantizeBlock(const float* in, std::size_t n, float scale, int32_t* out) {
+    std::size_t i = 0;
+    constexpr double kMin = static_cast<double>(std::numeric_limits<int32_t>::min());
+    constexpr double kMax = static_cast<double>(std::numeric_limits<int32_t>::max());
+#if defined(BCNP_SIMD_AVX)
+    {
+        const __m256d s = _mm256_set1_pd(static_cast<double>(scale));
+        const __m256d lo = _mm256_set1_pd(kMin);
+        const __m256d hi = _mm256_set1_pd(kMax);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d one = _mm256_set1_pd(1.0);
+        for (; i + 4 <= n; i += 4) {
+            const __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(in + i));
+            if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_sub_pd(x, x), _mm256_setzero_pd(), _CMP_EQ_OQ)) != 0xF) {
+                return false;
+            }
+            const __m256d v = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(x, s), lo), hi);
+            const __m256d t = _mm256_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m256d frac = _mm256_sub_pd(v, t);
+            const __m256d up = _mm256_and_pd(_mm256_cmp_pd(frac, half, _CMP_GE_OQ), one);
+            const __m256d down = _mm256_and_pd(_mm256_cmp_pd(frac, _mm256_sub_pd(_mm256_setzero_pd(), half), _CMP_LE_OQ), one);
+            const __m256d r = _mm256_sub_pd(_mm256_add_pd(t, up), down);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvttpd_epi32(r));
+        }
+    }
+#endif
+#if defined(BCNP_SIMD_SSE2)
+    {
+        const __m128d s = _mm_set1_pd(static_cast<double>(scale));
+        const __m128d lo = _mm_set1_pd(kMin);
+        const __m128d hi = _mm_set1_pd(kMax);
+        const __m128d half = _mm_set1_pd(0.5);
+        const __m128d negHalf = _mm_set1_pd(-0.5);
+        const __m128d one = _mm_set1_pd(1.0);
+        for (; i + 2 <= n; i += 2) {
+            const __m128d x = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i))));
+            if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_sub_pd(x, x), _mm_setzero_pd())) != 0x3) {
+                return false;
+            }
+            const __m128d v = _mm_min_pd(_mm_max_pd(_mm_mul_pd(x, s), lo), hi);
+            const __m128d t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(v));
+            const __m128d frac = _mm_sub_pd(v, t);
+            const __m128d up = _mm_and_pd(_mm_cmpge_pd(frac, half), one);
+            const __m128d down = _mm_and_pd(_mm_cmple_pd(frac, negHalf), one);
+            const __m128d r = _mm_sub_pd(_mm_add_pd(t, up), down);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_cvttpd_epi32(r));
+        }
+    }
+#elif defined(BCNP_SIMD_NEON)
+    {
+        const float64x2_t s = vdupq_n_f64(static_cast<double>(scale));
+        const float64x2_t lo = vdupq_n_f64(kMin);
+        const float64x2_t hi = vdupq_n_f64(kMax);
+        const float64x2_t half = vdupq_n_f64(0.5);
+        const float64x2_t negHalf = vdupq_n_f64(-0.5);
+        const float64x2_t one = vdupq_n_f64(1.0);
+        const float64x2_t zero = vdupq_n_f64(0.0);
+        for (; i + 2 <= n; i += 2) {
+            const float64x2_t x = vcvt_f64_f32(vld1_f32(in + i));
+            const uint64x2_t finite = vceqq_f64(vsubq_f64(x, x), zero);
+            if ((vgetq_lane_u64(finite, 0) & vgetq_lane_u64(finite, 1)) == 0) {
+                return false;
+            }
+            const float64x2_t v = vminq_f64(vmaxq_f64(vmulq_f64(x, s), lo), hi);
+            const float64x2_t t = vrndq_f64(v);
+            const float64x2_t frac = vsubq_f64(v, t);
+            const float64x2_t up = vbslq_f64(vcgeq_f64(frac, half), one, zero);
+            const float64x2_t down = vbslq_f64(vcleq_f64(frac, negHalf), one, zero);
+            const float64x2_t r = vsubq_f64(vaddq_f64(t, up), down);
+            vst1_s32(out + i, vmovn_s64(vcvtq_s64_f64(r)));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (!std::isfinite(in[i])) return false;
+        out[i] = QuantizeFloat(in[i], scale);
+    }
+    return true;
+}
+
+""".split("\n")
+
+
+def generate_cpp_batch_methods(msg: dict) -> list:
+    """Generate DecodeBatch/EncodeBatch for one message struct.
+
+    Messages are processed kBatchBlock at a time: fields are gathered into
+    small per-field arrays so the SIMD kernels can byte-swap and
+    (de)quantize many values per instruction. Messages made only of 32-bit
+    fields are byte-swapped as one contiguous block of words.
+    """
+    name = msg["name"]
+    fields = msg["fields"]
+    all32 = bool(fields) and all(TYPE_INFO[f["type"]][0] == 4 for f in fields)
+    has_float = any(f["type"] == "float32" for f in fields)
+    words = compute_message_size(msg) // 4
+
+    def word(index: str, k: int) -> str:
+        return f"words[{index} * kWords + {k}]"
+
+    out = []
+    out.append("")
+    out.append("    /// Decode `count` consecutive messages (count * kWireSize bytes) into `out`.")
+    out.append("    /// Same results as Decode() per message; float fields are always finite.")
+    out.append(f"    static void DecodeBatch(const uint8_t* data, std::size_t count, {name}* out) {{")
+    out.append("        constexpr std::size_t kBlock = detail::kBatchBlock;")
+    if all32:
+        out.append("        constexpr std::size_t kWords = kWireSize / 4;")
+        out.append("        uint32_t words[kBlock * kWords];")
+    if has_float:
+        out.append("        int32_t raw[kBlock];")
+        out.append("        float values[kBlock];")
+    out.append("        for (std::size_t base = 0; base < count; base += kBlock) {")
+    out.append("            const std::size_t n = std::min(kBlock, count - base);")
+    out.append("            const uint8_t* block = data + base * kWireSize;")
+    out.append(f"            {name}* dst = out + base;")
+    if all32:
+        out.append("            detail::LoadBlockU32(block, words, n * kWords);")
+    offset = 0
+    for k, field in enumerate(fields):
+        ftype = field["type"]
+        fname = field["name"]
+        at = f"block + i * kWireSize + {offset}"
+        if ftype == "float32":
+            scale = field.get("scale", 10000)
+            src = f"static_cast<int32_t>({word('i', offset // 4)})" if all32 else f"detail::LoadS32({at})"
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) raw[i] = {src};")
+            out.append(f"            detail::DequantizeBlock(raw, n, {scale}.0f, values);")
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) dst[i].{fname} = values[i];")
+        elif ftype == "int32":
+            src = f"static_cast<int32_t>({word('i', offset // 4)})" if all32 else f"detail::LoadS32({at})"
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) dst[i].{fname} = {src};")
+        elif ftype == "uint32":
+            src = word("i", offset // 4) if all32 else f"detail::LoadU32({at})"
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) dst[i].{fname} = {src};")
+        elif ftype == "int16":
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) dst[i].{fname} = detail::LoadS16({at});")
+        elif ftype == "uint16":
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) dst[i].{fname} = detail::LoadU16({at});")
+        elif ftype == "uint8":
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) dst[i].{fname} = block[i * kWireSize + {offset}];")
+        elif ftype == "int8":
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) dst[i].{fname} = static_cast<int8_t>(block[i * kWireSize + {offset}]);")
+        offset += TYPE_INFO[ftype][0]
+    out.append("        }")
+    out.append("    }")
+    out.append("")
+
+    out.append("    /// Encode `count` messages from `in` into `out` (count * kWireSize bytes).")
+    out.append("    /// Same bytes as Encode() per message; false if any float field is not finite.")
+    out.append(f"    static bool EncodeBatch(const {name}* in, std::size_t count, uint8_t* out) {{")
+    out.append("        constexpr std::size_t kBlock = detail::kBatchBlock;")
+    if all32:
+        out.append("        constexpr std::size_t kWords = kWireSize / 4;")
+        out.append("        uint32_t words[kBlock * kWords];")
+    if has_float:
+        out.append("        int32_t raw[kBlock];")
+        out.append("        float values[kBlock];")
+    out.append("        for (std::size_t base = 0; base < count; base += kBlock) {")
+    out.append("            const std::size_t n = std::min(kBlock, count - base);")
+    out.append("            uint8_t* block = out + base * kWireSize;")
+    out.append(f"            const {name}* src = in + base;")
+    offset = 0
+    for field in fields:
+        ftype = field["type"]
+        fname = field["name"]
+        at = f"block + i * kWireSize + {offset}"
+        if ftype == "float32":
+            scale = field.get("scale", 10000)
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) values[i] = src[i].{fname};")
+            out.append(f"            if (!detail::QuantizeBlock(values, n, {scale}.0f, raw)) return false;")
+            if all32:
+                out.append(f"            for (std::size_t i = 0; i < n; ++i) {word('i', offset // 4)} = static_cast<uint32_t>(raw[i]);")
+            else:
+                out.append(f"            for (std::size_t i = 0; i < n; ++i) detail::StoreS32(raw[i], {at});")
+        elif ftype == "int32":
+            if all32:
+                out.append(f"            for (std::size_t i = 0; i < n; ++i) {word('i', offset // 4)} = static_cast<uint32_t>(src[i].{fname});")
+            else:
+                out.append(f"            for (std::size_t i = 0; i < n; ++i) detail::StoreS32(src[i].{fname}, {at});")
+        elif ftype == "uint32":
+            if all32:
+                out.append(f"            for (std::size_t i = 0; i < n; ++i) {word('i', offset // 4)} = src[i].{fname};")
+            else:
+                out.append(f"            for (std::size_t i = 0; i < n; ++i) detail::StoreU32(src[i].{fname}, {at});")
+        elif ftype == "int16":
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) detail::StoreS16(src[i].{fname}, {at});")
+        elif ftype == "uint16":
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) detail::StoreU16(src[i].{fname}, {at});")
+        elif ftype in ("int8", "uint8"):
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) block[i * kWireSize + {offset}] = static_cast<uint8_t>(src[i].{fname});")
+        offset += TYPE_INFO[ftype][0]
+    if all32:
+        out.append("            detail::StoreBlockU32(words, block, n * kWords);")
+    out.append("        }")
+    out.append("        return true;")
+    out.append("    }")
+    return out
+
+
+
+def generate_cpp_columns(msg: dict) -> list:
+    """Generate the structure-of-arrays container <Name>Columns for one message.
+
+    Each field gets its own contiguous vector and a FieldMask bit constant
+    (k<FieldName>). Assign() decodes only the selected fields, so callers
+    scanning a few columns skip the loads and dequantization of the rest.
+    """
+    name = msg["name"]
+    fields = msg["fields"]
+    if len(fields) > 64:
+        raise ValueError(f"{name}: column decoding supports at most 64 fields")
+    for field in fields:
+        if field["name"] in ("count", "fields", "clear", "Assign", "Message", "kAll", "kStride"):
+            raise ValueError(f"{name}.{field['name']}: name is reserved by {name}Columns")
+
+    def mask_name(fname: str) -> str:
+        return "k" + fname[0].upper() + fname[1:]
+
+    out = []
+    out.append(f"/// Structure-of-arrays storage for {name}, filled by DecodeColumns()")
+    out.append(f"struct {name}Columns {{")
+    out.append(f"    using Message = {name};")
+    out.append("")
+    for i, field in enumerate(fields):
+        out.append(f"    static constexpr FieldMask {mask_name(field['name'])} = FieldMask{{1}} << {i};")
+    all_mask = " | ".join(mask_name(f["name"]) for f in fields) if fields else "0"
+    out.append(f"    static constexpr FieldMask kAll = {all_mask};")
+    out.append("")
+    for field in fields:
+        cpp_type = TYPE_INFO[field["type"]][1]
+        out.append(f"    std::vector<{cpp_type}> {field['name']};")
+    out.append("    std::size_t count{0};  ///< Messages decoded by the last Assign()")
+    out.append("    FieldMask fields{0};   ///< Columns populated by the last Assign()")
+    out.append("")
+    out.append("    /// Empty every column (capacity is kept for reuse)")
+    out.append("    void clear() {")
+    for field in fields:
+        out.append(f"        {field['name']}.clear();")
+    out.append("        count = 0;")
+    out.append("        fields = 0;")
+    out.append("    }")
+    out.append("")
+    out.append("    /// Decode `n` consecutive messages; columns outside `mask` are left empty")
+    out.append("    void Assign(const uint8_t* data, std::size_t n, FieldMask mask) {")
+    out.append("        count = n;")
+    out.append("        fields = mask & kAll;")
+    if any(f["type"] == "float32" for f in fields):
+        out.append("        int32_t raw[detail::kBatchBlock];")
+    offset = 0
+    for field in fields:
+        ftype = field["type"]
+        fname = field["name"]
+        at = f"data + i * kStride + {offset}"
+        out.append(f"        if (mask & {mask_name(fname)}) {{")
+        out.append(f"            {fname}.resize(n);")
+        if ftype == "float32":
+            scale = field.get("scale", 10000)
+            out.append("            for (std::size_t base = 0; base < n; base += detail::kBatchBlock) {")
+            out.append("                const std::size_t block = std::min(detail::kBatchBlock, n - base);")
+            out.append(f"                for (std::size_t i = 0; i < block; ++i) raw[i] = detail::LoadS32(data + (base + i) * kStride + {offset});")
+            out.append(f"                detail::DequantizeBlock(raw, block, {scale}.0f, {fname}.data() + base);")
+            out.append("            }")
+        else:
+            load = {
+                "int32": f"detail::LoadS32({at})",
+                "uint32": f"detail::LoadU32({at})",
+                "int16": f"detail::LoadS16({at})",
+                "uint16": f"detail::LoadU16({at})",
+                "uint8": f"data[i * kStride + {offset}]",
+                "int8": f"static_cast<int8_t>(data[i * kStride + {offset}])",
+            }[ftype]
+            out.append(f"            for (std::size_t i = 0; i < n; ++i) {fname}[i] = {load};")
+        out.append("        } else {")
+        out.append(f"            {fname}.clear();")
+        out.append("        }")
+        offset += TYPE_INFO[ftype][0]
+    out.append("    }")
+    out.append("")
+    out.append("private:")
+    out.append(f"    static constexpr std::size_t kStride = {name}::kWireSize;")
+    out.append("};")
+    out.append("")
+    return out
+
 
 def generate_cpp_header(schema: dict, output_dir: Path) -> None:
     """Generate C++ header with message types and serialization.
@@ -115,6 +536,9 @@ def generate_cpp_header(schema: dict, output_dir: Path) -> None:
     lines.append("#include <limits>")
     lines.append("#include <optional>")
     lines.append("#include <variant>")
+    lines.append("#include <vector>")
+    lines.append("")
+    lines.extend(SIMD_PREAMBLE)
     lines.append("")
     lines.append(f"namespace {namespace} {{")
     lines.append("")
@@ -211,9 +635,46 @@ def generate_cpp_header(schema: dict, output_dir: Path) -> None:
     lines.append("    return static_cast<float>(static_cast<double>(fixed) / static_cast<double>(scale));")
     lines.append("}")
     lines.append("")
+    lines.append("/// QuantizeFloat() for a finite value without the llround() call (same result)")
+    lines.append("inline int32_t QuantizeFloatUnchecked(float value, float scale) {")
+    lines.append("    const double scaled = static_cast<double>(value) * static_cast<double>(scale);")
+    lines.append("    const double clamped = std::clamp(scaled,")
+    lines.append("        static_cast<double>(std::numeric_limits<int32_t>::min()),")
+    lines.append("        static_cast<double>(std::numeric_limits<int32_t>::max()));")
+    lines.append("    const auto truncated = static_cast<int32_t>(clamped);")
+    lines.append("    const double frac = clamped - static_cast<double>(truncated);   // Exact within int32 range")
+    lines.append("    return truncated + static_cast<int32_t>(frac >= 0.5) - static_cast<int32_t>(frac <= -0.5);")
+    lines.append("}")
+    lines.append("")
+    lines.extend(SIMD_KERNELS)
     lines.append("} // namespace detail")
     lines.append("")
     
+    lines.append("/// Bit set selecting message fields for column decoding (bit i = field i)")
+    lines.append("using FieldMask = uint64_t;")
+    lines.append("")
+    lines.append("/// Select every field of a message")
+    lines.append("constexpr FieldMask kAllFields = ~FieldMask{0};")
+    lines.append("")
+    lines.append("/// Wire byte width of each field in order, for the compressed (delta) encoding")
+    lines.append("struct FieldLayout {")
+    lines.append("    const uint8_t* widths{nullptr};")
+    lines.append("    std::size_t count{0};   ///< 0 = unknown message type")
+    lines.append("};")
+    lines.append("")
+    lines.append("/// Wire type of a message field")
+    lines.append("enum class FieldType : uint8_t { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32 };")
+    lines.append("")
+    lines.append("/// Compile-time description of one field (see <Message>::kFields)")
+    lines.append("struct FieldDescriptor {")
+    lines.append("    const char* name;")
+    lines.append("    FieldType type;")
+    lines.append("    uint16_t offset;   ///< Byte offset within the message")
+    lines.append("    uint8_t width;     ///< Wire bytes")
+    lines.append("    float scale;       ///< Fixed-point scale for Float32, 1 otherwise")
+    lines.append("};")
+    lines.append("")
+
     # Generate message structs
     lines.append("// ============================================================================")
     lines.append("// Message Structs")
@@ -226,6 +687,19 @@ def generate_cpp_header(schema: dict, output_dir: Path) -> None:
         lines.append(f"struct {msg['name']} {{")
         lines.append(f"    static constexpr MessageTypeId kTypeId = MessageTypeId::{msg['name']};")
         lines.append(f"    static constexpr std::size_t kWireSize = k{msg['name']}Size;")
+        widths = ", ".join(str(TYPE_INFO[f["type"]][0]) for f in msg["fields"])
+        lines.append(f"    static constexpr std::array<uint8_t, {len(msg['fields'])}> kFieldWidths = {{{{{widths}}}}};")
+        descriptors = []
+        offset = 0
+        for field in msg["fields"]:
+            ftype = field["type"]
+            scale = field.get("scale", 10000) if ftype == "float32" else 1
+            descriptors.append(f"        {{\"{field['name']}\", FieldType::{FIELD_TYPE_ENUM[ftype]}, {offset}, "
+                               f"{TYPE_INFO[ftype][0]}, {scale}.0f}},")
+            offset += TYPE_INFO[ftype][0]
+        lines.append(f"    static constexpr std::array<FieldDescriptor, {len(msg['fields'])}> kFields = {{{{")
+        lines.extend(descriptors)
+        lines.append("    }};")
         lines.append("")
         for field in msg["fields"]:
             cpp_type = TYPE_INFO[field["type"]][1]
@@ -239,19 +713,25 @@ def generate_cpp_header(schema: dict, output_dir: Path) -> None:
             lines.append(f"    {cpp_type} {field['name']}{{0}};{comment}")
         lines.append("")
         
-        # Encode method
+        # Encode: validating wrapper around EncodeUnchecked
+        float_fields = [f["name"] for f in msg["fields"] if f["type"] == "float32"]
         lines.append("    bool Encode(uint8_t* out, std::size_t capacity) const {")
         lines.append(f"        if (capacity < kWireSize) return false;")
-        offset = 0
-        for field in msg["fields"]:
+        for fname in float_fields:
+            lines.append(f"        if (!std::isfinite({fname})) return false;")
+        lines.append("        EncodeUnchecked(out);")
+        lines.append("        return true;")
+        lines.append("    }")
+        lines.append("")
+        lines.append("    /// Encode() without checks: `out` holds kWireSize bytes and float fields are finite")
+        lines.append("    void EncodeUnchecked(uint8_t* out) const {")
+        for field, desc in zip(msg["fields"], field_offsets(msg)):
             ftype = field["type"]
             fname = field["name"]
-            size = TYPE_INFO[ftype][0]
-            
+            offset = desc
             if ftype == "float32":
                 scale = field.get("scale", 10000)
-                lines.append(f"        if (!std::isfinite({fname})) return false;")
-                lines.append(f"        detail::StoreS32(detail::QuantizeFloat({fname}, {scale}.0f), &out[{offset}]);")
+                lines.append(f"        detail::StoreS32(detail::QuantizeFloatUnchecked({fname}, {scale}.0f), &out[{offset}]);")
             elif ftype == "int32":
                 lines.append(f"        detail::StoreS32({fname}, &out[{offset}]);")
             elif ftype == "uint32":
@@ -262,25 +742,29 @@ def generate_cpp_header(schema: dict, output_dir: Path) -> None:
                 lines.append(f"        detail::StoreU16({fname}, &out[{offset}]);")
             elif ftype in ("int8", "uint8"):
                 lines.append(f"        out[{offset}] = static_cast<uint8_t>({fname});")
-            offset += size
-        lines.append("        return true;")
+        if not msg["fields"]:
+            lines.append("        (void)out;")
         lines.append("    }")
         lines.append("")
-        
-        # Decode method
+
+        # Decode: validating wrapper around DecodeUnchecked
         lines.append(f"    static std::optional<{msg['name']}> Decode(const uint8_t* data, std::size_t length) {{")
         lines.append(f"        if (length < kWireSize) return std::nullopt;")
+        lines.append(f"        {msg['name']} msg = DecodeUnchecked(data);")
+        for fname in float_fields:
+            lines.append(f"        if (!std::isfinite(msg.{fname})) return std::nullopt;")
+        lines.append("        return msg;")
+        lines.append("    }")
+        lines.append("")
+        lines.append("    /// Decode() without checks, for payloads whose length and CRC were already validated")
+        lines.append(f"    static {msg['name']} DecodeUnchecked(const uint8_t* data) {{")
         lines.append(f"        {msg['name']} msg;")
-        offset = 0
-        for field in msg["fields"]:
+        for field, offset in zip(msg["fields"], field_offsets(msg)):
             ftype = field["type"]
             fname = field["name"]
-            size = TYPE_INFO[ftype][0]
-            
             if ftype == "float32":
                 scale = field.get("scale", 10000)
                 lines.append(f"        msg.{fname} = detail::DequantizeFloat(detail::LoadS32(&data[{offset}]), {scale}.0f);")
-                lines.append(f"        if (!std::isfinite(msg.{fname})) return std::nullopt;")
             elif ftype == "int32":
                 lines.append(f"        msg.{fname} = detail::LoadS32(&data[{offset}]);")
             elif ftype == "uint32":
@@ -293,11 +777,14 @@ def generate_cpp_header(schema: dict, output_dir: Path) -> None:
                 lines.append(f"        msg.{fname} = data[{offset}];")
             elif ftype == "int8":
                 lines.append(f"        msg.{fname} = static_cast<int8_t>(data[{offset}]);")
-            offset += size
+        if not msg["fields"]:
+            lines.append("        (void)data;")
         lines.append("        return msg;")
         lines.append("    }")
+        lines.extend(generate_cpp_batch_methods(msg))
         lines.append("};")
         lines.append("")
+        lines.extend(generate_cpp_columns(msg))
     
     # Message variant type (only if messages exist)
     if schema["messages"]:
@@ -331,17 +818,72 @@ def generate_cpp_header(schema: dict, output_dir: Path) -> None:
         lines.append("// No messages defined - add message types to your schema and regenerate")
         lines.append("inline constexpr std::array<MessageInfo, 0> kMessageRegistry = {{}};")
     lines.append("")
-    lines.append("inline std::optional<MessageInfo> GetMessageInfo(MessageTypeId typeId) {")
-    lines.append("    for (const auto& info : kMessageRegistry) {")
-    lines.append("        if (info.typeId == typeId) return info;")
-    lines.append("    }")
-    lines.append("    return std::nullopt;")
-    lines.append("}")
+    # Dense lookup tables indexed directly by type ID (no scan per frame).
+    # Sparse schemas with very large IDs fall back to a switch.
+    max_id = max((msg["id"] for msg in schema["messages"]), default=0)
+    dense = max_id <= MAX_DENSE_TYPE_ID
+    by_id = {msg["id"]: (index, compute_message_size(msg)) for index, msg in enumerate(schema["messages"])}
+    lines.append(f"/// Largest message type ID defined by the schema")
+    lines.append(f"inline constexpr uint16_t kMaxMessageTypeId = {max_id};")
+    lines.append("")
+    if dense:
+        sizes = ", ".join(str(by_id[i][1]) if i in by_id else "0" for i in range(max_id + 1))
+        indices = ", ".join(str(by_id[i][0]) if i in by_id else "kNoMessageIndex" for i in range(max_id + 1))
+        lines.append("/// Wire size per type ID (0 = unknown type)")
+        lines.append(f"inline constexpr std::array<uint16_t, {max_id + 1}> kWireSizeTable = {{{{{sizes}}}}};")
+        lines.append("")
+        lines.append("/// kMessageRegistry index per type ID (kNoMessageIndex = unknown type)")
+        lines.append("inline constexpr uint16_t kNoMessageIndex = 0xFFFF;")
+        lines.append(f"inline constexpr std::array<uint16_t, {max_id + 1}> kMessageIndexTable = {{{{{indices}}}}};")
+        lines.append("")
+        lines.append("/// Wire size for a message type, or 0 if the type is unknown")
+        lines.append("inline constexpr std::size_t GetWireSize(MessageTypeId typeId) {")
+        lines.append("    const auto index = static_cast<uint16_t>(typeId);")
+        lines.append("    return index < kWireSizeTable.size() ? kWireSizeTable[index] : 0;")
+        lines.append("}")
+        lines.append("")
+        lines.append("inline std::optional<MessageInfo> GetMessageInfo(MessageTypeId typeId) {")
+        lines.append("    const auto index = static_cast<uint16_t>(typeId);")
+        lines.append("    if (index >= kMessageIndexTable.size() || kMessageIndexTable[index] == kNoMessageIndex) {")
+        lines.append("        return std::nullopt;")
+        lines.append("    }")
+        lines.append("    return kMessageRegistry[kMessageIndexTable[index]];")
+        lines.append("}")
+    else:
+        lines.append("/// Wire size for a message type, or 0 if the type is unknown")
+        lines.append("inline constexpr std::size_t GetWireSize(MessageTypeId typeId) {")
+        lines.append("    switch (typeId) {")
+        for msg in schema["messages"]:
+            lines.append(f"        case MessageTypeId::{msg['name']}: return {compute_message_size(msg)};")
+        lines.append("        default: return 0;")
+        lines.append("    }")
+        lines.append("}")
+        lines.append("")
+        lines.append("inline std::optional<MessageInfo> GetMessageInfo(MessageTypeId typeId) {")
+        lines.append("    for (const auto& info : kMessageRegistry) {")
+        lines.append("        if (info.typeId == typeId) return info;")
+        lines.append("    }")
+        lines.append("    return std::nullopt;")
+        lines.append("}")
     lines.append("")
     lines.append("inline std::optional<MessageInfo> GetMessageInfo(uint16_t typeId) {")
     lines.append("    return GetMessageInfo(static_cast<MessageTypeId>(typeId));")
     lines.append("}")
     lines.append("")
+    lines.append("/// Field widths for a message type (count 0 if the type is unknown)")
+    lines.append("inline FieldLayout GetFieldLayout(MessageTypeId typeId) {")
+    if schema["messages"]:
+        lines.append("    switch (typeId) {")
+        for msg in schema["messages"]:
+            name = msg["name"]
+            lines.append(f"        case MessageTypeId::{name}: return {{{name}::kFieldWidths.data(), {name}::kFieldWidths.size()}};")
+        lines.append("        default: return {};")
+        lines.append("    }")
+    else:
+        lines.append("    (void)typeId;")
+        lines.append("    return {};")
+    lines.append("}")
+    lines.append("")
     
     # Handshake utilities
     lines.append("// ============================================================================")
@@ -415,6 +957,9 @@ def generate_python_bindings(schema: dict, output_dir: Path) -> None:
     lines.append(f"SCHEMA_HASH = 0x{schema_hash:08X}")
     lines.append("HANDSHAKE_MAGIC = b'BCNP'")
     lines.append("HEADER_SIZE_V3 = 7")
+    lines.append("FLAG_CLEAR_QUEUE = 0x01")
+    lines.append("FLAG_COMPRESSED = 0x02")
+    lines.append("FLAG_ACCEPTS_COMPRESSED = 0x04")
     lines.append("")
     
     # CRC32 function
@@ -449,6 +994,8 @@ def generate_python_bindings(schema: dict, output_dir: Path) -> None:
         lines.append(f'    """')
         lines.append(f"    TYPE_ID = MessageTypeId.{msg['name']}")
         lines.append(f"    WIRE_SIZE = {size}")
+        widths = ", ".join(str(TYPE_INFO[f["type"]][0]) for f in msg["fields"])
+        lines.append(f"    FIELD_WIDTHS = ({widths},)")
         lines.append("")
         for field in msg["fields"]:
             py_type = "float" if field["type"] == "float32" else "int"
@@ -548,6 +1095,89 @@ def generate_python_bindings(schema: dict, output_dir: Path) -> None:
     lines.append("    checksum = struct.pack('>I', crc32(packet_data))")
     lines.append("    return packet_data + checksum")
     lines.append("")
+
+    # Compressed encoding (delta + zigzag LEB128 per field, see packet.h)
+    lines.append("def _split_fields(data: bytes, widths: tuple) -> list:")
+    lines.append("    values, offset = [], 0")
+    lines.append("    for width in widths:")
+    lines.append("        values.append(int.from_bytes(data[offset:offset + width], 'big'))")
+    lines.append("        offset += width")
+    lines.append("    return values")
+    lines.append("")
+    lines.append("def encode_compressed_packet(msg_type_id: int, messages: list, flags: int = 0) -> bytes:")
+    lines.append('    """Encode a BCNP v3 packet with the compressed payload (only for peers sending FLAG_ACCEPTS_COMPRESSED)."""')
+    lines.append("    widths = MESSAGE_REGISTRY[msg_type_id].FIELD_WIDTHS")
+    lines.append("    payload = bytearray()")
+    lines.append("    previous = [0] * len(widths)")
+    lines.append("    for m in messages:")
+    lines.append("        current = _split_fields(m.encode(), widths)")
+    lines.append("        for value, prior, width in zip(current, previous, widths):")
+    lines.append("            bits = width * 8")
+    lines.append("            delta = (value - prior) & ((1 << bits) - 1)")
+    lines.append("            if delta >> (bits - 1):")
+    lines.append("                delta -= 1 << bits")
+    lines.append("            zigzag = delta * 2 if delta >= 0 else -delta * 2 - 1")
+    lines.append("            while zigzag >= 0x80:")
+    lines.append("                payload.append((zigzag & 0x7F) | 0x80)")
+    lines.append("                zigzag >>= 7")
+    lines.append("            payload.append(zigzag)")
+    lines.append("        previous = current")
+    lines.append("    flags |= FLAG_COMPRESSED | FLAG_ACCEPTS_COMPRESSED")
+    lines.append("    header = struct.pack('>BBBHHH', PROTOCOL_MAJOR, PROTOCOL_MINOR, flags, msg_type_id, len(messages), len(payload))")
+    lines.append("    packet_data = header + bytes(payload)")
+    lines.append("    return packet_data + struct.pack('>I', crc32(packet_data))")
+    lines.append("")
+    lines.append("def decode_packet(data: bytes) -> Optional[tuple]:")
+    lines.append('    """Decode one packet (fixed-width or compressed) into (flags, msg_type_id, messages), or None if invalid."""')
+    lines.append("    if len(data) < HEADER_SIZE_V3:")
+    lines.append("        return None")
+    lines.append("    major, minor, flags, msg_type_id, count = struct.unpack('>BBBHH', data[:HEADER_SIZE_V3])")
+    lines.append("    cls = MESSAGE_REGISTRY.get(msg_type_id)")
+    lines.append("    if major != PROTOCOL_MAJOR or minor != PROTOCOL_MINOR or cls is None:")
+    lines.append("        return None")
+    lines.append("    if not flags & FLAG_COMPRESSED:")
+    lines.append("        end = HEADER_SIZE_V3 + count * cls.WIRE_SIZE")
+    lines.append("        if len(data) < end + 4 or struct.unpack('>I', data[end:end + 4])[0] != crc32(data[:end]):")
+    lines.append("            return None")
+    lines.append("        payload = data[HEADER_SIZE_V3:end]")
+    lines.append("    else:")
+    lines.append("        if len(data) < HEADER_SIZE_V3 + 2:")
+    lines.append("            return None")
+    lines.append("        end = HEADER_SIZE_V3 + 2 + struct.unpack('>H', data[HEADER_SIZE_V3:HEADER_SIZE_V3 + 2])[0]")
+    lines.append("        if len(data) < end + 4 or struct.unpack('>I', data[end:end + 4])[0] != crc32(data[:end]):")
+    lines.append("            return None")
+    lines.append("        expanded, pos = bytearray(), HEADER_SIZE_V3 + 2")
+    lines.append("        previous = [0] * len(cls.FIELD_WIDTHS)")
+    lines.append("        for _ in range(count):")
+    lines.append("            current = []")
+    lines.append("            for prior, width in zip(previous, cls.FIELD_WIDTHS):")
+    lines.append("                zigzag, shift = 0, 0")
+    lines.append("                while True:")
+    lines.append("                    if pos >= end or shift >= width * 8:")
+    lines.append("                        return None")
+    lines.append("                    byte = data[pos]")
+    lines.append("                    pos += 1")
+    lines.append("                    if byte == 0 and shift:")
+    lines.append("                        return None  # Non-minimal varint")
+    lines.append("                    zigzag |= (byte & 0x7F) << shift")
+    lines.append("                    shift += 7")
+    lines.append("                    if not byte & 0x80:")
+    lines.append("                        break")
+    lines.append("                if zigzag >> (width * 8):")
+    lines.append("                    return None")
+    lines.append("                delta = (zigzag >> 1) ^ -(zigzag & 1)")
+    lines.append("                value = (prior + delta) & ((1 << (width * 8)) - 1)")
+    lines.append("                current.append(value)")
+    lines.append("                expanded += value.to_bytes(width, 'big')")
+    lines.append("            previous = current")
+    lines.append("        if pos != end:")
+    lines.append("            return None")
+    lines.append("        payload = bytes(expanded)")
+    lines.append("        flags &= ~FLAG_COMPRESSED")
+    lines.append("    size = cls.WIRE_SIZE")
+    lines.append("    messages = [cls.decode(payload[i * size:(i + 1) * size]) for i in range(count)]")
+    lines.append("    return flags, msg_type_id, messages")
+    lines.append("")
     
     output_file.write_text("\n".join(lines))
     print(f"Generated: {output_file}")
@@ -593,6 +1223,9 @@ def generate_java_flyweights(schema: dict, output_dir: Path) -> None:
         lines.append(f"public final class {class_name} {{")
         lines.append(f"    public static final int TYPE_ID = {msg['id']};")
         lines.append(f"    public static final int WIRE_SIZE = {size};")
+        java_widths = ", ".join(str(JAVA_TYPE_INFO[f["type"]][2]) for f in msg["fields"])
+        lines.append("    /** Byte width of each field in wire order (compressed encoding, see protocol.md). */")
+        lines.append(f"    public static final int[] FIELD_WIDTHS = {{{java_widths}}};")
         lines.append("")
         lines.append("    private ByteBuffer buffer;")
         lines.append("    private int offset;")
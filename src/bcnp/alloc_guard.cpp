@@ -0,0 +1,94 @@
+/**
+ * @file alloc_guard.cpp
+ * @brief Counters and per-thread arming for the allocation guard.
+ *
+ * Lives in the library so every TU shares one state; the replacement
+ * operators themselves are only compiled where BCNP_ALLOCATION_GUARD_IMPLEMENT
+ * is defined.
+ */
+
+#include "bcnp/alloc_guard.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace bcnp {
+
+namespace {
+
+thread_local bool t_armed = false;
+
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_violations{0};
+std::atomic<bool> g_installed{false};
+
+/**
+ * @brief Default handler: report, then abort unless NDEBUG.
+ *
+ * Uses stdio rather than iostreams so reporting itself does not allocate.
+ */
+void DefaultViolationHandler(std::size_t size) {
+#ifndef NDEBUG
+    std::fprintf(stderr, "BCNP allocation guard: %zu byte allocation inside NoAllocationScope\n", size);
+    std::abort();
+#else
+    (void)size;
+#endif
+}
+
+std::atomic<AllocationViolationHandler> g_handler{&DefaultViolationHandler};
+
+} // namespace
+
+NoAllocationScope::NoAllocationScope() : m_wasArmed(t_armed) {
+    t_armed = true;
+}
+
+NoAllocationScope::~NoAllocationScope() {
+    t_armed = m_wasArmed;
+}
+
+uint64_t AllocationCount() {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationViolations() {
+    return g_violations.load(std::memory_order_relaxed);
+}
+
+void SetAllocationViolationHandler(AllocationViolationHandler handler) {
+    g_handler.store(handler ? handler : &DefaultViolationHandler, std::memory_order_release);
+}
+
+bool AllocationGuardInstalled() {
+    return g_installed.load(std::memory_order_acquire);
+}
+
+namespace detail {
+
+/**
+ * @brief Count an allocation and report it if this thread is armed.
+ *
+ * The thread is disarmed while the handler runs so a handler that
+ * allocates (logging, throwing) does not recurse.
+ */
+void OnAllocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (!t_armed) {
+        return;
+    }
+    g_violations.fetch_add(1, std::memory_order_relaxed);
+    t_armed = false;
+    g_handler.load(std::memory_order_acquire)(size);
+    t_armed = true;
+}
+
+bool MarkAllocationGuardInstalled() {
+    g_installed.store(true, std::memory_order_release);
+    return true;
+}
+
+} // namespace detail
+
+} // namespace bcnp
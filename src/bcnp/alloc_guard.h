@@ -0,0 +1,148 @@
+#pragma once
+
+/**
+ * @file alloc_guard.h
+ * @brief Debug check that nothing allocates once a real-time loop is running.
+ *
+ * Define BCNP_ALLOCATION_GUARD_IMPLEMENT in exactly one translation unit of
+ * the executable before including this header. That TU then replaces the
+ * global operator new/delete with versions that report every allocation
+ * made on a thread inside a NoAllocationScope:
+ *
+ * @code{cpp}
+ *   // main.cpp
+ *   #define BCNP_ALLOCATION_GUARD_IMPLEMENT
+ *   #include "bcnp/alloc_guard.h"
+ *
+ *   void ControlLoop() {
+ *       SetupEverything();                  // Allocate freely here
+ *       bcnp::NoAllocationScope realtime;   // From now on, new/delete on this thread is a bug
+ *       while (running) { ... }
+ *   }
+ * @endcode
+ *
+ * The default violation handler prints the allocation size and aborts in
+ * debug builds (NDEBUG unset); release builds only count violations, see
+ * AllocationViolations(). Without the replacement operators the scope is
+ * still valid but sees nothing (AllocationGuardInstalled() is false).
+ * Allocations that bypass operator new (malloc, mmap) are not observed.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bcnp {
+
+/// Called for an allocation inside a NoAllocationScope (the guard is disarmed while it runs)
+using AllocationViolationHandler = void (*)(std::size_t size);
+
+/**
+ * @brief Arms the allocation guard for the current thread.
+ *
+ * Scopes nest; the guard stays armed until the outermost scope ends.
+ */
+class NoAllocationScope {
+public:
+    NoAllocationScope();
+    ~NoAllocationScope();
+
+    NoAllocationScope(const NoAllocationScope&) = delete;
+    NoAllocationScope& operator=(const NoAllocationScope&) = delete;
+
+private:
+    bool m_wasArmed;
+};
+
+/// Allocations seen through the replacement operator new (all threads)
+uint64_t AllocationCount();
+
+/// Allocations made inside a NoAllocationScope (all threads)
+uint64_t AllocationViolations();
+
+/// Replace the violation handler (nullptr restores the default)
+void SetAllocationViolationHandler(AllocationViolationHandler handler);
+
+/// true if this executable defines BCNP_ALLOCATION_GUARD_IMPLEMENT somewhere
+bool AllocationGuardInstalled();
+
+namespace detail {
+
+/// Hook for the replacement operators
+void OnAllocate(std::size_t size);
+
+bool MarkAllocationGuardInstalled();
+
+} // namespace detail
+
+} // namespace bcnp
+
+#ifdef BCNP_ALLOCATION_GUARD_IMPLEMENT
+
+#include <cstdlib>
+#include <new>
+
+namespace bcnp::detail {
+
+inline void* GuardedAllocate(std::size_t size) {
+    OnAllocate(size);
+    return std::malloc(size != 0 ? size : 1);
+}
+
+inline void* GuardedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+    OnAllocate(size);
+    const auto align = static_cast<std::size_t>(alignment);
+    const std::size_t rounded = (size + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded != 0 ? rounded : align);
+}
+
+inline void* GuardedAllocateOrThrow(std::size_t size) {
+    void* ptr = GuardedAllocate(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+inline void* GuardedAllocateAlignedOrThrow(std::size_t size, std::align_val_t alignment) {
+    void* ptr = GuardedAllocateAligned(size, alignment);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+[[maybe_unused]] static const bool kAllocationGuardInstalled = MarkAllocationGuardInstalled();
+
+} // namespace bcnp::detail
+
+void* operator new(std::size_t size) { return bcnp::detail::GuardedAllocateOrThrow(size); }
+void* operator new[](std::size_t size) { return bcnp::detail::GuardedAllocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return bcnp::detail::GuardedAllocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return bcnp::detail::GuardedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return bcnp::detail::GuardedAllocateAlignedOrThrow(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return bcnp::detail::GuardedAllocateAlignedOrThrow(size, alignment);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return bcnp::detail::GuardedAllocateAligned(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return bcnp::detail::GuardedAllocateAligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+#endif // BCNP_ALLOCATION_GUARD_IMPLEMENT
@@ -0,0 +1,469 @@
+/**
+ * @file capture.cpp
+ * @brief Implementation of the capture writer and the mmap replay reader.
+ *
+ * The writer owns a fixed set of buffers that cycle between recorders
+ * (filling the current buffer) and the writer thread (draining full ones
+ * in FIFO order). Nothing is allocated after construction.
+ */
+
+#include "bcnp/capture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BCNP_CAPTURE_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bcnp {
+
+namespace {
+
+constexpr char kCaptureMagic[8] = {'B', 'C', 'N', 'P', 'C', 'A', 'P', '1'};
+
+void StoreU64(uint64_t value, uint8_t* out) {
+    detail::StoreU32(static_cast<uint32_t>(value), out);
+    detail::StoreU32(static_cast<uint32_t>(value >> 32), out + 4);
+}
+
+uint64_t LoadU64(const uint8_t* in) {
+    return static_cast<uint64_t>(detail::LoadU32(in)) |
+           (static_cast<uint64_t>(detail::LoadU32(in + 4)) << 32);
+}
+
+} // namespace
+
+// ============================================================================
+// CaptureWriter
+// ============================================================================
+
+/**
+ * @brief Allocate every buffer up front.
+ * @param config Buffer size/count; clamped to at least one buffer holding a 1-byte chunk
+ */
+CaptureWriter::CaptureWriter(CaptureWriterConfig config)
+    : m_config(config) {
+    m_config.bufferSize = std::max(m_config.bufferSize, kCaptureRecordHeaderSize + 1);
+    m_config.bufferCount = std::max<std::size_t>(m_config.bufferCount, 1);
+    m_buffers.reserve(m_config.bufferCount);
+    for (std::size_t i = 0; i < m_config.bufferCount; ++i) {
+        m_buffers.push_back(std::make_unique<uint8_t[]>(m_config.bufferSize));
+    }
+    m_fill.assign(m_config.bufferCount, 0);
+    m_full.assign(m_config.bufferCount, 0);
+    m_free.reserve(m_config.bufferCount);
+}
+
+CaptureWriter::~CaptureWriter() {
+    Close();
+}
+
+bool CaptureWriter::Open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_open) {
+        return false;
+    }
+    m_file = std::fopen(path.c_str(), "wb");
+    if (!m_file) {
+        std::cerr << "[BCNP] capture open failed: " << path << std::endl;
+        return false;
+    }
+
+    m_start = Clock::now();
+    const auto wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    uint8_t header[kCaptureHeaderSize] = {};
+    std::memcpy(header, kCaptureMagic, sizeof(kCaptureMagic));
+    detail::StoreU16(kCaptureVersion, &header[8]);
+    detail::StoreU32(m_config.schemaHash, &header[12]);
+    StoreU64(static_cast<uint64_t>(wallNs), &header[16]);
+    if (std::fwrite(header, 1, sizeof(header), m_file) != sizeof(header)) {
+        std::fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+    m_metrics.bytesWritten += sizeof(header);
+
+    m_free.clear();
+    for (std::size_t i = 0; i < m_buffers.size(); ++i) {
+        m_free.push_back(i);
+    }
+    m_fullHead = 0;
+    m_fullCount = 0;
+    m_hasCurrent = false;
+    m_stopping = false;
+    m_open = true;
+    m_thread = std::thread([this]() { WriterLoop(); });
+    return true;
+}
+
+void CaptureWriter::Close() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_open) {
+            return;
+        }
+        if (m_hasCurrent && m_fill[m_current] > 0) {
+            SubmitCurrentLocked();
+        }
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::fclose(m_file);
+    m_file = nullptr;
+    m_open = false;
+    m_hasCurrent = false;
+}
+
+bool CaptureWriter::IsOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_open;
+}
+
+/**
+ * @brief Copy one chunk into the current buffer.
+ *
+ * Never touches the file: a full buffer is queued for the writer thread
+ * and recording continues in a free one. With no free buffer the chunk is
+ * dropped and counted.
+ */
+bool CaptureWriter::Record(const uint8_t* data, std::size_t length, uint16_t streamId) {
+    if (!data || length == 0) {
+        return true;
+    }
+    const std::size_t recordSize = kCaptureRecordHeaderSize + length;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open || m_stopping || recordSize > m_config.bufferSize) {
+        ++m_metrics.chunksDropped;
+        m_metrics.bytesDropped += length;
+        return false;
+    }
+    if (m_hasCurrent && m_fill[m_current] + recordSize > m_config.bufferSize) {
+        SubmitCurrentLocked();
+    }
+    if (!m_hasCurrent) {
+        if (m_free.empty()) {
+            ++m_metrics.chunksDropped;
+            m_metrics.bytesDropped += length;
+            return false;
+        }
+        m_current = m_free.back();
+        m_free.pop_back();
+        m_fill[m_current] = 0;
+        m_hasCurrent = true;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count();
+    uint8_t* out = m_buffers[m_current].get() + m_fill[m_current];
+    StoreU64(static_cast<uint64_t>(elapsed), out);
+    detail::StoreU32(static_cast<uint32_t>(length), out + 8);
+    detail::StoreU16(streamId, out + 12);
+    detail::StoreU16(0, out + 14);
+    std::memcpy(out + kCaptureRecordHeaderSize, data, length);
+    m_fill[m_current] += recordSize;
+
+    ++m_metrics.chunksRecorded;
+    m_metrics.bytesRecorded += length;
+    return true;
+}
+
+void CaptureWriter::Flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_open && m_hasCurrent && m_fill[m_current] > 0) {
+        SubmitCurrentLocked();
+    }
+}
+
+CaptureWriter::Metrics CaptureWriter::GetMetrics() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_metrics;
+}
+
+void CaptureWriter::SubmitCurrentLocked() {
+    m_full[(m_fullHead + m_fullCount) % m_full.size()] = m_current;
+    ++m_fullCount;
+    m_hasCurrent = false;
+    m_cv.notify_one();
+}
+
+/**
+ * @brief Writer thread: drain full buffers in order until Close().
+ */
+void CaptureWriter::WriterLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [this]() { return m_fullCount > 0 || m_stopping; });
+        if (m_fullCount == 0) {
+            return;  // Stopping and drained
+        }
+        const std::size_t index = m_full[m_fullHead];
+        m_fullHead = (m_fullHead + 1) % m_full.size();
+        --m_fullCount;
+        const std::size_t size = m_fill[index];
+
+        lock.unlock();
+        const std::size_t written = std::fwrite(m_buffers[index].get(), 1, size, m_file);
+        const bool flushed = std::fflush(m_file) == 0;
+        lock.lock();
+
+        m_metrics.bytesWritten += written;
+        if (written != size || !flushed) {
+            ++m_metrics.writeErrors;
+        }
+        m_free.push_back(index);
+    }
+}
+
+// ============================================================================
+// CaptureReader
+// ============================================================================
+
+CaptureReader::~CaptureReader() {
+    Close();
+}
+
+/**
+ * @brief Map the capture read-only and check its header.
+ *
+ * Platforms without mmap read the file into memory instead.
+ */
+bool CaptureReader::Open(const std::string& path) {
+    Close();
+#if defined(BCNP_CAPTURE_HAS_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(kCaptureHeaderSize)) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(mapping, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+    m_data = static_cast<const uint8_t*>(mapping);
+    m_size = static_cast<std::size_t>(info.st_size);
+    m_mapped = true;
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long length = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (length < static_cast<long>(kCaptureHeaderSize)) {
+        std::fclose(file);
+        return false;
+    }
+    m_heapCopy = std::make_unique<uint8_t[]>(static_cast<std::size_t>(length));
+    const std::size_t read = std::fread(m_heapCopy.get(), 1, static_cast<std::size_t>(length), file);
+    std::fclose(file);
+    m_data = m_heapCopy.get();
+    m_size = read;
+#endif
+
+    if (m_size < kCaptureHeaderSize || std::memcmp(m_data, kCaptureMagic, sizeof(kCaptureMagic)) != 0 ||
+        detail::LoadU16(&m_data[8]) != kCaptureVersion) {
+        Close();
+        return false;
+    }
+    m_schemaHash = detail::LoadU32(&m_data[12]);
+    m_startWallNs = LoadU64(&m_data[16]);
+    return true;
+}
+
+void CaptureReader::Close() {
+#if defined(BCNP_CAPTURE_HAS_MMAP)
+    if (m_mapped && m_data) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_heapCopy.reset();
+    m_schemaHash = 0;
+    m_startWallNs = 0;
+    m_index.clear();
+}
+
+bool CaptureReader::Next(std::size_t& offset, CaptureChunk& chunk) const {
+    if (!m_data || offset < kCaptureHeaderSize || offset + kCaptureRecordHeaderSize > m_size) {
+        return false;
+    }
+    const uint8_t* record = m_data + offset;
+    const std::size_t length = detail::LoadU32(record + 8);
+    if (length > m_size - offset - kCaptureRecordHeaderSize) {
+        return false;  // Truncated tail
+    }
+    chunk.timestampNs = LoadU64(record);
+    chunk.streamId = detail::LoadU16(record + 12);
+    chunk.data = record + kCaptureRecordHeaderSize;
+    chunk.length = length;
+    chunk.fileOffset = offset;
+    offset += kCaptureRecordHeaderSize + length;
+    return true;
+}
+
+/**
+ * @brief Walk records from @p from, pacing them if requested.
+ *
+ * @p from.byteOffset bytes of the first record of @p from.streamId are
+ * skipped so replay starts exactly at an indexed packet. A position inside
+ * a stream that config.streamId filters out replays nothing.
+ */
+template<typename Sink>
+std::size_t CaptureReader::ReplayChunks(const CaptureReplayConfig& config, const CapturePacketRef& from,
+                                        Sink&& sink) const {
+    using Clock = std::chrono::steady_clock;
+    std::size_t offset = std::max(from.recordOffset, Begin());
+    std::size_t skip = from.byteOffset;
+    if (skip > 0 && config.streamId != kCaptureAllStreams && config.streamId != from.streamId) {
+        return 0;   // The offset belongs to a stream that is not replayed
+    }
+    const double speed = config.speed > 0.0 ? config.speed : 1.0;
+
+    bool started = false;
+    uint64_t firstTimestamp = 0;
+    Clock::time_point wallStart{};
+    std::size_t replayed = 0;
+    CaptureChunk chunk;
+    while (Next(offset, chunk)) {
+        if (config.streamId != kCaptureAllStreams && chunk.streamId != config.streamId) {
+            continue;
+        }
+        std::size_t skipped = 0;
+        if (chunk.streamId == from.streamId) {
+            skipped = std::min(skip, chunk.length);
+            skip = 0;
+        }
+
+        if (config.pacing == ReplayPacing::RealTime) {
+            if (!started) {
+                firstTimestamp = chunk.timestampNs;
+                wallStart = Clock::now();
+                started = true;
+            }
+            const auto delta = chunk.timestampNs > firstTimestamp ? chunk.timestampNs - firstTimestamp : 0;
+            std::this_thread::sleep_until(
+                wallStart + std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(delta) / speed)));
+        }
+        if (chunk.length > skipped) {
+            sink(chunk.data + skipped, chunk.length - skipped);
+        }
+        ++replayed;
+    }
+    return replayed;
+}
+
+std::size_t CaptureReader::Replay(StreamParser& parser, const CaptureReplayConfig& config,
+                                  const CapturePacketRef& from) const {
+    return ReplayChunks(config, from, [&](const uint8_t* data, std::size_t length) {
+        parser.Push(data, length);
+    });
+}
+
+std::size_t CaptureReader::Replay(PacketDispatcher& dispatcher, const CaptureReplayConfig& config,
+                                  const CapturePacketRef& from) const {
+    return ReplayChunks(config, from, [&](const uint8_t* data, std::size_t length) {
+        dispatcher.PushBytes(data, length);
+    });
+}
+
+/**
+ * @brief Parse every stream once and record where each packet starts.
+ *
+ * Each stream gets its own parser; a packet's stream offset is mapped back
+ * to the record that contains its first byte, so packets split across
+ * chunks are still replayable from their start. Frames larger than the
+ * parser ring are streamed (StreamParser::SetStreamingCallbacks()) and
+ * indexed once their CRC checks out.
+ */
+std::size_t CaptureReader::BuildIndex(StreamParser::WireSizeLookup lookup) {
+    struct RecordStart {
+        std::size_t streamOffset;
+        std::size_t recordOffset;
+        uint64_t timestampNs;
+    };
+    struct StreamState {
+        std::unique_ptr<StreamParser> parser;
+        std::vector<RecordStart> records;
+        std::size_t consumed{0};
+        std::size_t streamedStart{0};   // Stream offset of the frame being streamed
+    };
+
+    m_index.clear();
+    std::unordered_map<uint16_t, StreamState> streams;
+    StreamState* current = nullptr;
+    uint16_t currentStream = 0;
+    std::size_t indexed = 0;
+
+    const auto addToIndex = [&](MessageTypeId type, std::size_t start) {
+        auto it = std::upper_bound(current->records.begin(), current->records.end(), start,
+                                   [](std::size_t value, const RecordStart& record) {
+                                       return value < record.streamOffset;
+                                   });
+        const RecordStart& record = *(it - 1);
+        m_index[static_cast<uint16_t>(type)].push_back(
+            {record.recordOffset, start - record.streamOffset, record.timestampNs, currentStream});
+        ++indexed;
+    };
+    const auto onPacket = [&](const PacketView& packet) {
+        addToIndex(packet.header.messageType, current->parser->StreamOffset());
+    };
+    StreamParser::StreamingCallbacks streaming;
+    streaming.onPacketBegin = [&](const PacketHeader&) {
+        current->streamedStart = current->parser->StreamOffset();
+    };
+    streaming.onMessages = [](const PacketView&) {};
+    streaming.onPacketEnd = [&](const PacketHeader& header, bool crcOk) {
+        if (crcOk) {
+            addToIndex(header.messageType, current->streamedStart);
+        }
+    };
+
+    std::size_t offset = Begin();
+    CaptureChunk chunk;
+    while (Next(offset, chunk)) {
+        StreamState& state = streams[chunk.streamId];
+        if (!state.parser) {
+            // 64 KiB covers ordinary frames; bigger uncompressed ones are streamed.
+            // Compressed frames past the ring and frames found while resyncing
+            // after corrupt data are not indexed.
+            state.parser = std::make_unique<StreamParser>(onPacket, StreamParser::ErrorCallback{}, 64 * 1024);
+            state.parser->SetStreamingCallbacks(streaming);
+            if (lookup) {
+                state.parser->SetWireSizeLookup(lookup);
+            }
+        }
+        state.records.push_back({state.consumed, chunk.fileOffset, chunk.timestampNs});
+        state.consumed += chunk.length;
+        current = &state;
+        currentStream = chunk.streamId;
+        state.parser->Push(chunk.data, chunk.length);
+    }
+    return indexed;
+}
+
+const std::vector<CapturePacketRef>& CaptureReader::PacketsOfType(MessageTypeId type) const {
+    static const std::vector<CapturePacketRef> kEmpty;
+    auto it = m_index.find(static_cast<uint16_t>(type));
+    return it != m_index.end() ? it->second : kEmpty;
+}
+
+} // namespace bcnp
@@ -0,0 +1,288 @@
+#pragma once
+
+/**
+ * @file capture.h
+ * @brief Timestamped capture of received byte streams and offline replay.
+ *
+ * CaptureWriter appends every chunk read from a transport to a compact log
+ * file; CaptureReader maps the file and replays it through a StreamParser
+ * or PacketDispatcher, paced in real time or as fast as possible.
+ *
+ * File layout (little endian):
+ *
+ *   Header (24 bytes): "BCNPCAP1" | u16 version | u16 reserved |
+ *                      u32 schema hash | u64 wall-clock start (ns since epoch)
+ *   Record (16 + N):   u64 ns since capture start | u32 N | u16 stream id |
+ *                      u16 reserved | N chunk bytes
+ *
+ * A file truncated by a crash mid-record replays every complete record.
+ */
+
+#include "bcnp/dispatcher.h"
+#include "bcnp/packet.h"
+#include "bcnp/stream_parser.h"
+#include "bcnp/transport/adapter.h"
+#include <bcnp/message_types.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bcnp {
+
+inline constexpr uint16_t kCaptureVersion = 1;
+inline constexpr std::size_t kCaptureHeaderSize = 24;
+inline constexpr std::size_t kCaptureRecordHeaderSize = 16;
+
+/// Configuration for CaptureWriter
+struct CaptureWriterConfig {
+    std::size_t bufferSize{256 * 1024};  ///< Bytes per preallocated buffer (largest recordable chunk minus 16)
+    std::size_t bufferCount{8};          ///< Buffers shared between recorders and the writer thread
+    uint32_t schemaHash{kSchemaHash};    ///< Stored in the file header for replay-time checks
+};
+
+/**
+ * @brief Records received chunks to a capture file without blocking on I/O.
+ *
+ * Record() copies the chunk into a preallocated buffer under a short lock;
+ * full buffers are handed to a background thread that writes them out. If
+ * the writer falls behind and every buffer is full, chunks are dropped and
+ * counted rather than stalling the caller, so the control loop never waits
+ * on the disk.
+ *
+ * @code{cpp}
+ *   CaptureWriter capture;
+ *   capture.Open("/u/logs/match42.bcnpcap");
+ *   driver.SetCapture(&capture);   // Every chunk PollOnce() reads is logged
+ *   ...
+ *   capture.Close();               // Flushes and joins the writer thread
+ * @endcode
+ *
+ * Thread-safety: Record() and Flush() may be called from any thread.
+ * Open() and Close() must not race with each other.
+ */
+class CaptureWriter {
+public:
+    struct Metrics {
+        uint64_t chunksRecorded{0};
+        uint64_t bytesRecorded{0};   ///< Chunk payload bytes accepted
+        uint64_t chunksDropped{0};   ///< No free buffer, chunk too large, or not open
+        uint64_t bytesDropped{0};
+        uint64_t bytesWritten{0};    ///< File bytes written by the writer thread
+        uint64_t writeErrors{0};
+    };
+
+    explicit CaptureWriter(CaptureWriterConfig config = {});
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * @brief Create (truncate) @p path, write the header and start the writer thread.
+     * @return false if already open or the file cannot be created
+     */
+    bool Open(const std::string& path);
+
+    /// Write out everything recorded so far and close the file
+    void Close();
+
+    bool IsOpen() const;
+
+    /**
+     * @brief Append one received chunk, timestamped now.
+     * @param streamId Distinguishes captured connections (e.g. per adapter)
+     * @return false if the chunk was dropped
+     */
+    bool Record(const uint8_t* data, std::size_t length, uint16_t streamId = 0);
+
+    /// Hand the partially filled buffer to the writer thread
+    void Flush();
+
+    Metrics GetMetrics() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void SubmitCurrentLocked();
+    void WriterLoop();
+
+    CaptureWriterConfig m_config;
+    std::vector<std::unique_ptr<uint8_t[]>> m_buffers;
+    std::vector<std::size_t> m_fill;        // Bytes used per buffer
+    std::vector<std::size_t> m_free;        // Stack of free buffer indices
+    std::vector<std::size_t> m_full;        // FIFO ring of buffers awaiting write
+    std::size_t m_fullHead{0};
+    std::size_t m_fullCount{0};
+    std::size_t m_current{0};
+    bool m_hasCurrent{false};
+
+    std::FILE* m_file{nullptr};
+    Clock::time_point m_start{};
+    bool m_open{false};
+    bool m_stopping{false};
+    Metrics m_metrics{};
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::thread m_thread;
+};
+
+/**
+ * @brief Transport decorator that logs every chunk it receives.
+ *
+ * Wraps any DuplexAdapter; sends pass straight through.
+ */
+class CaptureTap : public DuplexAdapter {
+public:
+    CaptureTap(DuplexAdapter& inner, CaptureWriter& writer, uint16_t streamId = 0)
+        : m_inner(inner), m_writer(writer), m_streamId(streamId) {}
+
+    std::size_t ReceiveChunk(uint8_t* buffer, std::size_t maxLength) override {
+        const std::size_t received = m_inner.ReceiveChunk(buffer, maxLength);
+        if (received > 0) {
+            m_writer.Record(buffer, received, m_streamId);
+        }
+        return received;
+    }
+
+    ByteSpan ReceiveInPlace() override {
+        const ByteSpan received = m_inner.ReceiveInPlace();
+        if (received.length > 0) {
+            m_writer.Record(received.data, received.length, m_streamId);
+        }
+        return received;
+    }
+
+    bool SupportsReceiveInPlace() const override { return m_inner.SupportsReceiveInPlace(); }
+
+    bool SendBytes(const uint8_t* data, std::size_t length) override { return m_inner.SendBytes(data, length); }
+    bool SendBytesV(const ByteSpan* spans, std::size_t count) override { return m_inner.SendBytesV(spans, count); }
+    bool SendFramePart(const uint8_t* data, std::size_t length, FramePart part) override {
+        return m_inner.SendFramePart(data, length, part);
+    }
+    MutableByteSpan ReserveTx(std::size_t length) override { return m_inner.ReserveTx(length); }
+    bool CommitTx(std::size_t length) override { return m_inner.CommitTx(length); }
+
+private:
+    DuplexAdapter& m_inner;
+    CaptureWriter& m_writer;
+    uint16_t m_streamId;
+};
+
+/// One captured chunk; data points into the mapped file
+struct CaptureChunk {
+    uint64_t timestampNs{0};    ///< Since capture start
+    uint16_t streamId{0};
+    const uint8_t* data{nullptr};
+    std::size_t length{0};
+    std::size_t fileOffset{0};  ///< Offset of the record header
+};
+
+/// Location of one packet in a capture, for seeking
+struct CapturePacketRef {
+    std::size_t recordOffset{0};  ///< Record holding the packet's first byte
+    std::size_t byteOffset{0};    ///< Packet start within that record's chunk
+    uint64_t timestampNs{0};      ///< Timestamp of that record
+    uint16_t streamId{0};
+};
+
+enum class ReplayPacing {
+    AsFastAsPossible,
+    RealTime,   ///< Reproduce the captured inter-chunk timing (scaled by speed)
+};
+
+inline constexpr uint16_t kCaptureAllStreams = 0xFFFF;
+
+/// Options for CaptureReader::Replay()
+struct CaptureReplayConfig {
+    ReplayPacing pacing{ReplayPacing::AsFastAsPossible};
+    double speed{1.0};                        ///< RealTime multiplier (2.0 = twice as fast)
+    uint16_t streamId{kCaptureAllStreams};    ///< Replay a single stream (recommended with several)
+};
+
+/**
+ * @brief Memory-maps a capture file and replays it.
+ *
+ * Chunks are pushed straight from the mapping, so a StreamParser in
+ * zero-copy mode decodes complete frames without copying them. BuildIndex()
+ * scans the capture once and lists every packet per MessageTypeId so
+ * replay can start at an arbitrary packet.
+ *
+ * @code{cpp}
+ *   CaptureReader reader;
+ *   if (reader.Open("match42.bcnpcap") && reader.SchemaHash() == kSchemaHash) {
+ *       reader.Replay(dispatcher, {ReplayPacing::RealTime});
+ *   }
+ * @endcode
+ */
+class CaptureReader {
+public:
+    CaptureReader() = default;
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    /// Map @p path and validate its header
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return m_data != nullptr; }
+
+    uint32_t SchemaHash() const { return m_schemaHash; }
+    uint64_t StartWallClockNs() const { return m_startWallNs; }
+    std::size_t FileSize() const { return m_size; }
+
+    /// Offset of the first record (pass to Next() to iterate)
+    std::size_t Begin() const { return kCaptureHeaderSize; }
+
+    /**
+     * @brief Read the record at @p offset and advance it to the next record.
+     * @return false at the end of the file or on a truncated record
+     */
+    bool Next(std::size_t& offset, CaptureChunk& chunk) const;
+
+    /**
+     * @brief Feed captured chunks to @p parser, starting at @p from.
+     *
+     * @p from's byteOffset applies to the first chunk of @p from's stream;
+     * it replays nothing if config.streamId selects a different stream.
+     * @return Chunks replayed
+     */
+    std::size_t Replay(StreamParser& parser, const CaptureReplayConfig& config = {},
+                       const CapturePacketRef& from = {}) const;
+    std::size_t Replay(PacketDispatcher& dispatcher, const CaptureReplayConfig& config = {},
+                       const CapturePacketRef& from = {}) const;
+
+    /**
+     * @brief Index every packet in the capture by message type.
+     * @param lookup Wire sizes for the capture's schema (empty = GetWireSize())
+     * @return Packets indexed
+     */
+    std::size_t BuildIndex(StreamParser::WireSizeLookup lookup = {});
+
+    /// Packets of one type in capture order (empty before BuildIndex())
+    const std::vector<CapturePacketRef>& PacketsOfType(MessageTypeId type) const;
+
+private:
+    template<typename Sink>
+    std::size_t ReplayChunks(const CaptureReplayConfig& config, const CapturePacketRef& from, Sink&& sink) const;
+
+    const uint8_t* m_data{nullptr};
+    std::size_t m_size{0};
+    bool m_mapped{false};                    // false: heap copy (no mmap on this platform)
+    std::unique_ptr<uint8_t[]> m_heapCopy;
+    uint32_t m_schemaHash{0};
+    uint64_t m_startWallNs{0};
+    std::unordered_map<uint16_t, std::vector<CapturePacketRef>> m_index;
+};
+
+} // namespace bcnp
@@ -8,6 +8,10 @@
 
 #include "bcnp/dispatcher.h"
 
+#include "bcnp/latency_trace.h"
+
+#include <algorithm>
+
 namespace bcnp {
 
 /**
@@ -22,7 +26,9 @@ PacketDispatcher::PacketDispatcher(DispatcherConfig config)
       m_parser(
           [this](const PacketView& packet) { HandlePacket(packet); },
           [this](const StreamParser::ErrorInfo& error) { HandleError(error); },
-          m_config.parserBufferSize) {}
+          m_config.parserBufferSize) {
+    m_flatHandlers.resize(std::min<std::size_t>(std::size_t{kMaxMessageTypeId} + 1, kFlatHandlerLimit));
+}
 
 /**
  * @brief Push raw bytes for parsing and dispatch.
@@ -38,6 +44,19 @@ void PacketDispatcher::PushBytes(const uint8_t* data, std::size_t length) {
     m_parser.Push(data, length);
 }
 
+/**
+ * @brief Dispatch an already-validated packet to its handler.
+ * 
+ * For transports that parse each connection with its own StreamParser
+ * (TcpReactor): connection streams must not be interleaved through PushBytes().
+ * 
+ * @param packet The validated packet view
+ */
+void PacketDispatcher::Dispatch(const PacketView& packet) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    HandlePacket(packet);
+}
+
 /**
  * @brief Register a handler for a specific message type.
  * 
@@ -46,7 +65,49 @@ void PacketDispatcher::PushBytes(const uint8_t* data, std::size_t length) {
  */
 void PacketDispatcher::RegisterHandler(MessageTypeId typeId, PacketHandler handler) {
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_handlers[static_cast<uint16_t>(typeId)] = std::move(handler);
+    const auto id = static_cast<uint16_t>(typeId);
+    if (id >= kFlatHandlerLimit) {
+        m_sparseHandlers[id] = std::move(handler);
+        return;
+    }
+    if (id >= m_flatHandlers.size()) {
+        m_flatHandlers.resize(std::size_t{id} + 1);
+    }
+    m_flatHandlers[id] = std::move(handler);
+}
+
+/**
+ * @brief Register a handler that receives packets it may keep.
+ * 
+ * The first call allocates the FrameArena (frameArenaBlocks blocks of
+ * parserBufferSize bytes). Every packet of this type is then copied into a
+ * pooled block and passed as an OwnedPacketView.
+ * 
+ * @param typeId Message type ID to handle
+ * @param handler Callback taking ownership of a reference to the frame
+ */
+void PacketDispatcher::RegisterOwnedHandler(MessageTypeId typeId, OwnedPacketHandler handler) {
+    FrameArena* arena = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_arena) {
+            m_arena = std::make_unique<FrameArena>(
+                FrameArenaConfig{m_config.parserBufferSize, m_config.frameArenaBlocks});
+        }
+        arena = m_arena.get();
+    }
+    RegisterHandler(typeId, [arena, handler = std::move(handler)](const PacketView& packet) {
+        handler(arena->Retain(packet));
+    });
+}
+
+/**
+ * @brief Frame pool used by owned handlers.
+ * @return The arena, or nullptr if no owned handler was ever registered
+ */
+const FrameArena* PacketDispatcher::Arena() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_arena.get();
 }
 
 /**
@@ -55,7 +116,12 @@ void PacketDispatcher::RegisterHandler(MessageTypeId typeId, PacketHandler handl
  */
 void PacketDispatcher::UnregisterHandler(MessageTypeId typeId) {
     std::lock_guard<std::mutex> lock(m_mutex);
-    m_handlers.erase(static_cast<uint16_t>(typeId));
+    const auto id = static_cast<uint16_t>(typeId);
+    if (id >= kFlatHandlerLimit) {
+        m_sparseHandlers.erase(id);
+    } else if (id < m_flatHandlers.size()) {
+        m_flatHandlers[id] = nullptr;
+    }
 }
 
 /**
@@ -101,20 +167,56 @@ uint64_t PacketDispatcher::ParseErrorCount() const {
     return m_parseErrors;
 }
 
+bool PacketDispatcher::PeerAcceptsCompressed() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_parser.PeerAcceptsCompressed();
+}
+
+void PacketDispatcher::SetMetrics(MetricsRegistry* metrics) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_parser.SetMetrics(metrics);
+}
+
+void PacketDispatcher::SetStreamingCallbacks(StreamParser::StreamingCallbacks callbacks) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (callbacks.onMessages) {
+        callbacks.onMessages = [this, onMessages = std::move(callbacks.onMessages)](const PacketView& chunk) {
+            m_lastRx = Clock::now();
+            onMessages(chunk);
+        };
+    }
+    m_parser.SetStreamingCallbacks(std::move(callbacks));
+}
+
 /**
  * @brief Internal handler for successfully parsed packets.
  * 
  * Updates last receive time and dispatches to registered handler if one exists.
+ * Type IDs below kFlatHandlerLimit resolve with a single array index.
  * Unknown message types are silently ignored (no handler registered).
+ * Handler run time is recorded as the Dispatch stage when BCNP_LATENCY_TRACE is on.
  * 
  * @param packet The validated packet view
  */
 void PacketDispatcher::HandlePacket(const PacketView& packet) {
     m_lastRx = Clock::now();
 
-    auto it = m_handlers.find(static_cast<uint16_t>(packet.header.messageType));
-    if (it != m_handlers.end()) {
-        it->second(packet);
+    const auto id = static_cast<uint16_t>(packet.header.messageType);
+    if (id < m_flatHandlers.size()) {
+        if (m_flatHandlers[id]) {
+            const uint64_t start = trace::Now();
+            m_flatHandlers[id](packet);
+            trace::RecordSince(LatencyStage::Dispatch, id, start);
+        }
+        return;
+    }
+    if (id >= kFlatHandlerLimit) {
+        auto it = m_sparseHandlers.find(id);
+        if (it != m_sparseHandlers.end()) {
+            const uint64_t start = trace::Now();
+            it->second(packet);
+            trace::RecordSince(LatencyStage::Dispatch, id, start);
+        }
     }
     // Unknown message types are silently ignored (no handler registered)
 }
@@ -1,13 +1,16 @@
 #pragma once
 
+#include "bcnp/frame_arena.h"
 #include "bcnp/stream_parser.h"
 #include "bcnp/message_queue.h"
 #include <bcnp/message_types.h>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace bcnp {
 
@@ -15,11 +18,15 @@ namespace bcnp {
 struct DispatcherConfig {
     std::size_t parserBufferSize{4096};
     std::chrono::milliseconds connectionTimeout{200};
+    std::size_t frameArenaBlocks{32};   ///< Pool size, allocated by the first RegisterOwnedHandler()
 };
 
 /// Callback for handling message packets
 using PacketHandler = std::function<void(const PacketView&)>;
 
+/// Callback for handlers that keep packets beyond the call (see FrameArena)
+using OwnedPacketHandler = std::function<void(OwnedPacketView)>;
+
 /// Error callback for parse errors
 using ErrorHandler = std::function<void(const StreamParser::ErrorInfo&)>;
 
@@ -55,6 +62,9 @@ public:
     /// Feed raw bytes from transport (thread-safe)
     void PushBytes(const uint8_t* data, std::size_t length);
 
+    /// Dispatch a packet parsed elsewhere, e.g. per connection by TcpReactor (thread-safe)
+    void Dispatch(const PacketView& packet);
+
     /// Register a handler for a message type (by type)
     template<typename MsgType>
     void RegisterHandler(PacketHandler handler) {
@@ -64,6 +74,24 @@ public:
     /// Register a handler for a message type (by ID)
     void RegisterHandler(MessageTypeId typeId, PacketHandler handler);
 
+    /**
+     * @brief Register a handler that may keep the packet after returning.
+     * 
+     * Each packet is copied into a pooled FrameArena block (sized to the
+     * parser buffer) before the handler runs; moving the OwnedPacketView to
+     * another thread defers decoding without a per-packet allocation.
+     */
+    template<typename MsgType>
+    void RegisterOwnedHandler(OwnedPacketHandler handler) {
+        RegisterOwnedHandler(MsgType::kTypeId, std::move(handler));
+    }
+
+    /// Register an owned-frame handler for a message type (by ID)
+    void RegisterOwnedHandler(MessageTypeId typeId, OwnedPacketHandler handler);
+
+    /// Frame pool behind owned handlers (nullptr until one is registered)
+    const FrameArena* Arena() const;
+
     /// Remove a handler
     void UnregisterHandler(MessageTypeId typeId);
 
@@ -88,34 +116,41 @@ public:
     /// Convenience: set wire size lookup from a list of message types
     template<typename... MsgTypes>
     void RegisterMessageTypes() {
-        m_parser.SetWireSizeLookup([](MessageTypeId typeId) -> std::size_t {
-            return GetWireSizeFor<MsgTypes...>(typeId);
-        });
+        m_parser.SetWireSizeFunction(&WireSizeFor<MsgTypes...>);
+        m_parser.SetFieldLayoutFunction(&FieldLayoutFor<MsgTypes...>);
     }
 
+    /// true once the peer advertised kFlagAcceptsCompressed (see EncodeCompressedTypedPacket)
+    bool PeerAcceptsCompressed() const;
+
+    /// Record parser metrics into @p metrics (nullptr = off); see StreamParser::SetMetrics()
+    void SetMetrics(MetricsRegistry* metrics);
+
+    /**
+     * @brief Stream frames larger than parserBufferSize; see StreamParser::SetStreamingCallbacks().
+     * 
+     * Callbacks run under the dispatcher lock like packet handlers, and each
+     * chunk counts as receive activity for IsConnected().
+     */
+    void SetStreamingCallbacks(StreamParser::StreamingCallbacks callbacks);
+
+    /// Type IDs below this are dispatched through a flat array; larger IDs use a map
+    static constexpr std::size_t kFlatHandlerLimit = 1024;
+
     /// Get parse error count
     uint64_t ParseErrorCount() const;
 
 private:
-    template<typename First, typename... Rest>
-    static std::size_t GetWireSizeFor(MessageTypeId typeId) {
-        if (typeId == First::kTypeId) {
-            return First::kWireSize;
-        }
-        if constexpr (sizeof...(Rest) > 0) {
-            return GetWireSizeFor<Rest...>(typeId);
-        }
-        return 0;
-    }
-
     void HandlePacket(const PacketView& packet);
     void HandleError(const StreamParser::ErrorInfo& error);
 
     DispatcherConfig m_config;
     StreamParser m_parser;
     mutable std::mutex m_mutex;
-    std::unordered_map<uint16_t, PacketHandler> m_handlers;
+    std::vector<PacketHandler> m_flatHandlers;                    // Indexed by type ID
+    std::unordered_map<uint16_t, PacketHandler> m_sparseHandlers; // IDs >= kFlatHandlerLimit
     ErrorHandler m_errorHandler;
+    std::unique_ptr<FrameArena> m_arena;                          // Created on first owned handler
     Clock::time_point m_lastRx{Clock::time_point::min()};
     uint64_t m_parseErrors{0};
 };
@@ -0,0 +1,219 @@
+#pragma once
+
+/**
+ * @file fixed_dispatcher.h
+ * @brief Runtime-registered packet dispatcher with compile-time sized storage.
+ *
+ * FixedDispatcher sits between PacketDispatcher and StaticDispatcher:
+ * handlers are still registered and replaced at runtime, but the handler
+ * table, the callables and the parser buffers all live inside the object.
+ * Nothing is allocated after construction, so it can be used on a thread
+ * running under NoAllocationScope (see alloc_guard.h).
+ */
+
+#include "bcnp/dispatcher.h"
+#include "bcnp/inplace_function.h"
+#include "bcnp/latency_trace.h"
+#include "bcnp/stream_parser.h"
+#include <bcnp/message_types.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace bcnp {
+
+/**
+ * @brief Packet dispatcher with a fixed number of inline handlers.
+ *
+ * @code{cpp}
+ *   FixedDispatcher<8> dispatcher;
+ *   MessageQueue<DriveCmd> driveQueue;
+ *   dispatcher.RegisterHandler<DriveCmd>([&driveQueue](const PacketView& pkt) {
+ *       for (auto it = pkt.begin_as<DriveCmd>(); it != pkt.end_as<DriveCmd>(); ++it) {
+ *           driveQueue.Push(*it);
+ *       }
+ *   });
+ * @endcode
+ *
+ * Handlers are looked up with a linear scan of at most MaxHandlers IDs,
+ * which beats hashing for the handful of types a robot handles.
+ *
+ * Thread-safety: all methods are thread-safe, matching PacketDispatcher.
+ * Handlers run on the thread calling PushBytes() or Dispatch().
+ *
+ * @tparam MaxHandlers Handler slots
+ * @tparam BufferSize Parser ring size (largest frame)
+ * @tparam CallableSize Inline capture bytes per handler
+ */
+template<std::size_t MaxHandlers, std::size_t BufferSize = 4096, std::size_t CallableSize = 32>
+class FixedDispatcher {
+    static_assert(MaxHandlers > 0, "FixedDispatcher needs at least one handler slot");
+
+public:
+    using Clock = std::chrono::steady_clock;
+    using Handler = InplaceFunction<void(const PacketView&), CallableSize>;
+    using ErrorCallback = InplaceFunction<void(const StreamParser::ErrorInfo&), CallableSize>;
+
+    explicit FixedDispatcher(std::chrono::milliseconds connectionTimeout = std::chrono::milliseconds(200))
+        : m_connectionTimeout(connectionTimeout),
+          m_parser([this](const PacketView& packet) { HandlePacket(packet); },
+                   [this](const StreamParser::ErrorInfo& error) { HandleError(error); }) {}
+
+    FixedDispatcher(const FixedDispatcher&) = delete;
+    FixedDispatcher& operator=(const FixedDispatcher&) = delete;
+
+    /// Feed raw bytes from transport (thread-safe)
+    void PushBytes(const uint8_t* data, std::size_t length) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_parser.Push(data, length);
+    }
+
+    /// Dispatch a packet parsed elsewhere (thread-safe)
+    void Dispatch(const PacketView& packet) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        HandlePacket(packet);
+    }
+
+    /// Register a handler for a message type (by type)
+    template<typename MsgType>
+    bool RegisterHandler(Handler handler) {
+        return RegisterHandler(MsgType::kTypeId, std::move(handler));
+    }
+
+    /**
+     * @brief Register or replace the handler for @p typeId.
+     * @return false if every slot is taken by another type
+     */
+    bool RegisterHandler(MessageTypeId typeId, Handler handler) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto id = static_cast<uint16_t>(typeId);
+        std::size_t slot = Find(id);
+        if (slot == MaxHandlers) {
+            if (m_count == MaxHandlers) {
+                return false;
+            }
+            slot = m_count++;
+            m_ids[slot] = id;
+        }
+        m_handlers[slot] = std::move(handler);
+        return true;
+    }
+
+    /// Remove a handler, freeing its slot
+    void UnregisterHandler(MessageTypeId typeId) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const std::size_t slot = Find(static_cast<uint16_t>(typeId));
+        if (slot == MaxHandlers) {
+            return;
+        }
+        --m_count;
+        if (slot != m_count) {
+            m_ids[slot] = m_ids[m_count];
+            m_handlers[slot] = std::move(m_handlers[m_count]);
+        }
+        m_handlers[m_count] = nullptr;
+    }
+
+    /// Handlers currently registered
+    std::size_t HandlerCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+
+    static constexpr std::size_t Capacity() { return MaxHandlers; }
+
+    /// Set error callback
+    void SetErrorHandler(ErrorCallback handler) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_errorHandler = std::move(handler);
+    }
+
+    /// Check if any packets received recently
+    bool IsConnected(Clock::time_point now) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_lastRx == Clock::time_point::min()) {
+            return false;
+        }
+        return (now - m_lastRx) <= m_connectionTimeout;
+    }
+
+    /// Get last receive time
+    Clock::time_point LastReceiveTime() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_lastRx;
+    }
+
+    /// Get parse error count
+    uint64_t ParseErrorCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_parseErrors;
+    }
+
+    /// Set wire size lookup for custom message types (function pointer, no allocation)
+    void SetWireSizeFunction(StreamParser::WireSizeFn fn) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_parser.SetWireSizeFunction(fn);
+    }
+
+    /// Convenience: set wire size and field layout lookups from a list of message types
+    template<typename... MsgTypes>
+    void RegisterMessageTypes() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_parser.SetWireSizeFunction(&WireSizeFor<MsgTypes...>);
+        m_parser.SetFieldLayoutFunction(&FieldLayoutFor<MsgTypes...>);
+    }
+
+    /// true once the peer advertised kFlagAcceptsCompressed
+    bool PeerAcceptsCompressed() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_parser.PeerAcceptsCompressed();
+    }
+
+    /// Access the parser (for diagnostics)
+    StreamParser& Parser() { return m_parser; }
+    const StreamParser& Parser() const { return m_parser; }
+
+private:
+    std::size_t Find(uint16_t id) const {
+        for (std::size_t i = 0; i < m_count; ++i) {
+            if (m_ids[i] == id) {
+                return i;
+            }
+        }
+        return MaxHandlers;
+    }
+
+    void HandlePacket(const PacketView& packet) {
+        m_lastRx = Clock::now();
+        const auto id = static_cast<uint16_t>(packet.header.messageType);
+        const std::size_t slot = Find(id);
+        if (slot != MaxHandlers) {
+            const uint64_t start = trace::Now();
+            m_handlers[slot](packet);
+            trace::RecordSince(LatencyStage::Dispatch, id, start);
+        }
+    }
+
+    void HandleError(const StreamParser::ErrorInfo& error) {
+        ++m_parseErrors;
+        if (m_errorHandler) {
+            m_errorHandler(error);
+        }
+    }
+
+    std::chrono::milliseconds m_connectionTimeout;
+    std::array<uint16_t, MaxHandlers> m_ids{};
+    std::array<Handler, MaxHandlers> m_handlers{};
+    std::size_t m_count{0};
+    ErrorCallback m_errorHandler;
+    Clock::time_point m_lastRx{Clock::time_point::min()};
+    uint64_t m_parseErrors{0};
+    mutable std::mutex m_mutex;
+    StaticStreamParser<BufferSize> m_parser;   // Last: its callbacks use the members above
+};
+
+} // namespace bcnp
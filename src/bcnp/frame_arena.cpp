@@ -0,0 +1,143 @@
+/**
+ * @file frame_arena.cpp
+ * @brief Implementation of the pooled frame arena.
+ *
+ * The pool is reference counted separately from its blocks: the arena
+ * holds one reference and every checked-out block holds one more, so a
+ * view released after the arena is destroyed still has a pool to return to.
+ */
+
+#include "bcnp/frame_arena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace bcnp {
+namespace detail {
+
+struct FramePool {
+    std::size_t blockSize{0};
+    std::unique_ptr<uint8_t[]> storage;
+    std::unique_ptr<FrameBlock[]> blocks;
+    std::size_t blockCount{0};
+
+    mutable std::mutex mutex;
+    std::vector<FrameBlock*> freeList;  // Capacity reserved for every block
+
+    std::atomic<uint32_t> refs{1};      // Arena + checked-out blocks
+    std::atomic<uint64_t> retained{0};
+    std::atomic<uint64_t> heapFallbacks{0};
+
+    void Unref() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+};
+
+void ReleaseFrameBlock(FrameBlock* block) {
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    FramePool* pool = block->pool;
+    if (!pool) {
+        delete block;  // Heap fallback
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->freeList.push_back(block);
+    }
+    pool->Unref();
+}
+
+} // namespace detail
+
+/**
+ * @brief Allocate every block up front.
+ * @param config Block size and count (a zero size or count leaves only the heap fallback)
+ */
+FrameArena::FrameArena(FrameArenaConfig config)
+    : m_pool(new detail::FramePool) {
+    m_pool->blockSize = config.blockSize;
+    m_pool->blockCount = config.blockSize > 0 ? config.blockCount : 0;
+    m_pool->storage = std::make_unique<uint8_t[]>(m_pool->blockSize * m_pool->blockCount);
+    m_pool->blocks = std::make_unique<detail::FrameBlock[]>(m_pool->blockCount);
+    m_pool->freeList.reserve(m_pool->blockCount);
+    for (std::size_t i = 0; i < m_pool->blockCount; ++i) {
+        detail::FrameBlock& block = m_pool->blocks[i];
+        block.pool = m_pool;
+        block.data = m_pool->storage.get() + i * m_pool->blockSize;
+        m_pool->freeList.push_back(&block);
+    }
+}
+
+FrameArena::~FrameArena() {
+    m_pool->Unref();
+}
+
+/**
+ * @brief Copy a frame's payload into a pooled block.
+ *
+ * Falls back to a heap block when the pool is exhausted or the payload is
+ * larger than blockSize, so a retained frame is never lost.
+ *
+ * @param view Packet view valid for the current callback
+ * @return View owning a copy of the payload
+ */
+OwnedPacketView FrameArena::Retain(const PacketView& view) {
+    const std::size_t length = view.payload.size();
+    detail::FrameBlock* block = nullptr;
+
+    if (length <= m_pool->blockSize) {
+        std::lock_guard<std::mutex> lock(m_pool->mutex);
+        if (!m_pool->freeList.empty()) {
+            block = m_pool->freeList.back();
+            m_pool->freeList.pop_back();
+        }
+    }
+
+    if (block) {
+        m_pool->refs.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        block = new detail::FrameBlock;
+        block->heap = std::make_unique<uint8_t[]>(std::max<std::size_t>(length, 1));
+        block->data = block->heap.get();
+        m_pool->heapFallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+    block->refs.store(1, std::memory_order_relaxed);
+    m_pool->retained.fetch_add(1, std::memory_order_relaxed);
+
+    if (length > 0) {
+        std::memcpy(block->data, view.payload.data(), length);
+    }
+    PacketView owned;
+    owned.header = view.header;
+    owned.payload = crab::Slice<const uint8_t>(block->data, length);
+    return OwnedPacketView(block, owned);
+}
+
+std::size_t FrameArena::BlockSize() const {
+    return m_pool->blockSize;
+}
+
+std::size_t FrameArena::BlockCount() const {
+    return m_pool->blockCount;
+}
+
+std::size_t FrameArena::FreeBlockCount() const {
+    std::lock_guard<std::mutex> lock(m_pool->mutex);
+    return m_pool->freeList.size();
+}
+
+FrameArena::Metrics FrameArena::GetMetrics() const {
+    Metrics metrics;
+    metrics.retained = m_pool->retained.load(std::memory_order_relaxed);
+    metrics.heapFallbacks = m_pool->heapFallbacks.load(std::memory_order_relaxed);
+    metrics.blocksInUse = m_pool->blockCount - FreeBlockCount();
+    return metrics;
+}
+
+} // namespace bcnp
@@ -0,0 +1,155 @@
+#pragma once
+
+/**
+ * @file frame_arena.h
+ * @brief Pooled, reference-counted packet frames for deferred handlers.
+ *
+ * A PacketView handed to a StreamParser or PacketDispatcher callback only
+ * lives until the callback returns. FrameArena::Retain() copies the frame
+ * into a recycled fixed-size block and returns an OwnedPacketView that can
+ * be moved to another thread (e.g. a trajectory planner) and read later.
+ * The block goes back to its pool when the last reference is released, so
+ * deferred processing allocates nothing in steady state.
+ */
+
+#include "bcnp/packet.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace bcnp {
+
+/// Configuration for FrameArena
+struct FrameArenaConfig {
+    std::size_t blockSize{4096};  ///< Payload bytes per block (larger frames use a heap block)
+    std::size_t blockCount{32};   ///< Blocks allocated up front
+};
+
+namespace detail {
+
+struct FramePool;
+
+/// One pooled (or heap fallback) frame buffer with an intrusive reference count
+struct FrameBlock {
+    std::atomic<uint32_t> refs{0};
+    FramePool* pool{nullptr};           // Owning pool; recycles the block on last release
+    uint8_t* data{nullptr};
+    std::unique_ptr<uint8_t[]> heap;    // Set only for heap fallback blocks
+};
+
+/// Drop one reference; the last one returns the block to its pool
+void ReleaseFrameBlock(FrameBlock* block);
+
+} // namespace detail
+
+/**
+ * @brief Reference-counted PacketView whose payload lives in a FrameArena block.
+ *
+ * Copying shares the block (one atomic increment); the block is recycled
+ * when the last copy is destroyed or Reset(). Views may be released on any
+ * thread and may safely outlive the FrameArena that produced them.
+ *
+ * @code{cpp}
+ *   dispatcher.RegisterOwnedHandler<TrajectoryPoint>([&](OwnedPacketView frame) {
+ *       plannerQueue.Push(std::move(frame));  // Decoded later on the planner thread
+ *   });
+ * @endcode
+ */
+class OwnedPacketView {
+public:
+    OwnedPacketView() = default;
+    ~OwnedPacketView() { Reset(); }
+
+    OwnedPacketView(const OwnedPacketView& other) : m_block(other.m_block), m_view(other.m_view) {
+        if (m_block) {
+            m_block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    OwnedPacketView(OwnedPacketView&& other) noexcept : m_block(other.m_block), m_view(other.m_view) {
+        other.m_block = nullptr;
+        other.m_view = {};
+    }
+
+    OwnedPacketView& operator=(OwnedPacketView other) noexcept {
+        std::swap(m_block, other.m_block);
+        std::swap(m_view, other.m_view);
+        return *this;
+    }
+
+    /// True if this holds a frame
+    explicit operator bool() const { return m_block != nullptr; }
+
+    /// The retained packet (empty view if none)
+    const PacketView& View() const { return m_view; }
+    const PacketView& operator*() const { return m_view; }
+    const PacketView* operator->() const { return &m_view; }
+
+    /// Release this reference now
+    void Reset() {
+        if (m_block) {
+            detail::ReleaseFrameBlock(m_block);
+            m_block = nullptr;
+            m_view = {};
+        }
+    }
+
+    /// Number of OwnedPacketViews sharing the frame (0 if empty)
+    uint32_t UseCount() const { return m_block ? m_block->refs.load(std::memory_order_relaxed) : 0; }
+
+private:
+    friend class FrameArena;
+
+    // Adopts one reference on block
+    OwnedPacketView(detail::FrameBlock* block, const PacketView& view) : m_block(block), m_view(view) {}
+
+    detail::FrameBlock* m_block{nullptr};
+    PacketView m_view{};
+};
+
+/**
+ * @brief Fixed pool of frame blocks backing OwnedPacketView.
+ *
+ * All blocks are allocated by the constructor. When the pool is empty, or
+ * a frame exceeds blockSize, Retain() falls back to a one-off heap block
+ * (counted in Metrics::heapFallbacks) rather than lose the frame.
+ *
+ * Thread-safety: Retain(), releases and the accessors are thread-safe.
+ */
+class FrameArena {
+public:
+    struct Metrics {
+        uint64_t retained{0};       ///< Frames retained
+        uint64_t heapFallbacks{0};  ///< Retains that could not use a pooled block
+        std::size_t blocksInUse{0}; ///< Pooled blocks currently referenced
+    };
+
+    explicit FrameArena(FrameArenaConfig config = {});
+
+    /// Outstanding views keep the pool alive; it is freed with the last one
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /**
+     * @brief Copy a frame into a pooled block.
+     * @param view Packet view valid for the current callback
+     * @return View owning a copy of the payload
+     */
+    OwnedPacketView Retain(const PacketView& view);
+
+    std::size_t BlockSize() const;
+    std::size_t BlockCount() const;
+    std::size_t FreeBlockCount() const;
+
+    Metrics GetMetrics() const;
+
+private:
+    detail::FramePool* m_pool;
+};
+
+} // namespace bcnp
@@ -0,0 +1,142 @@
+#pragma once
+
+/**
+ * @file inplace_function.h
+ * @brief Type-erased callable stored inline, never on the heap.
+ *
+ * Drop-in for std::function where a handler must not allocate: the
+ * callable is constructed in a fixed buffer and a capture that does not
+ * fit is a compile error instead of a silent heap allocation.
+ */
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace bcnp {
+
+template<typename Signature, std::size_t Capacity = 32>
+class InplaceFunction;
+
+/**
+ * @brief Callable wrapper with small-buffer storage only.
+ *
+ * @code{cpp}
+ *   InplaceFunction<void(const PacketView&)> handler = [&queue](const PacketView& pkt) { ... };
+ * @endcode
+ *
+ * @tparam R Return type
+ * @tparam Args Argument types
+ * @tparam Capacity Bytes available for the callable (its captures)
+ */
+template<typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+public:
+    InplaceFunction() noexcept = default;
+    InplaceFunction(std::nullptr_t) noexcept {}
+
+    template<typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, InplaceFunction> &&
+                                                      std::is_invocable_r_v<R, std::decay_t<Fn>&, Args...>>>
+    InplaceFunction(Fn&& fn) {
+        using Callable = std::decay_t<Fn>;
+        static_assert(sizeof(Callable) <= Capacity, "InplaceFunction: callable too large, raise Capacity");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "InplaceFunction: callable over-aligned");
+        static_assert(std::is_nothrow_move_constructible_v<Callable>,
+                      "InplaceFunction: callable must be nothrow move constructible");
+        static_assert(std::is_copy_constructible_v<Callable>, "InplaceFunction: callable must be copyable");
+        ::new (static_cast<void*>(m_storage)) Callable(std::forward<Fn>(fn));
+        m_invoke = &Invoke<Callable>;
+        m_manage = &Manage<Callable>;
+    }
+
+    InplaceFunction(const InplaceFunction& other) {
+        if (other.m_manage) {
+            other.m_manage(Op::Copy, m_storage, const_cast<unsigned char*>(other.m_storage));
+            m_invoke = other.m_invoke;
+            m_manage = other.m_manage;
+        }
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept {
+        MoveFrom(other);
+    }
+
+    InplaceFunction& operator=(const InplaceFunction& other) {
+        if (this != &other) {
+            InplaceFunction copy(other);
+            Reset();
+            MoveFrom(copy);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction& operator=(std::nullptr_t) noexcept {
+        Reset();
+        return *this;
+    }
+
+    ~InplaceFunction() { Reset(); }
+
+    R operator()(Args... args) const {
+        return m_invoke(const_cast<unsigned char*>(m_storage), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return m_invoke != nullptr; }
+
+private:
+    enum class Op { Copy, Move, Destroy };
+
+    template<typename Callable>
+    static R Invoke(void* storage, Args&&... args) {
+        return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template<typename Callable>
+    static void Manage(Op op, void* dst, void* src) {
+        switch (op) {
+            case Op::Copy:
+                ::new (dst) Callable(*static_cast<const Callable*>(src));
+                break;
+            case Op::Move:
+                ::new (dst) Callable(std::move(*static_cast<Callable*>(src)));
+                static_cast<Callable*>(src)->~Callable();
+                break;
+            case Op::Destroy:
+                static_cast<Callable*>(dst)->~Callable();
+                break;
+        }
+    }
+
+    void MoveFrom(InplaceFunction& other) noexcept {
+        if (other.m_manage) {
+            other.m_manage(Op::Move, m_storage, other.m_storage);
+            m_invoke = other.m_invoke;
+            m_manage = other.m_manage;
+            other.m_invoke = nullptr;
+            other.m_manage = nullptr;
+        }
+    }
+
+    void Reset() noexcept {
+        if (m_manage) {
+            m_manage(Op::Destroy, m_storage, nullptr);
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char m_storage[Capacity];
+    R (*m_invoke)(void*, Args&&...){nullptr};
+    void (*m_manage)(Op, void*, void*){nullptr};
+};
+
+} // namespace bcnp
@@ -0,0 +1,138 @@
+/**
+ * @file latency_trace.cpp
+ * @brief Latency histogram snapshots and the global per-stage registry.
+ *
+ * The registry only exists when BCNP_LATENCY_TRACE is enabled; otherwise
+ * the snapshot functions return zeros and nothing is allocated.
+ */
+
+#include "bcnp/latency_trace.h"
+
+#include <algorithm>
+
+namespace bcnp {
+
+/**
+ * @brief Summarize the histogram.
+ *
+ * Percentiles report the upper bound of the bucket holding the requested
+ * rank, clamped to the recorded maximum.
+ */
+LatencyStageMetrics LatencyHistogram::Snapshot() const {
+    std::array<uint64_t, kBucketCount> counts;
+    LatencyStageMetrics metrics;
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        metrics.count += counts[i];
+    }
+    if (metrics.count == 0) {
+        return metrics;
+    }
+    metrics.maxNs = m_maxNs.load(std::memory_order_relaxed);
+    metrics.meanNs = m_sumNs.load(std::memory_order_relaxed) / metrics.count;
+
+    const auto percentile = [&](uint64_t perMille) {
+        // Smallest bucket whose cumulative count reaches ceil(count * p)
+        const uint64_t rank = std::max<uint64_t>(1, (metrics.count * perMille + 999) / 1000);
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(BucketUpperBound(i), metrics.maxNs);
+            }
+        }
+        return metrics.maxNs;
+    };
+    metrics.p50Ns = percentile(500);
+    metrics.p90Ns = percentile(900);
+    metrics.p99Ns = percentile(990);
+    metrics.p999Ns = percentile(999);
+    return metrics;
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_sumNs.store(0, std::memory_order_relaxed);
+    m_maxNs.store(0, std::memory_order_relaxed);
+}
+
+#if BCNP_LATENCY_TRACE
+
+namespace {
+
+// Slot kLatencyTypeSlots is the aggregate over all types
+using StageHistograms = std::array<LatencyHistogram, kLatencyTypeSlots + 1>;
+
+// Constant-initialized (zeroed atomics), so no static-init guard on the hot path
+std::array<StageHistograms, kLatencyStageCount> g_registry;
+
+thread_local uint64_t t_receiveMarkNs = 0;
+
+LatencyMetrics SnapshotSlot(std::size_t slot) {
+    LatencyMetrics metrics;
+    for (std::size_t stage = 0; stage < kLatencyStageCount; ++stage) {
+        metrics.stages[stage] = g_registry[stage][slot].Snapshot();
+    }
+    return metrics;
+}
+
+} // namespace
+
+namespace trace {
+
+void Record(LatencyStage stage, uint16_t typeId, uint64_t ns) {
+    StageHistograms& histograms = g_registry[static_cast<std::size_t>(stage)];
+    histograms[kLatencyTypeSlots].Record(ns);
+    if (typeId < kLatencyTypeSlots) {
+        histograms[typeId].Record(ns);
+    }
+}
+
+void MarkReceive(uint64_t startNs) {
+    const uint64_t now = Now();
+    Record(LatencyStage::Receive, kLatencyNoType, now > startNs ? now - startNs : 0);
+    t_receiveMarkNs = now;
+}
+
+uint64_t ReceiveMark() {
+    return t_receiveMarkNs;
+}
+
+} // namespace trace
+
+LatencyMetrics GetLatencyMetrics() {
+    return SnapshotSlot(kLatencyTypeSlots);
+}
+
+LatencyMetrics GetLatencyMetrics(uint16_t typeId) {
+    if (typeId >= kLatencyTypeSlots) {
+        return {};
+    }
+    return SnapshotSlot(typeId);
+}
+
+void ResetLatencyMetrics() {
+    for (auto& stage : g_registry) {
+        for (auto& histogram : stage) {
+            histogram.Reset();
+        }
+    }
+}
+
+#else
+
+LatencyMetrics GetLatencyMetrics() {
+    return {};
+}
+
+LatencyMetrics GetLatencyMetrics(uint16_t) {
+    return {};
+}
+
+void ResetLatencyMetrics() {}
+
+#endif
+
+} // namespace bcnp
@@ -0,0 +1,209 @@
+#pragma once
+
+/**
+ * @file latency_trace.h
+ * @brief Optional per-stage latency histograms for the receive path.
+ *
+ * Build with BCNP_LATENCY_TRACE=1 (CMake option BCNP_LATENCY_TRACE) to
+ * timestamp each packet as it moves through the stack:
+ *
+ * Receive:   time spent inside an adapter's ReceiveChunk() that returned data
+ * Buffering: ReceiveChunk() returning to StreamParser emitting the packet
+ *            (measured from the chunk that completed the frame)
+ * Dispatch:  PacketDispatcher handler execution
+ * QueueWait: MessageQueue / SpscMessageQueue Push() to promotion
+ * LagSkip:   Push() to being dropped by lag compensation
+ *
+ * Samples go into lock-free log-linear histograms, one per stage and per
+ * message type (type IDs below kLatencyTypeSlots) plus an aggregate, and
+ * are read with GetLatencyMetrics(). Recording is one monotonic clock read
+ * and a few relaxed atomic increments, cheap enough to leave on in matches.
+ *
+ * With the switch off the hooks are empty inline functions, the queues
+ * carry no timestamps and GetLatencyMetrics() returns zeros.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifndef BCNP_LATENCY_TRACE
+#define BCNP_LATENCY_TRACE 0
+#endif
+
+namespace bcnp {
+
+enum class MessageTypeId : uint16_t;
+
+/// Instrumented pipeline stages
+enum class LatencyStage : uint8_t {
+    Receive,
+    Buffering,
+    Dispatch,
+    QueueWait,
+    LagSkip,
+};
+
+inline constexpr std::size_t kLatencyStageCount = 5;
+
+/// Type IDs below this get their own histograms; all types feed the aggregate
+inline constexpr uint16_t kLatencyTypeSlots = 16;
+
+/// Type ID for samples that are not tied to a message type (e.g. Receive)
+inline constexpr uint16_t kLatencyNoType = 0xFFFF;
+
+inline constexpr bool kLatencyTraceEnabled = BCNP_LATENCY_TRACE != 0;
+
+/**
+ * @brief Summary of one histogram. Percentiles are bucket upper bounds
+ *        (at most 12.5% above the true value, exact below 8 ns).
+ */
+struct LatencyStageMetrics {
+    uint64_t count{0};
+    uint64_t maxNs{0};
+    uint64_t meanNs{0};
+    uint64_t p50Ns{0};
+    uint64_t p90Ns{0};
+    uint64_t p99Ns{0};
+    uint64_t p999Ns{0};
+};
+
+/// Snapshot of every stage for one message type (or the aggregate)
+struct LatencyMetrics {
+    std::array<LatencyStageMetrics, kLatencyStageCount> stages{};
+
+    const LatencyStageMetrics& operator[](LatencyStage stage) const {
+        return stages[static_cast<std::size_t>(stage)];
+    }
+};
+
+/**
+ * @brief Lock-free log-linear (HDR-style) histogram of nanosecond samples.
+ *
+ * Each power of two is split into 8 linear sub-buckets, so relative error
+ * is bounded by 1/8 across the whole range. Values of 2^36 ns (~69 s) and
+ * above land in the last bucket. Record() may be called from any thread;
+ * Snapshot() concurrent with Record() may miss in-flight samples.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr uint64_t kSubBuckets = 1u << kSubBucketBits;
+    static constexpr unsigned kMaxExponent = 36;
+    static constexpr std::size_t kBucketCount =
+        kSubBuckets + (kMaxExponent - kSubBucketBits) * kSubBuckets;
+
+    void Record(uint64_t ns) {
+        m_buckets[BucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        m_sumNs.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t max = m_maxNs.load(std::memory_order_relaxed);
+        while (ns > max && !m_maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    LatencyStageMetrics Snapshot() const;
+    void Reset();
+
+    static std::size_t BucketIndex(uint64_t ns) {
+        if (ns < kSubBuckets) {
+            return static_cast<std::size_t>(ns);
+        }
+        const unsigned exponent = Log2(ns);
+        if (exponent >= kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        const unsigned shift = exponent - kSubBucketBits;
+        return static_cast<std::size_t>(kSubBuckets + shift * kSubBuckets + ((ns >> shift) - kSubBuckets));
+    }
+
+    /// Largest value that maps to @p index
+    static uint64_t BucketUpperBound(std::size_t index) {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        const uint64_t shift = (index - kSubBuckets) / kSubBuckets;
+        const uint64_t sub = kSubBuckets + (index - kSubBuckets) % kSubBuckets;
+        return ((sub + 1) << shift) - 1;
+    }
+
+private:
+    static unsigned Log2(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned exponent = 0;
+        while (value >>= 1) {
+            ++exponent;
+        }
+        return exponent;
+#endif
+    }
+
+    std::array<std::atomic<uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<uint64_t> m_sumNs{0};
+    std::atomic<uint64_t> m_maxNs{0};
+};
+
+/// Aggregate latency over all message types (zeros when tracing is compiled out)
+LatencyMetrics GetLatencyMetrics();
+
+/// Latency for one message type; IDs at or above kLatencyTypeSlots return zeros
+LatencyMetrics GetLatencyMetrics(uint16_t typeId);
+
+inline LatencyMetrics GetLatencyMetrics(MessageTypeId typeId) {
+    return GetLatencyMetrics(static_cast<uint16_t>(typeId));
+}
+
+void ResetLatencyMetrics();
+
+namespace trace {
+
+#if BCNP_LATENCY_TRACE
+
+/// Monotonic timestamp in nanoseconds
+inline uint64_t Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// Record one sample into the stage's aggregate and per-type histograms
+void Record(LatencyStage stage, uint16_t typeId, uint64_t ns);
+
+inline void RecordSince(LatencyStage stage, uint16_t typeId, uint64_t startNs) {
+    const uint64_t now = Now();
+    Record(stage, typeId, now > startNs ? now - startNs : 0);
+}
+
+/// Called when ReceiveChunk() returns data: records Receive and marks this thread
+void MarkReceive(uint64_t startNs);
+
+/// Time of this thread's last MarkReceive(), 0 if none
+uint64_t ReceiveMark();
+
+#else
+
+inline constexpr uint64_t Now() { return 0; }
+inline void Record(LatencyStage, uint16_t, uint64_t) {}
+inline void RecordSince(LatencyStage, uint16_t, uint64_t) {}
+inline void MarkReceive(uint64_t) {}
+inline constexpr uint64_t ReceiveMark() { return 0; }
+
+#endif
+
+/// MsgType::kTypeId for generated messages, kLatencyNoType otherwise
+template<typename MsgType, typename = void>
+struct TypeIdOf {
+    static constexpr uint16_t value = kLatencyNoType;
+};
+
+template<typename MsgType>
+struct TypeIdOf<MsgType, std::void_t<decltype(MsgType::kTypeId)>> {
+    static constexpr uint16_t value = static_cast<uint16_t>(MsgType::kTypeId);
+};
+
+} // namespace trace
+
+} // namespace bcnp
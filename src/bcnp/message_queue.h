@@ -12,6 +12,9 @@
  * All public methods use mutex synchronization.
  */
 
+#include "bcnp/latency_trace.h"
+#include "bcnp/metrics.h"
+
 #include <algorithm>
 #include <chrono>
 #include <cstddef>
@@ -23,6 +26,17 @@
 
 namespace bcnp {
 
+/**
+ * @brief What Push() does when the queue is full.
+ * 
+ * Every policy is O(1), so overload costs the same as normal operation.
+ */
+enum class QueueOverflowPolicy : uint8_t {
+    DropNewest,       ///< Reject the incoming message (Push() returns false)
+    DropOldest,       ///< Evict the front of the queue to make room
+    CoalesceLatest    ///< Replace the newest queued message with the incoming one
+};
+
 /**
  * @brief Configuration parameters for a message queue.
  */
@@ -30,6 +44,7 @@ struct MessageQueueConfig {
     std::size_t capacity{200};                          ///< Maximum messages in queue
     std::chrono::milliseconds connectionTimeout{200};    ///< Time before declaring disconnect
     std::chrono::milliseconds maxCommandLag{100};        ///< Max lag before clamping virtual time
+    QueueOverflowPolicy overflowPolicy{QueueOverflowPolicy::DropNewest};  ///< MessageQueue only; SpscMessageQueue always drops newest
 };
 
 /**
@@ -39,6 +54,7 @@ struct MessageQueueMetrics {
     uint64_t messagesReceived{0};    ///< Total messages pushed to queue
     uint64_t queueOverflows{0};      ///< Push attempts when queue was full
     uint64_t messagesSkipped{0};     ///< Messages skipped due to lag compensation
+    uint64_t messagesEvicted{0};     ///< Queued messages dropped or replaced by the overflow policy
 };
 
 /**
@@ -64,6 +80,10 @@ struct HasDurationMs {
  * This queue manages timed execution of messages, ensuring each message runs
  * for its specified duration before the next one starts. It handles connection timeouts, lag compensation
  * 
+ * Each slot also records the running total of queued durations, so after a
+ * stall Update() finds the first message that is not stale with a binary
+ * search and drops the whole stale run at once instead of one by one.
+ * 
  * @tparam MsgType Message struct with a uint16_t durationMs field
  * 
  * @code{cpp}
@@ -92,7 +112,7 @@ public:
     explicit MessageQueue(MessageQueueConfig config = {})
         : m_config(config) {
         ClampConfig();
-        m_storage.resize(m_config.capacity);
+        ResizeStorage();
     }
 
     /**
@@ -104,24 +124,21 @@ public:
     void Clear() {
         std::lock_guard<std::mutex> lock(m_mutex);
         ClearUnlocked();
+        RecordDepthUnlocked();
     }
 
     /**
      * @brief Add a message to the back of the queue.
      * 
      * @param message The message to enqueue
-     * @return true if successfully added, false if queue was full
+     * @return true if the message was queued, false if the queue was full
+     *         and the overflow policy is DropNewest
      * 
-     * @note Increments queueOverflows metric on failure.
+     * @note Increments queueOverflows whenever the queue was full.
      */
     bool Push(const MsgType& message) {
         std::lock_guard<std::mutex> lock(m_mutex);
-        if (!PushUnlocked(message)) {
-            ++m_metrics.queueOverflows;
-            return false;
-        }
-        ++m_metrics.messagesReceived;
-        return true;
+        return EnqueueUnlocked(message);
     }
 
     /**
@@ -163,6 +180,7 @@ public:
         if (!IsConnectedUnlocked(now)) {
             ClearUnlocked();
             m_hasVirtualCursor = false;
+            RecordDepthUnlocked();
             return;
         }
 
@@ -189,6 +207,7 @@ public:
                 }
             }
         }
+        RecordDepthUnlocked();
     }
 
     /**
@@ -235,6 +254,17 @@ public:
         m_metrics = {};
     }
 
+    /**
+     * @brief Also record depth, overflows and lag skips into @p registry (nullptr = off).
+     * 
+     * The registry is written under the queue mutex but read lock-free, so
+     * exporting it never blocks Update().
+     */
+    void SetMetricsRegistry(MetricsRegistry* registry) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_registry = registry;
+    }
+
     /**
      * @brief Update queue configuration.
      * 
@@ -248,7 +278,7 @@ public:
         ClampConfig();
         if (m_storage.size() != m_config.capacity) {
             ClearUnlocked();
-            m_storage.resize(m_config.capacity);
+            ResizeStorage();
         }
     }
 
@@ -279,12 +309,7 @@ public:
             : m_queue(queue), m_lock(queue.m_mutex) {}
         
         bool Push(const MsgType& message) {
-            if (!m_queue.PushUnlocked(message)) {
-                ++m_queue.m_metrics.queueOverflows;
-                return false;
-            }
-            ++m_queue.m_metrics.messagesReceived;
-            return true;
+            return m_queue.EnqueueUnlocked(message);
         }
 
         void Clear() {
@@ -316,45 +341,121 @@ private:
         }
 
         const auto lagFloor = now - m_config.maxCommandLag;
+        SkipStaleUnlocked(lagFloor);
+        if (m_count == 0) {
+            return;
+        }
 
-        while (m_count > 0) {
-            const MsgType& next = FrontUnlocked();
-            const auto duration = std::chrono::milliseconds(next.durationMs);
-            auto projectedStart = m_virtualCursor;
-            auto projectedEnd = projectedStart + duration;
-
-            if (projectedEnd <= lagFloor) {
-                PopUnlocked();
-                m_virtualCursor = projectedEnd;
-                ++m_metrics.messagesSkipped;
-                continue;
-            }
+        const MsgType& next = FrontUnlocked();
+        const auto duration = std::chrono::milliseconds(next.durationMs);
+        auto projectedStart = m_virtualCursor;
+        if (projectedStart < lagFloor) {
+            projectedStart = lagFloor;
+        }
 
-            if (projectedStart < lagFloor) {
-                projectedStart = lagFloor;
-            }
+        m_active = crab::Some(ActiveSlot{next, projectedStart});
+        TraceDequeue(LatencyStage::QueueWait);
+        PopUnlocked();
+        m_virtualCursor = projectedStart + duration;
+    }
 
-            m_active = crab::Some(ActiveSlot{next, projectedStart});
-            PopUnlocked();
-            m_virtualCursor = projectedStart + duration;
+    /**
+     * @brief Drop every queued message that would end at or before @p lagFloor.
+     * 
+     * A message's projected end is the virtual cursor plus the durations
+     * queued up to and including it, i.e. its running total minus the total
+     * already popped. That is monotonic along the queue, so the stale run is
+     * a prefix found by binary search.
+     */
+    void SkipStaleUnlocked(Clock::time_point lagFloor) {
+        if (m_virtualCursor >= lagFloor) {
+            return;
+        }
+        const auto budget = lagFloor - m_virtualCursor;
+        std::size_t low = 0;
+        std::size_t high = m_count;
+        while (low < high) {
+            const std::size_t mid = low + (high - low) / 2;
+            if (std::chrono::milliseconds(EndMsAt(mid) - m_poppedMs) <= budget) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low == 0) {
             return;
         }
+        const uint64_t skippedMs = EndMsAt(low - 1) - m_poppedMs;
+#if BCNP_LATENCY_TRACE
+        for (std::size_t i = 0; i < low; ++i) {
+            trace::RecordSince(LatencyStage::LagSkip, trace::TypeIdOf<MsgType>::value,
+                               m_enqueuedNs[Slot(i)]);
+        }
+#endif
+        m_virtualCursor += std::chrono::milliseconds(skippedMs);
+        m_poppedMs += skippedMs;
+        m_head = Slot(low);
+        m_count -= low;
+        m_metrics.messagesSkipped += low;
+        if (m_registry) {
+            m_registry->Add(Metric::QueueLagSkips, low);
+        }
     }
 
     void ClearUnlocked() {
         m_head = 0;
         m_tail = 0;
         m_count = 0;
+        m_pushedMs = 0;
+        m_poppedMs = 0;
         m_active = crab::None;
         m_virtualCursor = Clock::time_point::min();
         m_hasVirtualCursor = false;
     }
     
+    /// Push under the configured overflow policy, updating metrics
+    bool EnqueueUnlocked(const MsgType& message) {
+        if (m_count >= EffectiveDepth()) {
+            ++m_metrics.queueOverflows;
+            if (m_registry) {
+                m_registry->Add(Metric::QueueOverflows);
+            }
+            switch (m_config.overflowPolicy) {
+                case QueueOverflowPolicy::DropNewest:
+                    return false;
+                case QueueOverflowPolicy::DropOldest:
+                    PopUnlocked();
+                    ++m_metrics.messagesEvicted;
+                    break;
+                case QueueOverflowPolicy::CoalesceLatest:
+                    ReplaceBackUnlocked(message);
+                    ++m_metrics.messagesEvicted;
+                    ++m_metrics.messagesReceived;
+                    return true;
+            }
+        }
+        PushUnlocked(message);
+        ++m_metrics.messagesReceived;
+        RecordDepthUnlocked();
+        return true;
+    }
+
+    void RecordDepthUnlocked() {
+        if (m_registry) {
+            m_registry->SetWithHighWater(Metric::QueueDepth, Metric::QueueHighWater, m_count);
+        }
+    }
+
     bool PushUnlocked(const MsgType& message) {
         if (m_count >= EffectiveDepth()) {
             return false;
         }
         m_storage[m_tail] = message;
+        m_pushedMs += message.durationMs;
+        m_endMs[m_tail] = m_pushedMs;
+#if BCNP_LATENCY_TRACE
+        m_enqueuedNs[m_tail] = trace::Now();
+#endif
         m_tail = (m_tail + 1) % Capacity();
         ++m_count;
         return true;
@@ -362,13 +463,47 @@ private:
 
     void PopUnlocked() {
         if (m_count == 0) return;
+        m_poppedMs = m_endMs[m_head];
         m_head = (m_head + 1) % Capacity();
         --m_count;
     }
 
+    /// Overwrite the newest queued message, keeping the running totals consistent
+    void ReplaceBackUnlocked(const MsgType& message) {
+        const std::size_t back = Slot(m_count - 1);
+        const uint64_t before = m_count > 1 ? m_endMs[Slot(m_count - 2)] : m_poppedMs;
+        m_storage[back] = message;
+        m_pushedMs = before + message.durationMs;
+        m_endMs[back] = m_pushedMs;
+#if BCNP_LATENCY_TRACE
+        m_enqueuedNs[back] = trace::Now();
+#endif
+    }
+
+    /// Ring slot of the @p index-th queued message
+    std::size_t Slot(std::size_t index) const { return (m_head + index) % Capacity(); }
+
+    /// Running duration total through the @p index-th queued message
+    uint64_t EndMsAt(std::size_t index) const { return m_endMs[Slot(index)]; }
+
     const MsgType& FrontUnlocked() const {
         return m_storage[m_head];
     }
+
+    void ResizeStorage() {
+        m_storage.resize(m_config.capacity);
+        m_endMs.resize(m_config.capacity);
+#if BCNP_LATENCY_TRACE
+        m_enqueuedNs.resize(m_config.capacity);
+#endif
+    }
+
+    /// Record how long the front message waited (no-op without BCNP_LATENCY_TRACE)
+    void TraceDequeue([[maybe_unused]] LatencyStage stage) const {
+#if BCNP_LATENCY_TRACE
+        trace::RecordSince(stage, trace::TypeIdOf<MsgType>::value, m_enqueuedNs[m_head]);
+#endif
+    }
     
     std::size_t Capacity() const { return m_storage.size(); }
     std::size_t EffectiveDepth() const { return std::min(m_config.capacity, Capacity()); }
@@ -391,7 +526,14 @@ private:
 
     MessageQueueConfig m_config{};
     MessageQueueMetrics m_metrics{};
+    MetricsRegistry* m_registry{nullptr};
     std::vector<MsgType> m_storage;
+    std::vector<uint64_t> m_endMs;      // Running total of durationMs through each slot, parallel to m_storage
+    uint64_t m_pushedMs{0};             // Running total through the newest message
+    uint64_t m_poppedMs{0};             // Running total through the last message popped
+#if BCNP_LATENCY_TRACE
+    std::vector<uint64_t> m_enqueuedNs; // Push() time per slot, parallel to m_storage
+#endif
     std::size_t m_head{0};
     std::size_t m_tail{0};
     std::size_t m_count{0};
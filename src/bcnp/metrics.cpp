@@ -0,0 +1,109 @@
+/**
+ * @file metrics.cpp
+ * @brief Metric names, registry snapshots and the text exporter format.
+ */
+
+#include "bcnp/metrics.h"
+
+namespace bcnp {
+
+namespace {
+
+struct MetricInfo {
+    const char* name;
+    bool counter;
+};
+
+constexpr std::array<MetricInfo, kMetricCount> kMetricInfo{{
+    {"parser_bytes", true},
+    {"parser_frames", true},
+    {"parser_errors", true},
+    {"parser_resync_bytes", true},
+    {"rx_bytes", true},
+    {"tx_bytes", true},
+    {"tx_eagain", true},
+    {"tx_drops", true},
+    {"connects", true},
+    {"tx_queued_bytes", false},
+    {"tx_queued_high_water", false},
+    {"queue_depth", false},
+    {"queue_high_water", false},
+    {"queue_overflows", true},
+    {"queue_lag_skips", true},
+    {"tx_evictions", true},
+    {"tx_control_delay_us", false},
+    {"tx_telemetry_delay_us", false},
+    {"tx_bulk_delay_us", false},
+    {"tx_control_delay_max_us", false},
+    {"tx_telemetry_delay_max_us", false},
+    {"tx_bulk_delay_max_us", false},
+}};
+
+static_assert(static_cast<std::size_t>(Metric::TxBulkDelayMaxUs) + 1 == kMetricCount,
+              "kMetricCount and kMetricInfo must cover every Metric");
+
+void AppendLine(std::string& out, const char* name, const char* suffix, const char* labels, uint64_t value) {
+    out += "bcnp_";
+    out += name;
+    out += suffix;
+    out += labels;
+    out += ' ';
+    out += std::to_string(value);
+    out += '\n';
+}
+
+} // namespace
+
+const char* MetricName(Metric metric) {
+    return kMetricInfo[static_cast<std::size_t>(metric)].name;
+}
+
+bool IsMetricCounter(Metric metric) {
+    return kMetricInfo[static_cast<std::size_t>(metric)].counter;
+}
+
+MetricsSnapshot MetricsRegistry::Snapshot() const {
+    MetricsSnapshot snapshot;
+    for (std::size_t i = 0; i < kMetricCount; ++i) {
+        snapshot.values[i] = m_cells[i].Load();
+    }
+    for (std::size_t i = 0; i < kMetricTypeSlots; ++i) {
+        snapshot.packetsByType[i] = m_packets[i].Load();
+    }
+    snapshot.packetsOtherTypes = m_packets[kMetricTypeSlots].Load();
+    return snapshot;
+}
+
+void MetricsRegistry::Reset() {
+    for (auto& cell : m_cells) {
+        cell.Set(0);
+    }
+    for (auto& cell : m_packets) {
+        cell.Set(0);
+    }
+}
+
+void FormatMetricsText(const MetricsSnapshot& snapshot, std::string& out) {
+    for (std::size_t i = 0; i < kMetricCount; ++i) {
+        const MetricInfo& info = kMetricInfo[i];
+        const char* suffix = info.counter ? "_total" : "";
+        out += "# TYPE bcnp_";
+        out += info.name;
+        out += suffix;
+        out += info.counter ? " counter\n" : " gauge\n";
+        AppendLine(out, info.name, suffix, "", snapshot.values[i]);
+    }
+
+    out += "# TYPE bcnp_packets_total counter\n";
+    for (uint16_t type = 0; type < kMetricTypeSlots; ++type) {
+        if (snapshot.packetsByType[type] != 0) {
+            const std::string labels = "{type=\"" + std::to_string(type) + "\"}";
+            AppendLine(out, "packets", "_total", labels.c_str(), snapshot.packetsByType[type]);
+        }
+    }
+    if (snapshot.packetsOtherTypes != 0) {
+        AppendLine(out, "packets", "_total", "{type=\"other\"}", snapshot.packetsOtherTypes);
+    }
+}
+
+} // namespace bcnp
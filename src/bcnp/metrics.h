@@ -0,0 +1,310 @@
+#pragma once
+
+/**
+ * @file metrics.h
+ * @brief Lock-free counters for the receive/transmit hot path and a periodic exporter.
+ *
+ * A MetricsRegistry is a fixed table of relaxed atomic counters and gauges,
+ * each on its own cache line, so the network thread, the control loop and
+ * the exporter never share a line they both write. Components record into
+ * it once SetMetrics() (SetMetricsRegistry() on the queues) is called on
+ * them; nullptr, the default, turns the hooks off at the cost of one branch:
+ *
+ * StreamParser:       bytes pushed, frames, errors, resync bytes, packets per type
+ * TcpPosixAdapter:    bytes in/out, send EAGAIN, dropped sends, connects, TX ring depth,
+ *                     TX lane evictions and queueing delay
+ * UdpPosixAdapter:    bytes in/out, send EAGAIN, dropped datagrams
+ * MessageQueue /
+ * SpscMessageQueue:   queue depth, overflows, lag skips
+ *
+ * Snapshot() is a handful of relaxed loads and never blocks a writer.
+ * MetricsExporter takes one every period and emits it as Prometheus-style
+ * text or as a telemetry packet of a user-schema message type.
+ *
+ * @code{cpp}
+ *   bcnp::MetricsRegistry metrics;
+ *   dispatcher.SetMetrics(&metrics);
+ *   tcpAdapter.SetMetrics(&metrics);
+ *   driveQueue.SetMetricsRegistry(&metrics);
+ *
+ *   bcnp::MetricsExporter exporter(metrics, std::chrono::seconds(1));
+ *   std::string text;
+ *   if (exporter.MaybeFormatText(now, text)) { ... }          // Off the control thread
+ *   exporter.MaybeSendPacket<MetricSample>(now, tcpAdapter);  // Or over the link (user schema type)
+ * @endcode
+ */
+
+#include "bcnp/packet.h"
+#include "bcnp/transport/adapter.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace bcnp {
+
+/// Counters and gauges kept by MetricsRegistry
+enum class Metric : uint8_t {
+    ParserBytes,        ///< Bytes pushed into StreamParser
+    ParserFrames,       ///< Valid packets emitted
+    ParserErrors,       ///< Parse errors (bad header, CRC, oversize, ...)
+    ParserResyncBytes,  ///< Bytes discarded while resyncing
+    RxBytes,            ///< Bytes returned by adapter receives
+    TxBytes,            ///< Bytes accepted by the kernel
+    TxEagain,           ///< Sends that hit EAGAIN/EWOULDBLOCK
+    TxDrops,            ///< Sends rejected (TX ring congested or full, datagram dropped)
+    Connects,           ///< TCP connections established (first connect and reconnects)
+    TxQueuedBytes,      ///< Gauge: bytes waiting in the TCP TX ring
+    TxQueuedHighWater,  ///< Gauge: largest TxQueuedBytes seen
+    QueueDepth,         ///< Gauge: messages waiting in a message queue
+    QueueHighWater,     ///< Gauge: largest QueueDepth seen
+    QueueOverflows,     ///< Push attempts on a full message queue
+    QueueLagSkips,      ///< Messages skipped by lag compensation
+    TxEvictions,        ///< Queued lower-priority TX units dropped to admit higher-priority data
+    TxControlDelayUs,   ///< Gauge: enqueue-to-sent time of the last control unit
+    TxTelemetryDelayUs, ///< Gauge: same for the telemetry lane
+    TxBulkDelayUs,      ///< Gauge: same for the bulk lane
+    TxControlDelayMaxUs,    ///< Gauge: largest TxControlDelayUs seen
+    TxTelemetryDelayMaxUs,  ///< Gauge: largest TxTelemetryDelayUs seen
+    TxBulkDelayMaxUs,       ///< Gauge: largest TxBulkDelayUs seen
+};
+
+inline constexpr std::size_t kMetricCount = 22;
+
+/// Type IDs below this get their own packet counter; the rest share one
+inline constexpr uint16_t kMetricTypeSlots = 16;
+
+/// Wire metric ID of the per-type packet counters (see AppendMetricSamples())
+inline constexpr uint16_t kMetricPacketsIdBase = 0x100;
+/// Wire metric ID of the packet counter for type IDs at or above kMetricTypeSlots
+inline constexpr uint16_t kMetricPacketsOtherId = kMetricPacketsIdBase + kMetricTypeSlots;
+
+/// snake_case name, e.g. "parser_bytes"
+const char* MetricName(Metric metric);
+
+/// true for counters that only grow (until Reset()), false for gauges
+bool IsMetricCounter(Metric metric);
+
+/**
+ * @brief Relaxed atomic counter padded to a cache line.
+ *
+ * Any thread may update it. Every Metric normally has one writing thread,
+ * so the line stays in that core's cache and an update costs one
+ * uncontended atomic add.
+ */
+struct alignas(64) MetricCell {
+    std::atomic<uint64_t> value{0};
+
+    void Add(uint64_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+    void Set(uint64_t n) { value.store(n, std::memory_order_relaxed); }
+
+    /// Raise to @p n if larger (high-water marks)
+    void Max(uint64_t n) {
+        uint64_t current = value.load(std::memory_order_relaxed);
+        while (n > current && !value.compare_exchange_weak(current, n, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t Load() const { return value.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Plain copy of every metric at one point in time.
+ *
+ * Values are read one at a time without a lock, so a snapshot taken while
+ * writers are active may mix values from slightly different instants.
+ */
+struct MetricsSnapshot {
+    std::array<uint64_t, kMetricCount> values{};
+    std::array<uint64_t, kMetricTypeSlots> packetsByType{};
+    uint64_t packetsOtherTypes{0};   ///< Packets whose type ID is >= kMetricTypeSlots
+
+    uint64_t operator[](Metric metric) const { return values[static_cast<std::size_t>(metric)]; }
+
+    /// Packets of @p typeId (the shared counter for IDs >= kMetricTypeSlots)
+    uint64_t Packets(uint16_t typeId) const {
+        return typeId < kMetricTypeSlots ? packetsByType[typeId] : packetsOtherTypes;
+    }
+};
+
+/**
+ * @brief Fixed table of lock-free hot-path metrics.
+ *
+ * Recording never allocates, locks or makes a syscall. Share one registry
+ * between the components of a link; gauges written by several components
+ * (two queues feeding QueueDepth) hold whichever wrote last, so give each
+ * queue its own registry when the per-queue depth matters.
+ *
+ * Thread-safety: every member may be called from any thread.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    void Add(Metric metric, uint64_t n = 1) { Cell(metric).Add(n); }
+    void Set(Metric metric, uint64_t value) { Cell(metric).Set(value); }
+    void Max(Metric metric, uint64_t value) { Cell(metric).Max(value); }
+    uint64_t Get(Metric metric) const { return m_cells[static_cast<std::size_t>(metric)].Load(); }
+
+    /// Set a gauge and raise its high-water mark
+    void SetWithHighWater(Metric gauge, Metric highWater, uint64_t value) {
+        Cell(gauge).Set(value);
+        Cell(highWater).Max(value);
+    }
+
+    void CountPacket(MessageTypeId typeId) {
+        const auto id = static_cast<uint16_t>(typeId);
+        m_packets[id < kMetricTypeSlots ? id : kMetricTypeSlots].Add(1);
+    }
+
+    MetricsSnapshot Snapshot() const;
+
+    /// Zero every counter and gauge (racing writers may survive the reset)
+    void Reset();
+
+private:
+    MetricCell& Cell(Metric metric) { return m_cells[static_cast<std::size_t>(metric)]; }
+
+    std::array<MetricCell, kMetricCount> m_cells{};
+    std::array<MetricCell, kMetricTypeSlots + 1> m_packets{};   // Last slot: all other type IDs
+};
+
+/**
+ * @brief Append @p snapshot in the Prometheus text exposition format.
+ *
+ * One `bcnp_<name>` line per metric with a `# TYPE` comment, plus
+ * `bcnp_packets_total{type="<id>"}` for every message type seen. Counters carry
+ * a `_total` suffix.
+ */
+void FormatMetricsText(const MetricsSnapshot& snapshot, std::string& out);
+
+/**
+ * @brief Append @p snapshot as (metricId, value) messages.
+ *
+ * MsgType is any schema message with integer fields `metricId` and
+ * `value`, for example
+ * `{"name": "MetricSample", "fields": [{"name": "metricId", "type": "uint16"},
+ * {"name": "value", "type": "uint32"}]}`. Scalar metrics use their Metric
+ * index as ID; packets per type use kMetricPacketsIdBase + type ID (and
+ * kMetricPacketsOtherId), and are only sent once non-zero. Values wider
+ * than the field wrap, so take counter differences modulo its width.
+ *
+ * @return Messages appended
+ */
+template<typename MsgType, typename Storage>
+std::size_t AppendMetricSamples(const MetricsSnapshot& snapshot, Storage& messages) {
+    using IdType = decltype(MsgType::metricId);
+    using ValueType = decltype(MsgType::value);
+    const auto append = [&](uint16_t id, uint64_t value) {
+        MsgType sample{};
+        sample.metricId = static_cast<IdType>(id);
+        sample.value = static_cast<ValueType>(value);
+        messages.push_back(sample);
+    };
+
+    std::size_t appended = 0;
+    for (std::size_t i = 0; i < kMetricCount; ++i, ++appended) {
+        append(static_cast<uint16_t>(i), snapshot.values[i]);
+    }
+    for (uint16_t type = 0; type < kMetricTypeSlots; ++type) {
+        if (snapshot.packetsByType[type] != 0) {
+            append(static_cast<uint16_t>(kMetricPacketsIdBase + type), snapshot.packetsByType[type]);
+            ++appended;
+        }
+    }
+    if (snapshot.packetsOtherTypes != 0) {
+        append(kMetricPacketsOtherId, snapshot.packetsOtherTypes);
+        ++appended;
+    }
+    return appended;
+}
+
+/**
+ * @brief Takes a registry snapshot once per period and emits it.
+ *
+ * Call one of the Maybe*() functions every tick from the thread that owns
+ * the output; only the tick in which the period has elapsed does any work.
+ * The exporter only reads the registry, so it adds no contention to the
+ * threads recording into it.
+ *
+ * Thread-safety: not thread-safe; use from one thread.
+ */
+class MetricsExporter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit MetricsExporter(const MetricsRegistry& registry,
+                             Clock::duration period = std::chrono::seconds(1))
+        : m_registry(registry), m_period(period) {}
+
+    /**
+     * @brief Snapshot the registry if a period has elapsed since the last export.
+     *
+     * The first call always exports.
+     *
+     * @return true if @p out was filled
+     */
+    bool Poll(Clock::time_point now, MetricsSnapshot& out) {
+        if (m_hasExported && now - m_lastExport < m_period) {
+            return false;
+        }
+        m_hasExported = true;
+        m_lastExport = now;
+        out = m_registry.Snapshot();
+        ++m_exports;
+        return true;
+    }
+
+    /**
+     * @brief Replace @p out with the text format when a period has elapsed.
+     * @return true if @p out was written
+     */
+    bool MaybeFormatText(Clock::time_point now, std::string& out) {
+        MetricsSnapshot snapshot;
+        if (!Poll(now, snapshot)) {
+            return false;
+        }
+        out.clear();
+        FormatMetricsText(snapshot, out);
+        return true;
+    }
+
+    /**
+     * @brief Send a telemetry packet of MsgType samples when a period has elapsed.
+     *
+     * See AppendMetricSamples() for the message layout. The packet is built
+     * on the stack; the fallback encode buffer for adapters without
+     * ReserveTx() keeps its capacity, so at most the first export allocates.
+     *
+     * @return true if a packet was sent
+     */
+    template<typename MsgType, typename Adapter>
+    bool MaybeSendPacket(Clock::time_point now, Adapter& adapter) {
+        MetricsSnapshot snapshot;
+        if (!Poll(now, snapshot)) {
+            return false;
+        }
+        StaticTypedPacket<MsgType, kMetricCount + kMetricTypeSlots + 1> packet;
+        AppendMetricSamples<MsgType>(snapshot, packet.messages);
+        return SendTypedPacket(adapter, packet, m_scratch);
+    }
+
+    /// Exports so far
+    uint64_t ExportCount() const { return m_exports; }
+
+private:
+    const MetricsRegistry& m_registry;
+    Clock::duration m_period;
+    Clock::time_point m_lastExport{};
+    bool m_hasExported{false};
+    uint64_t m_exports{0};
+    std::vector<uint8_t> m_scratch;
+};
+
+} // namespace bcnp
@@ -0,0 +1,359 @@
+#pragma once
+
+/**
+ * @file mpsc_telemetry_accumulator.h
+ * @brief Lock-free multi-producer telemetry accumulator.
+ *
+ * Same batching as TelemetryAccumulator, but Record() never takes a lock:
+ * any number of threads (swerve modules, vision, IMU...) record into one
+ * accumulator while a single flushing thread drains it in MaybeFlush().
+ */
+
+#include "bcnp/packet.h"
+#include "bcnp/telemetry_accumulator.h"
+#include "bcnp/transport/adapter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace bcnp {
+
+/**
+ * @brief Multi-producer/single-consumer variant of TelemetryAccumulator.
+ *
+ * Readings live in a bounded ring of sequenced cells (Vyukov's bounded
+ * queue). A producer claims a slot with one compare-and-swap on the tail
+ * index and publishes it with a release store of the cell's sequence
+ * number; the flushing thread consumes cells the same way from the head.
+ *
+ * When the ring is full a producer retires the oldest reading itself, so
+ * the newest readings are kept as in TelemetryAccumulator. A producer
+ * that keeps losing the race for a slot drops its reading after a bounded
+ * number of attempts rather than spin; both cases count as bufferOverflows,
+ * so messagesRecorded == messagesSent + bufferOverflows + BufferedCount()
+ * (plus readings in failed sends).
+ *
+ * Thread roles:
+ * Producers (any thread): Record(), RecordBatch()
+ * Flushing thread: MaybeFlush(), ForceFlush(), EncodePendingInto(), Clear()
+ * Any thread: BufferedCount(), GetMetrics(), ResetMetrics()
+ *
+ * Flushes are serialized by a mutex that producers never touch, and the
+ * transport is only ever called by the flushing thread.
+ *
+ * @tparam MsgType The message struct type (e.g., EncoderData)
+ *
+ * @code{cpp}
+ *   MpscTelemetryAccumulator<EncoderData> encoders;
+ *
+ *   // Each swerve module thread:
+ *   encoders.Record(EncoderData{moduleId, position, velocity});
+ *
+ *   // Control loop, once per tick:
+ *   encoders.MaybeFlush(tcpAdapter);
+ * @endcode
+ */
+template<typename MsgType>
+class MpscTelemetryAccumulator {
+    static_assert(std::is_default_constructible_v<MsgType> && std::is_copy_assignable_v<MsgType>,
+                  "MsgType must be default constructible and copy assignable");
+
+public:
+    using Message = MsgType;
+    using Metrics = TelemetryAccumulatorMetrics;
+
+    /// Producer slot claims attempted before a reading is dropped
+    static constexpr int kMaxRecordAttempts = 8;
+
+    /// Configuration is fixed at construction (the ring cannot be resized lock-free)
+    explicit MpscTelemetryAccumulator(TelemetryAccumulatorConfig config = {})
+        : m_config(config) {
+        m_capacity = std::min<std::size_t>(std::max<std::size_t>(m_config.maxBufferedMessages, 1),
+                                           kMaxMessagesPerPacket);
+        m_cells.reset(new Cell[m_capacity]);
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_drain.resize(m_capacity);
+        m_wireBuffer.resize(PacketSizeFor<MsgType>(m_capacity));
+    }
+
+    MpscTelemetryAccumulator(const MpscTelemetryAccumulator&) = delete;
+    MpscTelemetryAccumulator& operator=(const MpscTelemetryAccumulator&) = delete;
+
+    // ========================================================================
+    // Producers
+    // ========================================================================
+
+    /**
+     * @brief Record a telemetry reading (any thread, lock-free).
+     *
+     * If the ring is full the oldest reading is overwritten.
+     *
+     * @param msg The telemetry message to record
+     * @return true if recorded, false if dropped under sustained contention
+     */
+    bool Record(const MsgType& msg) {
+        m_messagesRecorded.fetch_add(1, std::memory_order_relaxed);
+        for (int attempt = 0; attempt < kMaxRecordAttempts; ++attempt) {
+            if (TryEnqueue(msg)) {
+                return true;
+            }
+            // Full: retire the oldest reading to make room
+            MsgType discarded;
+            if (TryDequeue(discarded)) {
+                m_bufferOverflows.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        m_bufferOverflows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief Record multiple telemetry readings (any thread, lock-free).
+     *
+     * Readings from concurrent producers may interleave with the batch.
+     */
+    template<typename InputIt>
+    void RecordBatch(InputIt first, InputIt last) {
+        for (auto it = first; it != last; ++it) {
+            Record(*it);
+        }
+    }
+
+    // ========================================================================
+    // Flushing thread
+    // ========================================================================
+
+    /**
+     * @brief Flush if interval has elapsed.
+     *
+     * @param adapter The transport adapter to send through (must have SendBytes)
+     * @return true if a packet was sent, false if interval not yet elapsed or buffer empty
+     */
+    template<typename Adapter>
+    bool MaybeFlush(Adapter& adapter) {
+        std::lock_guard<std::mutex> flushLock(m_flushMutex);
+        ++m_tickCount;
+        if (m_tickCount < m_config.flushIntervalTicks) {
+            return false;
+        }
+        m_tickCount = 0;
+        return FlushPending(adapter);
+    }
+
+    /**
+     * @brief Force an immediate flush regardless of interval.
+     *
+     * @param adapter The transport adapter to send through
+     * @return true if a packet was sent, false if buffer was empty
+     */
+    template<typename Adapter>
+    bool ForceFlush(Adapter& adapter) {
+        std::lock_guard<std::mutex> flushLock(m_flushMutex);
+        m_tickCount = 0;
+        return FlushPending(adapter);
+    }
+
+    /**
+     * @brief Drain and encode the oldest readings that fit in @p capacity (flushing thread).
+     *
+     * Building block for TelemetryBatcher; see
+     * TelemetryAccumulator::EncodePendingInto().
+     */
+    TelemetryEncodeResult EncodePendingInto(uint8_t* out, std::size_t capacity,
+                                            std::size_t maxMessages = kMaxMessagesPerPacket) {
+        std::lock_guard<std::mutex> flushLock(m_flushMutex);
+        if (!out || capacity < PacketSizeFor<MsgType>(1)) {
+            return {};
+        }
+        const std::size_t fit = std::min({(capacity - PacketSizeFor<MsgType>(0)) / MsgType::kWireSize,
+                                          m_drain.size(), maxMessages});
+        TelemetryEncodeResult result;
+        while (result.messages < fit && TryDequeue(m_drain[result.messages])) {
+            ++result.messages;
+        }
+        if (result.messages > 0) {
+            EncodePacketFromSpans<MsgType>(m_drain.data(), result.messages, nullptr, 0,
+                                           0, out, capacity, result.bytes);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Record the outcome of sending bytes from EncodePendingInto().
+     */
+    void CompleteExternalFlush(bool sent, std::size_t messageCount) {
+        RecordFlushResult(sent, messageCount);
+    }
+
+    /**
+     * @brief Discard all buffered readings without sending.
+     */
+    void Clear() {
+        std::lock_guard<std::mutex> flushLock(m_flushMutex);
+        MsgType discarded;
+        while (TryDequeue(discarded)) {
+        }
+        m_tickCount = 0;
+    }
+
+    // ========================================================================
+    // Any thread
+    // ========================================================================
+
+    /**
+     * @brief Approximate number of buffered readings (includes in-flight claims).
+     */
+    std::size_t BufferedCount() const {
+        const uint64_t tail = m_enqueuePos.load(std::memory_order_acquire);
+        const uint64_t head = m_dequeuePos.load(std::memory_order_acquire);
+        return tail > head ? static_cast<std::size_t>(std::min<uint64_t>(tail - head, m_capacity)) : 0;
+    }
+
+    std::size_t Capacity() const { return m_capacity; }
+
+    const TelemetryAccumulatorConfig& GetConfig() const { return m_config; }
+
+    /**
+     * @brief Snapshot of accumulator statistics (relaxed, never blocks).
+     */
+    Metrics GetMetrics() const {
+        Metrics metrics;
+        metrics.messagesRecorded = m_messagesRecorded.load(std::memory_order_relaxed);
+        metrics.messagesSent = m_messagesSent.load(std::memory_order_relaxed);
+        metrics.packetsSent = m_packetsSent.load(std::memory_order_relaxed);
+        metrics.bufferOverflows = m_bufferOverflows.load(std::memory_order_relaxed);
+        metrics.sendFailures = m_sendFailures.load(std::memory_order_relaxed);
+        return metrics;
+    }
+
+    void ResetMetrics() {
+        m_messagesRecorded.store(0, std::memory_order_relaxed);
+        m_messagesSent.store(0, std::memory_order_relaxed);
+        m_packetsSent.store(0, std::memory_order_relaxed);
+        m_bufferOverflows.store(0, std::memory_order_relaxed);
+        m_sendFailures.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // sequence == pos: free for the producer claiming pos
+    // sequence == pos + 1: holds the reading enqueued at pos
+    struct Cell {
+        std::atomic<uint64_t> sequence{0};
+        MsgType value{};
+    };
+
+    bool TryEnqueue(const MsgType& msg) {
+        uint64_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos % m_capacity];
+            const uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq - pos);
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = msg;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Used by the flushing thread and by producers retiring the oldest reading
+    bool TryDequeue(MsgType& out) {
+        uint64_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos % m_capacity];
+            const uint64_t seq = cell.sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = cell.value;
+                    cell.sequence.store(pos + m_capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // Empty, or the oldest slot is still being written
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Drain up to one ring's worth of readings and send them as one packet
+    template<typename Adapter>
+    bool FlushPending(Adapter& adapter) {
+        std::size_t count = 0;
+        while (count < m_drain.size() && TryDequeue(m_drain[count])) {
+            ++count;
+        }
+        if (count == 0) {
+            return false;
+        }
+
+        const std::size_t maxBytes = PacketSizeFor<MsgType>(count);
+        std::size_t written = 0;
+
+        if constexpr (std::is_base_of_v<ByteWriter, Adapter>) {
+            const MutableByteSpan span = adapter.ReserveTx(maxBytes);
+            if (span.data && span.length >= maxBytes) {
+                EncodePacketFromSpans<MsgType>(m_drain.data(), count, nullptr, 0,
+                                               0, span.data, span.length, written);
+                const bool ok = written > 0 && adapter.CommitTx(written);
+                if (written == 0) {
+                    adapter.CommitTx(0);
+                }
+                return RecordFlushResult(ok, count);
+            }
+        }
+
+        EncodePacketFromSpans<MsgType>(m_drain.data(), count, nullptr, 0,
+                                       0, m_wireBuffer.data(), m_wireBuffer.size(), written);
+        const bool ok = written > 0 && adapter.SendBytes(m_wireBuffer.data(), written);
+        return RecordFlushResult(ok, count);
+    }
+
+    bool RecordFlushResult(bool ok, std::size_t messageCount) {
+        if (!ok) {
+            m_sendFailures.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_messagesSent.fetch_add(messageCount, std::memory_order_relaxed);
+        m_packetsSent.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    TelemetryAccumulatorConfig m_config;
+    std::size_t m_capacity{1};
+    std::unique_ptr<Cell[]> m_cells;
+
+    // Shared indices, each on its own cache line
+    alignas(64) std::atomic<uint64_t> m_enqueuePos{0};
+    alignas(64) std::atomic<uint64_t> m_dequeuePos{0};
+
+    // Flushing-thread state
+    alignas(64) std::mutex m_flushMutex;
+    std::size_t m_tickCount{0};
+    std::vector<MsgType> m_drain;       // Contiguous copy of one drained batch
+    std::vector<uint8_t> m_wireBuffer;  // Fallback encode buffer for one full ring
+
+    // Metrics
+    alignas(64) std::atomic<uint64_t> m_messagesRecorded{0};
+    std::atomic<uint64_t> m_messagesSent{0};
+    std::atomic<uint64_t> m_packetsSent{0};
+    std::atomic<uint64_t> m_bufferOverflows{0};
+    std::atomic<uint64_t> m_sendFailures{0};
+};
+
+} // namespace bcnp
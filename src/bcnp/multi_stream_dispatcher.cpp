@@ -0,0 +1,405 @@
+/**
+ * @file multi_stream_dispatcher.cpp
+ * @brief Implementation of the multi-stream dispatcher and its executors.
+ *
+ * Lock order: stream mutex -> route mutex (shared) -> executor mutex.
+ * The setup mutex is only held around list changes and never while parsing.
+ */
+
+#include "bcnp/multi_stream_dispatcher.h"
+
+#include "bcnp/latency_trace.h"
+#include "bcnp/realtime.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace bcnp {
+
+/**
+ * @brief Bounded FIFO of retained packets served by one pinned thread.
+ */
+class MultiStreamDispatcher::Executor {
+public:
+    Executor(MultiStreamDispatcher& owner, HandlerExecutorConfig config, std::size_t depth)
+        : m_owner(owner), m_ring(std::max<std::size_t>(depth, 1)) {
+        m_thread = std::thread([this, config]() { Loop(config); });
+    }
+
+    ~Executor() { Stop(); }
+
+    /// Retain @p packet and queue it for @p handler; drops it if the queue is full or stopping
+    void Enqueue(StreamId stream, const PacketView& packet, const std::shared_ptr<const Handler>& handler) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping || m_count == m_ring.size()) {
+                ++m_metrics.dropped;
+                return;
+            }
+            Task& task = m_ring[(m_head + m_count) % m_ring.size()];
+            task.frame = m_owner.m_arena.Retain(packet);
+            task.handler = handler;
+            task.stream = stream;
+            ++m_count;
+        }
+        m_wake.notify_one();
+    }
+
+    /// Finish queued packets, then join
+    void Stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    HandlerExecutorMetrics Metrics() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_metrics;
+    }
+
+private:
+    struct Task {
+        OwnedPacketView frame;
+        std::shared_ptr<const Handler> handler;
+        StreamId stream{0};
+    };
+
+    void Loop(HandlerExecutorConfig config) {
+        PinCurrentThread(config.cpu);
+        SetCurrentThreadFifo(config.fifoPriority);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_wake.wait(lock, [this]() { return m_count > 0 || m_stopping; });
+            if (m_count == 0) {
+                return;   // Stopping and drained
+            }
+            Task task = std::move(m_ring[m_head]);
+            m_head = (m_head + 1) % m_ring.size();
+            --m_count;
+            lock.unlock();
+
+            m_owner.RunDeferred(task.stream, task.frame.View(), task.handler);
+            task.frame.Reset();   // Recycle the block before waiting again
+            task.handler.reset();
+
+            lock.lock();
+            ++m_metrics.executed;
+        }
+    }
+
+    MultiStreamDispatcher& m_owner;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<Task> m_ring;
+    std::size_t m_head{0};
+    std::size_t m_count{0};
+    bool m_stopping{false};
+    HandlerExecutorMetrics m_metrics{};
+    std::thread m_thread;   // Last: started once the members above exist
+};
+
+MultiStreamDispatcher::Stream::Stream(MultiStreamDispatcher& owner, StreamId id)
+    : m_owner(owner),
+      m_id(id),
+      m_parser(
+          [this](const PacketView& packet) {
+              m_lastRx = Clock::now();
+              m_owner.RoutePacket(m_id, packet);
+          },
+          [this](const StreamParser::ErrorInfo& error) {
+              ++m_parseErrors;
+              m_owner.RouteError(m_id, error);
+          },
+          owner.m_config.parserBufferSize) {}
+
+/**
+ * @brief Parse bytes from this source.
+ *
+ * Only this stream's lock is taken, so other streams parse concurrently.
+ *
+ * @param data Pointer to incoming byte data
+ * @param length Number of bytes to process
+ */
+void MultiStreamDispatcher::Stream::PushBytes(const uint8_t* data, std::size_t length) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_parser.Push(data, length);
+}
+
+void MultiStreamDispatcher::Stream::Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_parser.Reset(false);
+}
+
+bool MultiStreamDispatcher::Stream::IsConnected(Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_lastRx == Clock::time_point::min()) {
+        return false;
+    }
+    return (now - m_lastRx) <= m_owner.m_config.connectionTimeout;
+}
+
+MultiStreamDispatcher::Clock::time_point MultiStreamDispatcher::Stream::LastReceiveTime() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastRx;
+}
+
+uint64_t MultiStreamDispatcher::Stream::ParseErrorCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_parseErrors;
+}
+
+/**
+ * @brief Construct a dispatcher with no streams and no executors.
+ *
+ * Allocates the shared FrameArena (frameArenaBlocks blocks of
+ * parserBufferSize bytes) up front.
+ *
+ * @param config Parser size, timeout and executor sizing
+ */
+MultiStreamDispatcher::MultiStreamDispatcher(MultiStreamDispatcherConfig config)
+    : m_config(config),
+      m_arena(FrameArenaConfig{config.parserBufferSize, config.frameArenaBlocks}) {
+    m_flatRoutes.resize(std::min<std::size_t>(std::size_t{kMaxMessageTypeId} + 1,
+                                              PacketDispatcher::kFlatHandlerLimit));
+}
+
+MultiStreamDispatcher::~MultiStreamDispatcher() {
+    Stop();
+}
+
+/**
+ * @brief Add a source stream with its own parser.
+ * @return ID for GetStream()
+ */
+MultiStreamDispatcher::StreamId MultiStreamDispatcher::AddStream() {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    const StreamId id = m_streams.size();
+    m_streams.push_back(std::unique_ptr<Stream>(new Stream(*this, id)));
+    if (m_wireSizeFn) {
+        m_streams.back()->m_parser.SetWireSizeFunction(m_wireSizeFn);
+    }
+    if (m_fieldLayoutFn) {
+        m_streams.back()->m_parser.SetFieldLayoutFunction(m_fieldLayoutFn);
+    }
+    return id;
+}
+
+/**
+ * @brief Look up a stream.
+ * @throws std::out_of_range if @p id was not returned by AddStream()
+ */
+MultiStreamDispatcher::Stream& MultiStreamDispatcher::GetStream(StreamId id) {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    return *m_streams.at(id);
+}
+
+const MultiStreamDispatcher::Stream& MultiStreamDispatcher::GetStream(StreamId id) const {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    return *m_streams.at(id);
+}
+
+std::size_t MultiStreamDispatcher::StreamCount() const {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    return m_streams.size();
+}
+
+/**
+ * @brief Start a handler executor thread.
+ *
+ * @param config CPU pinning and SCHED_FIFO priority (failures are logged, not fatal)
+ * @return ID to pass to RegisterHandler()
+ */
+MultiStreamDispatcher::ExecutorId MultiStreamDispatcher::AddExecutor(HandlerExecutorConfig config) {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    m_executors.push_back(std::make_unique<Executor>(*this, config, m_config.executorQueueDepth));
+    return m_executors.size() - 1;
+}
+
+std::size_t MultiStreamDispatcher::ExecutorCount() const {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    return m_executors.size();
+}
+
+/**
+ * @brief Register or replace the handler for a message type.
+ *
+ * @param typeId Message type ID to handle
+ * @param handler Callback receiving the packet and the stream it arrived on
+ * @param executor Executor from AddExecutor(), or kInline for the parsing thread
+ * @throws std::out_of_range if @p executor is neither kInline nor a valid ID
+ */
+void MultiStreamDispatcher::RegisterHandler(MessageTypeId typeId, Handler handler, ExecutorId executor) {
+    Executor* target = nullptr;
+    if (executor != kInline) {
+        std::lock_guard<std::mutex> lock(m_setupMutex);
+        target = m_executors.at(executor).get();
+    }
+    std::unique_lock<std::shared_mutex> lock(m_routeMutex);
+    const auto id = static_cast<uint16_t>(typeId);
+    RouteEntry entry{handler ? std::make_shared<const Handler>(std::move(handler)) : nullptr, target};
+    if (id >= PacketDispatcher::kFlatHandlerLimit) {
+        m_sparseRoutes[id] = std::move(entry);
+        return;
+    }
+    if (id >= m_flatRoutes.size()) {
+        m_flatRoutes.resize(std::size_t{id} + 1);
+    }
+    m_flatRoutes[id] = std::move(entry);
+}
+
+void MultiStreamDispatcher::UnregisterHandler(MessageTypeId typeId) {
+    std::unique_lock<std::shared_mutex> lock(m_routeMutex);
+    const auto id = static_cast<uint16_t>(typeId);
+    if (id >= PacketDispatcher::kFlatHandlerLimit) {
+        m_sparseRoutes.erase(id);
+    } else if (id < m_flatRoutes.size()) {
+        m_flatRoutes[id] = RouteEntry{};
+    }
+}
+
+void MultiStreamDispatcher::SetErrorHandler(StreamErrorHandler handler) {
+    std::unique_lock<std::shared_mutex> lock(m_routeMutex);
+    m_errorHandler = std::move(handler);
+}
+
+void MultiStreamDispatcher::SetWireSizeFunction(StreamParser::WireSizeFn fn) {
+    SetLookups(fn, nullptr);
+}
+
+/**
+ * @brief Apply lookups to every stream and remember them for later AddStream() calls.
+ *
+ * @param wireSize Wire size lookup
+ * @param layout Field layout lookup (nullptr = generated default)
+ */
+void MultiStreamDispatcher::SetLookups(StreamParser::WireSizeFn wireSize, StreamParser::FieldLayoutFn layout) {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    m_wireSizeFn = wireSize;
+    m_fieldLayoutFn = layout;
+    for (auto& stream : m_streams) {
+        std::lock_guard<std::mutex> streamLock(stream->m_mutex);
+        stream->m_parser.SetWireSizeFunction(wireSize);
+        stream->m_parser.SetFieldLayoutFunction(layout);
+    }
+}
+
+/**
+ * @brief Check if any stream is connected.
+ * @param now Current time point for comparison
+ * @return true if some stream received a packet within connectionTimeout
+ */
+bool MultiStreamDispatcher::IsConnected(Clock::time_point now) const {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    return std::any_of(m_streams.begin(), m_streams.end(),
+                       [now](const std::unique_ptr<Stream>& stream) { return stream->IsConnected(now); });
+}
+
+MultiStreamDispatcher::Clock::time_point MultiStreamDispatcher::LastReceiveTime() const {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    Clock::time_point latest = Clock::time_point::min();
+    for (const auto& stream : m_streams) {
+        latest = std::max(latest, stream->LastReceiveTime());
+    }
+    return latest;
+}
+
+uint64_t MultiStreamDispatcher::ParseErrorCount() const {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    uint64_t total = 0;
+    for (const auto& stream : m_streams) {
+        total += stream->ParseErrorCount();
+    }
+    return total;
+}
+
+HandlerExecutorMetrics MultiStreamDispatcher::GetExecutorMetrics(ExecutorId executor) const {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    return m_executors.at(executor)->Metrics();
+}
+
+/**
+ * @brief Run every queued packet and join the executor threads.
+ *
+ * Packets routed to an executor afterwards are dropped.
+ */
+void MultiStreamDispatcher::Stop() {
+    std::lock_guard<std::mutex> lock(m_setupMutex);
+    for (auto& executor : m_executors) {
+        executor->Stop();
+    }
+}
+
+const MultiStreamDispatcher::RouteEntry* MultiStreamDispatcher::FindRoute(uint16_t id) const {
+    if (id < m_flatRoutes.size()) {
+        return m_flatRoutes[id].handler ? &m_flatRoutes[id] : nullptr;
+    }
+    if (id >= PacketDispatcher::kFlatHandlerLimit) {
+        auto it = m_sparseRoutes.find(id);
+        if (it != m_sparseRoutes.end() && it->second.handler) {
+            return &it->second;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Called on a stream's parsing thread for each packet.
+ *
+ * Inline handlers run here; executor-bound packets are retained and queued.
+ * Handler run time is recorded as the Dispatch stage when BCNP_LATENCY_TRACE is on.
+ *
+ * @param stream Source stream
+ * @param packet Packet valid for this call
+ */
+void MultiStreamDispatcher::RoutePacket(StreamId stream, const PacketView& packet) {
+    std::shared_lock<std::shared_mutex> lock(m_routeMutex);
+    const auto id = static_cast<uint16_t>(packet.header.messageType);
+    const RouteEntry* route = FindRoute(id);
+    if (!route) {
+        return;   // No handler registered
+    }
+    if (route->executor) {
+        route->executor->Enqueue(stream, packet, route->handler);
+        return;
+    }
+    const uint64_t start = trace::Now();
+    (*route->handler)(packet, stream);
+    trace::RecordSince(LatencyStage::Dispatch, id, start);
+}
+
+/**
+ * @brief Called on an executor thread for a retained packet.
+ *
+ * Runs @p handler, the one the packet was routed to, unless it has been
+ * unregistered or replaced since. The route lock is released before the
+ * call, so a slow handler does not hold up RegisterHandler().
+ */
+void MultiStreamDispatcher::RunDeferred(StreamId stream, const PacketView& packet,
+                                        const std::shared_ptr<const Handler>& handler) {
+    const auto id = static_cast<uint16_t>(packet.header.messageType);
+    {
+        std::shared_lock<std::shared_mutex> lock(m_routeMutex);
+        const RouteEntry* route = FindRoute(id);
+        if (!route || route->handler != handler) {
+            return;
+        }
+    }
+    const uint64_t start = trace::Now();
+    (*handler)(packet, stream);
+    trace::RecordSince(LatencyStage::Dispatch, id, start);
+}
+
+void MultiStreamDispatcher::RouteError(StreamId stream, const StreamParser::ErrorInfo& error) {
+    std::shared_lock<std::shared_mutex> lock(m_routeMutex);
+    if (m_errorHandler) {
+        m_errorHandler(stream, error);
+    }
+}
+
+} // namespace bcnp
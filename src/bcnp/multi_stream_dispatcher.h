@@ -0,0 +1,227 @@
+#pragma once
+
+/**
+ * @file multi_stream_dispatcher.h
+ * @brief Dispatcher for several byte streams parsed in parallel.
+ *
+ * PacketDispatcher serializes every source on one parser and one mutex.
+ * MultiStreamDispatcher gives each source (TCP control link, UDP
+ * telemetry, a replayed capture) its own StreamParser and lock, so each
+ * source is parsed on the thread that feeds it, typically its own
+ * DispatcherDriver I/O thread. Handlers can be bound to executor threads
+ * pinned to particular cores; packets routed there are retained in a
+ * shared FrameArena and handed over without a per-packet allocation.
+ */
+
+#include "bcnp/dispatcher.h"
+#include "bcnp/frame_arena.h"
+#include "bcnp/stream_parser.h"
+#include <bcnp/message_types.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bcnp {
+
+/// Configuration for MultiStreamDispatcher
+struct MultiStreamDispatcherConfig {
+    std::size_t parserBufferSize{4096};                 ///< Ring size of each stream's parser
+    std::chrono::milliseconds connectionTimeout{200};   ///< Per stream
+    std::size_t frameArenaBlocks{64};                   ///< Frames in flight to executors (all streams)
+    std::size_t executorQueueDepth{256};                ///< Pending packets per executor before drops
+};
+
+/// Options for a handler executor thread
+struct HandlerExecutorConfig {
+    int cpu{-1};            ///< Pin the thread to this CPU (-1 = no pinning, Linux only)
+    int fifoPriority{0};    ///< SCHED_FIFO priority 1-99 (0 = default scheduler)
+};
+
+/// Runtime metrics for one handler executor
+struct HandlerExecutorMetrics {
+    uint64_t executed{0};   ///< Packets handled on the executor thread
+    uint64_t dropped{0};    ///< Packets dropped because the executor queue was full
+};
+
+/**
+ * @brief Parses several streams independently and routes packets by type.
+ *
+ * @code{cpp}
+ *   MultiStreamDispatcher dispatcher;
+ *   auto control = dispatcher.AddStream();
+ *   auto telemetry = dispatcher.AddStream();
+ *   HandlerExecutorConfig plannerCore;
+ *   plannerCore.cpu = 3;
+ *   auto planner = dispatcher.AddExecutor(plannerCore);
+ *
+ *   dispatcher.RegisterHandler<DriveCmd>([&](const PacketView& pkt, MultiStreamDispatcher::StreamId) {
+ *       ...   // Runs on the parsing thread of whichever stream carried it
+ *   });
+ *   dispatcher.RegisterHandler<TrajectoryPoint>([&](const PacketView& pkt, MultiStreamDispatcher::StreamId) {
+ *       ...   // Runs on the planner thread
+ *   }, planner);
+ *
+ *   DispatcherDriver controlDriver(dispatcher.GetStream(control), tcpAdapter);
+ *   DispatcherDriver telemetryDriver(dispatcher.GetStream(telemetry), udpAdapter);
+ *   controlDriver.Start();
+ *   telemetryDriver.Start();
+ * @endcode
+ *
+ * Packets of one type from one stream reach their handler in order.
+ * Executor queues are bounded: when one is full the packet is dropped and
+ * counted (HandlerExecutorMetrics::dropped), so a slow handler never
+ * stalls parsing.
+ *
+ * Thread-safety: all methods are thread-safe. Add streams and executors
+ * during setup; GetStream() references stay valid for the dispatcher's
+ * lifetime. Inline handlers run under a shared lock on the routing table,
+ * so they must not register or unregister handlers.
+ */
+class MultiStreamDispatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+    using StreamId = std::size_t;
+    using ExecutorId = std::size_t;
+    using Handler = std::function<void(const PacketView&, StreamId)>;
+    using StreamErrorHandler = std::function<void(StreamId, const StreamParser::ErrorInfo&)>;
+
+    /// Run the handler on the parsing thread
+    static constexpr ExecutorId kInline = std::numeric_limits<ExecutorId>::max();
+
+    /**
+     * @brief One source stream: its own parser, lock and connection state.
+     *
+     * Has PushBytes(), so it can be driven by a DispatcherDriver.
+     */
+    class Stream {
+    public:
+        Stream(const Stream&) = delete;
+        Stream& operator=(const Stream&) = delete;
+
+        /// Parse bytes from this source; handlers for inline types run on the caller (thread-safe)
+        void PushBytes(const uint8_t* data, std::size_t length);
+
+        /// Drop any partial frame, e.g. after the source reconnects
+        void Reset();
+
+        StreamId Id() const { return m_id; }
+        bool IsConnected(Clock::time_point now) const;
+        Clock::time_point LastReceiveTime() const;
+        uint64_t ParseErrorCount() const;
+
+    private:
+        friend class MultiStreamDispatcher;
+
+        Stream(MultiStreamDispatcher& owner, StreamId id);
+
+        MultiStreamDispatcher& m_owner;
+        StreamId m_id;
+        mutable std::mutex m_mutex;
+        StreamParser m_parser;
+        Clock::time_point m_lastRx{Clock::time_point::min()};
+        uint64_t m_parseErrors{0};
+    };
+
+    explicit MultiStreamDispatcher(MultiStreamDispatcherConfig config = {});
+
+    /// Drains and joins the executor threads
+    ~MultiStreamDispatcher();
+
+    MultiStreamDispatcher(const MultiStreamDispatcher&) = delete;
+    MultiStreamDispatcher& operator=(const MultiStreamDispatcher&) = delete;
+
+    /// Add a source stream (uses the wire size lookup set so far)
+    StreamId AddStream();
+
+    /// Stream by ID (reference stays valid for the dispatcher's lifetime)
+    Stream& GetStream(StreamId id);
+    const Stream& GetStream(StreamId id) const;
+
+    std::size_t StreamCount() const;
+
+    /// Start an executor thread for handlers bound to it
+    ExecutorId AddExecutor(HandlerExecutorConfig config = {});
+
+    std::size_t ExecutorCount() const;
+
+    /// Register a handler for a message type (by type)
+    template<typename MsgType>
+    void RegisterHandler(Handler handler, ExecutorId executor = kInline) {
+        RegisterHandler(MsgType::kTypeId, std::move(handler), executor);
+    }
+
+    /// Register or replace the handler for @p typeId, run on @p executor (packets queued for the old one are discarded)
+    void RegisterHandler(MessageTypeId typeId, Handler handler, ExecutorId executor = kInline);
+
+    /// Remove a handler; packets already queued on an executor for it are discarded
+    void UnregisterHandler(MessageTypeId typeId);
+
+    /// Set the parse error callback (runs on the stream's parsing thread)
+    void SetErrorHandler(StreamErrorHandler handler);
+
+    /// Set the wire size lookup for every stream, current and future
+    void SetWireSizeFunction(StreamParser::WireSizeFn fn);
+
+    /// Convenience: set wire size and field layout lookups from a list of message types
+    template<typename... MsgTypes>
+    void RegisterMessageTypes() {
+        SetLookups(&WireSizeFor<MsgTypes...>, &FieldLayoutFor<MsgTypes...>);
+    }
+
+    /// true if any stream received a packet within the timeout
+    bool IsConnected(Clock::time_point now) const;
+
+    /// Most recent receive time over all streams
+    Clock::time_point LastReceiveTime() const;
+
+    /// Parse errors over all streams
+    uint64_t ParseErrorCount() const;
+
+    HandlerExecutorMetrics GetExecutorMetrics(ExecutorId executor) const;
+
+    /// Frame pool used to hand packets to executors
+    const FrameArena& Arena() const { return m_arena; }
+
+    /// Finish queued packets and join the executor threads (also done by the destructor)
+    void Stop();
+
+private:
+    class Executor;
+
+    struct RouteEntry {
+        std::shared_ptr<const Handler> handler;   // Shared with packets queued for it
+        Executor* executor{nullptr};               // nullptr = inline
+    };
+
+    void SetLookups(StreamParser::WireSizeFn wireSize, StreamParser::FieldLayoutFn layout);
+    void RoutePacket(StreamId stream, const PacketView& packet);
+    void RouteError(StreamId stream, const StreamParser::ErrorInfo& error);
+    void RunDeferred(StreamId stream, const PacketView& packet, const std::shared_ptr<const Handler>& handler);
+    const RouteEntry* FindRoute(uint16_t id) const;
+
+    MultiStreamDispatcherConfig m_config;
+    FrameArena m_arena;
+
+    mutable std::mutex m_setupMutex;                     // Guards the stream and executor lists
+    std::vector<std::unique_ptr<Stream>> m_streams;
+    std::vector<std::unique_ptr<Executor>> m_executors;
+    StreamParser::WireSizeFn m_wireSizeFn{nullptr};
+    StreamParser::FieldLayoutFn m_fieldLayoutFn{nullptr};
+
+    mutable std::shared_mutex m_routeMutex;              // Readers: parsing and executor threads
+    std::vector<RouteEntry> m_flatRoutes;                // Indexed by type ID
+    std::unordered_map<uint16_t, RouteEntry> m_sparseRoutes;   // IDs >= PacketDispatcher::kFlatHandlerLimit
+    StreamErrorHandler m_errorHandler;
+};
+
+} // namespace bcnp
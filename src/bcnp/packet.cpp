@@ -2,7 +2,8 @@
  * @file packet.cpp
  * @brief Implementation of BCNP packet encoding and decoding functions.
  * 
- * Contains the CRC32 computation, packet view decoding, and payload size
+ * Contains the CRC32 computation (slice-by-8 with runtime-dispatched
+ * PCLMULQDQ / ARMv8 CRC paths), packet view decoding, and payload size
  * calculation. Encoding is handled by template functions in the header.
  */
 
@@ -14,19 +15,45 @@
 #include <cstring>
 #include <limits>
 
+// Hardware CRC paths are compiled in where the toolchain can target them and
+// selected at runtime. Define BCNP_CRC32_PORTABLE to force slice-by-8.
+#if !defined(BCNP_CRC32_PORTABLE) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BCNP_CRC32_X86_PCLMUL 1
+#include <immintrin.h>
+#else
+#define BCNP_CRC32_X86_PCLMUL 0
+#endif
+
+#if !defined(BCNP_CRC32_PORTABLE) && defined(__aarch64__) && defined(__linux__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BCNP_CRC32_ARM_CRC 1
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#else
+#define BCNP_CRC32_ARM_CRC 0
+#endif
+
 namespace bcnp {
 namespace {
 
+/// @brief Number of slicing tables (slice-by-8 processes 8 bytes per step).
+constexpr std::size_t kCrcSlices = 8;
+
+using CrcTables = std::array<std::array<uint32_t, 256>, kCrcSlices>;
+
 /**
- * @brief Generate CRC32 lookup table at compile time.
+ * @brief Generate CRC32 slicing tables at compile time.
  * 
  * Uses the standard CRC32 polynomial (reversed: 0xEDB88320).
- * The table is computed once at compile time using constexpr.
+ * Table 0 is the classic byte-at-a-time table; table k advances a byte
+ * through k additional zero bytes so eight input bytes can be folded
+ * with independent lookups.
  * 
- * @return 256-entry lookup table for byte-at-a-time CRC computation
+ * @return kCrcSlices x 256 lookup tables
  */
-constexpr std::array<uint32_t, 256> MakeCrcTable() {
-    std::array<uint32_t, 256> table{};
+constexpr CrcTables MakeCrcTables() {
+    CrcTables tables{};
     for (uint32_t i = 0; i < 256; ++i) {
         uint32_t crc = i;
         for (uint32_t bit = 0; bit < 8; ++bit) {
@@ -36,23 +63,208 @@ constexpr std::array<uint32_t, 256> MakeCrcTable() {
                 crc >>= 1U;
             }
         }
-        table[i] = crc;
+        tables[0][i] = crc;
+    }
+    for (std::size_t slice = 1; slice < kCrcSlices; ++slice) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            const uint32_t prev = tables[slice - 1][i];
+            tables[slice][i] = (prev >> 8U) ^ tables[0][prev & 0xFFU];
+        }
+    }
+    return tables;
+}
+
+/// @brief Compile-time CRC32 slicing tables.
+constexpr auto kCrc32Tables = MakeCrcTables();
+
+/// @brief Load 4 bytes as a little-endian word (CRC32 is bit-reflected).
+inline uint32_t LoadLe32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+/**
+ * @brief Portable slice-by-8 CRC32 update.
+ * 
+ * @param crc Running (pre-inverted) CRC state
+ * @param data Input bytes
+ * @param length Number of bytes
+ * @return Updated CRC state
+ */
+uint32_t Crc32SliceBy8(uint32_t crc, const uint8_t* data, std::size_t length) {
+    const auto& t = kCrc32Tables;
+    while (length >= 8) {
+        const uint32_t one = crc ^ LoadLe32(data);
+        const uint32_t two = LoadLe32(data + 4);
+        crc = t[7][one & 0xFFU] ^ t[6][(one >> 8U) & 0xFFU] ^
+              t[5][(one >> 16U) & 0xFFU] ^ t[4][one >> 24U] ^
+              t[3][two & 0xFFU] ^ t[2][(two >> 8U) & 0xFFU] ^
+              t[1][(two >> 16U) & 0xFFU] ^ t[0][two >> 24U];
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = (crc >> 8U) ^ t[0][(crc ^ *data++) & 0xFFU];
+    }
+    return crc;
+}
+
+using Crc32Fn = uint32_t (*)(uint32_t, const uint8_t*, std::size_t);
+
+#if BCNP_CRC32_X86_PCLMUL
+
+/// @brief Below this length folding setup costs more than it saves.
+constexpr std::size_t kCrcPclmulMinLength = 64;
+
+#define BCNP_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+
+BCNP_TARGET_PCLMUL inline __m128i LoadU128(const uint8_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+/// @brief Fold a 128-bit accumulator forward by the distance encoded in @p k and add @p next.
+BCNP_TARGET_PCLMUL inline __m128i Fold128(__m128i acc, __m128i next, __m128i k) {
+    const __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+    const __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(hi, next), lo);
+}
+
+/**
+ * @brief CRC32 using carry-less multiplication (PCLMULQDQ) folding.
+ * 
+ * Folds four 128-bit lanes per 64-byte block, reduces to 128 bits, then
+ * Barrett-reduces to 32 bits ("Fast CRC Computation for Generic Polynomials
+ * Using PCLMULQDQ", Intel). Constants are for the reflected 0xEDB88320
+ * polynomial; the sub-16-byte tail goes through slice-by-8.
+ */
+BCNP_TARGET_PCLMUL
+uint32_t Crc32Pclmul(uint32_t crc, const uint8_t* data, std::size_t length) {
+    if (length < kCrcPclmulMinLength) {
+        return Crc32SliceBy8(crc, data, length);
+    }
+
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4ULL, 0x01c6e41596ULL};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0ULL, 0x00ccaa009eULL};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124ULL, 0x0000000000ULL};
+    alignas(16) static const uint64_t poly[] = {0x01db710641ULL, 0x01f7011641ULL};
+
+    __m128i x1 = LoadU128(data + 0x00);
+    __m128i x2 = LoadU128(data + 0x10);
+    __m128i x3 = LoadU128(data + 0x20);
+    __m128i x4 = LoadU128(data + 0x30);
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    data += 64;
+    length -= 64;
+
+    // Fold four lanes in parallel
+    while (length >= 64) {
+        x1 = Fold128(x1, LoadU128(data + 0x00), x0);
+        x2 = Fold128(x2, LoadU128(data + 0x10), x0);
+        x3 = Fold128(x3, LoadU128(data + 0x20), x0);
+        x4 = Fold128(x4, LoadU128(data + 0x30), x0);
+        data += 64;
+        length -= 64;
+    }
+
+    // Fold the four lanes into one
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x1 = Fold128(x1, x2, x0);
+    x1 = Fold128(x1, x3, x0);
+    x1 = Fold128(x1, x4, x0);
+
+    while (length >= 16) {
+        x1 = Fold128(x1, LoadU128(data), x0);
+        data += 16;
+        length -= 16;
+    }
+
+    // Fold 128 bits to 64 bits
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    crc = static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+
+    return Crc32SliceBy8(crc, data, length);
+}
+
+#endif // BCNP_CRC32_X86_PCLMUL
+
+#if BCNP_CRC32_ARM_CRC
+
+/**
+ * @brief CRC32 using the ARMv8 CRC32 instructions.
+ * 
+ * CRC32X/W/H/B implement the same reflected 0x04C11DB7 polynomial as the
+ * table (not the CRC32C variant), so results are identical.
+ */
+__attribute__((target("+crc")))
+uint32_t Crc32Armv8(uint32_t crc, const uint8_t* data, std::size_t length) {
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32d(crc, word);
+        data += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = __crc32b(crc, *data++);
     }
-    return table;
+    return crc;
 }
 
-/// @brief Compile-time CRC32 lookup table.
-constexpr auto kCrc32Table = MakeCrcTable();
+#endif // BCNP_CRC32_ARM_CRC
+
+struct Crc32Impl {
+    Crc32Fn fn;
+    const char* name;
+};
+
+/// @brief Pick the fastest CRC32 implementation supported by this CPU.
+Crc32Impl SelectCrc32Impl() {
+#if BCNP_CRC32_X86_PCLMUL
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+        return {Crc32Pclmul, "pclmul"};
+    }
+#endif
+#if BCNP_CRC32_ARM_CRC
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        return {Crc32Armv8, "armv8-crc"};
+    }
+#endif
+    return {Crc32SliceBy8, "slice-by-8"};
+}
+
+const Crc32Impl& ActiveCrc32Impl() {
+    static const Crc32Impl impl = SelectCrc32Impl();
+    return impl;
+}
 
 } // namespace
 
 uint32_t ComputeCrc32(const uint8_t* data, std::size_t length) {
-    uint32_t crc = 0xFFFFFFFFU;
-    for (std::size_t i = 0; i < length; ++i) {
-        const uint8_t index = static_cast<uint8_t>((crc ^ data[i]) & 0xFFU);
-        crc = (crc >> 8U) ^ kCrc32Table[index];
-    }
-    return crc ^ 0xFFFFFFFFU;
+    return ActiveCrc32Impl().fn(0xFFFFFFFFU, data, length) ^ 0xFFFFFFFFU;
+}
+
+uint32_t UpdateCrc32(uint32_t crc, const uint8_t* data, std::size_t length) {
+    return ActiveCrc32Impl().fn(crc ^ 0xFFFFFFFFU, data, length) ^ 0xFFFFFFFFU;
+}
+
+const char* Crc32Implementation() {
+    return ActiveCrc32Impl().name;
 }
 
 std::size_t PacketView::GetPayloadSize() const {
@@ -96,6 +308,13 @@ DecodeViewResult DecodePacketViewWithSize(const uint8_t* data, std::size_t lengt
         return result;
     }
 
+    // Variable-length payload: framed by DecodeCompressedPacketView() instead
+    if (header.flags & kFlagCompressed) {
+        result.error = PacketError::InvalidCompression;
+        result.bytesConsumed = 1;
+        return result;
+    }
+
     if (header.messageCount > kMaxMessagesPerPacket) {
         result.error = PacketError::TooManyMessages;
         result.bytesConsumed = 1;
@@ -131,6 +350,196 @@ DecodeViewResult DecodePacketViewWithSize(const uint8_t* data, std::size_t lengt
     return result;
 }
 
+namespace {
+
+/// Value of a big-endian field of @p width bytes
+uint64_t LoadField(const uint8_t* data, std::size_t width) {
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < width; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+void StoreField(uint64_t value, std::size_t width, uint8_t* out) {
+    for (std::size_t i = width; i-- > 0;) {
+        out[i] = static_cast<uint8_t>(value);
+        value >>= 8;
+    }
+}
+
+uint64_t FieldMaskFor(std::size_t width) {
+    return width >= 8 ? ~uint64_t{0} : (uint64_t{1} << (width * 8)) - 1;
+}
+
+} // namespace
+
+/**
+ * @brief Delta-encode one message against the previous one.
+ * 
+ * Each field difference wraps at the field width and is sign-extended
+ * from it, so a counter that wraps costs one byte, not five.
+ * 
+ * @param wire Fixed-width message bytes
+ * @param previous Previous message bytes, or nullptr to encode against zero
+ * @param layout Field widths
+ * @param out Destination (MaxCompressedMessageSize(layout) bytes)
+ * @return Bytes written
+ */
+std::size_t CompressMessage(const uint8_t* wire, const uint8_t* previous, FieldLayout layout, uint8_t* out) {
+    std::size_t written = 0;
+    std::size_t offset = 0;
+    for (std::size_t f = 0; f < layout.count; ++f) {
+        const std::size_t width = layout.widths[f];
+        const unsigned bits = static_cast<unsigned>(width * 8);
+        const uint64_t current = LoadField(wire + offset, width);
+        const uint64_t prior = previous ? LoadField(previous + offset, width) : 0;
+        uint64_t delta = (current - prior) & FieldMaskFor(width);
+        // Sign-extend from the field width, then zigzag
+        int64_t signedDelta = static_cast<int64_t>(delta << (64 - bits)) >> (64 - bits);
+        uint64_t zigzag = (static_cast<uint64_t>(signedDelta) << 1) ^ static_cast<uint64_t>(signedDelta >> 63);
+        zigzag &= FieldMaskFor(width);
+        while (zigzag >= 0x80) {
+            out[written++] = static_cast<uint8_t>(zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        out[written++] = static_cast<uint8_t>(zigzag);
+        offset += width;
+    }
+    return written;
+}
+
+/**
+ * @brief Expand a compressed payload to fixed-width wire bytes.
+ * 
+ * Rejects non-minimal varints, varints longer than the field allows and
+ * values with bits beyond the field width, so every valid payload has
+ * exactly one encoding.
+ * 
+ * @param data Compressed payload
+ * @param length Compressed payload length
+ * @param messageCount Messages to expand
+ * @param layout Field widths
+ * @param out Destination (messageCount * sum(widths) bytes)
+ * @return true if exactly @p length bytes expanded to @p messageCount messages
+ */
+bool ExpandCompressedPayload(const uint8_t* data, std::size_t length, std::size_t messageCount,
+                             FieldLayout layout, uint8_t* out) {
+    if (layout.count == 0) {
+        return false;
+    }
+    std::size_t wireSize = 0;
+    for (std::size_t f = 0; f < layout.count; ++f) {
+        wireSize += layout.widths[f];
+    }
+
+    std::size_t pos = 0;
+    const uint8_t* previous = nullptr;
+    for (std::size_t m = 0; m < messageCount; ++m) {
+        uint8_t* current = out + m * wireSize;
+        std::size_t offset = 0;
+        for (std::size_t f = 0; f < layout.count; ++f) {
+            const std::size_t width = layout.widths[f];
+            const uint64_t mask = FieldMaskFor(width);
+            uint64_t zigzag = 0;
+            unsigned shift = 0;
+            while (true) {
+                if (pos == length || shift >= width * 8) {
+                    return false;
+                }
+                const uint8_t byte = data[pos++];
+                if (byte == 0 && shift != 0) {
+                    return false;   // Zero continuation: non-minimal varint
+                }
+                zigzag |= uint64_t{byte & 0x7Fu} << shift;
+                shift += 7;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            if ((zigzag & ~mask) != 0) {
+                return false;
+            }
+            // Undo the zigzag within the field width: the result wraps modulo 2^bits
+            const uint64_t delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+            const uint64_t prior = previous ? LoadField(previous + offset, width) : 0;
+            StoreField((prior + delta) & mask, width, current + offset);
+            offset += width;
+        }
+        previous = current;
+    }
+    return pos == length;
+}
+
+/**
+ * @brief Validate and expand a kFlagCompressed frame.
+ * 
+ * @param data Raw frame bytes
+ * @param length Available bytes
+ * @param wireSize Fixed-width message size
+ * @param layout Field widths (sum must equal @p wireSize)
+ * @param expandBuffer Destination for the expanded payload
+ * @param expandCapacity Size of @p expandBuffer
+ * @return DecodeViewResult with a view into @p expandBuffer on success
+ */
+DecodeViewResult DecodeCompressedPacketView(const uint8_t* data, std::size_t length, std::size_t wireSize,
+                                            FieldLayout layout, uint8_t* expandBuffer,
+                                            std::size_t expandCapacity) {
+    DecodeViewResult result{};
+    constexpr std::size_t kPrefixSize = kHeaderSizeV3 + kCompressedLengthSize;
+    if (length < kPrefixSize) {
+        result.error = PacketError::TooSmall;
+        return result;
+    }
+
+    PacketHeader header;
+    header.major = data[kHeaderMajorIndex];
+    header.minor = data[kHeaderMinorIndex];
+    header.flags = data[kHeaderFlagsIndex];
+    header.messageType = static_cast<MessageTypeId>(detail::LoadU16(&data[kHeaderMsgTypeIndex]));
+    header.messageCount = detail::LoadU16(&data[kHeaderMsgCountIndex]);
+
+    if (header.major != kProtocolMajorV3 || header.minor != kProtocolMinorV3) {
+        result.error = PacketError::UnsupportedVersion;
+        result.bytesConsumed = 1;
+        return result;
+    }
+
+    const std::size_t compressedLength = detail::LoadU16(&data[kHeaderSizeV3]);
+    const std::size_t payloadEnd = kPrefixSize + compressedLength;
+    const std::size_t expectedSize = payloadEnd + kChecksumSize;
+    if (length < expectedSize) {
+        result.error = PacketError::Truncated;
+        return result;
+    }
+
+    if (detail::LoadU32(&data[payloadEnd]) != ComputeCrc32(data, payloadEnd)) {
+        result.error = PacketError::ChecksumMismatch;
+        result.bytesConsumed = expectedSize;
+        return result;
+    }
+
+    std::size_t layoutSize = 0;
+    for (std::size_t f = 0; f < layout.count; ++f) {
+        layoutSize += layout.widths[f];
+    }
+    const std::size_t expandedSize = std::size_t{header.messageCount} * wireSize;
+    result.bytesConsumed = expectedSize;
+    if (layout.count == 0 || layoutSize != wireSize || !expandBuffer || expandedSize > expandCapacity ||
+        !ExpandCompressedPayload(&data[kPrefixSize], compressedLength, header.messageCount, layout,
+                                 expandBuffer)) {
+        result.error = PacketError::InvalidCompression;
+        return result;
+    }
+
+    header.flags = static_cast<uint8_t>(header.flags & ~kFlagCompressed);
+    PacketView view;
+    view.header = header;
+    view.payload = crab::Slice<const uint8_t>(expandBuffer, expandedSize);
+    result.view = crab::Some(view);
+    return result;
+}
+
 /**
  * @brief Decode a packet using the global message type registry.
  * 
@@ -18,6 +18,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace bcnp {
@@ -37,6 +40,24 @@ constexpr std::size_t kMaxMessagesPerPacket = 65535;
 /** @brief Packet flag: Clear command queue before processing this packet. */
 constexpr uint8_t kFlagClearQueue = 0x01;
 
+/** @brief Packet flag: payload uses the compressed (delta + zigzag varint) encoding. */
+constexpr uint8_t kFlagCompressed = 0x02;
+
+/**
+ * @brief Packet flag: the sender decodes compressed packets.
+ * 
+ * Capability advertisement: only send kFlagCompressed packets to a peer
+ * whose packets carry this bit (StreamParser::PeerAcceptsCompressed()).
+ * Peers that predate it ignore unknown flag bits. EncodeCompressedTypedPacket()
+ * always sets it; to advertise from a peer that sends only uncompressed
+ * packets, pass it as extraFlags to SendTypedPacket() or enable
+ * DispatcherDriver::SetAdvertiseCompressed().
+ */
+constexpr uint8_t kFlagAcceptsCompressed = 0x04;
+
+/** @brief Size of the compressed payload length that follows the header. */
+constexpr std::size_t kCompressedLengthSize = 2;
+
 /** @brief Current protocol major version. */
 constexpr uint8_t kProtocolMajor = kProtocolMajorV3;
 
@@ -81,19 +102,44 @@ struct PacketHeader {
     uint16_t messageCount{0};                  ///< Number of messages in payload
 };
 
+namespace detail {
+
+/// Message types with generated DecodeUnchecked()/EncodeUnchecked()
+template<typename, typename = void>
+struct has_unchecked_codec : std::false_type {};
+
+template<typename MsgType>
+struct has_unchecked_codec<MsgType, std::void_t<
+    decltype(MsgType::DecodeUnchecked(std::declval<const uint8_t*>())),
+    decltype(std::declval<const MsgType&>().EncodeUnchecked(std::declval<uint8_t*>()))>>
+    : std::true_type {};
+
+/// Decode one message of kWireSize bytes; default-constructed on failure
+template<typename MsgType>
+MsgType DecodeOne(const uint8_t* data) {
+    if constexpr (has_unchecked_codec<MsgType>::value) {
+        return MsgType::DecodeUnchecked(data);
+    } else {
+        return MsgType::Decode(data, MsgType::kWireSize).value_or(MsgType{});
+    }
+}
+
+} // namespace detail
+
 /**
  * @brief Forward iterator for zero-copy message access from packet payload.
  * 
  * Allows iterating over messages in a PacketView without copying them to
- * intermediate storage. Each dereference decodes the message on-the-fly
- * from the raw wire bytes.
+ * intermediate storage. The current message is decoded from the raw wire
+ * bytes on first access and cached in the iterator, so `*it` and `it->`
+ * return references that stay valid until the iterator is advanced.
  * 
  * @tparam MsgType The message struct type (must have Decode() and kWireSize)
  * 
  * @code{cpp}
  * for (auto it = view.begin_as<DriveCmd>(); it != view.end_as<DriveCmd>(); ++it) {
- *     DriveCmd cmd = *it;  // Decoded on access
- *     // Process cmd...
+ *     const DriveCmd& cmd = *it;  // Decoded on access
+ *     // Process cmd, or read it->vx directly...
  * }
  * @endcode
  */
@@ -104,7 +150,7 @@ public:
     using value_type = MsgType;
     using difference_type = std::ptrdiff_t;
     using pointer = const MsgType*;
-    using reference = MsgType;
+    using reference = const MsgType&;
 
     /**
      * @brief Construct iterator at a position in the payload.
@@ -115,12 +161,20 @@ public:
         : m_ptr(ptr), m_count(count) {}
 
     /**
-     * @brief Decode and return the current message.
+     * @brief Decode (once) and return the current message.
      * @return Decoded message, or default-constructed MsgType on decode failure
      */
-    MsgType operator*() const {
-        auto result = MsgType::Decode(m_ptr, MsgType::kWireSize);
-        return result.value_or(MsgType{});
+    const MsgType& operator*() const {
+        if (!m_decoded) {
+            m_cache = detail::DecodeOne<MsgType>(m_ptr);
+            m_decoded = true;
+        }
+        return m_cache;
+    }
+
+    /** @brief Member access to the current message. */
+    const MsgType* operator->() const {
+        return &**this;
     }
 
     /** @brief Advance to the next message (pre-increment). */
@@ -132,6 +186,7 @@ public:
         if (m_count == 0) {
             m_ptr = nullptr;
         }
+        m_decoded = false;
         return *this;
     }
 
@@ -156,6 +211,8 @@ public:
 private:
     const uint8_t* m_ptr;   ///< Current position in payload buffer
     std::size_t m_count;     ///< Remaining messages from current position
+    mutable MsgType m_cache{};        ///< Message at m_ptr once m_decoded is set
+    mutable bool m_decoded{false};
 };
 
 /**
@@ -285,7 +342,8 @@ enum class PacketError {
     ChecksumMismatch,       ///< CRC32 validation failed
     UnknownMessageType,     ///< Message type ID not in registry
     HandshakeRequired,      ///< Connection requires handshake first
-    SchemaMismatch          ///< Client/server schema hash mismatch
+    SchemaMismatch,         ///< Client/server schema hash mismatch
+    InvalidCompression      ///< Compressed payload malformed, or no field layout to expand it
 };
 
 /**
@@ -306,6 +364,7 @@ struct DecodeViewResult {
  * 
  * Uses the standard CRC32 polynomial (0xEDB88320) with initial value
  * of 0xFFFFFFFF and final XOR. Compatible with common CRC32 implementations.
+ * Dispatches at runtime to a hardware-accelerated path when available.
  * 
  * @param data Pointer to data buffer
  * @param length Number of bytes to checksum
@@ -313,6 +372,56 @@ struct DecodeViewResult {
  */
 uint32_t ComputeCrc32(const uint8_t* data, std::size_t length);
 
+/**
+ * @brief Extend a CRC32 over more data, for checksums computed in pieces.
+ * 
+ * UpdateCrc32(UpdateCrc32(0, a, n), b, m) equals ComputeCrc32() over the
+ * concatenation of a and b.
+ * 
+ * @param crc CRC32 of the data so far (0 for none)
+ * @param data Pointer to the next bytes
+ * @param length Number of bytes
+ * @return CRC32 of everything so far
+ */
+uint32_t UpdateCrc32(uint32_t crc, const uint8_t* data, std::size_t length);
+
+/**
+ * @brief Name of the CRC32 implementation selected for this CPU.
+ * 
+ * One of "pclmul" (x86-64), "armv8-crc" (aarch64) or "slice-by-8"
+ * (portable). All produce identical checksums.
+ * 
+ * @return Static string naming the active implementation
+ */
+const char* Crc32Implementation();
+
+namespace detail {
+
+/// Message types with generated DecodeBatch()/EncodeBatch() block codecs
+template<typename, typename = void>
+struct has_batch_codec : std::false_type {};
+
+template<typename MsgType>
+struct has_batch_codec<MsgType, std::void_t<
+    decltype(MsgType::DecodeBatch(std::declval<const uint8_t*>(), std::size_t{}, std::declval<MsgType*>())),
+    decltype(MsgType::EncodeBatch(std::declval<const MsgType*>(), std::size_t{}, std::declval<uint8_t*>()))>>
+    : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @brief Wire size of a typed packet: header, messages, and CRC32.
+ * 
+ * @tparam MsgType Message struct type with kWireSize
+ * @tparam Storage Container type holding the messages
+ * @param packet The packet to size
+ * @return Number of bytes EncodeTypedPacket() will write
+ */
+template<typename MsgType, typename Storage>
+constexpr std::size_t EncodedPacketSize(const TypedPacket<MsgType, Storage>& packet) {
+    return kHeaderSizeV3 + packet.messages.size() * MsgType::kWireSize + kChecksumSize;
+}
+
 /**
  * @brief Encode a typed packet to a pre-allocated buffer.
  * 
@@ -325,18 +434,19 @@ uint32_t ComputeCrc32(const uint8_t* data, std::size_t length);
  * @param output Destination buffer (must have sufficient capacity)
  * @param capacity Size of output buffer in bytes
  * @param[out] bytesWritten Number of bytes written on success
+ * @param extraFlags Flags ORed into the header on top of packet.header.flags
  * @return true if encoding succeeded, false if capacity insufficient or encoding failed
  */
 template<typename MsgType, typename Storage>
 bool EncodeTypedPacket(const TypedPacket<MsgType, Storage>& packet, uint8_t* output, 
-                       std::size_t capacity, std::size_t& bytesWritten) {
+                       std::size_t capacity, std::size_t& bytesWritten, uint8_t extraFlags = 0) {
     bytesWritten = 0;
     if (packet.messages.size() > kMaxMessagesPerPacket || !output) {
         return false;
     }
 
-    const std::size_t payloadSize = kHeaderSizeV3 + packet.messages.size() * MsgType::kWireSize;
-    const std::size_t required = payloadSize + kChecksumSize;
+    const std::size_t required = EncodedPacketSize(packet);
+    const std::size_t payloadSize = required - kChecksumSize;
     if (capacity < required) {
         return false;
     }
@@ -344,17 +454,24 @@ bool EncodeTypedPacket(const TypedPacket<MsgType, Storage>& packet, uint8_t* out
     // V3 Header
     output[kHeaderMajorIndex] = packet.header.major;
     output[kHeaderMinorIndex] = packet.header.minor;
-    output[kHeaderFlagsIndex] = packet.header.flags;
+    output[kHeaderFlagsIndex] = static_cast<uint8_t>(packet.header.flags | extraFlags);
     detail::StoreU16(static_cast<uint16_t>(MsgType::kTypeId), &output[kHeaderMsgTypeIndex]);
     detail::StoreU16(static_cast<uint16_t>(packet.messages.size()), &output[kHeaderMsgCountIndex]);
 
     // Encode messages
-    std::size_t offset = kHeaderSizeV3;
-    for (const auto& msg : packet.messages) {
-        if (!msg.Encode(&output[offset], MsgType::kWireSize)) {
+    if constexpr (detail::has_batch_codec<MsgType>::value &&
+                  detail::has_contiguous_data<const Storage>::value) {
+        if (!MsgType::EncodeBatch(packet.messages.data(), packet.messages.size(), &output[kHeaderSizeV3])) {
             return false;
         }
-        offset += MsgType::kWireSize;
+    } else {
+        std::size_t offset = kHeaderSizeV3;
+        for (const auto& msg : packet.messages) {
+            if (!msg.Encode(&output[offset], MsgType::kWireSize)) {
+                return false;
+            }
+            offset += MsgType::kWireSize;
+        }
     }
 
     // CRC32
@@ -375,23 +492,279 @@ bool EncodeTypedPacket(const TypedPacket<MsgType, Storage>& packet, uint8_t* out
  * @tparam Storage Container type holding the messages
  * @param packet The packet to encode
  * @param[out] output Vector to receive encoded bytes (resized automatically)
+ * @param extraFlags Flags ORed into the header on top of packet.header.flags
  * @return true if encoding succeeded, false on encoding failure
  */
 template<typename MsgType, typename Storage>
-bool EncodeTypedPacket(const TypedPacket<MsgType, Storage>& packet, std::vector<uint8_t>& output) {
+bool EncodeTypedPacket(const TypedPacket<MsgType, Storage>& packet, std::vector<uint8_t>& output,
+                       uint8_t extraFlags = 0) {
+    if (packet.messages.size() > kMaxMessagesPerPacket) {
+        return false;
+    }
+    output.resize(EncodedPacketSize(packet));
+    std::size_t bytesWritten = 0;
+    if (!EncodeTypedPacket(packet, output.data(), output.size(), bytesWritten, extraFlags)) {
+        return false;
+    }
+    output.resize(bytesWritten);
+    return true;
+}
+
+/**
+ * @brief Wire size of a packet carrying @p messageCount messages of MsgType.
+ */
+template<typename MsgType>
+constexpr std::size_t PacketSizeFor(std::size_t messageCount) {
+    return kHeaderSizeV3 + messageCount * MsgType::kWireSize + kChecksumSize;
+}
+
+/**
+ * @brief Encode one packet from messages held in up to two contiguous spans.
+ *
+ * For ring-buffered producers (TelemetryAccumulator): the spans are encoded
+ * back to back, in order, without first gathering them into a TypedPacket.
+ *
+ * @tparam MsgType Message struct type with Encode() and kWireSize
+ * @param first First span of messages
+ * @param firstCount Number of messages in @p first
+ * @param second Second span (may be null when @p secondCount is 0)
+ * @param secondCount Number of messages in @p second
+ * @param flags Header flags byte
+ * @param output Destination buffer
+ * @param capacity Size of output buffer in bytes
+ * @param[out] bytesWritten Number of bytes written on success
+ * @return true on success, false if capacity insufficient or encoding failed
+ */
+template<typename MsgType>
+bool EncodePacketFromSpans(const MsgType* first, std::size_t firstCount,
+                           const MsgType* second, std::size_t secondCount,
+                           uint8_t flags, uint8_t* output, std::size_t capacity,
+                           std::size_t& bytesWritten) {
+    bytesWritten = 0;
+    const std::size_t count = firstCount + secondCount;
+    const std::size_t required = PacketSizeFor<MsgType>(count);
+    if (count > kMaxMessagesPerPacket || !output || capacity < required) {
+        return false;
+    }
+
+    output[kHeaderMajorIndex] = kProtocolMajorV3;
+    output[kHeaderMinorIndex] = kProtocolMinorV3;
+    output[kHeaderFlagsIndex] = flags;
+    detail::StoreU16(static_cast<uint16_t>(MsgType::kTypeId), &output[kHeaderMsgTypeIndex]);
+    detail::StoreU16(static_cast<uint16_t>(count), &output[kHeaderMsgCountIndex]);
+
+    uint8_t* out = &output[kHeaderSizeV3];
+    const auto encodeSpan = [&out](const MsgType* messages, std::size_t n) {
+        if constexpr (detail::has_batch_codec<MsgType>::value) {
+            if (n > 0 && !MsgType::EncodeBatch(messages, n, out)) {
+                return false;
+            }
+            out += n * MsgType::kWireSize;
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!messages[i].Encode(out, MsgType::kWireSize)) {
+                    return false;
+                }
+                out += MsgType::kWireSize;
+            }
+        }
+        return true;
+    };
+    if (!encodeSpan(first, firstCount) || !encodeSpan(second, secondCount)) {
+        return false;
+    }
+
+    const std::size_t payloadSize = required - kChecksumSize;
+    detail::StoreU32(ComputeCrc32(output, payloadSize), &output[payloadSize]);
+    bytesWritten = required;
+    return true;
+}
+
+/**
+ * @defgroup CompressedEncoding Compressed Payload Encoding
+ * @brief Delta + zigzag varint payloads for slowly changing batches.
+ * 
+ * With kFlagCompressed the header is followed by a u16 payload length and
+ * the payload holds, for each message and each field in wire order, the
+ * difference from the same field of the previous message (the first
+ * message is relative to zero). Differences wrap at the field width, are
+ * zigzag mapped and written as LEB128 varints. The CRC covers the header,
+ * the length and the compressed bytes. Encoder positions and timestamps
+ * that move a little per message shrink from 4 bytes to 1 or 2.
+ * 
+ * StreamParser expands compressed frames before dispatch, so handlers
+ * always see a fixed-width payload.
+ * @{
+ */
+
+/** @brief Largest compressed size of one message: ceil(8 * width / 7) bytes per field. */
+constexpr std::size_t MaxCompressedMessageSize(FieldLayout layout) {
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < layout.count; ++i) {
+        size += (std::size_t{layout.widths[i]} * 8 + 6) / 7;
+    }
+    return size;
+}
+
+/** @brief Field layout of a generated message type. */
+template<typename MsgType>
+constexpr FieldLayout FieldLayoutOf() {
+    return {MsgType::kFieldWidths.data(), MsgType::kFieldWidths.size()};
+}
+
+/** @brief Field layout lookup over a list of message types (for StreamParser::SetFieldLayoutFunction). */
+template<typename First, typename... Rest>
+FieldLayout FieldLayoutFor(MessageTypeId typeId) {
+    if (typeId == First::kTypeId) {
+        return FieldLayoutOf<First>();
+    }
+    if constexpr (sizeof...(Rest) > 0) {
+        return FieldLayoutFor<Rest...>(typeId);
+    }
+    return {};
+}
+
+/** @brief Wire size lookup over a list of message types (for StreamParser::SetWireSizeFunction). */
+template<typename First, typename... Rest>
+std::size_t WireSizeFor(MessageTypeId typeId) {
+    if (typeId == First::kTypeId) {
+        return First::kWireSize;
+    }
+    if constexpr (sizeof...(Rest) > 0) {
+        return WireSizeFor<Rest...>(typeId);
+    }
+    return 0;
+}
+
+/** @brief Upper bound on the size of a compressed packet of @p messageCount messages. */
+template<typename MsgType>
+constexpr std::size_t MaxCompressedPacketSize(std::size_t messageCount) {
+    return kHeaderSizeV3 + kCompressedLengthSize +
+           messageCount * MaxCompressedMessageSize(FieldLayoutOf<MsgType>()) + kChecksumSize;
+}
+
+/**
+ * @brief Delta-encode one message's wire bytes.
+ * 
+ * @param wire Fixed-width encoding of the message
+ * @param previous Previous message in the batch (nullptr for the first)
+ * @param layout Field widths of the message type
+ * @param out Destination, at least MaxCompressedMessageSize(layout) bytes
+ * @return Bytes written
+ */
+std::size_t CompressMessage(const uint8_t* wire, const uint8_t* previous, FieldLayout layout, uint8_t* out);
+
+/**
+ * @brief Expand a compressed payload back to fixed-width wire bytes.
+ * 
+ * @param data Compressed payload
+ * @param length Compressed payload length (must be consumed exactly)
+ * @param messageCount Messages to expand
+ * @param layout Field widths of the message type
+ * @param out Destination, messageCount * sum(widths) bytes
+ * @return false if the payload is truncated, has trailing bytes or a
+ *         varint does not fit its field
+ */
+bool ExpandCompressedPayload(const uint8_t* data, std::size_t length, std::size_t messageCount,
+                             FieldLayout layout, uint8_t* out);
+
+/**
+ * @brief Validate a compressed frame and expand it into @p expandBuffer.
+ * 
+ * The returned view's payload points into @p expandBuffer and its header
+ * has kFlagCompressed cleared.
+ * 
+ * @param data Raw frame bytes (header, length, payload, CRC)
+ * @param length Number of bytes available
+ * @param wireSize Fixed-width size of one message
+ * @param layout Field widths of the message type (sum must equal wireSize)
+ * @param expandBuffer Destination for the expanded payload
+ * @param expandCapacity Size of @p expandBuffer
+ * @return DecodeViewResult; bytesConsumed is the frame length once known
+ */
+DecodeViewResult DecodeCompressedPacketView(const uint8_t* data, std::size_t length, std::size_t wireSize,
+                                            FieldLayout layout, uint8_t* expandBuffer,
+                                            std::size_t expandCapacity);
+
+/**
+ * @brief Encode a typed packet with the compressed payload encoding.
+ * 
+ * Sets kFlagCompressed and kFlagAcceptsCompressed on top of the packet's
+ * own flags. Only send to peers that advertised kFlagAcceptsCompressed.
+ * 
+ * @param packet The packet to encode
+ * @param output Destination buffer (MaxCompressedPacketSize() always suffices)
+ * @param capacity Size of output buffer in bytes
+ * @param[out] bytesWritten Number of bytes written on success
+ * @return false if capacity is insufficient, the payload exceeds 65535
+ *         bytes or a message fails to encode
+ */
+template<typename MsgType, typename Storage>
+bool EncodeCompressedTypedPacket(const TypedPacket<MsgType, Storage>& packet, uint8_t* output,
+                                 std::size_t capacity, std::size_t& bytesWritten) {
+    constexpr FieldLayout kLayout = FieldLayoutOf<MsgType>();
+    constexpr std::size_t kMaxMessage = MaxCompressedMessageSize(kLayout);
+    constexpr std::size_t kPayloadStart = kHeaderSizeV3 + kCompressedLengthSize;
+
+    bytesWritten = 0;
+    if (packet.messages.size() > kMaxMessagesPerPacket || !output) {
+        return false;
+    }
+
+    uint8_t wire[2][MsgType::kWireSize];
+    uint8_t compressed[kMaxMessage];
+    std::size_t offset = kPayloadStart;
+    std::size_t index = 0;
+    for (const auto& msg : packet.messages) {
+        uint8_t* current = wire[index & 1];
+        if (!msg.Encode(current, MsgType::kWireSize)) {
+            return false;
+        }
+        const uint8_t* previous = index > 0 ? wire[(index - 1) & 1] : nullptr;
+        const std::size_t size = CompressMessage(current, previous, kLayout, compressed);
+        if (capacity < offset + size + kChecksumSize) {
+            return false;
+        }
+        std::memcpy(&output[offset], compressed, size);
+        offset += size;
+        ++index;
+    }
+
+    const std::size_t payloadLength = offset - kPayloadStart;
+    if (payloadLength > 0xFFFF || capacity < offset + kChecksumSize) {
+        return false;
+    }
+    output[kHeaderMajorIndex] = packet.header.major;
+    output[kHeaderMinorIndex] = packet.header.minor;
+    output[kHeaderFlagsIndex] = packet.header.flags | kFlagCompressed | kFlagAcceptsCompressed;
+    detail::StoreU16(static_cast<uint16_t>(MsgType::kTypeId), &output[kHeaderMsgTypeIndex]);
+    detail::StoreU16(static_cast<uint16_t>(packet.messages.size()), &output[kHeaderMsgCountIndex]);
+    detail::StoreU16(static_cast<uint16_t>(payloadLength), &output[kHeaderSizeV3]);
+    detail::StoreU32(ComputeCrc32(output, offset), &output[offset]);
+
+    bytesWritten = offset + kChecksumSize;
+    return true;
+}
+
+/**
+ * @brief Encode a compressed typed packet into a dynamically-sized vector.
+ */
+template<typename MsgType, typename Storage>
+bool EncodeCompressedTypedPacket(const TypedPacket<MsgType, Storage>& packet, std::vector<uint8_t>& output) {
     if (packet.messages.size() > kMaxMessagesPerPacket) {
         return false;
     }
-    const std::size_t required = kHeaderSizeV3 + packet.messages.size() * MsgType::kWireSize + kChecksumSize;
-    output.resize(required);
+    output.resize(MaxCompressedPacketSize<MsgType>(packet.messages.size()));
     std::size_t bytesWritten = 0;
-    if (!EncodeTypedPacket(packet, output.data(), output.size(), bytesWritten)) {
+    if (!EncodeCompressedTypedPacket(packet, output.data(), output.size(), bytesWritten)) {
         return false;
     }
     output.resize(bytesWritten);
     return true;
 }
 
+/** @} */ // end of CompressedEncoding
+
 /**
  * @brief Decode messages from a PacketView into a typed packet.
  * 
@@ -410,9 +783,28 @@ crab::Option<TypedPacket<MsgType>> DecodeTypedPacket(const PacketView& view) {
     
     TypedPacket<MsgType> packet;
     packet.header = view.header;
-    packet.messages.reserve(view.header.messageCount);
     
+    if constexpr (detail::has_batch_codec<MsgType>::value) {
+        if (view.payload.size() < std::size_t{view.header.messageCount} * MsgType::kWireSize) {
+            return crab::None;
+        }
+        packet.messages.resize(view.header.messageCount);
+        MsgType::DecodeBatch(view.payload.data(), packet.messages.size(), packet.messages.data());
+        return crab::Some(std::move(packet));
+    }
+    
+    packet.messages.reserve(view.header.messageCount);
     const uint8_t* ptr = view.payload.data();
+    if constexpr (detail::has_unchecked_codec<MsgType>::value) {
+        if (view.payload.size() < std::size_t{view.header.messageCount} * MsgType::kWireSize) {
+            return crab::None;
+        }
+        for (std::size_t i = 0; i < view.header.messageCount; ++i) {
+            packet.messages.push_back(MsgType::DecodeUnchecked(ptr));
+            ptr += MsgType::kWireSize;
+        }
+        return crab::Some(std::move(packet));
+    }
     for (std::size_t i = 0; i < view.header.messageCount; ++i) {
         auto msg = MsgType::Decode(ptr, MsgType::kWireSize);
         if (!msg) {
@@ -444,9 +836,31 @@ crab::Option<TypedPacket<MsgType, Storage>> DecodeTypedPacketAs(const PacketView
     
     TypedPacket<MsgType, Storage> packet;
     packet.header = view.header;
-    ReserveIfPossible(packet.messages, view.header.messageCount);
     
+    if constexpr (detail::has_batch_codec<MsgType>::value &&
+                  detail::has_resize<Storage>::value &&
+                  detail::has_contiguous_data<Storage>::value) {
+        if (view.payload.size() < std::size_t{view.header.messageCount} * MsgType::kWireSize) {
+            return crab::None;
+        }
+        // resize() throws on overflow for StaticVector, matching push_back()
+        packet.messages.resize(view.header.messageCount);
+        MsgType::DecodeBatch(view.payload.data(), packet.messages.size(), packet.messages.data());
+        return crab::Some(std::move(packet));
+    }
+    
+    ReserveIfPossible(packet.messages, view.header.messageCount);
     const uint8_t* ptr = view.payload.data();
+    if constexpr (detail::has_unchecked_codec<MsgType>::value) {
+        if (view.payload.size() < std::size_t{view.header.messageCount} * MsgType::kWireSize) {
+            return crab::None;
+        }
+        for (std::size_t i = 0; i < view.header.messageCount; ++i) {
+            packet.messages.push_back(MsgType::DecodeUnchecked(ptr));
+            ptr += MsgType::kWireSize;
+        }
+        return crab::Some(std::move(packet));
+    }
     for (std::size_t i = 0; i < view.header.messageCount; ++i) {
         auto msg = MsgType::Decode(ptr, MsgType::kWireSize);
         if (!msg) {
@@ -459,6 +873,38 @@ crab::Option<TypedPacket<MsgType, Storage>> DecodeTypedPacketAs(const PacketView
     return crab::Some(std::move(packet));
 }
 
+/**
+ * @brief Decode selected fields of a packet into structure-of-arrays columns.
+ *
+ * Fills one contiguous vector per selected field of the generated
+ * `<MsgType>Columns` container. Unselected columns are left empty and their
+ * loads and dequantization are skipped entirely. Column capacity is reused
+ * across calls, so steady-state decoding does not allocate.
+ *
+ * @code{cpp}
+ * DrivetrainStateColumns cols;
+ * DecodeColumns(view, cols, DrivetrainStateColumns::kLeftPos | DrivetrainStateColumns::kTimestampMs);
+ * @endcode
+ *
+ * @tparam Columns Generated columns type (e.g., DrivetrainStateColumns)
+ * @param view Validated packet view to decode from
+ * @param[out] columns Destination columns (previous contents replaced)
+ * @param fields FieldMask of columns to decode (kAllFields for all)
+ * @return false on message type mismatch or short payload (columns cleared)
+ */
+template<typename Columns>
+bool DecodeColumns(const PacketView& view, Columns& columns, FieldMask fields = kAllFields) {
+    using MsgType = typename Columns::Message;
+    const std::size_t count = view.header.messageCount;
+    if (view.header.messageType != MsgType::kTypeId ||
+        view.payload.size() < count * MsgType::kWireSize) {
+        columns.clear();
+        return false;
+    }
+    columns.Assign(view.payload.data(), count, fields);
+    return true;
+}
+
 /**
  * @brief Decode packet view with explicit wire size.
  * 
@@ -65,6 +65,21 @@ template<typename T>
 struct has_subscript<T, std::void_t<decltype(std::declval<T>()[std::size_t{}])>> 
     : std::true_type {};
 
+template<typename, typename = void>
+struct has_resize : std::false_type {};
+
+template<typename T>
+struct has_resize<T, std::void_t<decltype(std::declval<T>().resize(std::size_t{}))>> 
+    : std::true_type {};
+
+/// Contiguous storage exposing data() as a pointer to value_type
+template<typename, typename = void>
+struct has_contiguous_data : std::false_type {};
+
+template<typename T>
+struct has_contiguous_data<T, std::enable_if_t<std::is_pointer_v<decltype(std::declval<T&>().data())>>> 
+    : std::true_type {};
+
 } // namespace detail
 
 /**
@@ -113,6 +128,15 @@ using StaticPacketStorage = StaticVector<T, Capacity>;
 template<typename T>
 using DefaultRealtimeStorage = StaticPacketStorage<T, 64>;
 
+/**
+ * @brief Fixed capacity of a storage type (0 = grows on demand).
+ */
+template<typename Container>
+struct StaticCapacity : std::integral_constant<std::size_t, 0> {};
+
+template<typename T, std::size_t Capacity>
+struct StaticCapacity<StaticVector<T, Capacity>> : std::integral_constant<std::size_t, Capacity> {};
+
 /**
  * @brief Helper to reserve capacity (no-op for static storage).
  * 
@@ -0,0 +1,159 @@
+/**
+ * @file realtime.cpp
+ * @brief Implementation of the memory locking helpers.
+ */
+
+#include "bcnp/realtime.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BCNP_REALTIME_HAS_MLOCK 1
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace bcnp {
+
+bool LockAllMemory() {
+#if defined(BCNP_REALTIME_HAS_MLOCK)
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << "LockAllMemory: mlockall failed errno=" << errno << std::endl;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool LockMemory(const void* data, std::size_t length) {
+#if defined(BCNP_REALTIME_HAS_MLOCK)
+    if (::mlock(data, length) != 0) {
+        std::cerr << "LockMemory: mlock failed errno=" << errno << std::endl;
+        return false;
+    }
+    return true;
+#else
+    (void)data;
+    (void)length;
+    return false;
+#endif
+}
+
+void UnlockMemory(const void* data, std::size_t length) {
+#if defined(BCNP_REALTIME_HAS_MLOCK)
+    ::munlock(data, length);
+#else
+    (void)data;
+    (void)length;
+#endif
+}
+
+/**
+ * @brief Write a stack array so its pages are mapped before the loop runs.
+ *
+ * The empty asm statement takes the array's address and clobbers memory, so
+ * the compiler has to keep the writes (a volatile array trips
+ * -Wunused-but-set-variable instead).
+ */
+void PrefaultStack(std::size_t bytes) {
+    constexpr std::size_t kChunk = 4096;
+    uint8_t page[kChunk];
+    if (bytes > kChunk) {
+        PrefaultStack(bytes - kChunk);   // Recurse first so this frame stays live (no tail call)
+    }
+    for (std::size_t i = 0; i < kChunk; i += 64) {
+        page[i] = 0;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(page) : "memory");
+#else
+    static uint8_t* volatile sink;
+    sink = page;
+#endif
+}
+
+bool PinCurrentThread(int cpu) {
+    if (cpu < 0) {
+        return true;
+    }
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    const int result = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+    if (result != 0) {
+        std::cerr << "PinCurrentThread: CPU affinity failed errno=" << result << std::endl;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool SetCurrentThreadFifo(int priority) {
+    if (priority <= 0) {
+        return true;
+    }
+#if defined(BCNP_REALTIME_HAS_MLOCK)
+    sched_param param{};
+    param.sched_priority = priority;
+    const int result = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+        std::cerr << "SetCurrentThreadFifo: SCHED_FIFO failed errno=" << result << std::endl;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+LockedBuffer::LockedBuffer(std::size_t size) : m_size(size) {
+#if defined(BCNP_REALTIME_HAS_MLOCK)
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    m_mappedSize = (size + page - 1) / page * page;
+    if (m_mappedSize == 0) {
+        m_mappedSize = page;
+    }
+    void* mapping = MAP_FAILED;
+#if defined(MAP_LOCKED) && defined(MAP_POPULATE)
+    mapping = ::mmap(nullptr, m_mappedSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_LOCKED | MAP_POPULATE, -1, 0);
+    m_locked = mapping != MAP_FAILED;
+#endif
+    if (mapping == MAP_FAILED) {
+        // MAP_LOCKED fails outright when over RLIMIT_MEMLOCK; retry pageable
+        mapping = ::mmap(nullptr, m_mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "LockedBuffer: mmap failed errno=" << errno << std::endl;
+            throw std::bad_alloc();
+        }
+        m_locked = ::mlock(mapping, m_mappedSize) == 0;
+        if (!m_locked) {
+            std::cerr << "LockedBuffer: mlock failed errno=" << errno << std::endl;
+        }
+        std::memset(mapping, 0, m_mappedSize);   // Prefault
+    }
+    m_data = static_cast<uint8_t*>(mapping);
+#else
+    m_data = new uint8_t[size != 0 ? size : 1]();
+#endif
+}
+
+LockedBuffer::~LockedBuffer() {
+#if defined(BCNP_REALTIME_HAS_MLOCK)
+    ::munmap(m_data, m_mappedSize);
+#else
+    delete[] m_data;
+#endif
+}
+
+} // namespace bcnp
@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file realtime.h
+ * @brief Memory locking and scheduling helpers for real-time receive threads.
+ *
+ * Page faults on a buffer the control loop touches for the first time, or
+ * on one the kernel swapped out, stall the loop for microseconds to
+ * milliseconds. Lock the process (LockAllMemory()) or just the involved
+ * objects (LockObject()) after setup, or allocate receive buffers as a
+ * LockedBuffer:
+ *
+ * @code{cpp}
+ *   static FixedDispatcher<8> dispatcher;
+ *   LockedBuffer rx(8192);
+ *   DispatcherDriver driver(dispatcher, adapter, rx.Data(), rx.Size());
+ *   LockObject(dispatcher);
+ *   PrefaultStack();
+ * @endcode
+ *
+ * Locking needs CAP_IPC_LOCK or a large enough RLIMIT_MEMLOCK; failures
+ * are logged and reported through the return value, never fatal. On
+ * platforms without mlock() the functions return false. The same holds
+ * for the thread pinning and SCHED_FIFO helpers (CAP_SYS_NICE).
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace bcnp {
+
+/// mlockall(MCL_CURRENT | MCL_FUTURE): lock every current and future page
+bool LockAllMemory();
+
+/// Lock the pages spanning [data, data + length)
+bool LockMemory(const void* data, std::size_t length);
+
+/// Undo LockMemory()
+void UnlockMemory(const void* data, std::size_t length);
+
+/// Lock the pages holding @p object (e.g. a FixedDispatcher or StaticStreamParser)
+template<typename T>
+bool LockObject(const T& object) {
+    return LockMemory(&object, sizeof(T));
+}
+
+/// Touch @p bytes of stack below the caller so later calls do not fault
+void PrefaultStack(std::size_t bytes = 64 * 1024);
+
+/// Pin the calling thread to @p cpu (Linux only; negative = no-op returning true)
+bool PinCurrentThread(int cpu);
+
+/// Run the calling thread under SCHED_FIFO at @p priority (1-99; 0 = no-op returning true)
+bool SetCurrentThreadFifo(int priority);
+
+/**
+ * @brief Page-aligned buffer that is locked and prefaulted at construction.
+ *
+ * Uses mmap(MAP_LOCKED | MAP_POPULATE) on Linux and mmap + mlock elsewhere.
+ * If locking is not permitted the buffer is still usable, just pageable
+ * (see Locked()).
+ */
+class LockedBuffer {
+public:
+    explicit LockedBuffer(std::size_t size);
+    ~LockedBuffer();
+
+    LockedBuffer(const LockedBuffer&) = delete;
+    LockedBuffer& operator=(const LockedBuffer&) = delete;
+
+    uint8_t* Data() { return m_data; }
+    const uint8_t* Data() const { return m_data; }
+    std::size_t Size() const { return m_size; }
+
+    /// true if the pages are resident and locked
+    bool Locked() const { return m_locked; }
+
+private:
+    uint8_t* m_data{nullptr};
+    std::size_t m_size{0};
+    std::size_t m_mappedSize{0};   // Rounded to whole pages (0 = heap)
+    bool m_locked{false};
+};
+
+} // namespace bcnp
@@ -80,6 +80,7 @@ public:
      * @brief Send a typed packet over SPI.
      * 
      * Encodes the packet to wire format and transmits using the send callback.
+     * The encode buffer is reused, so steady-state sends do not allocate.
      * 
      * @tparam MsgType Message type in the packet
      * @param packet The packet to send
@@ -87,17 +88,17 @@ public:
      */
     template<typename MsgType>
     bool SendPacket(const TypedPacket<MsgType>& packet) {
-        std::vector<uint8_t> buffer;
-        if (!EncodeTypedPacket(packet, buffer)) {
+        if (!EncodeTypedPacket(packet, m_txBuffer)) {
             return false;
         }
-        return m_send(buffer.data(), buffer.size());
+        return m_send(m_txBuffer.data(), m_txBuffer.size());
     }
 
 private:
     ReceiveChunkFn m_receive;
     SendBytesFn m_send;
     StreamParser& m_parser;
+    std::vector<uint8_t> m_txBuffer;
 };
 
 } // namespace bcnp
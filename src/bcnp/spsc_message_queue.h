@@ -0,0 +1,484 @@
+#pragma once
+
+/**
+ * @file spsc_message_queue.h
+ * @brief Lock-free single-producer/single-consumer timed message queue.
+ *
+ * Same timing semantics as MessageQueue (virtual cursor, lag skip,
+ * connection timeout) without a mutex. One thread (typically the network
+ * thread inside PacketDispatcher::HandlePacket) produces; one thread (the
+ * control loop) consumes. Neither side ever blocks the other.
+ */
+
+#include "bcnp/latency_trace.h"
+#include "bcnp/message_queue.h"
+#include "bcnp/metrics.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <crab/option.h>
+
+namespace bcnp {
+
+/**
+ * @brief Lock-free SPSC variant of MessageQueue.
+ *
+ * Pending messages live in an atomic ring buffer. The producer publishes its
+ * tail index and the most recent clear position together in a single 64-bit
+ * release store, so a Transaction (Clear() plus a batch of Push() calls)
+ * becomes visible to the consumer all at once. The active message is
+ * published through a seqlock, so ActiveMessage() may be read from any
+ * thread without blocking Update().
+ *
+ * Thread roles:
+ * Producer: Push(), Clear(), NotifyReceived(), BeginTransaction()
+ * Consumer: Update()
+ * Any thread: ActiveMessage(), Size(), IsConnected(), GetMetrics()
+ *
+ * Cleared entries are reclaimed on the consumer's next Update(). The ring
+ * reserves twice the configured capacity so a Clear() followed by a full
+ * batch never waits for that.
+ *
+ * @tparam MsgType Trivially copyable message struct with a uint16_t durationMs field
+ *
+ * @code{cpp}
+ *   SpscMessageQueue<DriveCmd> driveQueue;
+ *
+ *   // Network thread:
+ *   {
+ *       auto tx = driveQueue.BeginTransaction();
+ *       if (pkt.header.flags & kFlagClearQueue) tx.Clear();
+ *       for (auto it = pkt.begin_as<DriveCmd>(); it != pkt.end_as<DriveCmd>(); ++it) {
+ *           tx.Push(*it);
+ *       }
+ *   } // Published here with one release store
+ *   driveQueue.NotifyReceived(now);
+ *
+ *   // Control loop:
+ *   driveQueue.Update(now);
+ *   if (auto cmd = driveQueue.ActiveMessage()) {
+ *       drivetrain.execute(cmd.unwrap());
+ *   }
+ * @endcode
+ */
+template<typename MsgType>
+class SpscMessageQueue {
+    static_assert(HasDurationMs<MsgType>::value,
+        "MsgType must have a uint16_t durationMs field");
+    static_assert(std::is_trivially_copyable_v<MsgType>,
+        "MsgType must be trivially copyable for the lock-free active slot");
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SpscMessageQueue(MessageQueueConfig config = {})
+        : m_config(config) {
+        if (m_config.capacity == 0) {
+            m_config.capacity = 200;
+        }
+        if (m_config.maxCommandLag <= std::chrono::milliseconds::zero()) {
+            m_config.maxCommandLag = std::chrono::milliseconds(1);
+        }
+        std::size_t storage = 1;
+        while (storage < m_config.capacity * 2) {
+            storage <<= 1;
+        }
+        m_storage.resize(storage);
+#if BCNP_LATENCY_TRACE
+        m_enqueuedNs.resize(storage);
+#endif
+        m_mask = static_cast<uint32_t>(storage - 1);
+    }
+
+    SpscMessageQueue(const SpscMessageQueue&) = delete;
+    SpscMessageQueue& operator=(const SpscMessageQueue&) = delete;
+
+    // ========================================================================
+    // Producer
+    // ========================================================================
+
+    /**
+     * @brief Add a message to the back of the queue (producer thread).
+     *
+     * @param message The message to enqueue
+     * @return true if successfully added, false if queue was full
+     */
+    bool Push(const MsgType& message) {
+        const bool pushed = StageUnlocked(message);
+        Publish();
+        return pushed;
+    }
+
+    /**
+     * @brief Drop all queued messages and the active message (producer thread).
+     *
+     * Takes effect on the consumer's next Update().
+     */
+    void Clear() {
+        m_producerClear = m_producerTail;
+        Publish();
+    }
+
+    /**
+     * @brief Notify that messages were received from the network.
+     * @param now Current timestamp (typically steady_clock::now())
+     */
+    void NotifyReceived(Clock::time_point now) {
+        m_lastRx.store(now.time_since_epoch().count(), std::memory_order_release);
+    }
+
+    /**
+     * @brief Batch of producer operations published with one release store.
+     *
+     * Nothing staged inside the transaction is visible to the consumer until
+     * the transaction is destroyed.
+     */
+    class Transaction {
+    public:
+        explicit Transaction(SpscMessageQueue& queue) : m_queue(queue) {}
+        ~Transaction() { m_queue.Publish(); }
+
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        bool Push(const MsgType& message) { return m_queue.StageUnlocked(message); }
+
+        void Clear() { m_queue.m_producerClear = m_queue.m_producerTail; }
+
+    private:
+        SpscMessageQueue& m_queue;
+    };
+
+    Transaction BeginTransaction() { return Transaction(*this); }
+
+    // ========================================================================
+    // Consumer
+    // ========================================================================
+
+    /**
+     * @brief Update queue state - call once per control loop iteration (consumer thread).
+     *
+     * Applies any published Clear(), checks the connection timeout, retires
+     * the active message when its duration has elapsed and promotes the next
+     * one, skipping messages that fall behind maxCommandLag.
+     *
+     * @param now Current timestamp for timing calculations
+     */
+    void Update(Clock::time_point now) {
+        const uint32_t headBefore = m_head;
+        const bool hadActive = m_active.is_some();
+        AcquirePublished();
+        if (m_registry) {
+            m_registry->Max(Metric::QueueHighWater, m_visibleTail - m_head);
+        }
+
+        if (!IsConnected(now)) {
+            m_head = m_visibleTail;
+            ResetActive();
+        } else {
+            AdvanceActive(now);
+        }
+
+        if (m_head != headBefore) {
+            m_sharedHead.store(m_head, std::memory_order_release);
+        }
+        if (m_activeDirty || hadActive != m_active.is_some()) {
+            PublishActive();
+        }
+        if (m_registry) {
+            m_registry->Set(Metric::QueueDepth, m_visibleTail - m_head);
+        }
+    }
+
+    // ========================================================================
+    // Any thread
+    // ========================================================================
+
+    /**
+     * @brief Get the currently executing message.
+     *
+     * Lock-free seqlock read; never blocks Update(). Safe from any thread.
+     *
+     * @return The active message, or None if none active
+     */
+    crab::Option<MsgType> ActiveMessage() const {
+        PublishedActive snapshot;
+        while (true) {
+            const uint32_t before = m_activeSeq.load(std::memory_order_acquire);
+            if (before & 1U) {
+                continue;
+            }
+            uint64_t words[kActiveWords];
+            for (std::size_t i = 0; i < kActiveWords; ++i) {
+                words[i] = m_activeWords[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_activeSeq.load(std::memory_order_relaxed) == before) {
+                std::memcpy(&snapshot, words, sizeof(snapshot));
+                break;
+            }
+        }
+        if (!snapshot.valid) {
+            return crab::None;
+        }
+        return crab::Some(snapshot.message);
+    }
+
+    /**
+     * @brief Approximate number of queued messages (excludes active message).
+     */
+    std::size_t Size() const {
+        const uint64_t published = m_published.load(std::memory_order_acquire);
+        const uint32_t tail = static_cast<uint32_t>(published);
+        const uint32_t clear = static_cast<uint32_t>(published >> 32);
+        const uint32_t head = m_sharedHead.load(std::memory_order_acquire);
+        return std::min<uint32_t>(tail - head, tail - clear);
+    }
+
+    /**
+     * @brief Check if the connection is still active.
+     * @param now Current timestamp for timeout calculation
+     */
+    bool IsConnected(Clock::time_point now) const {
+        const auto rx = m_lastRx.load(std::memory_order_acquire);
+        if (rx == kNoRx) {
+            return false;
+        }
+        return (now - Clock::time_point(Clock::duration(rx))) <= m_config.connectionTimeout;
+    }
+
+    /**
+     * @brief Snapshot of queue statistics (relaxed, never blocks).
+     */
+    MessageQueueMetrics GetMetrics() const {
+        MessageQueueMetrics metrics;
+        metrics.messagesReceived = m_messagesReceived.load(std::memory_order_relaxed);
+        metrics.queueOverflows = m_queueOverflows.load(std::memory_order_relaxed);
+        metrics.messagesSkipped = m_messagesSkipped.load(std::memory_order_relaxed);
+        return metrics;
+    }
+
+    void ResetMetrics() {
+        m_messagesReceived.store(0, std::memory_order_relaxed);
+        m_queueOverflows.store(0, std::memory_order_relaxed);
+        m_messagesSkipped.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Also record depth, overflows and lag skips into @p registry (nullptr = off).
+     *
+     * Call before the producer and consumer threads start. Depth is sampled
+     * by the consumer in Update(); the high-water mark is the backlog Update()
+     * found before promoting.
+     */
+    void SetMetricsRegistry(MetricsRegistry* registry) { m_registry = registry; }
+
+    /// Configuration is fixed at construction (the ring cannot be resized lock-free)
+    const MessageQueueConfig& GetConfig() const { return m_config; }
+
+private:
+    struct ActiveSlot {
+        MsgType message;
+        Clock::time_point start;
+    };
+
+    struct PublishedActive {
+        MsgType message{};
+        bool valid{false};
+    };
+
+    static constexpr std::size_t kActiveWords = (sizeof(PublishedActive) + 7) / 8;
+    static constexpr Clock::rep kNoRx = Clock::time_point::min().time_since_epoch().count();
+
+    // Producer side -----------------------------------------------------------
+
+    bool StageUnlocked(const MsgType& message) {
+        const uint32_t head = m_sharedHead.load(std::memory_order_acquire);
+        const uint32_t used = m_producerTail - head;
+        const uint32_t live = std::min(used, m_producerTail - m_producerClear);
+        if (used > m_mask || live >= m_config.capacity) {
+            m_queueOverflows.fetch_add(1, std::memory_order_relaxed);
+            if (m_registry) {
+                m_registry->Add(Metric::QueueOverflows);
+            }
+            return false;
+        }
+        m_storage[m_producerTail & m_mask] = message;
+#if BCNP_LATENCY_TRACE
+        m_enqueuedNs[m_producerTail & m_mask] = trace::Now();
+#endif
+        ++m_producerTail;
+        m_messagesReceived.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void Publish() {
+        const uint64_t published = (static_cast<uint64_t>(m_producerClear) << 32) | m_producerTail;
+        m_published.store(published, std::memory_order_release);
+    }
+
+    // Consumer side -----------------------------------------------------------
+
+    void AcquirePublished() {
+        const uint64_t published = m_published.load(std::memory_order_acquire);
+        m_visibleTail = static_cast<uint32_t>(published);
+        const uint32_t clear = static_cast<uint32_t>(published >> 32);
+        if (clear != m_appliedClear) {
+            // clear is the producer tail at Clear() time, never behind m_head
+            m_appliedClear = clear;
+            m_head = clear;
+            ResetActive();
+        }
+    }
+
+    void ResetActive() {
+        if (m_active.is_some()) {
+            m_activeDirty = true;
+        }
+        m_active = crab::None;
+        m_virtualCursor = Clock::time_point::min();
+        m_hasVirtualCursor = false;
+    }
+
+    void AdvanceActive(Clock::time_point now) {
+        while (true) {
+            if (m_active.is_some()) {
+                const auto& active = m_active.unwrap();
+                const auto elapsed = now - active.start;
+                const auto duration = std::chrono::milliseconds(active.message.durationMs);
+
+                if (elapsed < duration) {
+                    break;
+                }
+
+                const auto endTime = active.start + duration;
+                m_active = crab::None;
+                m_virtualCursor = endTime;
+                m_hasVirtualCursor = true;
+            }
+
+            if (m_active.is_none()) {
+                PromoteNext(now);
+                if (m_active.is_none()) {
+                    break;
+                }
+            }
+        }
+    }
+
+    void PromoteNext(Clock::time_point now) {
+        if (!m_hasVirtualCursor || m_virtualCursor == Clock::time_point::min()) {
+            m_virtualCursor = now;
+            m_hasVirtualCursor = true;
+        }
+
+        if (m_head == m_visibleTail) {
+            m_virtualCursor = std::max(m_virtualCursor, now);
+            return;
+        }
+
+        const auto lagFloor = now - m_config.maxCommandLag;
+
+        while (m_head != m_visibleTail) {
+            const MsgType next = m_storage[m_head & m_mask];
+            const auto duration = std::chrono::milliseconds(next.durationMs);
+            auto projectedStart = m_virtualCursor;
+            auto projectedEnd = projectedStart + duration;
+
+            if (projectedEnd <= lagFloor) {
+                TraceDequeue(LatencyStage::LagSkip);
+                ++m_head;
+                m_virtualCursor = projectedEnd;
+                m_messagesSkipped.fetch_add(1, std::memory_order_relaxed);
+                if (m_registry) {
+                    m_registry->Add(Metric::QueueLagSkips);
+                }
+                continue;
+            }
+
+            if (projectedStart < lagFloor) {
+                projectedStart = lagFloor;
+            }
+
+            m_active = crab::Some(ActiveSlot{next, projectedStart});
+            m_activeDirty = true;
+            TraceDequeue(LatencyStage::QueueWait);
+            ++m_head;
+            m_virtualCursor = projectedStart + duration;
+            return;
+        }
+    }
+
+    /// Record how long the head message waited (no-op without BCNP_LATENCY_TRACE)
+    void TraceDequeue([[maybe_unused]] LatencyStage stage) const {
+#if BCNP_LATENCY_TRACE
+        trace::RecordSince(stage, trace::TypeIdOf<MsgType>::value, m_enqueuedNs[m_head & m_mask]);
+#endif
+    }
+
+    void PublishActive() {
+        PublishedActive value;
+        if (m_active.is_some()) {
+            value.message = m_active.unwrap().message;
+            value.valid = true;
+        }
+        uint64_t words[kActiveWords] = {};
+        std::memcpy(words, &value, sizeof(value));
+
+        const uint32_t seq = m_activeSeq.load(std::memory_order_relaxed);
+        m_activeSeq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < kActiveWords; ++i) {
+            m_activeWords[i].store(words[i], std::memory_order_relaxed);
+        }
+        m_activeSeq.store(seq + 2, std::memory_order_release);
+        m_activeDirty = false;
+    }
+
+    MessageQueueConfig m_config{};
+    MetricsRegistry* m_registry{nullptr};   // Set before the threads start, then read-only
+    std::vector<MsgType> m_storage;
+#if BCNP_LATENCY_TRACE
+    std::vector<uint64_t> m_enqueuedNs; // Push() time per slot, published with the message
+#endif
+    uint32_t m_mask{0};
+
+    // Producer-owned
+    alignas(64) uint32_t m_producerTail{0};
+    uint32_t m_producerClear{0};
+
+    // Shared: tail | (clear << 32), written by producer
+    alignas(64) std::atomic<uint64_t> m_published{0};
+    std::atomic<Clock::rep> m_lastRx{kNoRx};
+
+    // Shared: consumer head, written by consumer
+    alignas(64) std::atomic<uint32_t> m_sharedHead{0};
+
+    // Consumer-owned
+    alignas(64) uint32_t m_head{0};
+    uint32_t m_visibleTail{0};
+    uint32_t m_appliedClear{0};
+    crab::Option<ActiveSlot> m_active{crab::None};
+    bool m_activeDirty{false};
+    Clock::time_point m_virtualCursor{Clock::time_point::min()};
+    bool m_hasVirtualCursor{false};
+
+    // Active slot seqlock (written by consumer, read by anyone)
+    alignas(64) std::atomic<uint32_t> m_activeSeq{0};
+    std::array<std::atomic<uint64_t>, kActiveWords> m_activeWords{};
+
+    // Metrics
+    alignas(64) std::atomic<uint64_t> m_messagesReceived{0};
+    std::atomic<uint64_t> m_queueOverflows{0};
+    std::atomic<uint64_t> m_messagesSkipped{0};
+};
+
+} // namespace bcnp
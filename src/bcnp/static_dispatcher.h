@@ -0,0 +1,280 @@
+#pragma once
+
+/**
+ * @file static_dispatcher.h
+ * @brief Compile-time typed packet dispatcher.
+ *
+ * StaticDispatcher resolves message type to handler with a constexpr table
+ * built from the handler list: no hashing, no std::function per packet, no
+ * allocation after construction. Use PacketDispatcher when handlers must be
+ * registered or replaced at runtime.
+ */
+
+#include "bcnp/dispatcher.h"
+#include "bcnp/stream_parser.h"
+#include <bcnp/message_types.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace bcnp {
+
+/**
+ * @brief Binds a message type to a handler callable for StaticDispatcher.
+ *
+ * The callable may take either `const PacketView&` (called once per packet)
+ * or `const MsgType&` (called once per decoded message).
+ */
+template<typename MsgType, typename Fn>
+struct StaticHandler {
+    using Message = MsgType;
+    Fn fn;
+};
+
+/// Create a StaticHandler for @p MsgType, deducing the callable type
+template<typename MsgType, typename Fn>
+StaticHandler<MsgType, std::decay_t<Fn>> On(Fn&& fn) {
+    return {std::forward<Fn>(fn)};
+}
+
+/**
+ * @brief Parses a BCNP stream and dispatches to a fixed set of typed handlers.
+ *
+ * @code{cpp}
+ *   MessageQueue<DriveCmd> driveQueue;
+ *   StaticDispatcher dispatcher(
+ *       On<DriveCmd>([&](const DriveCmd& cmd) { driveQueue.Push(cmd); }),
+ *       On<EncoderData>([&](const PacketView& pkt) { ... }));
+ *
+ *   dispatcher.PushBytes(data, length);
+ * @endcode
+ *
+ * Type IDs below PacketDispatcher::kFlatHandlerLimit index a flat array of
+ * handler thunks; larger IDs fall back to an unrolled comparison chain.
+ * Unhandled types known to the schema are framed via GetWireSize() and ignored.
+ *
+ * Thread-safety: PushBytes() and the accessors are thread-safe, matching
+ * PacketDispatcher. Handlers run on the thread calling PushBytes().
+ */
+template<typename... Handlers>
+class StaticDispatcher {
+    static_assert(sizeof...(Handlers) > 0, "StaticDispatcher needs at least one handler");
+
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit StaticDispatcher(Handlers... handlers)
+        : StaticDispatcher(DispatcherConfig{}, std::move(handlers)...) {}
+
+    StaticDispatcher(DispatcherConfig config, Handlers... handlers)
+        : m_config(config),
+          m_handlers(std::move(handlers)...),
+          m_parser(
+              [this](const PacketView& packet) {
+                  m_lastRx = Clock::now();
+                  Dispatch(packet);
+              },
+              [this](const StreamParser::ErrorInfo& error) { HandleError(error); },
+              m_config.parserBufferSize) {
+        static_assert(HasUniqueTypeIds(), "StaticDispatcher: duplicate handler for a message type");
+        m_parser.SetWireSizeFunction(&WireSize);
+        m_parser.SetFieldLayoutFunction(&Layout);
+    }
+
+    StaticDispatcher(const StaticDispatcher&) = delete;
+    StaticDispatcher& operator=(const StaticDispatcher&) = delete;
+
+    /// Feed raw bytes from transport (thread-safe)
+    void PushBytes(const uint8_t* data, std::size_t length) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_parser.Push(data, length);
+    }
+
+    /**
+     * @brief Dispatch an already-validated packet to its handler.
+     * @return true if a handler exists for the packet's type
+     */
+    bool Dispatch(const PacketView& packet) {
+        const auto id = static_cast<uint16_t>(packet.header.messageType);
+        if constexpr (kDense) {
+            if (id >= kThunks.size() || !kThunks[id]) {
+                return false;
+            }
+            kThunks[id](m_handlers, packet);
+            return true;
+        } else {
+            return DispatchChain(id, packet, std::index_sequence_for<Handlers...>{});
+        }
+    }
+
+    /// Wire size for handled types, else the generated schema table (0 = unknown)
+    static std::size_t WireSize(MessageTypeId typeId) {
+        const auto id = static_cast<uint16_t>(typeId);
+        if constexpr (kDense) {
+            if (id < kWireSizes.size() && kWireSizes[id] != 0) {
+                return kWireSizes[id];
+            }
+        } else {
+            const std::size_t size = WireSizeChain(id, std::index_sequence_for<Handlers...>{});
+            if (size != 0) {
+                return size;
+            }
+        }
+        return GetWireSize(typeId);
+    }
+
+    /// Field layout for handled types, else the generated schema table (count 0 = unknown)
+    static FieldLayout Layout(MessageTypeId typeId) {
+        const FieldLayout layout = FieldLayoutFor<typename Handlers::Message...>(typeId);
+        return layout.count != 0 ? layout : GetFieldLayout(typeId);
+    }
+
+    /// Set error callback
+    void SetErrorHandler(ErrorHandler handler) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_errorHandler = std::move(handler);
+    }
+
+    /// Check if any packets received recently
+    bool IsConnected(Clock::time_point now) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_lastRx == Clock::time_point::min()) {
+            return false;
+        }
+        return (now - m_lastRx) <= m_config.connectionTimeout;
+    }
+
+    /// Get last receive time
+    Clock::time_point LastReceiveTime() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_lastRx;
+    }
+
+    /// Get parse error count
+    uint64_t ParseErrorCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_parseErrors;
+    }
+
+    /// Access the parser (for diagnostics)
+    StreamParser& Parser() { return m_parser; }
+    const StreamParser& Parser() const { return m_parser; }
+
+private:
+    using HandlerTuple = std::tuple<Handlers...>;
+    using Thunk = void (*)(HandlerTuple&, const PacketView&);
+
+    template<std::size_t I>
+    using HandlerAt = std::tuple_element_t<I, HandlerTuple>;
+
+    static constexpr uint16_t kMaxTypeId =
+        std::max({static_cast<uint16_t>(Handlers::Message::kTypeId)...});
+    static constexpr bool kDense = kMaxTypeId < PacketDispatcher::kFlatHandlerLimit;
+    static constexpr std::size_t kTableSize = kDense ? std::size_t{kMaxTypeId} + 1 : 1;
+
+    static constexpr bool HasUniqueTypeIds() {
+        constexpr std::array<uint16_t, sizeof...(Handlers)> ids{
+            {static_cast<uint16_t>(Handlers::Message::kTypeId)...}};
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            for (std::size_t j = i + 1; j < ids.size(); ++j) {
+                if (ids[i] == ids[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template<std::size_t I>
+    static void Invoke(HandlerTuple& handlers, const PacketView& packet) {
+        using Handler = HandlerAt<I>;
+        using MsgType = typename Handler::Message;
+        auto& fn = std::get<I>(handlers).fn;
+        if constexpr (std::is_invocable_v<decltype(fn)&, const PacketView&>) {
+            fn(packet);
+        } else {
+            static_assert(std::is_invocable_v<decltype(fn)&, const MsgType&>,
+                          "StaticHandler callable must accept const PacketView& or const MsgType&");
+            for (auto it = packet.template begin_as<MsgType>(); it != packet.template end_as<MsgType>(); ++it) {
+                fn(*it);
+            }
+        }
+    }
+
+    template<std::size_t... Is>
+    static constexpr std::array<Thunk, kTableSize> MakeThunks(std::index_sequence<Is...>) {
+        std::array<Thunk, kTableSize> table{};
+        if constexpr (kDense) {
+            ((table[static_cast<uint16_t>(HandlerAt<Is>::Message::kTypeId)] = &Invoke<Is>), ...);
+        }
+        return table;
+    }
+
+    template<std::size_t... Is>
+    static constexpr std::array<uint16_t, kTableSize> MakeWireSizes(std::index_sequence<Is...>) {
+        std::array<uint16_t, kTableSize> table{};
+        if constexpr (kDense) {
+            ((table[static_cast<uint16_t>(HandlerAt<Is>::Message::kTypeId)] =
+                  static_cast<uint16_t>(HandlerAt<Is>::Message::kWireSize)), ...);
+        }
+        return table;
+    }
+
+    // Defined after the class: the builders need the complete class
+    static const std::array<Thunk, kTableSize> kThunks;
+    static const std::array<uint16_t, kTableSize> kWireSizes;
+
+    template<std::size_t... Is>
+    bool DispatchChain(uint16_t id, const PacketView& packet, std::index_sequence<Is...>) {
+        return ((id == static_cast<uint16_t>(HandlerAt<Is>::Message::kTypeId)
+                     ? (Invoke<Is>(m_handlers, packet), true)
+                     : false) || ...);
+    }
+
+    template<std::size_t... Is>
+    static constexpr std::size_t WireSizeChain(uint16_t id, std::index_sequence<Is...>) {
+        std::size_t size = 0;
+        ((id == static_cast<uint16_t>(HandlerAt<Is>::Message::kTypeId)
+              ? (size = HandlerAt<Is>::Message::kWireSize, true)
+              : false) || ...);
+        return size;
+    }
+
+    void HandleError(const StreamParser::ErrorInfo& error) {
+        ++m_parseErrors;
+        if (m_errorHandler) {
+            m_errorHandler(error);
+        }
+    }
+
+    DispatcherConfig m_config;
+    HandlerTuple m_handlers;
+    StreamParser m_parser;
+    mutable std::mutex m_mutex;
+    ErrorHandler m_errorHandler;
+    Clock::time_point m_lastRx{Clock::time_point::min()};
+    uint64_t m_parseErrors{0};
+};
+
+template<typename... Handlers>
+constexpr std::array<typename StaticDispatcher<Handlers...>::Thunk, StaticDispatcher<Handlers...>::kTableSize>
+    StaticDispatcher<Handlers...>::kThunks = MakeThunks(std::index_sequence_for<Handlers...>{});
+
+template<typename... Handlers>
+constexpr std::array<uint16_t, StaticDispatcher<Handlers...>::kTableSize>
+    StaticDispatcher<Handlers...>::kWireSizes = MakeWireSizes(std::index_sequence_for<Handlers...>{});
+
+template<typename... Handlers>
+StaticDispatcher(Handlers...) -> StaticDispatcher<Handlers...>;
+
+template<typename... Handlers>
+StaticDispatcher(DispatcherConfig, Handlers...) -> StaticDispatcher<Handlers...>;
+
+} // namespace bcnp
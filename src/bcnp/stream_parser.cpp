@@ -9,6 +9,9 @@
 
 #include "bcnp/stream_parser.h"
 
+#include "bcnp/latency_trace.h"
+#include "bcnp/metrics.h"
+
 #include <algorithm>
 #include <cstring>
 
@@ -26,16 +29,38 @@ StreamParser::StreamParser(PacketCallback onPacket, ErrorCallback onError, std::
         if (bufferSize < kHeaderSize + kChecksumSize) {
             bufferSize = kHeaderSize + kChecksumSize;
         }
-        m_buffer.resize(bufferSize);
-        m_decodeScratch.resize(bufferSize);
+        m_ownedStorage.resize(bufferSize * 3);
+        m_ring = m_ownedStorage.data();
+        m_scratch = m_ring + bufferSize;
+        m_expand = m_scratch + bufferSize;
+        m_capacity = bufferSize;
     }
 
+/**
+ * @brief Construct a stream parser over caller-provided storage.
+ * 
+ * Nothing is allocated; see StaticStreamParser for inline storage.
+ * 
+ * @param onPacket Callback invoked for each valid packet
+ * @param onError Callback invoked on parse errors (optional)
+ * @param ringStorage Ring buffer, @p storageSize bytes
+ * @param scratchStorage Scratch for wrapped frames, @p storageSize bytes
+ * @param storageSize Size of each buffer (at least header + checksum)
+ * @param expandStorage Expansion buffer for compressed frames, @p storageSize bytes (optional)
+ */
+StreamParser::StreamParser(PacketCallback onPacket, ErrorCallback onError, uint8_t* ringStorage,
+                           uint8_t* scratchStorage, std::size_t storageSize, uint8_t* expandStorage)
+    : m_onPacket(std::move(onPacket)), m_onError(std::move(onError)),
+      m_ring(ringStorage), m_scratch(scratchStorage), m_expand(expandStorage), m_capacity(storageSize) {}
+
 /**
  * @brief Push raw bytes into the parser for processing.
  * 
  * Bytes are added to the internal ring buffer and parsed for complete packets.
  * Valid packets trigger the onPacket callback; parse errors trigger onError.
  * The parser handles partial packets across multiple Push() calls.
+ * In zero-copy mode, complete frames are decoded straight from @p data when
+ * nothing is buffered; only the trailing partial frame is copied into the ring.
  * 
  * @param data Pointer to incoming byte data
  * @param length Number of bytes to process
@@ -49,16 +74,37 @@ void StreamParser::Push(const uint8_t* data, std::size_t length) {
     }
 
     std::size_t iterationBudget = kMaxParseIterationsPerPush;
+    if (m_metrics) {
+        m_metrics->Add(Metric::ParserBytes, length);
+    }
+
+    // Fast path: nothing buffered, so complete frames can be decoded in place
+    if (m_zeroCopy && m_size == 0) {
+        const std::size_t consumed = ParseDirect(data, length, iterationBudget);
+        data += consumed;
+        length -= consumed;
+        if (length == 0) {
+            return;
+        }
+        if (iterationBudget == 0) {
+            // Keep what fits so parsing resumes on the next Push()
+            WriteToBuffer(data, std::min(length, m_capacity));
+            return;
+        }
+    }
+
     std::size_t remaining = length;
 
     while (remaining > 0) {
-        if (m_size == m_buffer.size()) {
+        if (m_size == m_capacity) {
             ParseBuffer(iterationBudget);
         }
 
-        if (m_size == m_buffer.size()) {
+        if (m_size == m_capacity) {
             const auto errorOffset = m_streamOffset;
-            EmitError(PacketError::TooManyCommands, errorOffset);
+            EmitError(PacketError::TooManyCommands, errorOffset, m_size);
+            ++m_resyncCount;
+            m_bytesSkipped += m_size;
             m_streamOffset += m_size;
             m_head = 0;
             m_size = 0;
@@ -69,7 +115,7 @@ void StreamParser::Push(const uint8_t* data, std::size_t length) {
             return;
         }
 
-        const std::size_t writable = std::min(remaining, m_buffer.size() - m_size);
+        const std::size_t writable = std::min(remaining, m_capacity - m_size);
         if (writable == 0) {
             break;
         }
@@ -95,14 +141,27 @@ void StreamParser::Push(const uint8_t* data, std::size_t length) {
  * Clears the internal buffer and optionally resets error tracking.
  * Call this when starting a new connection or after unrecoverable errors.
  * 
- * @param resetErrorState If true, also resets consecutive error count and stream offset
+ * A partly received streamed frame ends with onPacketEnd(crcOk = false).
+ * 
+ * @param resetErrorState If true, also resets error counters and stream offset
  */
 void StreamParser::Reset(bool resetErrorState) {
     m_head = 0;
     m_size = 0;
+    if (m_stream.active) {
+        // The rest of the frame is gone with the buffer
+        m_stream.active = false;
+        if (m_streaming.onPacketEnd) {
+            m_streaming.onPacketEnd(m_stream.header, false);
+        }
+    }
     if (resetErrorState) {
+        m_recovering = false;
         m_consecutiveErrors = 0;
         m_streamOffset = 0;
+        m_resyncCount = 0;
+        m_bytesSkipped = 0;
+        m_peerAcceptsCompressed = false;
     }
 }
 
@@ -110,19 +169,19 @@ void StreamParser::Reset(bool resetErrorState) {
  * @brief Write data to the ring buffer tail.
  * 
  * Handles wrap-around when the buffer end is reached.
- * Caller must ensure sufficient space exists (m_buffer.size() - m_size >= length).
+ * Caller must ensure sufficient space exists (m_capacity - m_size >= length).
  * 
  * @param data Source data to copy
  * @param length Number of bytes to write
  */
 void StreamParser::WriteToBuffer(const uint8_t* data, std::size_t length) {
-    const std::size_t tailIndex = (m_head + m_size) % m_buffer.size();
-    const std::size_t firstChunk = std::min(length, m_buffer.size() - tailIndex);
-    std::memcpy(&m_buffer[tailIndex], data, firstChunk);
+    const std::size_t tailIndex = (m_head + m_size) % m_capacity;
+    const std::size_t firstChunk = std::min(length, m_capacity - tailIndex);
+    std::memcpy(&m_ring[tailIndex], data, firstChunk);
     
     const std::size_t remaining = length - firstChunk;
     if (remaining > 0) {
-        std::memcpy(&m_buffer[0], data + firstChunk, remaining);
+        std::memcpy(&m_ring[0], data + firstChunk, remaining);
     }
     m_size += length;
 }
@@ -138,16 +197,31 @@ void StreamParser::WriteToBuffer(const uint8_t* data, std::size_t length) {
  * @param dest Destination buffer (must have capacity >= length)
  */
 void StreamParser::CopyOut(std::size_t offset, std::size_t length, uint8_t* dest) const {
-    const std::size_t startIndex = (m_head + offset) % m_buffer.size();
-    const std::size_t firstChunk = std::min(length, m_buffer.size() - startIndex);
-    std::memcpy(dest, &m_buffer[startIndex], firstChunk);
+    const std::size_t startIndex = (m_head + offset) % m_capacity;
+    const std::size_t firstChunk = std::min(length, m_capacity - startIndex);
+    std::memcpy(dest, &m_ring[startIndex], firstChunk);
     
     const std::size_t remaining = length - firstChunk;
     if (remaining > 0) {
-        std::memcpy(dest + firstChunk, &m_buffer[0], remaining);
+        std::memcpy(dest + firstChunk, &m_ring[0], remaining);
     }
 }
 
+/**
+ * @brief Get a pointer to buffered bytes if they are contiguous in the ring.
+ * 
+ * @param offset Logical offset from buffer head
+ * @param length Number of bytes required
+ * @return Pointer into the ring, or nullptr if the range wraps around the end
+ */
+const uint8_t* StreamParser::PeekContiguous(std::size_t offset, std::size_t length) const {
+    const std::size_t startIndex = (m_head + offset) % m_capacity;
+    if (length > m_capacity - startIndex) {
+        return nullptr;
+    }
+    return &m_ring[startIndex];
+}
+
 /**
  * @brief Discard bytes from the front of the ring buffer.
  * 
@@ -163,7 +237,7 @@ void StreamParser::Discard(std::size_t count) {
     if (count > m_size) {
         count = m_size;
     }
-    m_head = (m_head + count) % m_buffer.size();
+    m_head = (m_head + count) % m_capacity;
     m_size -= count;
     m_streamOffset += count;
 }
@@ -179,57 +253,85 @@ void StreamParser::Discard(std::size_t count) {
  * @param iterationBudget Remaining iterations allowed (decremented on each loop)
  */
 void StreamParser::ParseBuffer(std::size_t& iterationBudget) {
-    while (iterationBudget > 0 && m_size >= kHeaderSizeV3) {
+    while (iterationBudget > 0 && m_size >= (m_stream.active ? 1 : kHeaderSizeV3)) {
         --iterationBudget;
 
-        CopyOut(0, kHeaderSizeV3, m_decodeScratch.data());
+        if (m_stream.active) {
+            if (!StreamFromBuffer()) {
+                break; // Wait for the next whole message or the CRC
+            }
+            continue;
+        }
+
+        const uint8_t* header = m_zeroCopy ? PeekContiguous(0, kHeaderSizeV3) : nullptr;
+        if (!header) {
+            CopyOut(0, kHeaderSizeV3, m_scratch);
+            header = m_scratch;
+        }
 
-        if (m_decodeScratch[kHeaderMajorIndex] != kProtocolMajorV3 ||
-            m_decodeScratch[kHeaderMinorIndex] != kProtocolMinorV3) {
-            const auto offset = m_streamOffset;
-            EmitError(PacketError::UnsupportedVersion, offset);
-            const std::size_t skip = FindNextHeaderCandidate();
-            Discard(skip > 0 ? skip : 1);
+        if (header[kHeaderMajorIndex] != kProtocolMajorV3 ||
+            header[kHeaderMinorIndex] != kProtocolMinorV3) {
+            Resync(PacketError::UnsupportedVersion);
             continue;
         }
 
-        const uint16_t msgTypeId = detail::LoadU16(&m_decodeScratch[kHeaderMsgTypeIndex]);
-        const uint16_t messageCount = detail::LoadU16(&m_decodeScratch[kHeaderMsgCountIndex]);
+        const uint16_t msgTypeId = detail::LoadU16(&header[kHeaderMsgTypeIndex]);
+        const uint16_t messageCount = detail::LoadU16(&header[kHeaderMsgCountIndex]);
 
         // Lookup message type to get wire size
         const std::size_t wireSize = LookupWireSize(static_cast<MessageTypeId>(msgTypeId));
         if (wireSize == 0) {
-            const auto offset = m_streamOffset;
-            EmitError(PacketError::UnknownMessageType, offset);
-            Discard(1);
+            Resync(PacketError::UnknownMessageType);
             continue;
         }
 
-        if (messageCount > kMaxMessagesPerPacket) {
-            const auto offset = m_streamOffset;
-            EmitError(PacketError::TooManyCommands, offset);
-            Discard(1);
+        std::size_t expected = kHeaderSizeV3 + (messageCount * wireSize) + kChecksumSize;
+        // A frame larger than the ring can never be assembled; don't wait for it.
+        // Compressed frames are bounded the same way since they expand to this size.
+        if (messageCount > kMaxMessagesPerPacket || expected > m_capacity) {
+            if (CanStream(header, wireSize)) {
+                BeginStream(header, wireSize);
+                Discard(kHeaderSizeV3);
+                continue;
+            }
+            Resync(PacketError::TooManyCommands);
             continue;
         }
 
-        const std::size_t expected = kHeaderSizeV3 + (messageCount * wireSize) + kChecksumSize;
+        if (header[kHeaderFlagsIndex] & kFlagCompressed) {
+            constexpr std::size_t kPrefixSize = kHeaderSizeV3 + kCompressedLengthSize;
+            if (m_size < kPrefixSize) {
+                break;
+            }
+            uint8_t prefix[kPrefixSize];
+            CopyOut(0, kPrefixSize, prefix);
+            expected = kPrefixSize + detail::LoadU16(&prefix[kHeaderSizeV3]) + kChecksumSize;
+            if (expected > m_capacity) {
+                Resync(PacketError::TooManyCommands);
+                continue;
+            }
+        }
 
-        const std::size_t available = std::min(expected, m_size);
-        CopyOut(0, available, m_decodeScratch.data());
-        auto result = DecodePacketViewWithSize(m_decodeScratch.data(), available, wireSize);
+        if (m_size < expected) {
+            break; // Truncated: wait for the rest of the frame
+        }
 
-        if (result.error == PacketError::Truncated) {
-            break;
+        const uint8_t* frame = m_zeroCopy ? PeekContiguous(0, expected) : nullptr;
+        if (!frame) {
+            CopyOut(0, expected, m_scratch);
+            frame = m_scratch;
+            ++m_scratchCopies;
         }
+        auto result = DecodeFrame(frame, expected, wireSize);
 
         if (!result.view) {
-            const auto offset = m_streamOffset;
-            EmitError(result.error, offset);
-            // Poison packet: only discard 1 byte to resync, not the entire calculated frame
+            // Poison packet: resync to the next candidate inside the frame, not past it
             if (result.error == PacketError::ChecksumMismatch || result.error == PacketError::InvalidFloat) {
-                Discard(1);
+                Resync(result.error);
             } else {
+                const auto offset = m_streamOffset;
                 const std::size_t consumed = result.bytesConsumed > 0 ? result.bytesConsumed : 1;
+                EmitError(result.error, offset, consumed);
                 Discard(consumed);
             }
             continue;
@@ -242,60 +344,351 @@ void StreamParser::ParseBuffer(std::size_t& iterationBudget) {
 }
 
 /**
- * @brief Find the next potential packet header in the buffer.
+ * @brief Decode complete frames directly from the caller's buffer.
  * 
- * Scans for the version magic bytes (major.minor) to find a resync point
- * after encountering corrupted data. Returns offset from current position.
+ * Used by Push() when the ring is empty. Stops at the first frame that is
+ * incomplete, invalid, or larger than the ring buffer; those bytes are left
+ * for the buffered path, which owns error reporting and resync. Streamed
+ * frames are started here too, and their whole messages delivered straight
+ * from @p data.
  * 
- * @return Byte offset to next header candidate, or 1 if none found
+ * @param data Incoming bytes (not yet buffered)
+ * @param length Number of bytes available
+ * @param iterationBudget Remaining iterations allowed (decremented per frame)
+ * @return Number of bytes consumed as valid packets
  */
-std::size_t StreamParser::FindNextHeaderCandidate() const {
-    if (m_size <= 1) {
-        return m_size == 0 ? 0 : 1;
-    }
+std::size_t StreamParser::ParseDirect(const uint8_t* data, std::size_t length, std::size_t& iterationBudget) {
+    std::size_t offset = 0;
+    while (iterationBudget > 0 && offset < length) {
+        if (m_stream.active) {
+            const std::size_t consumed = ContinueStream(data + offset, length - offset);
+            if (consumed == 0) {
+                break;
+            }
+            --iterationBudget;
+            offset += consumed;
+            m_streamOffset += consumed;
+            continue;
+        }
+        if (length - offset < kHeaderSizeV3) {
+            break;
+        }
+
+        const uint8_t* frame = data + offset;
+        const auto typeId = static_cast<MessageTypeId>(detail::LoadU16(&frame[kHeaderMsgTypeIndex]));
+        const std::size_t wireSize = LookupWireSize(typeId);
+        if (wireSize == 0) {
+            break;
+        }
 
-    for (std::size_t offset = 1; offset < m_size; ++offset) {
-        const std::size_t firstIndex = (m_head + offset) % m_buffer.size();
-        if (m_buffer[firstIndex] != kProtocolMajorV3) {
+        const uint16_t messageCount = detail::LoadU16(&frame[kHeaderMsgCountIndex]);
+        std::size_t expected = kHeaderSizeV3 + (messageCount * wireSize) + kChecksumSize;
+        if (frame[kHeaderFlagsIndex] & kFlagCompressed) {
+            if (length - offset < kHeaderSizeV3 + kCompressedLengthSize || expected > m_capacity) {
+                break;
+            }
+            expected = kHeaderSizeV3 + kCompressedLengthSize + detail::LoadU16(&frame[kHeaderSizeV3]) + kChecksumSize;
+        }
+        if (expected > m_capacity && CanStream(frame, wireSize)) {
+            --iterationBudget;
+            BeginStream(frame, wireSize);
+            offset += kHeaderSizeV3;
+            m_streamOffset += kHeaderSizeV3;
             continue;
         }
+        if (expected > length - offset || expected > m_capacity) {
+            break;
+        }
 
-        if (offset + 1 >= m_size) {
-            return offset;
+        auto result = DecodeFrame(frame, expected, wireSize);
+        if (!result.view) {
+            break;
         }
 
-        const std::size_t secondIndex = (m_head + offset + 1) % m_buffer.size();
-        if (m_buffer[secondIndex] == kProtocolMinorV3) {
+        --iterationBudget;
+        EmitPacket(result.view.unwrap());
+        m_consecutiveErrors = 0;
+        offset += result.bytesConsumed;
+        m_streamOffset += result.bytesConsumed;
+    }
+    return offset;
+}
+
+/**
+ * @brief Report an error at the buffer head and skip to the next header candidate.
+ * 
+ * Replaces byte-at-a-time recovery: everything up to the next plausible
+ * header is discarded in one step, and the skip is reported through
+ * ErrorInfo::bytesSkipped and BytesSkipped().
+ * 
+ * @param error The error that invalidated the frame at the head
+ */
+void StreamParser::Resync(PacketError error) {
+    const auto offset = m_streamOffset;
+    const std::size_t skip = FindNextHeaderCandidate(1);
+    EmitError(error, offset, skip);
+    ++m_resyncCount;
+    m_bytesSkipped += skip;
+    Discard(skip);
+}
+
+/**
+ * @brief Cheap validity checks for a header candidate, before any CRC work.
+ * 
+ * Rejects a wrong minor version, unknown type IDs and message counts whose
+ * frame could never fit in the ring. A candidate too close to the end of
+ * the buffered data to check is accepted so parsing waits for more bytes.
+ * 
+ * @param offset Logical offset of a kProtocolMajorV3 byte
+ * @return true if a frame could start at @p offset
+ */
+bool StreamParser::IsPlausibleHeader(std::size_t offset) const {
+    const std::size_t available = m_size - offset;
+    if (available < 2) {
+        return true;
+    }
+    uint8_t header[kHeaderSizeV3];
+    CopyOut(offset, std::min(available, kHeaderSizeV3), header);
+    if (header[kHeaderMinorIndex] != kProtocolMinorV3) {
+        return false;
+    }
+    if (available < kHeaderSizeV3) {
+        return true;
+    }
+    const std::size_t wireSize =
+        LookupWireSize(static_cast<MessageTypeId>(detail::LoadU16(&header[kHeaderMsgTypeIndex])));
+    if (wireSize == 0) {
+        return false;
+    }
+    const std::size_t messageCount = detail::LoadU16(&header[kHeaderMsgCountIndex]);
+    return messageCount <= kMaxMessagesPerPacket &&
+           kHeaderSizeV3 + messageCount * wireSize + kChecksumSize <= m_capacity;
+}
+
+/**
+ * @brief Find the next potential packet header in the buffer.
+ * 
+ * Searches each contiguous segment of the ring with memchr() (vectorized
+ * by the C library) for the major version byte, then filters candidates
+ * with IsPlausibleHeader(). Returns offset from current position.
+ * 
+ * @param from Logical offset to start searching at
+ * @return Offset of the next candidate, or m_size if there is none
+ */
+std::size_t StreamParser::FindNextHeaderCandidate(std::size_t from) const {
+    std::size_t offset = from;
+    while (offset < m_size) {
+        const std::size_t index = (m_head + offset) % m_capacity;
+        const std::size_t span = std::min(m_size - offset, m_capacity - index);
+        const uint8_t* segment = &m_ring[index];
+        const auto* hit = static_cast<const uint8_t*>(std::memchr(segment, kProtocolMajorV3, span));
+        if (!hit) {
+            offset += span;
+            continue;
+        }
+        offset += static_cast<std::size_t>(hit - segment);
+        if (IsPlausibleHeader(offset)) {
             return offset;
         }
+        ++offset;
+    }
+    return m_size;
+}
+
+/**
+ * @brief Whether the frame at @p header may be streamed instead of rejected as too large.
+ * 
+ * @param header Header bytes of a frame that does not fit the ring
+ * @param wireSize Wire size of the frame's message type (non-zero)
+ * @return true if streaming is on and the header and bounds check out
+ */
+bool StreamParser::CanStream(const uint8_t* header, std::size_t wireSize) const {
+    return m_streaming.onMessages && !m_recovering &&
+           header[kHeaderMajorIndex] == kProtocolMajorV3 && header[kHeaderMinorIndex] == kProtocolMinorV3 &&
+           (header[kHeaderFlagsIndex] & kFlagCompressed) == 0 &&
+           detail::LoadU16(&header[kHeaderMsgCountIndex]) <= kMaxMessagesPerPacket &&
+           wireSize <= m_capacity;
+}
+
+/**
+ * @brief Start streaming the frame at @p header; the caller consumes the header bytes.
+ */
+void StreamParser::BeginStream(const uint8_t* header, std::size_t wireSize) {
+    m_stream.active = true;
+    m_stream.header.major = header[kHeaderMajorIndex];
+    m_stream.header.minor = header[kHeaderMinorIndex];
+    m_stream.header.flags = header[kHeaderFlagsIndex];
+    m_stream.header.messageType = static_cast<MessageTypeId>(detail::LoadU16(&header[kHeaderMsgTypeIndex]));
+    m_stream.header.messageCount = detail::LoadU16(&header[kHeaderMsgCountIndex]);
+    m_stream.wireSize = wireSize;
+    m_stream.remaining = m_stream.header.messageCount;
+    m_stream.crc = UpdateCrc32(0, header, kHeaderSizeV3);
+    m_stream.frameOffset = m_streamOffset;
+    if (m_streaming.onPacketBegin) {
+        m_streaming.onPacketBegin(m_stream.header);
+    }
+}
+
+/**
+ * @brief Deliver the whole messages at the front of @p data, or check the CRC.
+ * 
+ * @param data Contiguous bytes following what the stream has consumed
+ * @param length Bytes available at @p data
+ * @return Bytes consumed; 0 if @p data holds neither a whole message nor the CRC
+ */
+std::size_t StreamParser::ContinueStream(const uint8_t* data, std::size_t length) {
+    if (m_stream.remaining == 0) {
+        if (length < kChecksumSize) {
+            return 0;
+        }
+        EndStream(detail::LoadU32(data) == m_stream.crc);
+        return kChecksumSize;
+    }
+
+    const std::size_t count = std::min(m_stream.remaining, length / m_stream.wireSize);
+    if (count == 0) {
+        return 0;
+    }
+    const std::size_t bytes = count * m_stream.wireSize;
+    m_stream.crc = UpdateCrc32(m_stream.crc, data, bytes);
+    m_stream.remaining -= count;
+
+    PacketView chunk;
+    chunk.header = m_stream.header;
+    chunk.header.messageCount = static_cast<uint16_t>(count);
+    chunk.payload = crab::Slice<const uint8_t>(data, bytes);
+    m_streaming.onMessages(chunk);
+    return bytes;
+}
+
+/**
+ * @brief Stream the next chunk from the ring.
+ * 
+ * Delivers every whole message buffered, straight from the ring when it
+ * is contiguous; a chunk that wraps is copied into scratch first.
+ * 
+ * @return false if more bytes are needed
+ */
+bool StreamParser::StreamFromBuffer() {
+    std::size_t wanted = kChecksumSize;
+    if (m_stream.remaining > 0) {
+        wanted = std::min(m_stream.remaining, m_size / m_stream.wireSize) * m_stream.wireSize;
+    }
+    if (wanted == 0 || m_size < wanted) {
+        return false;
+    }
+
+    const uint8_t* data = m_zeroCopy ? PeekContiguous(0, wanted) : nullptr;
+    if (!data) {
+        CopyOut(0, wanted, m_scratch);
+        data = m_scratch;
+        ++m_scratchCopies;
+    }
+    Discard(ContinueStream(data, wanted));
+    return true;
+}
+
+/**
+ * @brief Finish the streamed frame and report it.
+ * 
+ * @param crcOk Whether the transmitted CRC matched the one computed over the frame
+ */
+void StreamParser::EndStream(bool crcOk) {
+    m_stream.active = false;
+    if (crcOk) {
+        ++m_streamedFrames;
+        m_consecutiveErrors = 0;
+        m_recovering = false;
+        if (m_stream.header.flags & kFlagAcceptsCompressed) {
+            m_peerAcceptsCompressed = true;
+        }
+        if (m_metrics) {
+            m_metrics->Add(Metric::ParserFrames);
+            m_metrics->CountPacket(m_stream.header.messageType);
+        }
+    } else {
+        EmitError(PacketError::ChecksumMismatch, m_stream.frameOffset);
+    }
+    if (m_streaming.onPacketEnd) {
+        m_streaming.onPacketEnd(m_stream.header, crcOk);
     }
-    return 1;
 }
 
 /**
  * @brief Look up the wire size for a message type.
  * 
- * Uses custom lookup function if set, otherwise falls back to the
- * global message type registry.
+ * Uses the custom lookup if set, otherwise the generated dense
+ * GetWireSize() table.
  * 
  * @param typeId Message type ID to look up
  * @return Wire size in bytes, or 0 if type is unknown
  */
 std::size_t StreamParser::LookupWireSize(MessageTypeId typeId) const {
+    if (m_wireSizeFn) {
+        return m_wireSizeFn(typeId);
+    }
     // Use custom lookup if provided
     if (m_wireSizeLookup) {
         return m_wireSizeLookup(typeId);
     }
-    // Fall back to global registry
-    auto info = GetMessageInfo(typeId);
-    return info ? info->wireSize : 0;
+    // Fall back to the generated dense table
+    return GetWireSize(typeId);
+}
+
+/**
+ * @brief Look up the field layout for expanding compressed frames.
+ * 
+ * @param typeId Message type ID to look up
+ * @return Layout from the custom function if set, else the generated GetFieldLayout()
+ */
+FieldLayout StreamParser::LookupFieldLayout(MessageTypeId typeId) const {
+    if (m_fieldLayoutFn) {
+        return m_fieldLayoutFn(typeId);
+    }
+    return GetFieldLayout(typeId);
+}
+
+/**
+ * @brief Decode one complete frame, expanding it first if compressed.
+ * 
+ * @param frame Frame bytes
+ * @param length Frame length
+ * @param wireSize Fixed-width message size for the frame's type
+ * @return DecodeViewResult from the fixed-width or compressed decoder
+ */
+DecodeViewResult StreamParser::DecodeFrame(const uint8_t* frame, std::size_t length, std::size_t wireSize) {
+    if ((frame[kHeaderFlagsIndex] & kFlagCompressed) == 0) {
+        return DecodePacketViewWithSize(frame, length, wireSize);
+    }
+    const auto typeId = static_cast<MessageTypeId>(detail::LoadU16(&frame[kHeaderMsgTypeIndex]));
+    auto result = DecodeCompressedPacketView(frame, length, wireSize, LookupFieldLayout(typeId),
+                                             m_expand, m_expand ? m_capacity : 0);
+    if (result.view) {
+        ++m_compressedFrames;
+    }
+    return result;
 }
 
 /**
  * @brief Emit a successfully decoded packet to the callback.
+ * 
+ * With BCNP_LATENCY_TRACE, records the Buffering stage from this thread's
+ * last ReceiveChunk() mark.
+ * 
  * @param packet The validated packet view
  */
 void StreamParser::EmitPacket(const PacketView& packet) {
+    m_recovering = false;
+    if (packet.header.flags & kFlagAcceptsCompressed) {
+        m_peerAcceptsCompressed = true;
+    }
+    if (const uint64_t received = trace::ReceiveMark()) {
+        trace::RecordSince(LatencyStage::Buffering, static_cast<uint16_t>(packet.header.messageType), received);
+    }
+    if (m_metrics) {
+        m_metrics->Add(Metric::ParserFrames);
+        m_metrics->CountPacket(packet.header.messageType);
+    }
     if (m_onPacket) {
         m_onPacket(packet);
     }
@@ -305,13 +698,20 @@ void StreamParser::EmitPacket(const PacketView& packet) {
  * @brief Emit a parse error to the callback.
  * 
  * Increments consecutive error counter and invokes error callback if set.
+ * With metrics attached, also counts the error and the bytes it skipped.
  * 
  * @param error The error code
  * @param offset Stream byte offset where error occurred
+ * @param bytesSkipped Bytes discarded to recover from this error
  */
-void StreamParser::EmitError(PacketError error, std::size_t offset) {
+void StreamParser::EmitError(PacketError error, std::size_t offset, std::size_t bytesSkipped) {
+    m_recovering = true;
+    if (m_metrics) {
+        m_metrics->Add(Metric::ParserErrors);
+        m_metrics->Add(Metric::ParserResyncBytes, bytesSkipped);
+    }
     if (m_onError) {
-        ErrorInfo info{error, offset, ++m_consecutiveErrors};
+        ErrorInfo info{error, offset, ++m_consecutiveErrors, bytesSkipped};
         m_onError(info);
     }
 }
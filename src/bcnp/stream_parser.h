@@ -10,11 +10,33 @@
 
 namespace bcnp {
 
+class MetricsRegistry;
+
 /**
  * @brief Parses a byte stream into BCNP packets.
  * 
  * Handles stream reassembly, framing, CRC validation, and error recovery.
  * Uses a ring buffer internally for efficient parsing of partial packets.
+ * After corrupt data the parser skips straight to the next plausible header
+ * (magic bytes, known type, a frame that fits the ring) instead of retrying
+ * one byte at a time; each error reports the bytes it skipped.
+ * 
+ * In zero-copy mode (the default) emitted views point straight into the
+ * caller's Push() buffer when nothing is buffered, or into the ring itself
+ * when the frame is contiguous. Only frames that wrap around the end of the
+ * ring are copied into a scratch buffer (see ScratchCopyCount()). Either way
+ * a PacketView is only valid for the duration of the callback; use
+ * FrameArena::Retain() to keep a frame for deferred processing.
+ * 
+ * Compressed frames (kFlagCompressed) are expanded into a third buffer of
+ * the same size before the callback, using the field widths from the
+ * FieldLayoutFn (default: the generated GetFieldLayout()).
+ * 
+ * Frames larger than the ring are normally rejected (TooManyMessages). With
+ * SetStreamingCallbacks() they are streamed instead: once the header checks
+ * out, the payload is handed over in chunks of whole messages as it
+ * arrives and the CRC is computed incrementally, so a 65535-message batch
+ * needs no more memory than a small one.
  * 
  * Thread-safety: Not thread-safe. Caller must synchronize access.
  */
@@ -25,44 +47,215 @@ public:
         PacketError code{PacketError::None};
         std::size_t offset{0};
         uint64_t consecutiveErrors{0};
+        std::size_t bytesSkipped{0};    ///< Bytes discarded to resync after this error
     };
     using ErrorCallback = std::function<void(const ErrorInfo&)>;
     
     /// Callback to get wire size for a message type ID
     /// Return 0 if message type is unknown
     using WireSizeLookup = std::function<std::size_t(MessageTypeId)>;
+    /// Plain function form of WireSizeLookup (no type erasure on the per-frame path)
+    using WireSizeFn = std::size_t (*)(MessageTypeId);
+    /// Field widths per message type, for expanding compressed frames
+    using FieldLayoutFn = FieldLayout (*)(MessageTypeId);
+
+    /**
+     * @brief Callbacks for frames streamed because they do not fit the ring.
+     * 
+     * onPacketBegin gets the frame header (messageCount is the whole batch).
+     * onMessages then gets consecutive chunks as views whose
+     * header.messageCount is the number of messages in the chunk; read them
+     * with begin_as<T>() as usual. onPacketEnd reports whether the CRC over
+     * the whole frame matched. Chunks are unverified until then, so stage
+     * them and only act on the batch once crcOk is true.
+     */
+    struct StreamingCallbacks {
+        std::function<void(const PacketHeader&)> onPacketBegin;
+        std::function<void(const PacketView&)> onMessages;
+        std::function<void(const PacketHeader&, bool crcOk)> onPacketEnd;
+    };
 
     StreamParser(PacketCallback onPacket, ErrorCallback onError = {}, std::size_t bufferSize = 4096);
 
+    /**
+     * @brief Parser over caller-owned buffers of @p storageSize bytes each (no allocation).
+     * @param expandStorage Compressed frame expansion buffer (nullptr = reject compressed frames)
+     */
+    StreamParser(PacketCallback onPacket, ErrorCallback onError, uint8_t* ringStorage,
+                 uint8_t* scratchStorage, std::size_t storageSize, uint8_t* expandStorage = nullptr);
+
+    // A copy would share caller-provided storage
+    StreamParser(const StreamParser&) = delete;
+    StreamParser& operator=(const StreamParser&) = delete;
+    StreamParser(StreamParser&&) = default;
+    StreamParser& operator=(StreamParser&&) = default;
+
     void Push(const uint8_t* data, std::size_t length);
 
     void Reset(bool resetErrorState = true);
     
     /// Set custom wire size lookup (for testing with custom message types)
-    void SetWireSizeLookup(WireSizeLookup lookup) { m_wireSizeLookup = std::move(lookup); }
+    void SetWireSizeLookup(WireSizeLookup lookup) {
+        m_wireSizeLookup = std::move(lookup);
+        m_wireSizeFn = nullptr;
+    }
+
+    /// Set wire size lookup from a plain function (preferred; default is GetWireSize)
+    void SetWireSizeFunction(WireSizeFn lookup) {
+        m_wireSizeLookup = nullptr;
+        m_wireSizeFn = lookup;
+    }
+
+    /**
+     * @brief Stream frames larger than the ring (empty onMessages = off, the default).
+     * 
+     * A frame is streamed if its header has the current version, a known
+     * type, no kFlagCompressed flag (compressed frames must fit the ring),
+     * and one message fits the ring. Frames found while resyncing after an
+     * error are not streamed, so corrupt data cannot start a long
+     * unverified stream; the first good packet clears that state.
+     */
+    void SetStreamingCallbacks(StreamingCallbacks callbacks) {
+        m_streaming = std::move(callbacks);
+    }
+
+    /// true while a streamed frame is partly received
+    bool IsStreaming() const { return m_stream.active; }
+
+    /// Number of streamed frames whose CRC matched
+    uint64_t StreamedFrameCount() const { return m_streamedFrames; }
+
+    /// Set the field layout lookup used to expand compressed frames
+    void SetFieldLayoutFunction(FieldLayoutFn lookup) { m_fieldLayoutFn = lookup; }
+
+    /// true once a packet carrying kFlagAcceptsCompressed was received (cleared by Reset())
+    bool PeerAcceptsCompressed() const { return m_peerAcceptsCompressed; }
+
+    /// Number of compressed frames expanded
+    uint64_t CompressedFrameCount() const { return m_compressedFrames; }
+
+    /// Enable/disable zero-copy decoding (disabled: every frame is copied to scratch)
+    void SetZeroCopy(bool enabled) { m_zeroCopy = enabled; }
+    bool IsZeroCopy() const { return m_zeroCopy; }
+
+    /// Number of frames that had to be copied into scratch before decoding
+    uint64_t ScratchCopyCount() const { return m_scratchCopies; }
+
+    /// Number of times the parser skipped ahead to recover from corrupt data
+    uint64_t ResyncCount() const { return m_resyncCount; }
+
+    /// Total bytes discarded while resyncing
+    uint64_t BytesSkipped() const { return m_bytesSkipped; }
+
+    /// Record bytes, frames, errors and packets per type into @p metrics (nullptr = off)
+    void SetMetrics(MetricsRegistry* metrics) { m_metrics = metrics; }
+
+    /// Ring buffer size in bytes (largest frame the parser can assemble)
+    std::size_t Capacity() const { return m_capacity; }
+
+    /// Stream offset of the next unparsed byte; inside a packet callback, the packet's first byte
+    std::size_t StreamOffset() const { return m_streamOffset; }
 
     static constexpr std::size_t kMaxParseIterationsPerPush = 1024;
 
 private:
     void EmitPacket(const PacketView& packet);
-    void EmitError(PacketError error, std::size_t offset);
+    void EmitError(PacketError error, std::size_t offset, std::size_t bytesSkipped = 0);
+    void Resync(PacketError error);
 
     void WriteToBuffer(const uint8_t* data, std::size_t length);
     void CopyOut(std::size_t offset, std::size_t length, uint8_t* dest) const;
+    const uint8_t* PeekContiguous(std::size_t offset, std::size_t length) const;
     void Discard(std::size_t count);
+    std::size_t ParseDirect(const uint8_t* data, std::size_t length, std::size_t& iterationBudget);
     void ParseBuffer(std::size_t& iterationBudget);
-    std::size_t FindNextHeaderCandidate() const;
+    std::size_t FindNextHeaderCandidate(std::size_t from) const;
+    bool IsPlausibleHeader(std::size_t offset) const;
+    bool CanStream(const uint8_t* header, std::size_t wireSize) const;
+    void BeginStream(const uint8_t* header, std::size_t wireSize);
+    std::size_t ContinueStream(const uint8_t* data, std::size_t length);
+    bool StreamFromBuffer();
+    void EndStream(bool crcOk);
     std::size_t LookupWireSize(MessageTypeId typeId) const;
+    FieldLayout LookupFieldLayout(MessageTypeId typeId) const;
+    DecodeViewResult DecodeFrame(const uint8_t* frame, std::size_t length, std::size_t wireSize);
+
+    // Streamed frame in progress
+    struct StreamState {
+        bool active{false};
+        PacketHeader header{};
+        std::size_t wireSize{0};
+        std::size_t remaining{0};      // Messages not yet delivered
+        uint32_t crc{0};               // Running CRC of the header and delivered messages
+        std::size_t frameOffset{0};    // Stream offset of the frame's first byte
+    };
 
     PacketCallback m_onPacket;
     ErrorCallback m_onError;
+    StreamingCallbacks m_streaming;
+    StreamState m_stream;
     WireSizeLookup m_wireSizeLookup;
-    std::vector<uint8_t> m_buffer;
-    std::vector<uint8_t> m_decodeScratch;
+    WireSizeFn m_wireSizeFn{nullptr};
+    FieldLayoutFn m_fieldLayoutFn{nullptr};
+    MetricsRegistry* m_metrics{nullptr};
+    std::vector<uint8_t> m_ownedStorage;   // Ring + scratch + expand unless caller-provided
+    uint8_t* m_ring{nullptr};
+    uint8_t* m_scratch{nullptr};
+    uint8_t* m_expand{nullptr};            // Expanded compressed payloads (nullptr = unsupported)
+    std::size_t m_capacity{0};
     std::size_t m_head{0};
     std::size_t m_size{0};
     std::size_t m_streamOffset{0};
     uint64_t m_consecutiveErrors{0};
+    uint64_t m_scratchCopies{0};
+    uint64_t m_resyncCount{0};
+    uint64_t m_bytesSkipped{0};
+    uint64_t m_compressedFrames{0};
+    uint64_t m_streamedFrames{0};
+    bool m_zeroCopy{true};
+    bool m_recovering{false};              // Error since the last good packet: do not start streams
+    bool m_peerAcceptsCompressed{false};
+};
+
+namespace detail {
+
+template<std::size_t BufferSize, bool Compressed>
+struct StaticParserStorage {
+    std::array<uint8_t, BufferSize> ring{};
+    std::array<uint8_t, BufferSize> scratch{};
+    std::array<uint8_t, Compressed ? BufferSize : 0> expand{};
+
+    uint8_t* ExpandData() { return Compressed ? expand.data() : nullptr; }
+};
+
+} // namespace detail
+
+/**
+ * @brief StreamParser whose ring and scratch buffers are members sized at compile time.
+ * 
+ * Nothing is allocated at construction or while parsing, and the buffers
+ * can be locked along with the object (see LockObject() in realtime.h).
+ * Callbacks capturing only a pointer or two fit std::function's inline
+ * buffer, so they do not allocate either.
+ * 
+ * @tparam BufferSize Ring size, the largest frame the parser can assemble
+ * @tparam Compressed Reserve a buffer to expand compressed frames into
+ */
+template<std::size_t BufferSize, bool Compressed = true>
+class StaticStreamParser : private detail::StaticParserStorage<BufferSize, Compressed>, public StreamParser {
+    static_assert(BufferSize >= kHeaderSize + kChecksumSize, "StaticStreamParser buffer too small for a frame");
+
+public:
+    explicit StaticStreamParser(PacketCallback onPacket, ErrorCallback onError = {})
+        : detail::StaticParserStorage<BufferSize, Compressed>(),
+          StreamParser(std::move(onPacket), std::move(onError), this->ring.data(), this->scratch.data(),
+                       BufferSize, this->ExpandData()) {}
+
+    // The base points at this object's own arrays
+    StaticStreamParser(const StaticStreamParser&) = delete;
+    StaticStreamParser& operator=(const StaticStreamParser&) = delete;
+    StaticStreamParser(StaticStreamParser&&) = delete;
+    StaticStreamParser& operator=(StaticStreamParser&&) = delete;
 };
 
 } // namespace bcnp
@@ -3,12 +3,15 @@
 #include "bcnp/packet.h"
 #include "bcnp/packet_storage.h"
 #include "bcnp/static_vector.h"
+#include "bcnp/transport/adapter.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <mutex>
+#include <type_traits>
 #include <vector>
 
 namespace bcnp {
@@ -24,6 +27,25 @@ struct TelemetryAccumulatorConfig {
     std::size_t maxBufferedMessages{64};
 };
 
+/**
+ * @brief Metrics for diagnostics (shared by the mutex and MPSC accumulators).
+ */
+struct TelemetryAccumulatorMetrics {
+    uint64_t messagesRecorded{0};
+    uint64_t messagesSent{0};
+    uint64_t packetsSent{0};
+    uint64_t bufferOverflows{0};
+    uint64_t sendFailures{0};
+};
+
+/**
+ * @brief Outcome of encoding buffered telemetry into a caller's buffer.
+ */
+struct TelemetryEncodeResult {
+    std::size_t bytes{0};     ///< Packet bytes written (0 if nothing fit or encoding failed)
+    std::size_t messages{0};  ///< Buffered messages consumed
+};
+
 /**
  * @brief Accumulates high-frequency telemetry data and batches into packets.
  * 
@@ -50,35 +72,36 @@ struct TelemetryAccumulatorConfig {
  *   // At end of Periodic:
  *   drivetrainTelem.MaybeFlush(tcpAdapter);  // Sends every N ticks
  * @endcode
+ *
+ * Record() takes a short mutex. When several threads record into one
+ * accumulator, MpscTelemetryAccumulator never blocks the producers.
  */
 template<typename MsgType, typename Storage = StaticVector<MsgType, 64>>
 class TelemetryAccumulator {
+    static_assert(detail::has_resize<Storage>::value && detail::has_contiguous_data<Storage>::value,
+                  "TelemetryAccumulator storage must be resizable and contiguous");
+
 public:
+    using Message = MsgType;
     using Clock = std::chrono::steady_clock;
 
     explicit TelemetryAccumulator(TelemetryAccumulatorConfig config = {})
-        : m_config(config) {}
+        : m_config(config) {
+        ResizeRingUnlocked();
+    }
 
     /**
      * @brief Record a telemetry reading.
      * 
      * Call this for each sensor/state update during the control loop.
-     * If the buffer is full, the oldest reading is discarded (ring behavior via clear+re-add).
+     * If the buffer is full, the oldest reading is overwritten in O(1).
      * 
      * @param msg The telemetry message to record
-     * @return true if recorded successfully, false if buffer was full (still recorded, but overwrote)
+     * @return true (the reading is always recorded; overwrites count as bufferOverflows)
      */
     bool Record(const MsgType& msg) {
         std::lock_guard<std::mutex> lock(m_mutex);
-
-        // Ring-buffer behavior: drop oldest when full
-        if (m_buffer.size() >= m_config.maxBufferedMessages) {
-            DropOldestUnlocked();
-            ++m_metrics.bufferOverflows;
-        }
-
-        m_buffer.push_back(msg);
-        ++m_metrics.messagesRecorded;
+        PushUnlocked(msg);
         return true;
     }
 
@@ -91,12 +114,7 @@ public:
     void RecordBatch(InputIt first, InputIt last) {
         std::lock_guard<std::mutex> lock(m_mutex);
         for (auto it = first; it != last; ++it) {
-            if (m_buffer.size() >= m_config.maxBufferedMessages) {
-                DropOldestUnlocked();
-                ++m_metrics.bufferOverflows;
-            }
-            m_buffer.push_back(*it);
-            ++m_metrics.messagesRecorded;
+            PushUnlocked(*it);
         }
     }
 
@@ -110,9 +128,8 @@ public:
      */
     template<typename Adapter>
     bool MaybeFlush(Adapter& adapter) {
-        Storage localBuffer;
-        std::size_t messageCount = 0;
-        
+        std::lock_guard<std::mutex> flushLock(m_flushMutex);
+        std::size_t pending = 0;
         {
             std::lock_guard<std::mutex> lock(m_mutex);
             
@@ -122,19 +139,13 @@ public:
             }
             
             m_tickCount = 0;
-            
-            if (m_buffer.empty()) {
-                return false;
-            }
-            
-            // Swap buffer out while holding lock
-            localBuffer = std::move(m_buffer);
-            m_buffer = Storage{};
-            messageCount = localBuffer.size();
+            pending = m_count;
         }
-        // Lock released - now safe to do blocking I/O
         
-        return SendBuffer(adapter, std::move(localBuffer), messageCount);
+        if (pending == 0) {
+            return false;
+        }
+        return FlushPending(adapter, pending);
     }
 
     /**
@@ -145,25 +156,51 @@ public:
      */
     template<typename Adapter>
     bool ForceFlush(Adapter& adapter) {
-        Storage localBuffer;
-        std::size_t messageCount = 0;
-        
+        std::lock_guard<std::mutex> flushLock(m_flushMutex);
+        std::size_t pending = 0;
         {
             std::lock_guard<std::mutex> lock(m_mutex);
             m_tickCount = 0;
-            
-            if (m_buffer.empty()) {
-                return false;
-            }
-            
-            // Swap buffer out while holding lock
-            localBuffer = std::move(m_buffer);
-            m_buffer = Storage{};
-            messageCount = localBuffer.size();
+            pending = m_count;
         }
-        // Lock released - now safe to do blocking I/O
         
-        return SendBuffer(adapter, std::move(localBuffer), messageCount);
+        if (pending == 0) {
+            return false;
+        }
+        return FlushPending(adapter, pending);
+    }
+
+    /**
+     * @brief Encode and consume the oldest buffered messages that fit in @p capacity.
+     * 
+     * Building block for TelemetryBatcher, which coalesces several
+     * accumulators into one send. Report the send outcome through
+     * CompleteExternalFlush() so the metrics stay accurate.
+     * 
+     * @param out Destination buffer
+     * @param capacity Size of @p out in bytes
+     * @param maxMessages Upper bound on messages consumed
+     * @return Bytes written and messages consumed; nothing is consumed if
+     *         not even one message fits
+     */
+    TelemetryEncodeResult EncodePendingInto(uint8_t* out, std::size_t capacity,
+                                            std::size_t maxMessages = kMaxMessagesPerPacket) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count == 0 || maxMessages == 0 || !out || capacity < PacketSizeFor<MsgType>(1)) {
+            return {};
+        }
+        const std::size_t fit = std::min((capacity - PacketSizeFor<MsgType>(0)) / MsgType::kWireSize,
+                                         maxMessages);
+        TelemetryEncodeResult result;
+        result.messages = EncodeOldestUnlocked(fit, out, capacity, result.bytes);
+        return result;
+    }
+
+    /**
+     * @brief Record the outcome of sending bytes from EncodePendingInto().
+     */
+    void CompleteExternalFlush(bool sent, std::size_t messageCount) {
+        RecordFlushResult(sent, messageCount);
     }
 
     /**
@@ -171,7 +208,15 @@ public:
      */
     std::size_t BufferedCount() const {
         std::lock_guard<std::mutex> lock(m_mutex);
-        return m_buffer.size();
+        return m_count;
+    }
+
+    /**
+     * @brief Ring capacity: maxBufferedMessages, clamped to a fixed Storage capacity.
+     */
+    std::size_t Capacity() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_ring.size();
     }
 
     /**
@@ -179,20 +224,12 @@ public:
      */
     void Clear() {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_buffer.clear();
+        m_head = 0;
+        m_count = 0;
         m_tickCount = 0;
     }
 
-    /**
-     * @brief Metrics for diagnostics.
-     */
-    struct Metrics {
-        uint64_t messagesRecorded{0};
-        uint64_t messagesSent{0};
-        uint64_t packetsSent{0};
-        uint64_t bufferOverflows{0};
-        uint64_t sendFailures{0};
-    };
+    using Metrics = TelemetryAccumulatorMetrics;
 
     Metrics GetMetrics() const {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -206,67 +243,144 @@ public:
 
     /**
      * @brief Update configuration.
+     * 
+     * A capacity change keeps the newest buffered messages that still fit.
      */
     void SetConfig(const TelemetryAccumulatorConfig& config) {
+        std::lock_guard<std::mutex> flushLock(m_flushMutex);
         std::lock_guard<std::mutex> lock(m_mutex);
         m_config = config;
+        ResizeRingUnlocked();
     }
 
 private:
+    /// Ring capacity for the current config (at least one slot)
+    std::size_t TargetCapacityUnlocked() const {
+        std::size_t capacity = std::max<std::size_t>(m_config.maxBufferedMessages, 1);
+        if constexpr (StaticCapacity<Storage>::value > 0) {
+            capacity = std::min(capacity, StaticCapacity<Storage>::value);
+        }
+        return std::min(capacity, kMaxMessagesPerPacket);
+    }
+
+    /// Size the ring for the config, keeping the newest messages (caller holds both locks)
+    void ResizeRingUnlocked() {
+        const std::size_t capacity = TargetCapacityUnlocked();
+        if (capacity != m_ring.size()) {
+            Storage resized{};
+            resized.resize(capacity);
+            const std::size_t keep = std::min(m_count, capacity);
+            const std::size_t skip = m_count - keep;
+            for (std::size_t i = 0; i < keep; ++i) {
+                resized[i] = m_ring[(m_head + skip + i) % m_ring.size()];
+            }
+            m_ring = std::move(resized);
+            m_head = 0;
+            m_count = keep;
+        }
+        // Fallback encode buffer holds a full ring; allocated here, never on flush
+        m_wireBuffer.resize(PacketSizeFor<MsgType>(capacity));
+    }
+
+    /// Append at the tail; when full, overwrite the oldest slot in O(1)
+    void PushUnlocked(const MsgType& msg) {
+        const std::size_t capacity = m_ring.size();
+        if (m_count == capacity) {
+            m_ring[m_head] = msg;
+            m_head = (m_head + 1 == capacity) ? 0 : m_head + 1;
+            ++m_metrics.bufferOverflows;
+        } else {
+            std::size_t tail = m_head + m_count;
+            if (tail >= capacity) {
+                tail -= capacity;
+            }
+            m_ring[tail] = msg;
+            ++m_count;
+        }
+        ++m_metrics.messagesRecorded;
+    }
+
     /**
-     * @brief Send a buffer of messages (called without holding m_mutex).
+     * @brief Encode and consume up to @p limit of the oldest messages.
+     * 
+     * The occupied region is at most two contiguous spans of the ring, encoded
+     * back to back straight into @p out. Consumed messages are removed even if
+     * encoding fails (as a swapped-out buffer was before).
      * 
-     * This helper is called after the buffer has been swapped out of the
-     * accumulator, allowing blocking I/O without blocking Record() calls.
+     * @return Messages consumed; @p written is 0 on encode failure
      */
-    template<typename Adapter>
-    bool SendBuffer(Adapter& adapter, Storage&& buffer, std::size_t messageCount) {
-        // Build packet from extracted buffer
-        TypedPacket<MsgType, Storage> packet;
-        packet.messages = std::move(buffer);
-        
-        // Encode to wire format
-        m_wireBuffer.clear();
-        if (!EncodeTypedPacket(packet, m_wireBuffer)) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            ++m_metrics.sendFailures;
-            return false;
+    std::size_t EncodeOldestUnlocked(std::size_t limit, uint8_t* out, std::size_t capacity, std::size_t& written) {
+        const std::size_t n = std::min(m_count, limit);
+        const std::size_t firstCount = std::min(n, m_ring.size() - m_head);
+        if (!EncodePacketFromSpans(m_ring.data() + m_head, firstCount, m_ring.data(), n - firstCount,
+                                   0, out, capacity, written)) {
+            written = 0;
         }
+        m_head = (m_head + n) % m_ring.size();
+        m_count -= n;
+        if (m_count == 0) {
+            m_head = 0;  // Keep the next batch in a single span
+        }
+        return n;
+    }
 
-        // Send (potentially blocking syscall - but we don't hold the lock!)
-        if (!adapter.SendBytes(m_wireBuffer.data(), m_wireBuffer.size())) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            ++m_metrics.sendFailures;
-            return false;
+    /**
+     * @brief Encode the oldest @p pending messages as one packet and send it.
+     * 
+     * m_mutex is held only while encoding; transport I/O runs without it so
+     * Record() is never blocked by a slow socket. When the adapter supports
+     * ReserveTx the packet is encoded directly into its TX buffer.
+     */
+    template<typename Adapter>
+    bool FlushPending(Adapter& adapter, std::size_t pending) {
+        const std::size_t maxBytes = PacketSizeFor<MsgType>(pending);
+        std::size_t written = 0;
+        std::size_t consumed = 0;
+
+        if constexpr (std::is_base_of_v<ByteWriter, Adapter>) {
+            const MutableByteSpan span = adapter.ReserveTx(maxBytes);
+            if (span.data && span.length >= maxBytes) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    consumed = EncodeOldestUnlocked(pending, span.data, span.length, written);
+                }
+                const bool ok = written > 0 && adapter.CommitTx(written);
+                if (written == 0) {
+                    adapter.CommitTx(0);
+                }
+                return RecordFlushResult(ok, consumed);
+            }
         }
 
-        // Update metrics
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_metrics.messagesSent += messageCount;
-            ++m_metrics.packetsSent;
+            consumed = EncodeOldestUnlocked(pending, m_wireBuffer.data(), m_wireBuffer.size(), written);
         }
+        // Potentially blocking - but m_mutex is not held
+        const bool ok = written > 0 && adapter.SendBytes(m_wireBuffer.data(), written);
+        return RecordFlushResult(ok, consumed);
+    }
+
+    bool RecordFlushResult(bool ok, std::size_t messageCount) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!ok) {
+            ++m_metrics.sendFailures;
+            return false;
+        }
+        m_metrics.messagesSent += messageCount;
+        ++m_metrics.packetsSent;
         return true;
     }
 
     TelemetryAccumulatorConfig m_config;
-    Storage m_buffer{};
-    std::vector<uint8_t> m_wireBuffer;  // Persistent buffer, capacity retained across flushes
+    Storage m_ring{};                   // Fixed-size ring; occupied slots [m_head, m_head + m_count)
+    std::size_t m_head{0};
+    std::size_t m_count{0};
+    std::vector<uint8_t> m_wireBuffer;  // Fallback encode buffer for one full ring
     std::size_t m_tickCount{0};
     Metrics m_metrics{};
-    mutable std::mutex m_mutex;
-
-    void DropOldestUnlocked() {
-        if (m_buffer.empty()) {
-            return;
-        }
-
-        // Shift everything left by one; O(n) but small (default 64)
-        for (std::size_t i = 1; i < m_buffer.size(); ++i) {
-            m_buffer[i - 1] = std::move(m_buffer[i]);
-        }
-        m_buffer.pop_back();
-    }
+    mutable std::mutex m_mutex;         // Ring, counters, config
+    std::mutex m_flushMutex;            // Serializes flushes (owns m_wireBuffer)
 };
 
 /**
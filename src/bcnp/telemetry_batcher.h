@@ -0,0 +1,312 @@
+#pragma once
+
+/**
+ * @file telemetry_batcher.h
+ * @brief Coalesces several telemetry accumulators into one send per tick.
+ */
+
+#include "bcnp/packet.h"
+#include "bcnp/telemetry_accumulator.h"
+#include "bcnp/transport/adapter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace bcnp {
+
+/**
+ * @brief Configuration for TelemetryBatcher.
+ */
+struct TelemetryBatcherConfig {
+    /// Flush interval: send telemetry every N control loop ticks
+    std::size_t flushIntervalTicks{2};
+
+    /// Send buffer size for stream transports (TCP): one send per tick while pending data fits
+    std::size_t bufferSize{16 * 1024};
+
+    /// Datagram limit (0 = stream transport). 1472 fits a 1500-byte Ethernet MTU over IPv4/UDP.
+    std::size_t maxDatagramSize{0};
+};
+
+/**
+ * @brief Encodes packets from several telemetry accumulators back to back
+ *        and emits them with a single send.
+ *
+ * Each TelemetryAccumulator flushing on its own costs one send() syscall
+ * (one TCP segment or UDP datagram) per message type per tick. The wire
+ * format allows packets to be concatenated on a stream, so the batcher
+ * drains every registered accumulator into one buffer and sends it once.
+ *
+ * With maxDatagramSize set, every send is a self-contained datagram no
+ * larger than that: an accumulator whose backlog does not fit is split
+ * into several packets across datagrams, so nothing fragments at the IP
+ * layer. Adapters deriving from ByteWriter are encoded into in place via
+ * ReserveTx()/CommitTx().
+ *
+ * Accepts TelemetryAccumulator and MpscTelemetryAccumulator (anything with
+ * EncodePendingInto() and CompleteExternalFlush()); registered
+ * accumulators must outlive the batcher and should not also be flushed
+ * directly.
+ *
+ * @code{cpp}
+ *   TelemetryAccumulator<DrivetrainState> drivetrain;
+ *   TelemetryAccumulator<EncoderData> encoders;
+ *   TelemetryBatcher batcher;
+ *   batcher.Add(drivetrain);
+ *   batcher.Add(encoders);
+ *
+ *   // At end of Periodic:
+ *   batcher.MaybeFlush(tcpAdapter);  // One send for all types
+ * @endcode
+ *
+ * Thread-safety: Add() and the flush calls must come from one thread.
+ * Producers keep recording into the accumulators concurrently.
+ */
+class TelemetryBatcher {
+public:
+    /**
+     * @brief Send statistics.
+     */
+    struct Metrics {
+        uint64_t flushes{0};      ///< Ticks that sent at least one packet
+        uint64_t sends{0};        ///< SendBytes()/CommitTx() calls
+        uint64_t packetsSent{0};
+        uint64_t bytesSent{0};
+        uint64_t sendFailures{0};
+        std::size_t lastFlushBytes{0};
+        std::size_t lastFlushPackets{0};
+
+        double PacketsPerSend() const {
+            return sends == 0 ? 0.0 : static_cast<double>(packetsSent) / static_cast<double>(sends);
+        }
+        double BytesPerFlush() const {
+            return flushes == 0 ? 0.0 : static_cast<double>(bytesSent) / static_cast<double>(flushes);
+        }
+    };
+
+    explicit TelemetryBatcher(TelemetryBatcherConfig config = {})
+        : m_config(config) {
+        m_buffer.resize(SegmentSize());
+    }
+
+    TelemetryBatcher(const TelemetryBatcher&) = delete;
+    TelemetryBatcher& operator=(const TelemetryBatcher&) = delete;
+
+    /**
+     * @brief Register an accumulator; packets are emitted in registration order.
+     * @return false if one of its packets could never fit in a send buffer
+     */
+    template<typename Accumulator>
+    bool Add(Accumulator& accumulator) {
+        const std::size_t minPacketSize = PacketSizeFor<typename Accumulator::Message>(1);
+        if (minPacketSize > SegmentSize()) {
+            return false;
+        }
+        m_sources.push_back({&accumulator, &EncodeThunk<Accumulator>, &CompleteThunk<Accumulator>,
+                             &CapacityThunk<Accumulator>, &PendingBytesThunk<Accumulator>, minPacketSize});
+        m_pending.reserve(m_sources.size());
+        return true;
+    }
+
+    /**
+     * @brief Flush if interval has elapsed.
+     * @return true if anything was sent
+     */
+    template<typename Adapter>
+    bool MaybeFlush(Adapter& adapter) {
+        ++m_tickCount;
+        if (m_tickCount < m_config.flushIntervalTicks) {
+            return false;
+        }
+        m_tickCount = 0;
+        return Flush(adapter);
+    }
+
+    /**
+     * @brief Flush every registered accumulator now.
+     * @return true if anything was sent and every send succeeded
+     */
+    template<typename Adapter>
+    bool ForceFlush(Adapter& adapter) {
+        m_tickCount = 0;
+        return Flush(adapter);
+    }
+
+    Metrics GetMetrics() const { return m_metrics; }
+    void ResetMetrics() { m_metrics = {}; }
+
+    std::size_t SourceCount() const { return m_sources.size(); }
+
+private:
+    using EncodeFn = TelemetryEncodeResult (*)(void*, uint8_t*, std::size_t, std::size_t);
+    using CompleteFn = void (*)(void*, bool, std::size_t);
+    using CapacityFn = std::size_t (*)(const void*);
+    using PendingBytesFn = std::size_t (*)(const void*, std::size_t);
+
+    struct Source {
+        void* accumulator;
+        EncodeFn encode;
+        CompleteFn complete;
+        CapacityFn capacity;
+        PendingBytesFn pendingBytes;
+        std::size_t minPacketSize;  // One-message packet
+        std::size_t budget{0};      // Messages still allowed this flush
+    };
+
+    struct Pending {
+        std::size_t source;
+        std::size_t messages;
+    };
+
+    template<typename Accumulator>
+    static TelemetryEncodeResult EncodeThunk(void* accumulator, uint8_t* out, std::size_t capacity,
+                                             std::size_t maxMessages) {
+        return static_cast<Accumulator*>(accumulator)->EncodePendingInto(out, capacity, maxMessages);
+    }
+
+    template<typename Accumulator>
+    static void CompleteThunk(void* accumulator, bool sent, std::size_t messages) {
+        static_cast<Accumulator*>(accumulator)->CompleteExternalFlush(sent, messages);
+    }
+
+    template<typename Accumulator>
+    static std::size_t CapacityThunk(const void* accumulator) {
+        return static_cast<const Accumulator*>(accumulator)->Capacity();
+    }
+
+    /// Encoded size of one packet holding up to @p maxMessages of the buffered messages
+    template<typename Accumulator>
+    static std::size_t PendingBytesThunk(const void* accumulator, std::size_t maxMessages) {
+        const std::size_t pending =
+            std::min(static_cast<const Accumulator*>(accumulator)->BufferedCount(), maxMessages);
+        return pending == 0 ? 0 : PacketSizeFor<typename Accumulator::Message>(pending);
+    }
+
+    /// Bytes FillSegment() would write from source @p next on, capped at @p capacity
+    std::size_t PendingSegmentBytes(std::size_t next, std::size_t capacity) const {
+        std::size_t bytes = 0;
+        for (std::size_t i = next; i < m_sources.size() && bytes < capacity; ++i) {
+            const Source& source = m_sources[i];
+            bytes += source.pendingBytes(source.accumulator, source.budget);
+        }
+        return std::min(bytes, capacity);
+    }
+
+    std::size_t SegmentSize() const {
+        return m_config.maxDatagramSize > 0 ? m_config.maxDatagramSize : m_config.bufferSize;
+    }
+
+    /**
+     * @brief Fill one send segment with packets, starting at source @p next.
+     *
+     * Encoding failures are reported to their accumulator immediately;
+     * packets written are recorded in m_pending until the send completes.
+     * Each source contributes at most one ring's worth per flush, so
+     * producers recording during the flush cannot keep it going forever.
+     *
+     * @return Bytes written; @p next is the first source that may still have data
+     */
+    std::size_t FillSegment(uint8_t* out, std::size_t capacity, std::size_t& next) {
+        std::size_t used = 0;
+        m_pending.clear();
+        while (next < m_sources.size()) {
+            Source& source = m_sources[next];
+            const TelemetryEncodeResult result =
+                source.encode(source.accumulator, out + used, capacity - used, source.budget);
+            source.budget -= result.messages;
+            if (result.messages == 0) {
+                const bool waiting = source.pendingBytes(source.accumulator, source.budget) > 0;
+                if (waiting && capacity - used < source.minPacketSize) {
+                    break;  // Segment full: continue this source in the next one
+                }
+                ++next;     // Drained
+                continue;
+            }
+            if (result.bytes == 0) {
+                source.complete(source.accumulator, false, result.messages);
+                continue;
+            }
+            used += result.bytes;
+            m_pending.push_back({next, result.messages});
+        }
+        return used;
+    }
+
+    template<typename Adapter>
+    bool Flush(Adapter& adapter) {
+        const std::size_t segmentSize = m_buffer.size();
+        std::size_t next = 0;
+        std::size_t flushBytes = 0;
+        std::size_t flushPackets = 0;
+        bool allSent = true;
+        for (Source& source : m_sources) {
+            source.budget = source.capacity(source.accumulator);
+        }
+
+        while (next < m_sources.size()) {
+            uint8_t* out = m_buffer.data();
+            std::size_t capacity = segmentSize;
+            bool reserved = false;
+            if constexpr (std::is_base_of_v<ByteWriter, Adapter>) {
+                // Reserve only what is pending: the transport may evict or
+                // refuse other data to make room for the reservation
+                const std::size_t want = PendingSegmentBytes(next, segmentSize);
+                const MutableByteSpan span = want > 0 ? adapter.ReserveTx(want) : MutableByteSpan{};
+                if (span.data && span.length >= want) {
+                    out = span.data;
+                    capacity = want;
+                    reserved = true;
+                }
+            }
+
+            const std::size_t used = FillSegment(out, capacity, next);
+            bool ok = false;
+            if constexpr (std::is_base_of_v<ByteWriter, Adapter>) {
+                if (reserved) {
+                    ok = adapter.CommitTx(used) && used > 0;
+                } else if (used > 0) {
+                    ok = adapter.SendBytes(out, used);
+                }
+            } else if (used > 0) {
+                ok = adapter.SendBytes(out, used);
+            }
+            if (used == 0) {
+                break;  // Everything drained
+            }
+
+            ++m_metrics.sends;
+            for (const Pending& pending : m_pending) {
+                const Source& source = m_sources[pending.source];
+                source.complete(source.accumulator, ok, pending.messages);
+            }
+            if (!ok) {
+                ++m_metrics.sendFailures;
+                allSent = false;
+                continue;
+            }
+            m_metrics.packetsSent += m_pending.size();
+            m_metrics.bytesSent += used;
+            flushPackets += m_pending.size();
+            flushBytes += used;
+        }
+
+        if (flushPackets == 0) {
+            return false;
+        }
+        ++m_metrics.flushes;
+        m_metrics.lastFlushBytes = flushBytes;
+        m_metrics.lastFlushPackets = flushPackets;
+        return allSent;
+    }
+
+    TelemetryBatcherConfig m_config;
+    std::vector<Source> m_sources;
+    std::vector<Pending> m_pending;
+    std::vector<uint8_t> m_buffer;
+    std::size_t m_tickCount{0};
+    Metrics m_metrics{};
+};
+
+} // namespace bcnp
@@ -1,10 +1,42 @@
 #pragma once
 
+#include "bcnp/packet.h"
+
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <type_traits>
+#include <vector>
 
 namespace bcnp {
 
+/**
+ * @brief Non-owning view of a contiguous byte range, used for batched I/O.
+ */
+struct ByteSpan {
+    const uint8_t* data{nullptr};
+    std::size_t length{0};
+};
+
+/**
+ * @brief Non-owning view of a writable byte range (see ByteWriter::ReserveTx).
+ */
+struct MutableByteSpan {
+    uint8_t* data{nullptr};
+    std::size_t length{0};
+};
+
+/**
+ * @brief Where a send sits within one packet sent in several pieces.
+ */
+enum class FramePart : uint8_t {
+    Whole,      ///< Stand-alone bytes (every plain SendBytes() call)
+    Begin,      ///< First piece of a packet
+    Continue,   ///< Middle piece
+    End,        ///< Last piece; the packet is complete
+};
+
 /**
  * @brief Interface for sending raw bytes over a transport.
  */
@@ -19,6 +51,346 @@ public:
      * @return true if sent successfully (or queued), false on error
      */
     virtual bool SendBytes(const uint8_t* data, std::size_t length) = 0;
+
+    /**
+     * @brief Send several buffers, in order, as if by consecutive SendBytes() calls.
+     * 
+     * Transports override this to gather the buffers into a single syscall.
+     * The default implementation simply loops over SendBytes().
+     * 
+     * @param spans Buffers to send
+     * @param count Number of entries in @p spans
+     * @return true if every buffer was sent (or queued), false on error
+     */
+    virtual bool SendBytesV(const ByteSpan* spans, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!SendBytes(spans[i].data, spans[i].length)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Send one piece of a packet that is written in several calls.
+     * 
+     * Transports that reorder sends (TcpPosixAdapter's priority lanes)
+     * override this to keep the pieces together: once the Begin piece goes
+     * out, nothing else is sent until the End piece has. The default sends
+     * each piece like SendBytes(), so other sends made in between land
+     * inside the packet.
+     * 
+     * @return true if the piece was sent (or queued), false on error or if
+     *         the transport cannot take it now (retry the same piece)
+     */
+    virtual bool SendFramePart(const uint8_t* data, std::size_t length, FramePart part) {
+        (void)part;
+        return SendBytes(data, length);
+    }
+
+    /**
+     * @brief Reserve writable space in the transport's TX buffer.
+     * 
+     * Lets callers encode straight into the transport instead of building a
+     * temporary buffer and copying it through SendBytes(). At most one
+     * reservation may be outstanding; it must be closed by CommitTx().
+     * 
+     * @param length Bytes required
+     * @return Span of exactly @p length bytes, or an empty span if the
+     *         transport does not support reservations or cannot take the data now
+     */
+    virtual MutableByteSpan ReserveTx(std::size_t length) {
+        (void)length;
+        return {};
+    }
+
+    /**
+     * @brief Send the first @p length bytes of the outstanding reservation.
+     * @param length Bytes actually written (0 abandons the reservation)
+     * @return true if the bytes were sent (or queued), false on error
+     */
+    virtual bool CommitTx(std::size_t length) {
+        (void)length;
+        return false;
+    }
+};
+
+/**
+ * @brief Encode a typed packet directly into a writer's TX buffer.
+ * 
+ * @param packet The packet to encode
+ * @param writer Transport supporting ReserveTx()/CommitTx()
+ * @return true if the packet was encoded and committed, false if the writer
+ *         has no reservation available or encoding failed
+ */
+template<typename MsgType, typename Storage>
+bool EncodeTypedPacket(const TypedPacket<MsgType, Storage>& packet, ByteWriter& writer) {
+    const MutableByteSpan span = writer.ReserveTx(EncodedPacketSize(packet));
+    if (!span.data) {
+        return false;
+    }
+    std::size_t written = 0;
+    if (!EncodeTypedPacket(packet, span.data, span.length, written)) {
+        writer.CommitTx(0);
+        return false;
+    }
+    return writer.CommitTx(written);
+}
+
+/**
+ * @brief Send a typed packet, encoding in place when the adapter allows it.
+ * 
+ * ByteWriter adapters that support ReserveTx() get the packet encoded directly
+ * into their TX buffer. Otherwise (or for duck-typed adapters exposing only
+ * SendBytes()) the packet is encoded into @p scratch, whose capacity is
+ * retained across calls, and sent with SendBytes().
+ * 
+ * @param adapter Transport to send through
+ * @param packet The packet to send
+ * @param scratch Fallback encode buffer
+ * @param extraFlags Flags ORed into the header, e.g. kFlagAcceptsCompressed
+ * @return true if the packet was sent or queued
+ */
+template<typename Adapter, typename MsgType, typename Storage>
+bool SendTypedPacket(Adapter& adapter, const TypedPacket<MsgType, Storage>& packet,
+                     std::vector<uint8_t>& scratch, uint8_t extraFlags = 0) {
+    if constexpr (std::is_base_of_v<ByteWriter, Adapter>) {
+        const std::size_t required = EncodedPacketSize(packet);
+        const MutableByteSpan span = adapter.ReserveTx(required);
+        if (span.data) {
+            std::size_t written = 0;
+            if (!EncodeTypedPacket(packet, span.data, span.length, written, extraFlags)) {
+                adapter.CommitTx(0);
+                return false;
+            }
+            return adapter.CommitTx(written);
+        }
+    }
+    if (!EncodeTypedPacket(packet, scratch, extraFlags)) {
+        return false;
+    }
+    return adapter.SendBytes(scratch.data(), scratch.size());
+}
+
+/**
+ * @brief Sends one packet of any size through a fixed chunk buffer.
+ * 
+ * Streaming counterpart of EncodeTypedPacket() for batches too large to
+ * hold encoded (up to kMaxMessagesPerPacket messages): the header and
+ * messages are encoded into a ChunkBytes buffer that is sent whenever it
+ * fills, and the CRC is computed incrementally, so memory use does not
+ * depend on the batch size. Receivers parse the result with
+ * StreamParser::SetStreamingCallbacks() when it exceeds their buffer.
+ * 
+ * A chunk the writer rejects stays buffered: Write() then accepts fewer
+ * messages than offered and Finish() returns false, and calling them
+ * again later retries, so a congested link never truncates the frame.
+ * 
+ * Chunks go out through ByteWriter::SendFramePart(). TcpPosixAdapter then
+ * sends nothing from other lanes from the first chunk until the last, and
+ * refuses other sends on the writer's lane meanwhile. A plain ByteWriter
+ * cannot tell, so the writer needs the transport to itself until the
+ * packet is finished or aborted: anything else sent in between lands
+ * inside the frame.
+ * 
+ * If a message fails to encode, or the caller gives up part way, call
+ * Abort(): once part of the frame is on the wire it cannot be taken back,
+ * so the rest is filled out with zeroed messages and a CRC that cannot
+ * match. The receiver drops exactly this frame as a ChecksumMismatch and
+ * stays in sync with the stream. A writer destroyed part way through tries
+ * Abort() once; if the transport refuses, the frame stays open (holding
+ * back TcpPosixAdapter's other lanes) until the connection drops.
+ * 
+ * @code{cpp}
+ * ChunkedPacketWriter<TrajectoryPoint> upload(adapter, points.size());
+ * std::size_t sent = 0;
+ * while (sent < points.size()) {
+ *     sent += upload.Write(&points[sent], points.size() - sent);   // Poll or wait when it stalls
+ * }
+ * while (!upload.Finish()) { ... }
+ * @endcode
+ * 
+ * @tparam MsgType Message struct type with Encode() and kWireSize
+ * @tparam ChunkBytes Encode buffer size, the largest single send
+ */
+template<typename MsgType, std::size_t ChunkBytes = 4096>
+class ChunkedPacketWriter {
+    static_assert(ChunkBytes >= kHeaderSizeV3 + MsgType::kWireSize + kChecksumSize,
+                  "ChunkedPacketWriter chunk too small for a header and one message");
+
+public:
+    /**
+     * @param writer Transport to send through; must outlive the writer
+     * @param messageCount Messages the packet will hold
+     * @param flags Header flags byte (kFlagCompressed is not supported)
+     */
+    ChunkedPacketWriter(ByteWriter& writer, std::size_t messageCount, uint8_t flags = 0)
+        : m_writer(writer), m_count(messageCount) {
+        m_buffer[kHeaderMajorIndex] = kProtocolMajorV3;
+        m_buffer[kHeaderMinorIndex] = kProtocolMinorV3;
+        m_buffer[kHeaderFlagsIndex] = static_cast<uint8_t>(flags & ~kFlagCompressed);
+        detail::StoreU16(static_cast<uint16_t>(MsgType::kTypeId), &m_buffer[kHeaderMsgTypeIndex]);
+        detail::StoreU16(static_cast<uint16_t>(messageCount), &m_buffer[kHeaderMsgCountIndex]);
+        m_fill = kHeaderSizeV3;
+    }
+
+    ~ChunkedPacketWriter() {
+        if (m_begun && !IsClosed()) {
+            Abort();
+        }
+    }
+
+    ChunkedPacketWriter(const ChunkedPacketWriter&) = delete;
+    ChunkedPacketWriter& operator=(const ChunkedPacketWriter&) = delete;
+
+    /// false if messageCount exceeds kMaxMessagesPerPacket (nothing is sent)
+    bool IsValid() const { return m_count <= kMaxMessagesPerPacket; }
+
+    /**
+     * @brief Encode up to @p count more messages, sending each chunk that fills.
+     * @return Messages accepted; fewer than @p count if the writer refused a
+     *         chunk, the packet is full, or a message failed to encode
+     *         (see HasFailed(); the packet must then be aborted)
+     */
+    std::size_t Write(const MsgType* messages, std::size_t count) {
+        if (!IsValid() || m_failed) {
+            return 0;
+        }
+        count = std::min(count, m_count - m_written);
+        std::size_t accepted = 0;
+        while (accepted < count) {
+            if (ChunkBytes - m_fill < MsgType::kWireSize && !Flush()) {
+                break;
+            }
+            const std::size_t n = std::min(count - accepted, (ChunkBytes - m_fill) / MsgType::kWireSize);
+            if (!EncodeMessages(messages + accepted, n)) {
+                m_failed = true;
+                break;
+            }
+            m_fill += n * MsgType::kWireSize;
+            m_written += n;
+            accepted += n;
+        }
+        return accepted;
+    }
+
+    /**
+     * @brief Append the CRC once every message was written and send what is buffered.
+     * @return true when the whole packet has been handed to the writer
+     */
+    bool Finish() {
+        if (!IsValid() || m_failed || m_written != m_count) {
+            return false;
+        }
+        if (!m_crcAppended) {
+            if (ChunkBytes - m_fill < kChecksumSize && !Flush()) {
+                return false;
+            }
+            detail::StoreU32(UpdateCrc32(m_crc, m_buffer.data(), m_fill), &m_buffer[m_fill]);
+            m_fill += kChecksumSize;
+            m_crcAppended = true;
+        }
+        return Flush();
+    }
+
+    /**
+     * @brief Close the packet without completing it, so the receiver rejects it.
+     * 
+     * If nothing has been sent yet the buffered bytes are discarded.
+     * Otherwise the remaining messages are sent as zeros and the frame is
+     * closed with an inverted CRC, keeping the announced length intact.
+     * 
+     * @return true once the packet is closed; false while the writer refuses
+     *         a chunk (call again, before sending anything else)
+     */
+    bool Abort() {
+        if (IsComplete()) {
+            return true;
+        }
+        m_failed = true;
+        if (!m_begun) {
+            m_fill = 0;
+            m_crcAppended = true;
+            return true;
+        }
+        while (!m_crcAppended && m_written + m_padded < m_count) {
+            if (ChunkBytes - m_fill < MsgType::kWireSize && !Flush()) {
+                return false;
+            }
+            const std::size_t n = std::min(m_count - m_written - m_padded,
+                                           (ChunkBytes - m_fill) / MsgType::kWireSize);
+            std::fill_n(&m_buffer[m_fill], n * MsgType::kWireSize, uint8_t{0});
+            m_fill += n * MsgType::kWireSize;
+            m_padded += n;
+        }
+        if (!m_crcAppended) {
+            if (ChunkBytes - m_fill < kChecksumSize && !Flush()) {
+                return false;
+            }
+            // Inverted, so it never matches what the receiver computes
+            detail::StoreU32(~UpdateCrc32(m_crc, m_buffer.data(), m_fill), &m_buffer[m_fill]);
+            m_fill += kChecksumSize;
+            m_crcAppended = true;
+        }
+        return Flush();
+    }
+
+    /// Messages accepted so far
+    std::size_t MessagesWritten() const { return m_written; }
+
+    /// true once Finish() succeeded
+    bool IsComplete() const { return m_crcAppended && m_fill == 0 && !m_failed; }
+
+    /// true after a message failed to encode or Abort() was called
+    bool HasFailed() const { return m_failed; }
+
+    /// true once the transport has the whole frame, finished or aborted
+    bool IsClosed() const { return m_crcAppended && m_fill == 0; }
+
+private:
+    bool EncodeMessages(const MsgType* messages, std::size_t n) {
+        uint8_t* out = &m_buffer[m_fill];
+        if constexpr (detail::has_batch_codec<MsgType>::value) {
+            return MsgType::EncodeBatch(messages, n, out);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!messages[i].Encode(out + i * MsgType::kWireSize, MsgType::kWireSize)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    bool Flush() {
+        if (m_fill == 0) {
+            return true;
+        }
+        FramePart part = m_crcAppended ? FramePart::End : FramePart::Continue;
+        if (!m_begun) {
+            part = m_crcAppended ? FramePart::Whole : FramePart::Begin;
+        }
+        if (!m_writer.SendFramePart(m_buffer.data(), m_fill, part)) {
+            return false;
+        }
+        if (!m_crcAppended) {
+            m_crc = UpdateCrc32(m_crc, m_buffer.data(), m_fill);
+        }
+        m_begun = true;
+        m_fill = 0;
+        return true;
+    }
+
+    ByteWriter& m_writer;
+    std::size_t m_count;
+    std::size_t m_written{0};
+    std::size_t m_padded{0};      // Zeroed messages sent by Abort()
+    std::size_t m_fill{0};
+    uint32_t m_crc{0};
+    bool m_begun{false};          // First chunk handed to the writer
+    bool m_crcAppended{false};
+    bool m_failed{false};
+    std::array<uint8_t, ChunkBytes> m_buffer{};
 };
 
 /**
@@ -35,6 +407,32 @@ public:
      * @return Number of bytes actually read (0 if none available)
      */
     virtual std::size_t ReceiveChunk(uint8_t* buffer, std::size_t maxLength) = 0;
+
+    /**
+     * @brief Receive available bytes in place, without copying them out.
+     * 
+     * Receive-side counterpart of ReserveTx(): adapters that read into
+     * buffers of their own (io_uring registered buffers) return a view of
+     * them. The view stays valid until the next ReceiveChunk() or
+     * ReceiveInPlace() call.
+     * 
+     * @return Received bytes; empty if none are available or the adapter
+     *         does not support it (see SupportsReceiveInPlace())
+     */
+    virtual ByteSpan ReceiveInPlace() { return {}; }
+
+    /// true if ReceiveInPlace() should be used instead of ReceiveChunk()
+    virtual bool SupportsReceiveInPlace() const { return false; }
+
+    /**
+     * @brief Descriptor that becomes readable when ReceiveChunk() may return data.
+     * 
+     * Readiness hook for event-driven drivers (see DispatcherDriver::Start()).
+     * The descriptor may change over the adapter's lifetime (reconnects);
+     * -1 means none is available right now and the caller should fall back
+     * to periodic ReceiveChunk() calls.
+     */
+    virtual int ReadableFd() const { return -1; }
 };
 
 /**
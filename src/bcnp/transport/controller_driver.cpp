@@ -1,29 +1,188 @@
 #include "bcnp/transport/controller_driver.h"
 
+#include "bcnp/capture.h"
 #include "bcnp/packet.h"
+#include "bcnp/realtime.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BCNP_DRIVER_HAS_POLL 1
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 namespace bcnp {
 
 DispatcherDriver::DispatcherDriver(PacketDispatcher& dispatcher, DuplexAdapter& adapter)
-    : m_dispatcher(dispatcher), m_adapter(adapter) {
-        // Allocate buffer on heap to prevent stack overflow
-        m_rxScratch.resize(8192);
+    : DispatcherDriver(dispatcher, adapter, nullptr, 0) {}
+
+void DispatcherDriver::SetRxBuffer(uint8_t* buffer, std::size_t length) {
+    if (buffer && length > 0) {
+        m_rx = buffer;
+        m_rxLength = length;
+        return;
     }
+    // Allocate buffer on heap to prevent stack overflow
+    m_rxOwned.resize(8192);
+    m_rx = m_rxOwned.data();
+    m_rxLength = m_rxOwned.size();
+}
+
+DispatcherDriver::~DispatcherDriver() {
+    Stop();
+}
 
 void DispatcherDriver::PollOnce() {
+    if (IsRunning()) {
+        return;  // The I/O thread owns receiving
+    }
     // Limit iterations to prevent starvation if data arrives faster than we can process
     constexpr std::size_t kMaxChunksPerPoll = 10;
     for (std::size_t i = 0; i < kMaxChunksPerPoll; ++i) {
-        const std::size_t received = m_adapter.ReceiveChunk(m_rxScratch.data(), m_rxScratch.size());
-        if (received == 0) {
+        if (ReceiveOnce() == 0) {
             break;
         }
-        m_dispatcher.PushBytes(m_rxScratch.data(), received);
     }
 }
 
+/**
+ * @brief Read one chunk and feed it to the dispatcher.
+ *
+ * The adapter lock is released before dispatching so handlers may send
+ * through the driver. Adapters with ReceiveInPlace() are pushed from their
+ * own buffers and m_rx is not used.
+ *
+ * @return Bytes received.
+ */
+std::size_t DispatcherDriver::ReceiveOnce() {
+    ByteSpan chunk{};
+    {
+        std::lock_guard<std::mutex> lock(m_adapterMutex);
+        if (m_adapter.SupportsReceiveInPlace()) {
+            chunk = m_adapter.ReceiveInPlace();   // Valid until our next receive call
+        } else {
+            chunk = {m_rx, m_adapter.ReceiveChunk(m_rx, m_rxLength)};
+        }
+    }
+    if (chunk.length == 0) {
+        return 0;
+    }
+    if (m_capture) {
+        m_capture->Record(chunk.data, chunk.length, m_captureStream);
+    }
+    m_push(m_sink, chunk.data, chunk.length);
+    return chunk.length;
+}
+
+/**
+ * @brief Start the I/O thread.
+ *
+ * @param config CPU pinning, SCHED_FIFO priority and idle wait bound.
+ * @return false if already running or the wake pipe cannot be created.
+ */
+bool DispatcherDriver::Start(DispatcherDriverThreadConfig config) {
+    if (m_running.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+#if defined(BCNP_DRIVER_HAS_POLL)
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        std::cerr << "DispatcherDriver: pipe failed errno=" << errno << std::endl;
+        m_running.store(false, std::memory_order_release);
+        return false;
+    }
+    m_wakeRead = fds[0];
+    m_wakeWrite = fds[1];
+    ::fcntl(m_wakeRead, F_SETFL, ::fcntl(m_wakeRead, F_GETFL, 0) | O_NONBLOCK);
+    ::fcntl(m_wakeWrite, F_SETFL, ::fcntl(m_wakeWrite, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    if (config.idleTimeout <= std::chrono::milliseconds::zero()) {
+        config.idleTimeout = std::chrono::milliseconds(1);
+    }
+    m_stopRequested.store(false, std::memory_order_release);
+    m_thread = std::thread([this, config]() { ThreadLoop(config); });
+    return true;
+}
+
+/**
+ * @brief Signal the I/O thread through the wake pipe and join it.
+ */
+void DispatcherDriver::Stop() {
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    m_stopRequested.store(true, std::memory_order_release);
+#if defined(BCNP_DRIVER_HAS_POLL)
+    const uint8_t wake = 1;
+    [[maybe_unused]] const ssize_t ignored = ::write(m_wakeWrite, &wake, sizeof(wake));
+#endif
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+#if defined(BCNP_DRIVER_HAS_POLL)
+    ::close(m_wakeRead);
+    ::close(m_wakeWrite);
+    m_wakeRead = -1;
+    m_wakeWrite = -1;
+#endif
+    m_running.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief I/O thread body: apply scheduling, then drain and wait until Stop().
+ *
+ * Unlike PollOnce() there is no per-wakeup chunk cap: everything readable
+ * is dispatched before the thread goes back to sleep.
+ */
+void DispatcherDriver::ThreadLoop(DispatcherDriverThreadConfig config) {
+    PinCurrentThread(config.cpu);
+    SetCurrentThreadFifo(config.fifoPriority);
+
+    while (!m_stopRequested.load(std::memory_order_acquire)) {
+        while (!m_stopRequested.load(std::memory_order_relaxed) && ReceiveOnce() > 0) {
+        }
+        WaitReadable(config.idleTimeout);
+    }
+}
+
+/**
+ * @brief Block until the adapter is readable, Stop() is called, or @p timeout passes.
+ */
+void DispatcherDriver::WaitReadable(std::chrono::milliseconds timeout) {
+#if defined(BCNP_DRIVER_HAS_POLL)
+    int adapterFd = -1;
+    {
+        std::lock_guard<std::mutex> lock(m_adapterMutex);
+        adapterFd = m_adapter.ReadableFd();
+    }
+    pollfd fds[2] = {};
+    fds[0].fd = m_wakeRead;
+    fds[0].events = POLLIN;
+    fds[1].fd = adapterFd;   // Negative descriptors are ignored by poll()
+    fds[1].events = POLLIN;
+    const int ready = ::poll(fds, 2, static_cast<int>(timeout.count()));
+    if (ready > 0 && (fds[0].revents & POLLIN)) {
+        uint8_t drain[16];
+        while (::read(m_wakeRead, drain, sizeof(drain)) > 0) {
+        }
+    }
+#else
+    std::this_thread::sleep_for(timeout);
+#endif
+}
+
 bool DispatcherDriver::SendBytes(const uint8_t* data, std::size_t length) {
+    std::lock_guard<std::mutex> lock(m_adapterMutex);
     return m_adapter.SendBytes(data, length);
 }
 
+bool DispatcherDriver::SendBytesV(const ByteSpan* spans, std::size_t count) {
+    std::lock_guard<std::mutex> lock(m_adapterMutex);
+    return m_adapter.SendBytesV(spans, count);
+}
+
 } // namespace bcnp
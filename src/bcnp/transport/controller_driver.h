@@ -3,49 +3,164 @@
 #include "bcnp/dispatcher.h"
 #include "bcnp/transport/adapter.h"
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace bcnp {
 
+class CaptureWriter;
+
+/**
+ * @brief Options for DispatcherDriver's dedicated I/O thread.
+ */
+struct DispatcherDriverThreadConfig {
+    int cpu{-1};                                  ///< Pin the thread to this CPU (-1 = no pinning, Linux only)
+    int fifoPriority{0};                          ///< SCHED_FIFO priority 1-99 (0 = default scheduler)
+    std::chrono::milliseconds idleTimeout{10};    ///< Longest wait before ReceiveChunk() runs anyway
+};
+
 /**
  * @brief Drives a PacketDispatcher from a transport adapter.
- * 
+ *
  * Connects a network transport (TCP, UDP, etc.) to a PacketDispatcher,
  * polling for incoming data and feeding it to the parser.
- * 
+ *
  * @code{cpp}
  * PacketDispatcher dispatcher;
  * TcpPosixAdapter adapter(5800);
  * DispatcherDriver driver(dispatcher, adapter);
- * 
+ *
  * // In main loop:
  * driver.PollOnce();
  * @endcode
+ *
+ * Threaded mode: Start() runs a background thread that blocks in poll() on
+ * the adapter's ReadableFd() and drains every readable byte into the
+ * dispatcher as soon as it arrives, so reaction time no longer depends on
+ * the caller's loop period. Handlers then run on that thread. The wait is
+ * bounded by idleTimeout so adapters without a descriptor, reconnects and
+ * TCP TX flushing keep ticking.
+ *
+ * @code{cpp}
+ * DispatcherDriverThreadConfig io;
+ * io.cpu = 2;
+ * io.fifoPriority = 50;   // Needs CAP_SYS_NICE; falls back to the default scheduler
+ * driver.Start(io);
+ * @endcode
+ *
+ * With SetCapture(), every chunk read by PollOnce() is also appended to a
+ * CaptureWriter for offline replay (see capture.h).
+ *
+ * Allocation-free setup: any sink with PushBytes() can be driven
+ * (FixedDispatcher, StaticDispatcher), and the receive buffer may be
+ * supplied by the caller, e.g. a LockedBuffer (see realtime.h).
+ *
+ * @code{cpp}
+ * FixedDispatcher<8> dispatcher;
+ * LockedBuffer rx(8192);
+ * DispatcherDriver driver(dispatcher, adapter, rx.Data(), rx.Size());
+ * @endcode
+ *
+ * Thread-safety: the Send*() methods serialize with the I/O thread and may
+ * be called while it runs; use them instead of the adapter directly.
+ * PollOnce() does nothing while the thread is running.
  */
 class DispatcherDriver {
 public:
     DispatcherDriver(PacketDispatcher& dispatcher, DuplexAdapter& adapter);
 
+    /**
+     * @brief Drive any dispatcher with PushBytes(), optionally into a caller-owned buffer.
+     * @param rxBuffer Receive buffer (nullptr = allocate 8 KiB); must outlive the driver
+     */
+    template<typename Sink>
+    DispatcherDriver(Sink& sink, DuplexAdapter& adapter, uint8_t* rxBuffer = nullptr, std::size_t rxLength = 0)
+        : m_sink(&sink),
+          m_push([](void* target, const uint8_t* data, std::size_t length) {
+              static_cast<Sink*>(target)->PushBytes(data, length);
+          }),
+          m_adapter(adapter) {
+        SetRxBuffer(rxBuffer, rxLength);
+    }
+
+    /// Stops the I/O thread if running
+    ~DispatcherDriver();
+
+    DispatcherDriver(const DispatcherDriver&) = delete;
+    DispatcherDriver& operator=(const DispatcherDriver&) = delete;
+
     /// Poll transport and feed data to dispatcher
     void PollOnce();
 
+    /**
+     * @brief Start the dedicated I/O thread.
+     * @return false if already running or the wake pipe cannot be created
+     */
+    bool Start(DispatcherDriverThreadConfig config = {});
+
+    /// Wake the I/O thread and join it
+    void Stop();
+
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    /// Log received chunks to @p writer under @p streamId (nullptr stops capturing; set before Start())
+    void SetCapture(CaptureWriter* writer, uint16_t streamId = 0) {
+        m_capture = writer;
+        m_captureStream = streamId;
+    }
+
     /// Send raw bytes through the adapter
     bool SendBytes(const uint8_t* data, std::size_t length);
 
-    /// Send a typed packet
-    template<typename MsgType>
-    bool SendPacket(const TypedPacket<MsgType>& packet) {
-        std::vector<uint8_t> buffer;
-        if (!EncodeTypedPacket(packet, buffer)) {
-            return false;
-        }
-        return m_adapter.SendBytes(buffer.data(), buffer.size());
+    /// Send several buffers in order (one gathered syscall where the adapter supports it)
+    bool SendBytesV(const ByteSpan* spans, std::size_t count);
+
+    /**
+     * @brief Set kFlagAcceptsCompressed on every packet sent with SendPacket().
+     *
+     * Lets the peer start sending compressed packets even if this side only
+     * ever sends uncompressed ones. Enable only if the dispatcher decodes them.
+     */
+    void SetAdvertiseCompressed(bool advertise) {
+        std::lock_guard<std::mutex> lock(m_adapterMutex);
+        m_txFlags = advertise ? kFlagAcceptsCompressed : 0;
+    }
+
+    /// Send a typed packet (encoded in place via ReserveTx when the adapter supports it)
+    template<typename MsgType, typename Storage>
+    bool SendPacket(const TypedPacket<MsgType, Storage>& packet) {
+        std::lock_guard<std::mutex> lock(m_adapterMutex);
+        return SendTypedPacket(m_adapter, packet, m_txScratch, m_txFlags);
     }
 
 private:
-    PacketDispatcher& m_dispatcher;
+    using PushFn = void (*)(void*, const uint8_t*, std::size_t);
+
+    void SetRxBuffer(uint8_t* buffer, std::size_t length);
+    std::size_t ReceiveOnce();
+    void ThreadLoop(DispatcherDriverThreadConfig config);
+    void WaitReadable(std::chrono::milliseconds timeout);
+
+    void* m_sink;
+    PushFn m_push;
     DuplexAdapter& m_adapter;
-    std::vector<uint8_t> m_rxScratch;
+    std::mutex m_adapterMutex;        // Serializes adapter calls between the I/O thread and senders
+    std::vector<uint8_t> m_rxOwned;   // Empty when the caller supplied the buffer
+    uint8_t* m_rx{nullptr};
+    std::size_t m_rxLength{0};
+    std::vector<uint8_t> m_txScratch; // Fallback encode buffer, capacity retained
+    uint8_t m_txFlags{0};             // Header flags added by SendPacket()
+    CaptureWriter* m_capture{nullptr};
+    uint16_t m_captureStream{0};
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopRequested{false};
+    int m_wakeRead{-1};
+    int m_wakeWrite{-1};
 };
 
 /// Backward-compatible alias (prefer DispatcherDriver for new code).
@@ -0,0 +1,215 @@
+/**
+ * @file io_uring.cpp
+ * @brief Raw-syscall io_uring ring setup, submission and completion.
+ *
+ * The shared ring indices are accessed with __atomic builtins, matching
+ * the kernel's ordering rules: the SQ tail and CQ head are published with
+ * release stores, the CQ tail is read with an acquire load.
+ */
+#include "bcnp/transport/io_uring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(BCNP_HAS_IO_URING)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bcnp {
+
+#if defined(BCNP_HAS_IO_URING)
+
+namespace {
+
+int RingSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int RingEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int RingRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+template<typename T>
+T* At(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+}
+
+} // namespace
+
+/**
+ * @brief Create the ring and map its queues.
+ *
+ * @param entries Submission queue size (rounded up to a power of two by the kernel)
+ * @return false if io_uring_setup() or a mapping fails; errno is preserved
+ */
+bool IoUring::Init(unsigned entries) {
+    Close();
+
+    io_uring_params params{};
+    const int fd = RingSetup(entries, &params);
+    if (fd < 0) {
+        return false;
+    }
+    m_ringFd = fd;
+
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+    }
+
+    m_sqRing = ::mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      m_ringFd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED) {
+        m_sqRing = nullptr;
+        Close();
+        return false;
+    }
+    if (singleMap) {
+        m_cqRing = m_sqRing;
+    } else {
+        m_cqRing = ::mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          m_ringFd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED) {
+            m_cqRing = nullptr;
+            Close();
+            return false;
+        }
+    }
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    m_sqes = ::mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    m_ringFd, IORING_OFF_SQES);
+    if (m_sqes == MAP_FAILED) {
+        m_sqes = nullptr;
+        Close();
+        return false;
+    }
+
+    m_sqHead = At<unsigned>(m_sqRing, params.sq_off.head);
+    m_sqTail = At<unsigned>(m_sqRing, params.sq_off.tail);
+    m_sqMask = At<unsigned>(m_sqRing, params.sq_off.ring_mask);
+    m_sqArray = At<unsigned>(m_sqRing, params.sq_off.array);
+    m_sqEntries = params.sq_entries;
+    m_cqHead = At<unsigned>(m_cqRing, params.cq_off.head);
+    m_cqTail = At<unsigned>(m_cqRing, params.cq_off.tail);
+    m_cqMask = At<unsigned>(m_cqRing, params.cq_off.ring_mask);
+    m_cqes = At<void>(m_cqRing, params.cq_off.cqes);
+    m_sqLocalTail = *m_sqTail;
+    m_sqPending = 0;
+    return true;
+}
+
+bool IoUring::RegisterBuffers(const iovec* buffers, unsigned count) {
+    return IsValid() && RingRegister(m_ringFd, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+}
+
+bool IoUring::RegisterFiles(const int* fds, unsigned count) {
+    UnregisterFiles();
+    if (!IsValid() || RingRegister(m_ringFd, IORING_REGISTER_FILES, fds, count) != 0) {
+        return false;
+    }
+    m_filesRegistered = true;
+    return true;
+}
+
+void IoUring::UnregisterFiles() {
+    if (m_filesRegistered) {
+        RingRegister(m_ringFd, IORING_UNREGISTER_FILES, nullptr, 0);
+        m_filesRegistered = false;
+    }
+}
+
+io_uring_sqe* IoUring::NextSqe() {
+    if (!IsValid()) {
+        return nullptr;
+    }
+    const unsigned head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+    if (m_sqLocalTail - head >= m_sqEntries) {
+        return nullptr;
+    }
+    const unsigned index = m_sqLocalTail & *m_sqMask;
+    auto* sqe = static_cast<io_uring_sqe*>(m_sqes) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    m_sqArray[index] = index;
+    ++m_sqLocalTail;   // Published by Submit() once the caller has filled the entry
+    ++m_sqPending;
+    return sqe;
+}
+
+int IoUring::Submit(unsigned waitFor) {
+    if (!IsValid()) {
+        return -EBADF;
+    }
+    // Release orders the caller's SQE writes before the kernel can observe the new tail
+    __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+    const unsigned flags = waitFor > 0 ? IORING_ENTER_GETEVENTS : 0;
+    int result;
+    do {
+        result = RingEnter(m_ringFd, m_sqPending, waitFor, flags);
+    } while (result < 0 && errno == EINTR);
+    if (result < 0) {
+        return -errno;
+    }
+    m_sqPending -= std::min(m_sqPending, static_cast<unsigned>(result));
+    return result;
+}
+
+const io_uring_cqe* IoUring::PeekCqe() const {
+    if (!IsValid()) {
+        return nullptr;
+    }
+    const unsigned head = *m_cqHead;
+    if (head == __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+    }
+    return static_cast<const io_uring_cqe*>(m_cqes) + (head & *m_cqMask);
+}
+
+void IoUring::PopCqe() {
+    __atomic_store_n(m_cqHead, *m_cqHead + 1, __ATOMIC_RELEASE);
+}
+
+void IoUring::Close() {
+    if (m_sqes) {
+        ::munmap(m_sqes, m_sqesSize);
+        m_sqes = nullptr;
+    }
+    if (m_cqRing && m_cqRing != m_sqRing) {
+        ::munmap(m_cqRing, m_cqRingSize);
+    }
+    m_cqRing = nullptr;
+    if (m_sqRing) {
+        ::munmap(m_sqRing, m_sqRingSize);
+        m_sqRing = nullptr;
+    }
+    if (m_ringFd >= 0) {
+        ::close(m_ringFd);   // Also drops registered buffers and files
+        m_ringFd = -1;
+    }
+    m_filesRegistered = false;
+}
+
+#else // !BCNP_HAS_IO_URING
+
+bool IoUring::Init(unsigned) {
+    errno = ENOSYS;
+    return false;
+}
+
+void IoUring::Close() {}
+
+#endif
+
+IoUring::~IoUring() {
+    Close();
+}
+
+} // namespace bcnp
@@ -0,0 +1,110 @@
+#pragma once
+
+/**
+ * @file io_uring.h
+ * @brief Minimal io_uring ring used by the POSIX adapters.
+ *
+ * Talks to the kernel through the raw io_uring_setup/enter/register
+ * syscalls (no liburing dependency). Only what the adapters need is
+ * wrapped: one submission/completion queue, registered buffers and a
+ * registered (fixed) file table. On other platforms, or when the kernel
+ * refuses the ring (old kernel, seccomp), Init() fails and callers keep
+ * using plain socket calls.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define BCNP_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+namespace bcnp {
+
+/**
+ * @brief Options for an adapter's io_uring backend.
+ */
+struct IoUringConfig {
+    unsigned entries{16};              ///< Submission queue entries
+    std::size_t rxBufferSize{16384};   ///< Bytes per registered receive buffer (two are used)
+};
+
+/**
+ * @brief One io_uring instance: SQ/CQ rings mapped into user space.
+ *
+ * Not thread-safe; owned by a single adapter.
+ */
+class IoUring {
+public:
+    IoUring() = default;
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /// Create the ring; false if io_uring is unavailable
+    bool Init(unsigned entries);
+
+    bool IsValid() const { return m_ringFd >= 0; }
+
+    /// Ring descriptor; poll() reports it readable while completions are pending
+    int Fd() const { return m_ringFd; }
+
+#if defined(BCNP_HAS_IO_URING)
+    /// Register buffers for IORING_OP_READ_FIXED / WRITE_FIXED (buf_index = position)
+    bool RegisterBuffers(const iovec* buffers, unsigned count);
+
+    /// Register @p count descriptors for IOSQE_FIXED_FILE (fd = position)
+    bool RegisterFiles(const int* fds, unsigned count);
+    void UnregisterFiles();
+
+    /// Next free submission entry (zeroed), or nullptr if the queue is full.
+    /// The kernel does not see it until the next Submit().
+    io_uring_sqe* NextSqe();
+
+    /**
+     * @brief Publish filled entries and submit them, optionally waiting for completions.
+     * @param waitFor Completions to wait for (0 = do not block)
+     * @return Entries submitted, or -errno
+     */
+    int Submit(unsigned waitFor = 0);
+
+    /// Oldest unread completion, or nullptr (no syscall)
+    const io_uring_cqe* PeekCqe() const;
+
+    /// Release the completion returned by PeekCqe()
+    void PopCqe();
+#endif
+
+private:
+    void Close();
+
+    int m_ringFd{-1};
+    bool m_filesRegistered{false};
+
+    void* m_sqRing{nullptr};
+    void* m_cqRing{nullptr};   // Same mapping as m_sqRing with IORING_FEAT_SINGLE_MMAP
+    std::size_t m_sqRingSize{0};
+    std::size_t m_cqRingSize{0};
+    void* m_sqes{nullptr};
+    std::size_t m_sqesSize{0};
+
+    unsigned* m_sqHead{nullptr};
+    unsigned* m_sqTail{nullptr};
+    unsigned* m_sqMask{nullptr};
+    unsigned* m_sqArray{nullptr};
+    unsigned m_sqEntries{0};
+    unsigned m_sqLocalTail{0}; // Tail including entries handed out but not yet published
+    unsigned m_sqPending{0};   // Entries queued since the last Submit()
+
+    unsigned* m_cqHead{nullptr};
+    unsigned* m_cqTail{nullptr};
+    unsigned* m_cqMask{nullptr};
+    void* m_cqes{nullptr};
+};
+
+} // namespace bcnp
@@ -6,6 +6,10 @@
  * Supports both server mode (listen/accept) and client mode (connect) with
  * automatic reconnection, non-blocking I/O, and V3 schema handshake validation.
  * 
+ * With EnableIoUring() the connected socket's reads and sends are
+ * submitted to an io_uring ring (see io_uring.h); everything else,
+ * including connection management, is shared with the socket-call path.
+ * 
  * @note This implementation is for Linux/POSIX systems only. For Windows,
  *       use a separate Winsock implementation.
  * 
@@ -14,6 +18,8 @@
  */
 #include "bcnp/transport/tcp_posix.h"
 
+#include "bcnp/latency_trace.h"
+
 #include <algorithm>
 #include <arpa/inet.h>
 #include <cerrno>
@@ -23,6 +29,7 @@
 #include <iostream>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace bcnp {
@@ -33,6 +40,10 @@ constexpr auto kReconnectInterval = std::chrono::milliseconds(500);
 
 /// @brief Minimum interval between error log messages to prevent spam.
 constexpr auto kLogThrottle = std::chrono::seconds(1);
+
+/// @brief io_uring user_data tags.
+constexpr uint64_t kUringReadTag = 1;
+constexpr uint64_t kUringSendTag = 2;
 } // namespace
 
 /**
@@ -52,7 +63,7 @@ constexpr auto kLogThrottle = std::chrono::seconds(1);
  * Automatically reconnects on disconnect
  */
 TcpPosixAdapter::TcpPosixAdapter(uint16_t listenPort, const char* targetIp, uint16_t targetPort) {
-    m_txBuffer = std::make_unique<uint8_t[]>(kTxBufferCapacity);
+    m_txStaging = std::make_unique<uint8_t[]>(kMaxPacketSize);
 
     if (listenPort > 0) {
         m_isServer = true;
@@ -98,12 +109,8 @@ TcpPosixAdapter::TcpPosixAdapter(uint16_t listenPort, const char* targetIp, uint
  * @brief Destructor. Closes all open sockets.
  */
 TcpPosixAdapter::~TcpPosixAdapter() {
-    if (m_clientSocket >= 0) {
-        ::close(m_clientSocket);
-    }
-    if (m_socket >= 0) {
-        ::close(m_socket);
-    }
+    CloseSocket(m_clientSocket);
+    CloseSocket(m_socket);
 }
 
 /**
@@ -115,10 +122,7 @@ TcpPosixAdapter::~TcpPosixAdapter() {
  * @return true if socket was created successfully, false otherwise.
  */
 bool TcpPosixAdapter::CreateBaseSocket() {
-    if (m_socket >= 0) {
-        ::close(m_socket);
-        m_socket = -1;
-    }
+    CloseSocket(m_socket);
 
     m_socket = ::socket(AF_INET, SOCK_STREAM, 0);
     if (m_socket < 0) {
@@ -180,6 +184,8 @@ void TcpPosixAdapter::BeginClientConnect(bool forceImmediate) {
     // Synchronous connect succeeded (rare for non-blocking socket)
     m_isConnected = true;
     m_connectInProgress = false;
+    Count(Metric::Connects);
+    AttachUring(m_socket);
 }
 
 /**
@@ -204,8 +210,7 @@ void TcpPosixAdapter::PollConnection() {
             const auto now = std::chrono::steady_clock::now();
             if (m_lastServerRx != std::chrono::steady_clock::time_point{} &&
                 now - m_lastServerRx > m_serverClientTimeout) {
-                ::close(m_clientSocket);
-                m_clientSocket = -1;
+                CloseSocket(m_clientSocket);
                 m_isConnected = false;
                 m_lastServerRx = {};
                 return;
@@ -224,7 +229,9 @@ void TcpPosixAdapter::PollConnection() {
             }
             m_clientSocket = clientSock;
             m_isConnected = true;
+            Count(Metric::Connects);
             m_lastServerRx = std::chrono::steady_clock::now();
+            AttachUring(m_clientSocket);
             TryFlushTxBuffer(m_clientSocket);
         } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
             LogError("accept");
@@ -248,6 +255,8 @@ void TcpPosixAdapter::PollConnection() {
         if (err == 0) {
             m_isConnected = true;
             m_connectInProgress = false;
+            Count(Metric::Connects);
+            AttachUring(m_socket);
             TryFlushTxBuffer(m_socket);
             return;
         }
@@ -277,6 +286,7 @@ void TcpPosixAdapter::PollConnection() {
  * In client mode, triggers immediate reconnection attempt.
  */
 void TcpPosixAdapter::HandleConnectionLoss() {
+    DetachUring();   // Before DropPendingTx(): a send may still reference the ring
     m_isConnected = false;
     m_handshakeComplete = false;
     m_handshakeSent = false;
@@ -286,35 +296,114 @@ void TcpPosixAdapter::HandleConnectionLoss() {
     DropPendingTx();
 
     if (m_isServer) {
-        if (m_clientSocket >= 0) {
-            ::close(m_clientSocket);
-            m_clientSocket = -1;
-        }
+        CloseSocket(m_clientSocket);
         m_lastServerRx = {};
         return;
     }
 
     // Client mode - close broken socket and trigger reconnection
-    if (m_socket >= 0) {
-        ::close(m_socket);
-        m_socket = -1;
-    }
+    CloseSocket(m_socket);
     m_connectInProgress = false;
     BeginClientConnect(true);
 }
 
 /**
- * @brief Sends bytes through the TCP connection.
- * 
- * Data is buffered and sent asynchronously to prevent blocking on slow connections.
- * Implements congestion control by rejecting new packets when buffer exceeds 50% capacity.
+ * @brief Sends bytes through the TCP connection on the control lane.
  * 
  * @param data Pointer to byte buffer to send.
  * @param length Number of bytes to send.
- * @return true if data was accepted for sending, false if buffer full or not connected.
+ * @return true if data was sent or accepted for sending, false if buffer full or not connected.
  */
 bool TcpPosixAdapter::SendBytes(const uint8_t* data, std::size_t length) {
-    if (!data || length == 0) {
+    return SendBytes(data, length, TxPriority::Control);
+}
+
+bool TcpPosixAdapter::SendBytesV(const ByteSpan* spans, std::size_t count) {
+    return SendBytesV(spans, count, TxPriority::Control);
+}
+
+bool TcpPosixAdapter::SendFramePart(const uint8_t* data, std::size_t length, FramePart part) {
+    return SendFramePart(data, length, part, TxPriority::Control);
+}
+
+MutableByteSpan TcpPosixAdapter::ReserveTx(std::size_t length) {
+    return ReserveTx(length, TxPriority::Control);
+}
+
+/**
+ * @brief Sends bytes through the TCP connection on one transmit lane.
+ * 
+ * Equivalent to SendBytesV() with a single span: the bytes go straight to the
+ * socket when nothing is queued and are only copied into the lane if the
+ * kernel would block.
+ * 
+ * @param data Pointer to byte buffer to send.
+ * @param length Number of bytes to send.
+ * @param priority Transmit lane.
+ * @return true if data was sent or accepted for sending, false if congested or not connected.
+ */
+bool TcpPosixAdapter::SendBytes(const uint8_t* data, std::size_t length, TxPriority priority) {
+    const ByteSpan span{data, length};
+    return SendBytesV(&span, 1, priority);
+}
+
+/**
+ * @brief Sends a list of buffers through the TCP connection with gathered writes.
+ * 
+ * If nothing is queued in any lane the spans are written directly with
+ * sendmsg() (up to kMaxTxIov spans per call, MSG_NOSIGNAL), so several
+ * packets built in one control tick leave in a single syscall without an
+ * extra copy. Whatever the kernel does not accept is queued and sent before
+ * anything else. If data is already queued, the spans are queued in
+ * @p priority's lane and go out in lane order. A rate-limited bulk lane
+ * always queues.
+ * 
+ * Congestion control is per lane: new data is rejected (all or nothing)
+ * when more than half the buffer is queued in its own and higher lanes, and
+ * a full buffer evicts queued lower-lane packets first. Once any byte of the
+ * list has been written, the remainder is always queued so the stream stays
+ * framed. One call sends at most kMaxTxSendBytes (two maximum-size packets).
+ * 
+ * With io_uring the spans are always copied into the lane, since the
+ * kernel reads them after this call returns.
+ * 
+ * @param spans Buffers to send, in order.
+ * @param count Number of spans.
+ * @param priority Transmit lane.
+ * @return true if all data was sent or queued, false if congested, too large, or not connected.
+ */
+bool TcpPosixAdapter::SendBytesV(const ByteSpan* spans, std::size_t count, TxPriority priority) {
+    return SendSpans(spans, count, priority, FramePart::Whole);
+}
+
+/**
+ * @brief Sends one piece of a frame written in several calls (see ByteWriter::SendFramePart()).
+ * 
+ * From the moment the Begin piece reaches the wire until the End piece has,
+ * no other lane is sent, so a ChunkedPacketWriter on a bulk lane keeps
+ * control packets out of its frame (they wait for the End piece). Sends on
+ * @p priority that are not pieces of the frame are refused while it is open.
+ * Continue and End pieces are exempt from the congestion threshold but
+ * still need buffer space.
+ * 
+ * @return true if the piece was sent or queued, false if congested, out of
+ *         sequence, or not connected (retry the same piece later)
+ */
+bool TcpPosixAdapter::SendFramePart(const uint8_t* data, std::size_t length, FramePart part,
+                                    TxPriority priority) {
+    const ByteSpan span{data, length};
+    return SendSpans(&span, 1, priority, part);
+}
+
+bool TcpPosixAdapter::SendSpans(const ByteSpan* spans, std::size_t count, TxPriority priority, FramePart part) {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (spans[i].length > 0 && !spans[i].data) {
+            return false;
+        }
+        total += spans[i].length;
+    }
+    if (total == 0) {
         return true;
     }
 
@@ -325,16 +414,192 @@ bool TcpPosixAdapter::SendBytes(const uint8_t* data, std::size_t length) {
         return false;
     }
 
-    if (length > kTxBufferCapacity) {
+    if (total > kMaxTxSendBytes) {
         LogError("send payload exceeds tx buffer capacity");
         return false;
     }
 
-    if (!EnqueueTx(data, length)) {
+    TryFlushTxBuffer(targetSock);
+    targetSock = m_isServer ? m_clientSocket : m_socket;
+    if (targetSock < 0 || !m_isConnected) {
+        return false;
+    }
+    if (m_txReserved && priority == m_txReservedLane) {
+        LogError("tx lane reserved for an in-place packet - rejecting");
+        Count(Metric::TxDrops);
+        return false;
+    }
+    if (!m_tx.FramePartAllowed(priority, part)) {
+        LogError("tx lane busy with a frame sent in pieces - rejecting");
+        Count(Metric::TxDrops);
         return false;
     }
 
+    if (m_uringFd >= 0) {
+        if (!AdmitTx(priority, total, part)) {
+            return false;
+        }
+        m_tx.Append(priority, spans, count, std::chrono::steady_clock::now(), 0, part);
+        RecordTxQueued();
+        FlushUring();
+        return true;
+    }
+
+    std::size_t index = 0;
+    std::size_t offset = 0;  // Bytes of spans[index] already written
+    std::size_t written = 0;
+    while (m_tx.MayWriteDirect(priority) && written < total) {
+        iovec iov[kMaxTxIov];
+        std::size_t iovCount = 0;
+        for (std::size_t i = index; i < count && iovCount < kMaxTxIov; ++i) {
+            const std::size_t skip = (i == index) ? offset : 0;
+            if (spans[i].length == skip) {
+                continue;
+            }
+            iov[iovCount].iov_base = const_cast<uint8_t*>(spans[i].data + skip);
+            iov[iovCount].iov_len = spans[i].length - skip;
+            ++iovCount;
+        }
+
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iovCount;
+        const ssize_t sent = ::sendmsg(targetSock, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                Count(Metric::TxEagain);
+                break;
+            }
+            if (errno == EPIPE || errno == ECONNRESET || errno == ENOTCONN) {
+                HandleConnectionLoss();
+            } else {
+                LogError("sendmsg");
+            }
+            DropPendingTx();
+            return false;
+        }
+
+        written += static_cast<std::size_t>(sent);
+        Count(Metric::TxBytes, static_cast<std::size_t>(sent));
+        std::size_t advance = static_cast<std::size_t>(sent);
+        while (index < count && advance >= spans[index].length - offset) {
+            advance -= spans[index].length - offset;
+            offset = 0;
+            ++index;
+        }
+        offset += advance;
+    }
+
+    if (written == total) {
+        m_tx.ChargeDirect(priority, written, 1, part);
+        return true;
+    }
+    m_tx.ChargeDirect(priority, written, 0, part);
+    // Nothing on the wire yet: the usual congestion rule applies to the whole list
+    if (written == 0 && !AdmitTx(priority, total, part)) {
+        return false;
+    }
+    m_tx.Append(priority, spans, count, std::chrono::steady_clock::now(), written, part);
+    RecordTxQueued();
+    if (written == 0) {
+        TryFlushTxBuffer(targetSock);   // Queued behind other lanes: may still fit this tick
+    }
+    return true;
+}
+
+/**
+ * @brief Reserves space in a transmit lane so a packet can be encoded in place.
+ * 
+ * The span points directly at the lane's ring tail when enough contiguous
+ * space is free (the common case: an empty lane is rewound to offset 0), so
+ * the packet is encoded once and sent from there. If the free space wraps,
+ * the span points at a staging buffer instead. Either way the span is exactly
+ * @p length bytes, the amount AdmitTx() approved, so CommitTx() cannot queue
+ * more than congestion control allowed. Until CommitTx() the lane refuses
+ * other sends and is never evicted, so nothing moves under the caller.
+ * 
+ * @param length Bytes required.
+ * @param priority Transmit lane.
+ * @return Writable span, or empty if not connected, congested, or a
+ *         reservation is already outstanding.
+ */
+MutableByteSpan TcpPosixAdapter::ReserveTx(std::size_t length, TxPriority priority) {
+    if (m_txReserved || length == 0 || length > kMaxTxSendBytes) {
+        return {};
+    }
+
+    PollConnection();
+
+    const int targetSock = m_isServer ? m_clientSocket : m_socket;
+    if (targetSock < 0 || !m_isConnected) {
+        return {};
+    }
+
     TryFlushTxBuffer(targetSock);
+    if (!m_isConnected) {
+        return {};
+    }
+    // Without a staging fallback the ring itself must fit it; check before
+    // admission can evict other lanes' units for a reservation that fails
+    if (length > kMaxPacketSize && m_tx.TailRoom(priority) < length) {
+        return {};
+    }
+    if (!AdmitTx(priority, length)) {
+        return {};
+    }
+
+    const MutableByteSpan tail = m_tx.ReserveTail(priority);
+    m_tx.HoldTail(priority, length);
+    m_txReservedLane = priority;
+    if (tail.length >= length) {
+        m_txReserved = true;
+        m_txReserveStaged = false;
+        m_txReservedLength = length;
+        return {tail.data, length};
+    }
+
+    m_txReserved = true;
+    m_txReserveStaged = true;
+    m_txReservedLength = length;
+    return {m_txStaging.get(), length};
+}
+
+/**
+ * @brief Queues the bytes written into the outstanding reservation and flushes.
+ * 
+ * @param length Bytes written into the span returned by ReserveTx().
+ * @return true if the bytes were queued, false if there was no reservation,
+ *         @p length exceeds it, or the connection dropped in between.
+ */
+bool TcpPosixAdapter::CommitTx(std::size_t length) {
+    if (!m_txReserved) {
+        return false;
+    }
+    m_txReserved = false;
+    if (length > m_txReservedLength) {
+        m_tx.ReleaseTail();
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (m_txReserveStaged) {
+        m_tx.ReleaseTail();
+        if (length > 0) {
+            const ByteSpan staged{m_txStaging.get(), length};
+            m_tx.Append(m_txReservedLane, &staged, 1, now);
+        }
+    } else if (!m_tx.CommitTail(m_txReservedLane, length, now)) {
+        return false;   // The ring moved under the reservation; nothing queued
+    }
+    if (length == 0) {
+        return true;
+    }
+    RecordTxQueued();
+
+    TryFlushTxBuffer(m_isServer ? m_clientSocket : m_socket);
     return true;
 }
 
@@ -343,6 +608,7 @@ bool TcpPosixAdapter::SendBytes(const uint8_t* data, std::size_t length) {
  * 
  * Performs non-blocking receive. Handles V3 handshake protocol transparently -
  * handshake bytes are consumed internally and not returned to the caller.
+ * With io_uring the bytes are copied out of ReceiveInPlace()'s view.
  * 
  * @param buffer Destination buffer for received data.
  * @param maxLength Maximum bytes to receive.
@@ -353,6 +619,21 @@ std::size_t TcpPosixAdapter::ReceiveChunk(uint8_t* buffer, std::size_t maxLength
         return 0;
     }
 
+    if (m_uring) {
+        if (m_rxView.length == 0) {
+            m_rxView = ReceiveInPlace();
+        }
+        const std::size_t copied = std::min(m_rxView.length, maxLength);
+        if (copied > 0) {
+            std::memcpy(buffer, m_rxView.data, copied);
+        }
+        m_rxView.data += copied;
+        m_rxView.length -= copied;
+        return copied;
+    }
+
+    const uint64_t traceStart = trace::Now();
+
     PollConnection();
 
     int targetSock = m_isServer ? m_clientSocket : m_socket;
@@ -391,9 +672,13 @@ std::size_t TcpPosixAdapter::ReceiveChunk(uint8_t* buffer, std::size_t maxLength
             // Move remaining data to start of buffer
             std::size_t remaining = static_cast<std::size_t>(received) - consumed;
             std::memmove(buffer, buffer + consumed, remaining);
+            trace::MarkReceive(traceStart);
+            Count(Metric::RxBytes, remaining);
             return remaining;
         }
         
+        trace::MarkReceive(traceStart);
+        Count(Metric::RxBytes, static_cast<std::size_t>(received));
         return static_cast<std::size_t>(received);
     } else if (received == 0) {
         HandleConnectionLoss();
@@ -411,29 +696,63 @@ std::size_t TcpPosixAdapter::ReceiveChunk(uint8_t* buffer, std::size_t maxLength
     }
 }
 
+/**
+ * @brief Descriptor to wait on before the next ReceiveChunk().
+ * 
+ * Clients return -1 until connected, since connection progress, reconnects
+ * and the handshake are driven by ReceiveChunk() itself.
+ * 
+ * @return Socket descriptor, or -1 if none is usable yet.
+ */
+int TcpPosixAdapter::ReadableFd() const {
+    if (m_uringFd >= 0) {
+        return m_uring->Fd();   // Readable once a completion is queued
+    }
+    if (m_isServer) {
+        return m_clientSocket >= 0 ? m_clientSocket : m_socket;
+    }
+    return m_isConnected ? m_socket : -1;
+}
+
 /**
  * @brief Attempts to flush pending TX data to the socket.
  * 
  * Called internally after enqueuing data and during receive operations.
+ * Each sendmsg() gathers up to kMaxTxIov spans in scheduler order: the rest
+ * of a partly sent packet, then the control, telemetry and bulk lanes.
  * Uses MSG_NOSIGNAL to prevent SIGPIPE on broken connections.
  * 
  * @param targetSock Socket file descriptor to send to.
  */
 void TcpPosixAdapter::TryFlushTxBuffer(int targetSock) {
-    uint8_t* buffer = m_txBuffer.get();
-    if (!buffer) {
+    if (m_uringFd >= 0) {
+        FlushUring();
         return;
     }
 
-    while (m_txSize > 0 && targetSock >= 0 && m_isConnected) {
-        const std::size_t contiguous = std::min(m_txSize, kTxBufferCapacity - m_txHead);
-        ssize_t sent = ::send(targetSock, buffer + m_txHead, contiguous, MSG_NOSIGNAL);
+    while (!m_tx.Empty() && targetSock >= 0 && m_isConnected) {
+        ByteSpan spans[kMaxTxIov];
+        const std::size_t spanCount = m_tx.Gather(spans, kMaxTxIov, std::chrono::steady_clock::now());
+        if (spanCount == 0) {
+            return;   // Only rate-limited bulk data is left
+        }
+        iovec iov[kMaxTxIov];
+        for (std::size_t i = 0; i < spanCount; ++i) {
+            iov[i].iov_base = const_cast<uint8_t*>(spans[i].data);
+            iov[i].iov_len = spans[i].length;
+        }
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = spanCount;
+        const ssize_t sent = ::sendmsg(targetSock, &msg, MSG_NOSIGNAL);
         if (sent > 0) {
             const std::size_t consumed = static_cast<std::size_t>(sent);
-            m_txHead = (m_txHead + consumed) % kTxBufferCapacity;
-            m_txSize -= consumed;
+            m_tx.Consume(consumed, std::chrono::steady_clock::now());
+            Count(Metric::TxBytes, consumed);
+            RecordTxQueued();
             continue;
         }
+        m_tx.Consume(0, std::chrono::steady_clock::now());
 
         if (sent == 0) {
             HandleConnectionLoss();
@@ -446,13 +765,14 @@ void TcpPosixAdapter::TryFlushTxBuffer(int targetSock) {
         }
 
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            Count(Metric::TxEagain);
             return;
         }
 
         if (errno == EPIPE || errno == ECONNRESET || errno == ENOTCONN) {
             HandleConnectionLoss();
         } else {
-            LogError("send");
+            LogError("sendmsg");
         }
         DropPendingTx();
         return;
@@ -460,10 +780,7 @@ void TcpPosixAdapter::TryFlushTxBuffer(int targetSock) {
 }
 
 /**
- * @brief Enqueues data to the circular TX buffer.
- * 
- * Implements real-time congestion control: rejects new packets when buffer
- * exceeds 50% capacity to prevent runaway buffering and mid-packet corruption.
+ * @brief Queues data on the control lane (handshake).
  * 
  * @param data Pointer to data to enqueue.
  * @param length Number of bytes to enqueue.
@@ -473,32 +790,37 @@ bool TcpPosixAdapter::EnqueueTx(const uint8_t* data, std::size_t length) {
     if (!data || length == 0) {
         return true;
     }
-
-    // Real-time control: reject new packets when buffer > 50% to prevent runaway buffering
-    // This avoids mid-packet corruption that would occur if we dropped the buffer during flush
-    if (m_txSize > kTxBufferCapacity / 2) {
-        LogError("tx buffer congested - rejecting new packet");
+    if (!AdmitTx(TxPriority::Control, length)) {
         return false;
     }
+    const ByteSpan span{data, length};
+    m_tx.Append(TxPriority::Control, &span, 1, std::chrono::steady_clock::now());
+    RecordTxQueued();
+    return true;
+}
 
-    if (length > kTxBufferCapacity - m_txSize) {
-        LogError("tx buffer full - dropping packet");
+/**
+ * @brief Checks whether @p length new bytes may be queued in @p priority's lane.
+ * 
+ * Implements real-time congestion control: rejects new packets when more
+ * than 50% of the buffer is queued at this or a higher priority, to prevent
+ * runaway buffering and mid-packet corruption. Lower-lane packets are
+ * evicted if the buffer is otherwise too full.
+ * 
+ * @param priority Transmit lane.
+ * @param length Number of bytes about to be enqueued.
+ * @return true if the bytes may be queued now.
+ */
+bool TcpPosixAdapter::AdmitTx(TxPriority priority, std::size_t length, FramePart part) {
+    if (!m_tx.Admit(priority, length, part)) {
+        LogError("tx buffer congested - rejecting new packet");
+        Count(Metric::TxDrops);
         return false;
     }
-
-    const auto* src = data;
-    const std::size_t firstChunk = std::min(length, kTxBufferCapacity - m_txTail);
-    std::memcpy(m_txBuffer.get() + m_txTail, src, firstChunk);
-
-    const std::size_t remaining = length - firstChunk;
-    if (remaining > 0) {
-        std::memcpy(m_txBuffer.get(), src + firstChunk, remaining);
-    }
-
-    m_txTail = (m_txTail + length) % kTxBufferCapacity;
-    m_txSize += length;
+    RecordTxQueued();
     return true;
 }
+
 /**
  * @brief Configures socket options for BCNP transport.
  * 
@@ -545,9 +867,9 @@ void TcpPosixAdapter::LogError(const char* message) {
  * on reconnection.
  */
 void TcpPosixAdapter::DropPendingTx() {
-    m_txHead = 0;
-    m_txTail = 0;
-    m_txSize = 0;
+    m_tx.Clear();
+    m_txReserved = false;
+    RecordTxQueued();
 }
 
 /**
@@ -638,4 +960,341 @@ bool TcpPosixAdapter::ProcessHandshake(const uint8_t* data, std::size_t length)
     return true;
 }
 
-} // namespace bcnp
\ No newline at end of file
+/**
+ * @brief Closes a socket, detaching it from io_uring first if registered.
+ * 
+ * @param sock Socket to close; set to -1.
+ */
+void TcpPosixAdapter::CloseSocket(int& sock) {
+    if (sock < 0) {
+        return;
+    }
+    if (sock == m_uringFd) {
+        DetachUring();
+    }
+    ::close(sock);
+    sock = -1;
+}
+
+/**
+ * @brief Creates the io_uring ring and registers the receive buffers.
+ * 
+ * Takes effect for the current connection (if any) and every later one.
+ * 
+ * @param config Ring entries and per-buffer receive size.
+ * @return true if io_uring is in use (also when already enabled).
+ */
+bool TcpPosixAdapter::EnableIoUring(IoUringConfig config) {
+    if (m_uring) {
+        return true;
+    }
+#if defined(BCNP_HAS_IO_URING)
+    auto ring = std::make_unique<IoUring>();
+    if (!ring->Init(std::max(config.entries, 4u))) {
+        LogError("io_uring_setup");
+        return false;
+    }
+    const std::size_t size = std::max<std::size_t>(config.rxBufferSize, kHandshakeSize);
+    auto buffers = std::make_unique<uint8_t[]>(size * 2);
+    const iovec iov[2] = {{buffers.get(), size}, {buffers.get() + size, size}};
+    if (!ring->RegisterBuffers(iov, 2)) {
+        LogError("io_uring register buffers");
+        return false;
+    }
+    m_uring = std::move(ring);
+    m_uringRx = std::move(buffers);
+    m_uringRxSize = size;
+
+    const int targetSock = m_isServer ? m_clientSocket : m_socket;
+    if (targetSock >= 0 && m_isConnected) {
+        AttachUring(targetSock);
+    }
+    return true;
+#else
+    (void)config;
+    return false;
+#endif
+}
+
+/**
+ * @brief Registers a newly connected socket with the ring and starts reading.
+ * 
+ * The socket is switched to blocking mode: io_uring returns -EAGAIN for
+ * O_NONBLOCK files instead of waiting for readiness. No socket call is made
+ * on it while it is attached. If registration fails the connection keeps
+ * using socket calls.
+ * 
+ * @param sock Connected socket.
+ */
+void TcpPosixAdapter::AttachUring(int sock) {
+#if defined(BCNP_HAS_IO_URING)
+    if (!m_uring || m_uringFd >= 0 || sock < 0) {
+        return;
+    }
+    const int flags = fcntl(sock, F_GETFL, 0);
+    if (flags < 0 || fcntl(sock, F_SETFL, flags & ~O_NONBLOCK) < 0) {
+        LogError("fcntl(~O_NONBLOCK)");
+        return;
+    }
+    if (!m_uring->RegisterFiles(&sock, 1)) {
+        LogError("io_uring register files");
+        fcntl(sock, F_SETFL, flags);
+        return;
+    }
+    m_uringFd = sock;
+    m_rxSlot = 0;
+    m_rxInFlight = false;
+    m_rxResult = kNoResult;
+    m_txInFlight = false;
+    m_txResult = kNoResult;
+    m_rxView = {};
+    SubmitUringRead();
+#else
+    (void)sock;
+#endif
+}
+
+/**
+ * @brief Completes the outstanding operations and unregisters the socket.
+ * 
+ * shutdown() makes a pending read return 0 and a pending send fail, so the
+ * wait for their completions is short. Called before the socket is closed.
+ */
+void TcpPosixAdapter::DetachUring() {
+#if defined(BCNP_HAS_IO_URING)
+    if (m_uringFd < 0) {
+        return;
+    }
+    ::shutdown(m_uringFd, SHUT_RDWR);
+    while (m_rxInFlight || m_txInFlight) {
+        const unsigned pending = (m_rxInFlight ? 1u : 0u) + (m_txInFlight ? 1u : 0u);
+        if (m_uring->Submit(pending) < 0) {
+            LogError("io_uring_enter (detach)");
+            break;
+        }
+        ReapUring();
+    }
+    // Release the pinned send; bytes the kernel took are gone from the lanes
+    const bool sent = m_txResult != kNoResult && m_txResult > 0;
+    m_tx.Consume(sent ? static_cast<std::size_t>(m_txResult) : 0, std::chrono::steady_clock::now());
+    m_uring->UnregisterFiles();
+    m_uringFd = -1;
+    m_rxInFlight = false;
+    m_rxResult = kNoResult;
+    m_txInFlight = false;
+    m_txResult = kNoResult;
+    m_rxView = {};
+#endif
+}
+
+/**
+ * @brief Moves completions from the CQ ring into m_rxResult / m_txResult.
+ * 
+ * Only records results (no syscall), so it is safe to call from any send
+ * or receive path.
+ */
+void TcpPosixAdapter::ReapUring() {
+#if defined(BCNP_HAS_IO_URING)
+    while (const io_uring_cqe* cqe = m_uring->PeekCqe()) {
+        if (cqe->user_data == kUringReadTag) {
+            m_rxInFlight = false;
+            m_rxResult = cqe->res;
+        } else if (cqe->user_data == kUringSendTag) {
+            m_txInFlight = false;
+            m_txResult = cqe->res;
+        }
+        m_uring->PopCqe();
+    }
+#endif
+}
+
+/**
+ * @brief Queues a read into registered buffer m_rxSlot (no-op if one is outstanding).
+ */
+void TcpPosixAdapter::SubmitUringRead() {
+#if defined(BCNP_HAS_IO_URING)
+    if (m_uringFd < 0 || m_rxInFlight || m_rxResult != kNoResult) {
+        return;
+    }
+    io_uring_sqe* sqe = m_uring->NextSqe();
+    if (!sqe) {
+        return;
+    }
+    sqe->opcode = IORING_OP_READ_FIXED;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->fd = 0;
+    sqe->addr = reinterpret_cast<uint64_t>(m_uringRx.get() + m_rxSlot * m_uringRxSize);
+    sqe->len = static_cast<uint32_t>(m_uringRxSize);
+    sqe->buf_index = static_cast<uint16_t>(m_rxSlot);
+    sqe->user_data = kUringReadTag;
+    m_rxInFlight = true;
+    if (m_uring->Submit() < 0) {
+        LogError("io_uring_enter (read)");
+    }
+#endif
+}
+
+/**
+ * @brief Applies a completed send and submits the next contiguous TX run.
+ * 
+ * At most one send is outstanding; the scheduler keeps its bytes pinned
+ * until it completes, so new data is only ever queued behind it.
+ */
+void TcpPosixAdapter::FlushUring() {
+#if defined(BCNP_HAS_IO_URING)
+    ReapUring();
+    if (m_txResult != kNoResult) {
+        const int result = m_txResult;
+        m_txResult = kNoResult;
+        if (result > 0) {
+            const auto consumed = static_cast<std::size_t>(result);
+            m_tx.Consume(consumed, std::chrono::steady_clock::now());
+            Count(Metric::TxBytes, consumed);
+            RecordTxQueued();
+        } else {
+            m_tx.Consume(0, std::chrono::steady_clock::now());
+            if (result != -EINTR && result != -EAGAIN) {
+                errno = -result;
+                if (result == 0 || result == -EPIPE || result == -ECONNRESET || result == -ENOTCONN) {
+                    HandleConnectionLoss();
+                } else {
+                    LogError("io_uring send");
+                }
+                DropPendingTx();
+                return;
+            }
+        }
+    }
+    if (m_uringFd < 0 || m_txInFlight || m_tx.Empty() || !m_isConnected) {
+        return;
+    }
+
+    ByteSpan span{};
+    if (m_tx.Gather(&span, 1, std::chrono::steady_clock::now()) == 0) {
+        return;   // Only rate-limited bulk data is left
+    }
+    io_uring_sqe* sqe = m_uring->NextSqe();
+    if (!sqe) {
+        m_tx.Consume(0, std::chrono::steady_clock::now());
+        return;
+    }
+    sqe->opcode = IORING_OP_SEND;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->fd = 0;
+    sqe->addr = reinterpret_cast<uint64_t>(span.data);
+    sqe->len = static_cast<uint32_t>(span.length);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = kUringSendTag;
+    m_txInFlight = true;
+    if (m_uring->Submit() < 0) {
+        LogError("io_uring_enter (send)");
+    }
+#endif
+}
+
+/**
+ * @brief Receives bytes in place from the registered buffers.
+ * 
+ * Runs the same connection upkeep as ReceiveChunk(), then takes the
+ * completed read (if any), immediately queues the next read into the other
+ * buffer, and returns a view of the completed one minus handshake bytes.
+ * While the current connection is not registered (or registration failed)
+ * it falls back to recv() into the first buffer.
+ * 
+ * @return Received bytes, valid until the next receive call; empty if none.
+ */
+ByteSpan TcpPosixAdapter::ReceiveInPlace() {
+    if (!m_uring) {
+        return {};
+    }
+    if (m_rxView.length > 0) {
+        const ByteSpan rest = m_rxView;   // Left over by ReceiveChunk()
+        m_rxView = {};
+        return rest;
+    }
+    if (m_socket < 0) {
+        return {};
+    }
+    if (m_uringFd < 0) {
+        PollConnection();
+        const int targetSock = m_isServer ? m_clientSocket : m_socket;
+        if (targetSock >= 0 && m_isConnected) {
+            AttachUring(targetSock);   // Connected while the ring was parked below
+        }
+    }
+    if (m_uringFd < 0) {
+        // Socket-call path; m_uring is parked so ReceiveChunk() does not recurse
+        std::unique_ptr<IoUring> ring = std::move(m_uring);
+        const std::size_t received = ReceiveChunk(m_uringRx.get(), m_uringRxSize);
+        m_uring = std::move(ring);
+        return received > 0 ? ByteSpan{m_uringRx.get(), received} : ByteSpan{};
+    }
+    return ReceiveUring();
+}
+
+/**
+ * @brief io_uring receive path behind ReceiveInPlace().
+ */
+ByteSpan TcpPosixAdapter::ReceiveUring() {
+    const uint64_t traceStart = trace::Now();
+
+    PollConnection();
+
+    const int targetSock = m_isServer ? m_clientSocket : m_socket;
+    if (targetSock < 0 || !m_isConnected || m_uringFd < 0) {
+        return {};
+    }
+
+    FlushUring();
+    if (!m_handshakeSent) {
+        SendHandshake();
+    }
+    ReapUring();
+    if (m_uringFd < 0) {
+        return {};   // Connection lost while flushing
+    }
+    if (m_rxResult == kNoResult) {
+        SubmitUringRead();
+        return {};
+    }
+
+    const int result = m_rxResult;
+    const unsigned slot = m_rxSlot;
+    m_rxResult = kNoResult;
+    if (result <= 0) {
+        errno = -result;
+        if (result == 0 || result == -ENOTCONN || result == -ECONNRESET) {
+            HandleConnectionLoss();
+            return {};
+        }
+        if (result != -EINTR && result != -EAGAIN) {
+            LogError("io_uring read");
+        }
+        SubmitUringRead();
+        return {};
+    }
+
+    // Double buffering: the next read lands in the other buffer while this one is parsed
+    m_rxSlot ^= 1u;
+    SubmitUringRead();
+
+    const uint8_t* data = m_uringRx.get() + slot * m_uringRxSize;
+    std::size_t length = static_cast<std::size_t>(result);
+    if (m_isServer) {
+        m_lastServerRx = std::chrono::steady_clock::now();
+    }
+    if (!m_handshakeComplete) {
+        const std::size_t consumed = std::min(length, kHandshakeSize - m_handshakeReceived);
+        ProcessHandshake(data, consumed);
+        if (consumed >= length) {
+            return {};
+        }
+        data += consumed;
+        length -= consumed;
+    }
+    trace::MarkReceive(traceStart);
+    Count(Metric::RxBytes, length);
+    return {data, length};
+}
+
+} // namespace bcnp
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "bcnp/metrics.h"
 #include "bcnp/packet.h"
 #include "bcnp/transport/adapter.h"
+#include "bcnp/transport/io_uring.h"
+#include "bcnp/transport/tx_scheduler.h"
 #include <bcnp/message_types.h>
 
 #include <chrono>
@@ -18,9 +21,63 @@ namespace bcnp {
  * 
  * Server mode: Listens on a port, accepts one client at a time.
  * Client mode: Connects to a remote server, auto-reconnects on disconnect.
+ * 
+ * io_uring backend (Linux): after EnableIoUring(), reads and sends on the
+ * connected socket go through an io_uring ring instead of recv()/send().
+ * A read into one of two registered buffers is always outstanding, so
+ * data is reaped from the completion queue without a syscall or a
+ * would-block probe, and ReceiveInPlace() hands the registered buffer
+ * straight to the parser. Accept, connect, reconnect and the handshake are
+ * unchanged, so the adapter is a drop-in replacement either way.
+ * 
+ * Transmit lanes: queued data waits in per-priority lanes (see
+ * TxScheduler). The DuplexAdapter send calls use the control lane; the
+ * TxPriority overloads and Lane() pick another. Each flush sends control
+ * first, then telemetry, then bulk, which is split on packet boundaries and
+ * limited by SetBulkRateLimit(). When the buffer fills, queued bulk and then
+ * telemetry packets are dropped to make room for higher lanes.
+ * 
+ * @code{cpp}
+ * TcpPosixAdapter adapter(5800);
+ * if (!adapter.EnableIoUring()) {
+ *     // Kernel without io_uring (or blocked by seccomp): plain sockets are used
+ * }
+ * DispatcherDriver driver(dispatcher, adapter);   // Pushes from the registered buffers
+ * 
+ * adapter.SetBulkRateLimit(2'000'000, 64 * 1024);
+ * auto bulk = adapter.Lane(TxPriority::Bulk);
+ * SendTypedPacket(bulk, mapChunkPacket);          // Behind any queued control and telemetry
+ * @endcode
  */
 class TcpPosixAdapter : public DuplexAdapter {
 public:
+    /**
+     * @brief ByteWriter that sends through one transmit lane of an adapter.
+     * 
+     * A small value type; pass it to anything taking a ByteWriter, such as
+     * SendTypedPacket() or TelemetryBatcher. Valid while the adapter lives.
+     */
+    class LaneWriter : public ByteWriter {
+    public:
+        LaneWriter(TcpPosixAdapter& adapter, TxPriority priority) : m_adapter(&adapter), m_priority(priority) {}
+
+        bool SendBytes(const uint8_t* data, std::size_t length) override {
+            return m_adapter->SendBytes(data, length, m_priority);
+        }
+        bool SendBytesV(const ByteSpan* spans, std::size_t count) override {
+            return m_adapter->SendBytesV(spans, count, m_priority);
+        }
+        bool SendFramePart(const uint8_t* data, std::size_t length, FramePart part) override {
+            return m_adapter->SendFramePart(data, length, part, m_priority);
+        }
+        MutableByteSpan ReserveTx(std::size_t length) override { return m_adapter->ReserveTx(length, m_priority); }
+        bool CommitTx(std::size_t length) override { return m_adapter->CommitTx(length); }
+
+    private:
+        TcpPosixAdapter* m_adapter;
+        TxPriority m_priority;
+    };
+
     /**
      * @brief Construct TCP adapter.
      * @param listenPort Port to listen on (server mode) or 0 (client mode)
@@ -30,9 +87,39 @@ public:
     explicit TcpPosixAdapter(uint16_t listenPort, const char* targetIp = nullptr, uint16_t targetPort = 0);
     ~TcpPosixAdapter() override;
 
+    /// Send calls without a priority use the control lane
     bool SendBytes(const uint8_t* data, std::size_t length) override;
+    bool SendBytesV(const ByteSpan* spans, std::size_t count) override;
+    bool SendFramePart(const uint8_t* data, std::size_t length, FramePart part) override;
+    MutableByteSpan ReserveTx(std::size_t length) override;
+    bool CommitTx(std::size_t length) override;
+
+    bool SendBytes(const uint8_t* data, std::size_t length, TxPriority priority);
+    bool SendBytesV(const ByteSpan* spans, std::size_t count, TxPriority priority);
+    bool SendFramePart(const uint8_t* data, std::size_t length, FramePart part, TxPriority priority);
+    MutableByteSpan ReserveTx(std::size_t length, TxPriority priority);
+
+    /// Writer for one transmit lane
+    LaneWriter Lane(TxPriority priority) { return LaneWriter(*this, priority); }
     std::size_t ReceiveChunk(uint8_t* buffer, std::size_t maxLength) override;
 
+    /// With io_uring: view of the registered buffer the last read completed into
+    ByteSpan ReceiveInPlace() override;
+    bool SupportsReceiveInPlace() const override { return m_uring != nullptr; }
+
+    /// Connected socket (ring descriptor with io_uring); server: listening socket until a client attaches
+    int ReadableFd() const override;
+
+    /**
+     * @brief Switch socket reads and sends to an io_uring ring.
+     * @param config Ring size and registered receive buffer size
+     * @return false if io_uring is unavailable; the adapter keeps using socket calls
+     */
+    bool EnableIoUring(IoUringConfig config = {});
+
+    /// true once EnableIoUring() succeeded
+    bool IsIoUringEnabled() const { return m_uring != nullptr; }
+
     bool IsValid() const { return m_socket >= 0 || (!m_isServer && m_peerAddrValid); }
     bool IsConnected() const { return m_isConnected && m_handshakeComplete; }
     
@@ -43,6 +130,23 @@ public:
     /// Override expected schema hash (for testing with custom schemas)
     void SetExpectedSchemaHash(uint32_t hash) { m_expectedSchemaHash = hash; }
 
+    /// Record bytes, EAGAINs, drops, connects, TX ring depth and lane delays into @p metrics (nullptr = off)
+    void SetMetrics(MetricsRegistry* metrics) {
+        m_metrics = metrics;
+        m_tx.SetMetrics(metrics);
+    }
+
+    /// Limit the bulk lane to @p bytesPerSecond (0 = unlimited), allowing @p burstBytes at once
+    void SetBulkRateLimit(uint64_t bytesPerSecond, std::size_t burstBytes = 64 * 1024) {
+        m_tx.SetBulkRateLimit(bytesPerSecond, burstBytes);
+    }
+
+    /// Wire size lookup for splitting bulk data into packets (for custom schemas)
+    void SetWireSizeFunction(TxScheduler::WireSizeFn lookup) { m_tx.SetWireSizeFunction(lookup); }
+
+    /// Sent, evicted and rejected units and queueing delay of one lane
+    TxLaneMetrics GetTxLaneMetrics(TxPriority priority) const { return m_tx.GetLaneMetrics(priority); }
+
 private:
     bool CreateBaseSocket();
     bool ConfigureSocket(int sock);
@@ -51,10 +155,31 @@ private:
     void HandleConnectionLoss();
     void TryFlushTxBuffer(int targetSock);
     bool EnqueueTx(const uint8_t* data, std::size_t length);
+    bool AdmitTx(TxPriority priority, std::size_t length, FramePart part = FramePart::Whole);
+    bool SendSpans(const ByteSpan* spans, std::size_t count, TxPriority priority, FramePart part);
     void DropPendingTx();
     void LogError(const char* message);
+    void Count(Metric metric, std::size_t n = 1) {
+        if (m_metrics) {
+            m_metrics->Add(metric, n);
+        }
+    }
+    void RecordTxQueued() {
+        if (m_metrics) {
+            m_metrics->SetWithHighWater(Metric::TxQueuedBytes, Metric::TxQueuedHighWater, m_tx.QueuedBytes());
+        }
+    }
     bool ProcessHandshake(const uint8_t* data, std::size_t length);
     uint32_t GetExpectedSchemaHash() const;
+    void CloseSocket(int& sock);
+
+    // io_uring backend
+    void AttachUring(int sock);
+    void DetachUring();
+    void ReapUring();
+    void SubmitUringRead();
+    void FlushUring();
+    ByteSpan ReceiveUring();
 
     int m_socket{-1};
     int m_clientSocket{-1}; // For server mode, the connected client
@@ -74,15 +199,35 @@ private:
     // Max packet size: header + largest reasonable message payload + CRC
     static constexpr std::size_t kMaxPacketSize = 65536;
     static constexpr std::size_t kTxBufferCapacity = kMaxPacketSize * 8; // Real-time: limit buffering
-    std::unique_ptr<uint8_t[]> m_txBuffer;
-    std::size_t m_txHead{0};
-    std::size_t m_txTail{0};
-    std::size_t m_txSize{0};
+    static constexpr std::size_t kMaxTxSendBytes = kMaxPacketSize * 2; // Largest single send (lane rings hold threshold + this)
+    static constexpr std::size_t kMaxTxIov = 64; // Spans gathered per sendmsg()
+    TxScheduler m_tx{TxSchedulerConfig{kTxBufferCapacity, kTxBufferCapacity / 2, kMaxTxSendBytes}};
+    // ReserveTx state: reservations land at the lane's ring tail, or in
+    // m_txStaging when the free space wraps (copied into the lane on commit)
+    std::unique_ptr<uint8_t[]> m_txStaging;
+    std::size_t m_txReservedLength{0};
+    TxPriority m_txReservedLane{TxPriority::Control};
+    bool m_txReserved{false};
+    bool m_txReserveStaged{false};
     std::chrono::steady_clock::time_point m_lastErrorLog{};
+    MetricsRegistry* m_metrics{nullptr};
     
     // Handshake receive buffer
     uint8_t m_handshakeBuffer[kHandshakeSize]{};
     std::size_t m_handshakeReceived{0};
+
+    // io_uring backend: m_uringFd is the socket registered as fixed file 0 (-1 = plain socket calls)
+    static constexpr int kNoResult = 1 << 30;
+    std::unique_ptr<IoUring> m_uring;
+    std::unique_ptr<uint8_t[]> m_uringRx;  // Two registered buffers of m_uringRxSize bytes
+    std::size_t m_uringRxSize{0};
+    int m_uringFd{-1};
+    unsigned m_rxSlot{0};                  // Buffer the outstanding read targets
+    bool m_rxInFlight{false};
+    int m_rxResult{kNoResult};             // Completed read not yet consumed
+    bool m_txInFlight{false};
+    int m_txResult{kNoResult};             // Completed send not yet applied
+    ByteSpan m_rxView{};                   // Unreturned part of the last read (ReceiveChunk() copies)
 };
 
 } // namespace bcnp
\ No newline at end of file
@@ -0,0 +1,738 @@
+/**
+ * @file tcp_reactor.cpp
+ * @brief Event-driven multi-client TCP server for BCNP.
+ *
+ * One epoll instance (Linux) or a poll() set (other POSIX systems) watches
+ * the listening socket, every client socket, and a wake descriptor used to
+ * interrupt the wait from other threads. Sockets are level-triggered and
+ * non-blocking; each readable event drains a bounded number of recv() calls
+ * so one busy client cannot starve the others.
+ *
+ * @see TcpReactor
+ */
+#include "bcnp/transport/tcp_reactor.h"
+
+#include "bcnp/latency_trace.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#define BCNP_REACTOR_HAS_EPOLL 1
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace bcnp {
+
+namespace {
+/// @brief Event tokens for the non-connection descriptors (connection IDs are 32-bit).
+constexpr uint64_t kListenToken = ~uint64_t{0};
+constexpr uint64_t kWakeToken = ~uint64_t{0} - 1;
+
+/// @brief Events fetched per wait.
+constexpr std::size_t kMaxEvents = 64;
+
+/// @brief recv() calls per readable event before yielding to other clients.
+constexpr std::size_t kMaxReadsPerEvent = 16;
+
+/// @brief Wait timeout of the Start() thread (bounds idle-timeout latency).
+constexpr auto kReactorTick = std::chrono::milliseconds(100);
+
+/// @brief Minimum interval between error log messages to prevent spam.
+constexpr auto kLogThrottle = std::chrono::seconds(1);
+
+bool SetNonBlocking(int fd) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) >= 0;
+}
+} // namespace
+
+/**
+ * @brief Creates the listening socket, wake descriptor and event backend.
+ *
+ * On any failure the reactor is left invalid (see IsValid()).
+ *
+ * @param listenPort Port to bind on all interfaces (0 = ephemeral).
+ * @param config Reactor configuration.
+ */
+TcpReactor::TcpReactor(uint16_t listenPort, TcpReactorConfig config)
+    : m_config(config) {
+    m_rxScratch.resize(std::max<std::size_t>(m_config.rxChunkSize, kHandshakeSize));
+    m_events.reserve(kMaxEvents);
+
+    m_listenSocket = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenSocket < 0) {
+        LogError("socket");
+        return;
+    }
+
+    int yes = 1;
+    if (setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) < 0) {
+        LogError("setsockopt(SO_REUSEADDR)");
+    }
+
+    sockaddr_in bindAddr{};
+    bindAddr.sin_family = AF_INET;
+    bindAddr.sin_port = htons(listenPort);
+    bindAddr.sin_addr.s_addr = INADDR_ANY;
+
+    if (bind(m_listenSocket, reinterpret_cast<sockaddr*>(&bindAddr), sizeof(bindAddr)) < 0 ||
+        listen(m_listenSocket, static_cast<int>(std::max<std::size_t>(m_config.maxConnections, 1))) < 0 ||
+        !SetNonBlocking(m_listenSocket)) {
+        LogError("bind/listen");
+        ::close(m_listenSocket);
+        m_listenSocket = -1;
+        return;
+    }
+
+    sockaddr_in bound{};
+    socklen_t boundLen = sizeof(bound);
+    if (getsockname(m_listenSocket, reinterpret_cast<sockaddr*>(&bound), &boundLen) == 0) {
+        m_port = ntohs(bound.sin_port);
+    }
+
+#if defined(BCNP_REACTOR_HAS_EPOLL)
+    m_wakeRead = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_wakeWrite = m_wakeRead;
+    m_pollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (m_pollFd < 0) {
+        LogError("epoll_create1");
+    }
+#else
+    int fds[2];
+    if (::pipe(fds) == 0) {
+        m_wakeRead = fds[0];
+        m_wakeWrite = fds[1];
+        SetNonBlocking(m_wakeRead);
+        SetNonBlocking(m_wakeWrite);
+    }
+#endif
+
+    if (m_wakeRead < 0 || !Register(m_listenSocket, kListenToken) || !Register(m_wakeRead, kWakeToken)) {
+        LogError("reactor setup");
+        ::close(m_listenSocket);
+        m_listenSocket = -1;
+    }
+}
+
+/**
+ * @brief Stops the reactor thread and closes every socket.
+ *
+ * Connection callbacks are not invoked for clients closed here.
+ */
+TcpReactor::~TcpReactor() {
+    Stop();
+    for (auto& entry : m_connections) {
+        ::close(entry.second->fd);
+    }
+    m_connections.clear();
+    if (m_listenSocket >= 0) {
+        ::close(m_listenSocket);
+    }
+    if (m_pollFd >= 0) {
+        ::close(m_pollFd);
+    }
+    if (m_wakeRead >= 0) {
+        ::close(m_wakeRead);
+    }
+    if (m_wakeWrite >= 0 && m_wakeWrite != m_wakeRead) {
+        ::close(m_wakeWrite);
+    }
+}
+
+const char* TcpReactor::Backend() {
+#if defined(BCNP_REACTOR_HAS_EPOLL)
+    return "epoll";
+#else
+    return "poll";
+#endif
+}
+
+/**
+ * @brief Waits for activity and services it: accepts, reads, flushes, reaps.
+ *
+ * @param timeout Longest time to block when no descriptor is ready.
+ * @return Number of packets handed to the packet handler.
+ */
+std::size_t TcpReactor::PollOnce(std::chrono::milliseconds timeout) {
+    m_dispatched = 0;
+    if (!IsValid()) {
+        return 0;
+    }
+
+    const std::size_t count = WaitEvents(timeout);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Event event = m_events[i];
+        if (event.token == kWakeToken) {
+            DrainWake();
+            continue;
+        }
+        if (event.token == kListenToken) {
+            AcceptClients();
+            continue;
+        }
+
+        // Connections are only erased on this thread, so the pointer stays valid
+        Connection* conn = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_connections.find(static_cast<ConnectionId>(event.token));
+            if (it == m_connections.end()) {
+                continue;
+            }
+            conn = it->second.get();
+            if (event.writable && !FlushLocked(*conn)) {
+                conn->closeRequested = true;
+            }
+        }
+        if (event.readable || event.hangup) {
+            ReadConnection(*conn);
+        }
+    }
+
+    ReapConnections(Clock::now());
+    return m_dispatched;
+}
+
+/**
+ * @brief Runs PollOnce() on a dedicated thread until Stop().
+ * @return false if already running or the reactor is invalid.
+ */
+bool TcpReactor::Start() {
+    if (!IsValid() || m_running.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+    m_stopRequested.store(false, std::memory_order_release);
+    m_thread = std::thread([this]() {
+        while (!m_stopRequested.load(std::memory_order_acquire)) {
+            PollOnce(kReactorTick);
+        }
+    });
+    return true;
+}
+
+/**
+ * @brief Signals the reactor thread through the wake descriptor and joins it.
+ */
+void TcpReactor::Stop() {
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    m_stopRequested.store(true, std::memory_order_release);
+    Wake();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Sends bytes to a validated client.
+ *
+ * @param id Connection to send to.
+ * @param data Bytes to send.
+ * @param length Number of bytes.
+ * @return true if written or queued, false if the client is unknown, has not
+ *         completed the handshake, is closing, or its TX queue is full.
+ */
+bool TcpReactor::Send(ConnectionId id, const uint8_t* data, std::size_t length) {
+    if (!data && length > 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_connections.find(id);
+    if (it == m_connections.end() || !it->second->validated || it->second->closeRequested) {
+        return false;
+    }
+    return QueueLocked(*it->second, data, length);
+}
+
+/**
+ * @brief Sends the same bytes to every validated client.
+ * @return Number of clients that accepted the bytes.
+ */
+std::size_t TcpReactor::Broadcast(const uint8_t* data, std::size_t length) {
+    if (!data && length > 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t accepted = 0;
+    for (auto& entry : m_connections) {
+        Connection& conn = *entry.second;
+        if (conn.validated && !conn.closeRequested && QueueLocked(conn, data, length)) {
+            ++accepted;
+        }
+    }
+    return accepted;
+}
+
+/**
+ * @brief Requests that a client be closed by the reactor thread.
+ */
+void TcpReactor::Disconnect(ConnectionId id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_connections.find(id);
+    if (it != m_connections.end()) {
+        it->second->closeRequested = true;
+        Wake();
+    }
+}
+
+/**
+ * @brief Counts clients that completed the schema handshake.
+ */
+std::size_t TcpReactor::ConnectionCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<std::size_t>(std::count_if(m_connections.begin(), m_connections.end(),
+        [](const auto& entry) { return entry.second->validated && !entry.second->closeRequested; }));
+}
+
+/**
+ * @brief Adds a descriptor to the epoll set, readable interest only.
+ *
+ * The poll backend rebuilds its set on every wait, so nothing is stored.
+ */
+bool TcpReactor::Register(int fd, uint64_t token) {
+#if defined(BCNP_REACTOR_HAS_EPOLL)
+    if (m_pollFd < 0) {
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = token;
+    if (::epoll_ctl(m_pollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        LogError("epoll_ctl(ADD)");
+        return false;
+    }
+#else
+    (void)fd;
+    (void)token;
+#endif
+    return true;
+}
+
+/**
+ * @brief Applies the connection's write interest (caller holds m_mutex).
+ */
+void TcpReactor::UpdateInterest(Connection& conn) {
+#if defined(BCNP_REACTOR_HAS_EPOLL)
+    epoll_event ev{};
+    ev.events = EPOLLIN | (conn.wantWrite ? EPOLLOUT : 0u);
+    ev.data.u64 = conn.id;
+    if (::epoll_ctl(m_pollFd, EPOLL_CTL_MOD, conn.fd, &ev) < 0) {
+        LogError("epoll_ctl(MOD)");
+    }
+#else
+    (void)conn;
+    Wake(); // Rebuild the poll set with the new interest
+#endif
+}
+
+/**
+ * @brief Removes a descriptor from the epoll set (before it is closed).
+ */
+void TcpReactor::Unregister(int fd) {
+#if defined(BCNP_REACTOR_HAS_EPOLL)
+    ::epoll_ctl(m_pollFd, EPOLL_CTL_DEL, fd, nullptr);
+#else
+    (void)fd;
+#endif
+}
+
+/**
+ * @brief Blocks until a descriptor is ready or @p timeout passes.
+ * @return Number of entries written to m_events.
+ */
+std::size_t TcpReactor::WaitEvents(std::chrono::milliseconds timeout) {
+    m_events.clear();
+    const int timeoutMs = static_cast<int>(std::max<std::chrono::milliseconds::rep>(timeout.count(), 0));
+
+#if defined(BCNP_REACTOR_HAS_EPOLL)
+    epoll_event ready[kMaxEvents];
+    const int count = ::epoll_wait(m_pollFd, ready, static_cast<int>(kMaxEvents), timeoutMs);
+    if (count < 0) {
+        if (errno != EINTR) {
+            LogError("epoll_wait");
+        }
+        return 0;
+    }
+    for (int i = 0; i < count; ++i) {
+        Event event;
+        event.token = ready[i].data.u64;
+        event.readable = (ready[i].events & EPOLLIN) != 0;
+        event.writable = (ready[i].events & EPOLLOUT) != 0;
+        event.hangup = (ready[i].events & (EPOLLHUP | EPOLLERR)) != 0;
+        m_events.push_back(event);
+    }
+#else
+    m_pollSet.clear();
+    m_pollTokens.clear();
+    m_pollSet.push_back({m_listenSocket, POLLIN, 0});
+    m_pollTokens.push_back(kListenToken);
+    m_pollSet.push_back({m_wakeRead, POLLIN, 0});
+    m_pollTokens.push_back(kWakeToken);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_connections) {
+            const Connection& conn = *entry.second;
+            m_pollSet.push_back({conn.fd, static_cast<short>(POLLIN | (conn.wantWrite ? POLLOUT : 0)), 0});
+            m_pollTokens.push_back(conn.id);
+        }
+    }
+    const int count = ::poll(m_pollSet.data(), static_cast<nfds_t>(m_pollSet.size()), timeoutMs);
+    if (count < 0) {
+        if (errno != EINTR) {
+            LogError("poll");
+        }
+        return 0;
+    }
+    for (std::size_t i = 0; i < m_pollSet.size(); ++i) {
+        const short revents = m_pollSet[i].revents;
+        if (revents == 0) {
+            continue;
+        }
+        Event event;
+        event.token = m_pollTokens[i];
+        event.readable = (revents & POLLIN) != 0;
+        event.writable = (revents & POLLOUT) != 0;
+        event.hangup = (revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+        m_events.push_back(event);
+    }
+#endif
+    return m_events.size();
+}
+
+/**
+ * @brief Interrupts a blocked wait from any thread.
+ */
+void TcpReactor::Wake() {
+    if (m_wakeWrite < 0) {
+        return;
+    }
+#if defined(BCNP_REACTOR_HAS_EPOLL)
+    const uint64_t one = 1;
+    const ssize_t written = ::write(m_wakeWrite, &one, sizeof(one));
+#else
+    const uint8_t one = 1;
+    const ssize_t written = ::write(m_wakeWrite, &one, sizeof(one));
+#endif
+    (void)written; // EAGAIN means a wake is already pending
+}
+
+/**
+ * @brief Clears pending wake signals.
+ */
+void TcpReactor::DrainWake() {
+    uint8_t buffer[64];
+    while (::read(m_wakeRead, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+/**
+ * @brief Accepts every pending client and sends it the schema handshake.
+ *
+ * Clients beyond TcpReactorConfig::maxConnections are closed immediately.
+ */
+void TcpReactor::AcceptClients() {
+    while (true) {
+        sockaddr_in clientAddr{};
+        socklen_t len = sizeof(clientAddr);
+        const int fd = ::accept(m_listenSocket, reinterpret_cast<sockaddr*>(&clientAddr), &len);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LogError("accept");
+            }
+            return;
+        }
+
+        int yes = 1;
+        if (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes)) < 0 || !SetNonBlocking(fd)) {
+            LogError("configure client socket");
+            ::close(fd);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_connections.size() >= m_config.maxConnections) {
+            LogError("connection limit reached - rejecting client");
+            ::close(fd);
+            continue;
+        }
+
+        auto conn = std::make_unique<Connection>();
+        conn->id = m_nextId++;
+        if (m_nextId == 0) {
+            m_nextId = 1;
+        }
+        conn->fd = fd;
+        conn->lastRx = Clock::now();
+        const ConnectionId id = conn->id;
+        conn->parser = std::make_unique<StreamParser>(
+            [this, id](const PacketView& packet) {
+                ++m_dispatched;
+                if (m_packetHandler) {
+                    m_packetHandler(id, packet);
+                }
+            },
+            [this, id](const StreamParser::ErrorInfo& error) {
+                if (m_errorHandler) {
+                    m_errorHandler(id, error);
+                }
+            },
+            m_config.parserBufferSize);
+        if (m_config.wireSizeFn) {
+            conn->parser->SetWireSizeFunction(m_config.wireSizeFn);
+        }
+
+        if (!Register(fd, id)) {
+            ::close(fd);
+            continue;
+        }
+
+        uint8_t handshake[kHandshakeSize];
+        const uint32_t hash = m_config.expectedSchemaHash != 0 ? m_config.expectedSchemaHash : kSchemaHash;
+        EncodeHandshakeWithHash(handshake, sizeof(handshake), hash);
+        Connection& ref = *conn;
+        m_connections.emplace(id, std::move(conn));
+        QueueLocked(ref, handshake, sizeof(handshake));
+    }
+}
+
+/**
+ * @brief Reads available bytes from a client and feeds its parser.
+ *
+ * @return Bytes received.
+ */
+std::size_t TcpReactor::ReadConnection(Connection& conn) {
+    std::size_t total = 0;
+    for (std::size_t reads = 0; reads < kMaxReadsPerEvent; ++reads) {
+        const uint64_t traceStart = trace::Now();
+        const ssize_t received = ::recv(conn.fd, m_rxScratch.data(), m_rxScratch.size(), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                conn.closeRequested = true;
+            }
+            break;
+        }
+        if (received == 0) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            conn.closeRequested = true;
+            break;
+        }
+
+        total += static_cast<std::size_t>(received);
+        conn.lastRx = Clock::now();
+        trace::MarkReceive(traceStart);
+
+        const uint8_t* data = m_rxScratch.data();
+        std::size_t length = static_cast<std::size_t>(received);
+        if (!conn.validated && !ConsumeHandshake(conn, data, length)) {
+            break;
+        }
+        if (length > 0 && conn.validated) {
+            conn.parser->Push(data, length);
+        }
+        if (static_cast<std::size_t>(received) < m_rxScratch.size()) {
+            break; // Socket drained
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Accumulates the client's handshake from the front of @p data.
+ *
+ * Advances @p data / @p length past the consumed bytes. On a schema
+ * mismatch the connection is marked for closing.
+ *
+ * @return false if the connection must stop reading (mismatch).
+ */
+bool TcpReactor::ConsumeHandshake(Connection& conn, const uint8_t*& data, std::size_t& length) {
+    const std::size_t take = std::min(length, kHandshakeSize - conn.handshakeReceived);
+    std::memcpy(conn.handshake + conn.handshakeReceived, data, take);
+    conn.handshakeReceived += take;
+    data += take;
+    length -= take;
+    if (conn.handshakeReceived < kHandshakeSize) {
+        return true;
+    }
+
+    const uint32_t expected = m_config.expectedSchemaHash != 0 ? m_config.expectedSchemaHash : kSchemaHash;
+    if (!ValidateHandshakeWithHash(conn.handshake, kHandshakeSize, expected)) {
+        std::cerr << "TCP reactor: Schema mismatch on connection " << conn.id << "! Local=0x" << std::hex
+                  << expected << " Remote=0x" << ExtractSchemaHash(conn.handshake, kHandshakeSize)
+                  << std::dec << std::endl;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        conn.closeRequested = true;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        conn.validated = true;
+    }
+    if (m_connectionHandler) {
+        m_connectionHandler(conn.id, true);
+    }
+    return true;
+}
+
+/**
+ * @brief Writes bytes to a client, queueing what the kernel does not accept.
+ *
+ * Caller holds m_mutex. The queue limit is only enforced when nothing was
+ * written, so a partially sent packet is always completed.
+ *
+ * @return false if the queue is full or the socket failed.
+ */
+bool TcpReactor::QueueLocked(Connection& conn, const uint8_t* data, std::size_t length) {
+    std::size_t written = 0;
+    if (conn.txHead == conn.tx.size()) {
+        while (written < length) {
+            const ssize_t sent = ::send(conn.fd, data + written, length - written, MSG_NOSIGNAL);
+            if (sent > 0) {
+                written += static_cast<std::size_t>(sent);
+                continue;
+            }
+            if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            conn.closeRequested = true;
+            Wake();
+            return false;
+        }
+    }
+    if (written == length) {
+        return true;
+    }
+
+    const std::size_t pending = conn.tx.size() - conn.txHead;
+    if (written == 0 && pending + length > m_config.txBufferCapacity) {
+        LogError("client tx queue full - dropping packet");
+        return false;
+    }
+    if (pending == 0) {
+        conn.tx.clear();
+        conn.txHead = 0;
+    }
+    conn.tx.insert(conn.tx.end(), data + written, data + length);
+    if (!conn.wantWrite) {
+        conn.wantWrite = true;
+        UpdateInterest(conn);
+    }
+    return true;
+}
+
+/**
+ * @brief Flushes a client's TX queue after a writable event (caller holds m_mutex).
+ *
+ * @return false if the socket failed.
+ */
+bool TcpReactor::FlushLocked(Connection& conn) {
+    while (conn.txHead < conn.tx.size()) {
+        const ssize_t sent = ::send(conn.fd, conn.tx.data() + conn.txHead,
+                                    conn.tx.size() - conn.txHead, MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.txHead += static_cast<std::size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Keep the queue from creeping forward through the vector
+            if (conn.txHead > conn.tx.size() / 2) {
+                conn.tx.erase(conn.tx.begin(), conn.tx.begin() + static_cast<std::ptrdiff_t>(conn.txHead));
+                conn.txHead = 0;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    conn.tx.clear();
+    conn.txHead = 0;
+    if (conn.wantWrite) {
+        conn.wantWrite = false;
+        UpdateInterest(conn);
+    }
+    return true;
+}
+
+/**
+ * @brief Closes a client and reports it if it had completed the handshake.
+ */
+void TcpReactor::CloseConnection(ConnectionId id) {
+    std::unique_ptr<Connection> conn;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_connections.find(id);
+        if (it == m_connections.end()) {
+            return;
+        }
+        conn = std::move(it->second);
+        m_connections.erase(it);
+        Unregister(conn->fd);
+        ::close(conn->fd);
+    }
+    if (conn->validated && m_connectionHandler) {
+        m_connectionHandler(id, false);
+    }
+}
+
+/**
+ * @brief Closes clients that failed, were disconnected, or went silent.
+ */
+void TcpReactor::ReapConnections(Clock::time_point now) {
+    std::vector<ConnectionId> doomed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_connections) {
+            const Connection& conn = *entry.second;
+            const bool idle = m_config.idleTimeout.count() > 0 && now - conn.lastRx > m_config.idleTimeout;
+            if (conn.closeRequested || idle) {
+                doomed.push_back(entry.first);
+            }
+        }
+    }
+    for (const ConnectionId id : doomed) {
+        CloseConnection(id);
+    }
+}
+
+/**
+ * @brief Logs an error message with throttling.
+ *
+ * @param message Error description to log.
+ */
+void TcpReactor::LogError(const char* message) {
+    const Clock::rep now = Clock::now().time_since_epoch().count();
+    const Clock::rep throttle = std::chrono::duration_cast<Clock::duration>(kLogThrottle).count();
+    Clock::rep last = m_lastErrorLog.load(std::memory_order_relaxed);
+    if ((last != 0 && now - last < throttle) ||
+        !m_lastErrorLog.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+        return;
+    }
+    std::cerr << "TCP reactor error: " << message << " errno=" << errno << std::endl;
+}
+
+} // namespace bcnp
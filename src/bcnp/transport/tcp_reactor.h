@@ -0,0 +1,190 @@
+#pragma once
+
+#include "bcnp/packet.h"
+#include "bcnp/stream_parser.h"
+#include <bcnp/message_types.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bcnp {
+
+/// Configuration for TcpReactor
+struct TcpReactorConfig {
+    std::size_t maxConnections{16};                 ///< Further clients are accepted and closed
+    std::size_t parserBufferSize{4096};             ///< Per-connection StreamParser ring size
+    std::size_t txBufferCapacity{512 * 1024};       ///< Per-connection queued TX limit (bytes)
+    std::size_t rxChunkSize{8192};                  ///< recv() size per read
+    std::chrono::milliseconds idleTimeout{5000};    ///< Close silent clients (0 = never)
+    uint32_t expectedSchemaHash{0};                 ///< 0 = kSchemaHash from generated header
+    StreamParser::WireSizeFn wireSizeFn{nullptr};   ///< nullptr = GetWireSize()
+};
+
+/**
+ * @brief Multi-client BCNP TCP server driven by an event loop.
+ *
+ * Where TcpPosixAdapter serves a single client and must be polled,
+ * TcpReactor accepts up to TcpReactorConfig::maxConnections clients and
+ * blocks in epoll_wait() (poll() on non-Linux POSIX) until a socket is
+ * readable, so packets are dispatched as soon as they arrive.
+ *
+ * Every connection performs the V3 schema handshake independently and has
+ * its own StreamParser; clients with a mismatched schema hash are dropped.
+ * Parsed packets are delivered with the ConnectionId they arrived on.
+ *
+ * @code{cpp}
+ * PacketDispatcher dispatcher;
+ * TcpReactor reactor(5800);
+ * reactor.SetPacketHandler([&](TcpReactor::ConnectionId, const PacketView& pkt) {
+ *     dispatcher.Dispatch(pkt);
+ * });
+ * reactor.Start();  // Dedicated reactor thread
+ * @endcode
+ *
+ * Threading: handlers run on the thread calling PollOnce() (the reactor
+ * thread after Start()) and must be set before events are processed.
+ * Send(), Broadcast(), Disconnect() and ConnectionCount() are thread-safe
+ * and may be called from handlers. PollOnce() must not run concurrently
+ * with itself or with Start().
+ */
+class TcpReactor {
+public:
+    using Clock = std::chrono::steady_clock;
+    using ConnectionId = uint32_t;
+    using PacketCallback = std::function<void(ConnectionId, const PacketView&)>;
+    /// Called with connected=true once the handshake succeeds, false when it closes
+    using ConnectionCallback = std::function<void(ConnectionId, bool connected)>;
+    using ErrorCallback = std::function<void(ConnectionId, const StreamParser::ErrorInfo&)>;
+
+    /**
+     * @brief Create the listening socket.
+     * @param listenPort Port to bind (0 picks an ephemeral port, see Port())
+     * @param config Reactor configuration
+     */
+    explicit TcpReactor(uint16_t listenPort, TcpReactorConfig config = {});
+    ~TcpReactor();
+
+    TcpReactor(const TcpReactor&) = delete;
+    TcpReactor& operator=(const TcpReactor&) = delete;
+
+    bool IsValid() const { return m_listenSocket >= 0 && m_wakeRead >= 0; }
+
+    /// Bound listen port
+    uint16_t Port() const { return m_port; }
+
+    /// "epoll" or "poll"
+    static const char* Backend();
+
+    void SetPacketHandler(PacketCallback handler) { m_packetHandler = std::move(handler); }
+    void SetConnectionHandler(ConnectionCallback handler) { m_connectionHandler = std::move(handler); }
+    void SetErrorHandler(ErrorCallback handler) { m_errorHandler = std::move(handler); }
+
+    /**
+     * @brief Wait for socket activity and process it on the calling thread.
+     * @param timeout Longest time to block when nothing is ready
+     * @return Number of packets dispatched
+     */
+    std::size_t PollOnce(std::chrono::milliseconds timeout);
+
+    /// Run PollOnce() on a dedicated thread until Stop()
+    bool Start();
+
+    /// Wake and join the reactor thread (no-op if not running)
+    void Stop();
+
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Send bytes to one client (after its handshake).
+     *
+     * Writes directly when nothing is queued; the remainder is queued and
+     * flushed when the socket becomes writable.
+     *
+     * @return false if unknown, not yet validated, or its TX queue is full
+     */
+    bool Send(ConnectionId id, const uint8_t* data, std::size_t length);
+
+    /// Send to every validated client; returns how many accepted the bytes
+    std::size_t Broadcast(const uint8_t* data, std::size_t length);
+
+    /// Close a client from any thread (takes effect on the reactor thread)
+    void Disconnect(ConnectionId id);
+
+    /// Clients that completed the handshake
+    std::size_t ConnectionCount() const;
+
+private:
+    struct Connection {
+        ConnectionId id{0};
+        int fd{-1};
+        std::unique_ptr<StreamParser> parser;
+        uint8_t handshake[kHandshakeSize]{};
+        std::size_t handshakeReceived{0};
+        bool validated{false};
+        bool closeRequested{false};
+        bool wantWrite{false};
+        std::vector<uint8_t> tx;    // Pending bytes are tx[txHead, tx.size())
+        std::size_t txHead{0};
+        Clock::time_point lastRx{};
+    };
+
+    struct Event {
+        uint64_t token{0};
+        bool readable{false};
+        bool writable{false};
+        bool hangup{false};
+    };
+
+    bool Register(int fd, uint64_t token);
+    void UpdateInterest(Connection& conn);
+    void Unregister(int fd);
+    std::size_t WaitEvents(std::chrono::milliseconds timeout);
+    void Wake();
+    void DrainWake();
+
+    void AcceptClients();
+    std::size_t ReadConnection(Connection& conn);
+    bool ConsumeHandshake(Connection& conn, const uint8_t*& data, std::size_t& length);
+    bool QueueLocked(Connection& conn, const uint8_t* data, std::size_t length);
+    bool FlushLocked(Connection& conn);
+    void CloseConnection(ConnectionId id);
+    void ReapConnections(Clock::time_point now);
+    void LogError(const char* message);
+
+    TcpReactorConfig m_config;
+    int m_listenSocket{-1};
+    int m_pollFd{-1};          // epoll instance (unused by the poll backend)
+    int m_wakeRead{-1};        // eventfd, or read end of a pipe
+    int m_wakeWrite{-1};
+    uint16_t m_port{0};
+
+    mutable std::mutex m_mutex; // Guards m_connections and all TX state
+    std::unordered_map<ConnectionId, std::unique_ptr<Connection>> m_connections;
+    ConnectionId m_nextId{1};
+
+    PacketCallback m_packetHandler;
+    ConnectionCallback m_connectionHandler;
+    ErrorCallback m_errorHandler;
+
+    std::vector<Event> m_events;
+    std::vector<pollfd> m_pollSet;      // poll backend only
+    std::vector<uint64_t> m_pollTokens; // poll backend only
+    std::vector<uint8_t> m_rxScratch;
+    std::size_t m_dispatched{0};       // Packets dispatched during the current PollOnce()
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<Clock::rep> m_lastErrorLog{0}; // LogError() runs on reactor and sender threads
+};
+
+} // namespace bcnp
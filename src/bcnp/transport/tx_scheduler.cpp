@@ -0,0 +1,557 @@
+/**
+ * @file tx_scheduler.cpp
+ * @brief Priority lane bookkeeping, admission and the gather order.
+ */
+
+#include "bcnp/transport/tx_scheduler.h"
+
+#include "bcnp/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace bcnp {
+
+namespace {
+
+constexpr std::size_t kControlLane = static_cast<std::size_t>(TxPriority::Control);
+constexpr std::size_t kBulkLane = static_cast<std::size_t>(TxPriority::Bulk);
+constexpr uint8_t kUnitFrameBegin = 0x01;   // Unit starts a frame sent in pieces
+constexpr uint8_t kUnitFrameEnd = 0x02;     // Unit completes it
+
+uint8_t UnitFrameFlags(FramePart part) {
+    switch (part) {
+        case FramePart::Begin: return kUnitFrameBegin;
+        case FramePart::End: return kUnitFrameEnd;
+        default: return 0;
+    }
+}
+
+} // namespace
+
+TxScheduler::TxScheduler(TxSchedulerConfig config)
+    : m_config(config) {
+    m_config.capacity = std::max<std::size_t>(m_config.capacity, 1);
+    m_config.maxAppendBytes = std::clamp<std::size_t>(m_config.maxAppendBytes, 1, m_config.capacity);
+    m_config.maxUnitsPerLane = std::max<std::size_t>(m_config.maxUnitsPerLane, 1);
+    // Admission keeps a lane at or below threshold + one append (see Admit())
+    m_laneCapacity = m_config.capacity;
+    if (m_config.congestionThreshold < m_config.capacity - m_config.maxAppendBytes) {
+        m_laneCapacity = m_config.congestionThreshold + m_config.maxAppendBytes;
+    }
+    for (auto& lane : m_lanes) {
+        lane.data = std::make_unique<uint8_t[]>(m_laneCapacity);
+        lane.units = std::make_unique<Unit[]>(m_config.maxUnitsPerLane);
+    }
+    m_bulkTokens = static_cast<int64_t>(m_config.bulkBurstBytes);
+}
+
+/**
+ * @brief Admission control for @p bytes of new data in @p lane.
+ *
+ * Only bytes queued in this lane and higher ones delay the new data, so
+ * only those count towards the congestion threshold. If the buffer as a
+ * whole is full, lower lanes give up their newest units. Continue and End
+ * pieces of a frame skip the threshold: the frame holds back the other
+ * lanes, so their backlog must not keep it from finishing.
+ *
+ * @return true if the bytes may be queued now
+ */
+bool TxScheduler::Admit(TxPriority lane, std::size_t bytes, FramePart part) {
+    const auto index = static_cast<std::size_t>(lane);
+    std::size_t ahead = 0;
+    if (part != FramePart::Continue && part != FramePart::End) {
+        for (std::size_t i = 0; i <= index; ++i) {
+            ahead += m_lanes[i].size;
+        }
+    }
+    if (m_heldLane == static_cast<int>(index) || !FramePartAllowed(lane, part) ||
+        ahead > m_config.congestionThreshold ||
+        bytes > m_config.maxAppendBytes || bytes > m_laneCapacity - m_lanes[index].size) {
+        ++m_lanes[index].metrics.unitsRejected;
+        return false;
+    }
+
+    while (bytes + m_heldBytes > m_config.capacity - m_queuedBytes) {
+        bool evicted = false;
+        for (std::size_t i = kTxPriorityCount - 1; i > index && !evicted; --i) {
+            evicted = EvictNewest(m_lanes[i]);
+        }
+        if (!evicted) {
+            ++m_lanes[index].metrics.unitsRejected;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TxScheduler::FramePartAllowed(TxPriority lane, FramePart part) const {
+    const bool frameLane = m_frameLane == static_cast<int>(lane);
+    switch (part) {
+        case FramePart::Begin: return m_frameLane < 0;
+        case FramePart::Continue:
+        case FramePart::End: return m_frameOpen && frameLane;
+        default: return !(m_frameOpen && frameLane);
+    }
+}
+
+void TxScheduler::Append(TxPriority lane, const ByteSpan* spans, std::size_t count, Clock::time_point now,
+                         std::size_t alreadySent, FramePart part) {
+    const auto index = static_cast<std::size_t>(lane);
+    Lane& target = m_lanes[index];
+    RewindIfIdle(target);
+
+    std::size_t total = 0;
+    std::size_t skip = alreadySent;
+    for (std::size_t i = 0; i < count; ++i) {
+        total += spans[i].length;
+        const std::size_t skipped = std::min(skip, spans[i].length);
+        WriteTail(target, spans[i].data + skipped, spans[i].length - skipped);
+        skip -= skipped;
+    }
+    if (total > alreadySent) {
+        PushUnits(index, spans, count, total, alreadySent, now, part);
+    }
+}
+
+std::size_t TxScheduler::TailRoom(TxPriority lane) {
+    Lane& target = LaneAt(lane);
+    RewindIfIdle(target);
+    return std::min(m_laneCapacity - target.size, m_laneCapacity - target.tail);
+}
+
+MutableByteSpan TxScheduler::ReserveTail(TxPriority lane) {
+    const std::size_t contiguous = TailRoom(lane);
+    const std::size_t budget = std::min(m_config.capacity - m_queuedBytes, m_config.maxAppendBytes);
+    return {LaneAt(lane).data.get() + LaneAt(lane).tail, std::min(contiguous, budget)};
+}
+
+void TxScheduler::HoldTail(TxPriority lane, std::size_t bytes) {
+    m_heldLane = static_cast<int>(lane);
+    m_heldTail = LaneAt(lane).tail;
+    m_heldBytes = bytes;
+}
+
+bool TxScheduler::CommitTail(TxPriority lane, std::size_t length, Clock::time_point now, FramePart part) {
+    const auto index = static_cast<std::size_t>(lane);
+    Lane& target = m_lanes[index];
+    const bool held = m_heldLane == static_cast<int>(index) && target.tail == m_heldTail;
+    ReleaseTail();
+    if (!held) {
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+    const ByteSpan written{target.data.get() + target.tail, length};
+    target.tail = (target.tail + length) % m_laneCapacity;
+    target.size += length;
+    m_queuedBytes += length;
+    PushUnits(index, &written, 1, length, 0, now, part);
+    return true;
+}
+
+bool TxScheduler::MayWriteDirect(TxPriority lane) const {
+    if (!Empty() || m_gatherCount > 0) {
+        return false;
+    }
+    if (m_frameLane >= 0 && m_frameLane != static_cast<int>(lane)) {
+        return false;
+    }
+    return lane != TxPriority::Bulk || m_config.bulkBytesPerSecond == 0;
+}
+
+void TxScheduler::ChargeDirect(TxPriority lane, std::size_t bytes, std::size_t units, FramePart part) {
+    const auto index = static_cast<std::size_t>(lane);
+    if (part == FramePart::Begin && (bytes > 0 || units > 0)) {
+        m_frameLane = static_cast<int>(index);
+        m_frameOpen = true;
+        m_frameLive = true;
+    }
+    if (part == FramePart::End && units > 0) {
+        m_frameLane = -1;
+        m_frameOpen = false;
+        m_frameLive = false;
+    }
+    m_lanes[index].metrics.bytesSent += bytes;
+    if (index == kBulkLane && m_config.bulkBytesPerSecond != 0) {
+        m_bulkTokens -= static_cast<int64_t>(bytes);
+    }
+    for (std::size_t i = 0; i < units; ++i) {
+        RecordDelay(index, 0);
+    }
+}
+
+/**
+ * @brief Pin the next bytes to send: started remainder, control, telemetry, bulk.
+ *
+ * Nothing is gathered after a lane holding an unfinished frame, and once
+ * the frame is on the wire only its lane is.
+ */
+std::size_t TxScheduler::Gather(ByteSpan* out, std::size_t maxSpans, Clock::time_point now) {
+    if (m_gatherCount > 0 || maxSpans == 0) {
+        return 0;
+    }
+    RefillTokens(now);
+
+    std::size_t spans = 0;
+    if (m_startedLane >= 0) {
+        const auto index = static_cast<std::size_t>(m_startedLane);
+        const Lane& lane = m_lanes[index];
+        const std::size_t remainder = lane.units[lane.unitHead].length - lane.headSent;
+        spans += GatherLane(index, remainder, out, maxSpans);
+    }
+    for (std::size_t index = kControlLane; index < kTxPriorityCount && spans < maxSpans; ++index) {
+        const bool frameLane = m_frameLane == static_cast<int>(index);
+        if (m_frameLive && !frameLane) {
+            continue;
+        }
+        const Lane& lane = m_lanes[index];
+        std::size_t available = lane.size - lane.gathered;
+        if (m_frameLive && frameLane) {
+            available = FrameRemainder(lane) - lane.gathered;   // Higher lanes go once it ends
+        }
+        if (index == kBulkLane) {
+            available = std::min(available, BulkAllowance(lane));
+        }
+        if (available > 0) {
+            spans += GatherLane(index, available, out + spans, maxSpans - spans);
+        }
+        if (frameLane) {
+            break;   // Lower lanes would land inside the frame
+        }
+    }
+    return spans;
+}
+
+void TxScheduler::Consume(std::size_t bytes, Clock::time_point now) {
+    for (std::size_t i = 0; i < m_gatherCount && bytes > 0; ++i) {
+        const std::size_t taken = std::min(bytes, m_gather[i].bytes);
+        ConsumeLane(m_gather[i].lane, taken, now);
+        bytes -= taken;
+    }
+    for (auto& lane : m_lanes) {
+        lane.gathered = 0;
+    }
+    m_gatherCount = 0;
+}
+
+void TxScheduler::Clear() {
+    for (auto& lane : m_lanes) {
+        lane.head = 0;
+        lane.tail = 0;
+        lane.size = 0;
+        lane.unitHead = 0;
+        lane.unitCount = 0;
+        lane.headSent = 0;
+        lane.gathered = 0;
+    }
+    m_queuedBytes = 0;
+    m_startedLane = -1;
+    ReleaseTail();
+    m_frameLane = -1;
+    m_frameOpen = false;
+    m_frameLive = false;
+    m_gatherCount = 0;
+}
+
+void TxScheduler::SetBulkRateLimit(uint64_t bytesPerSecond, std::size_t burstBytes) {
+    m_config.bulkBytesPerSecond = bytesPerSecond;
+    m_config.bulkBurstBytes = burstBytes;
+    m_bulkTokens = static_cast<int64_t>(burstBytes);
+    m_lastRefill = {};
+    m_tokenRemainder = 0.0;
+}
+
+TxLaneMetrics TxScheduler::GetLaneMetrics(TxPriority lane) const {
+    const Lane& source = m_lanes[static_cast<std::size_t>(lane)];
+    TxLaneMetrics metrics = source.metrics;
+    metrics.queuedBytes = source.size;
+    metrics.queuedUnits = source.unitCount;
+    return metrics;
+}
+
+void TxScheduler::ResetMetrics() {
+    for (auto& lane : m_lanes) {
+        lane.metrics = {};
+    }
+}
+
+void TxScheduler::RewindIfIdle(Lane& lane) {
+    if (lane.size == 0 && lane.gathered == 0 && m_heldLane != static_cast<int>(&lane - m_lanes.data())) {
+        lane.head = 0;
+        lane.tail = 0;
+    }
+}
+
+/**
+ * @brief Record unit boundaries for @p total bytes of @p spans just queued.
+ *
+ * Bulk data is split at packet boundaries read from the packet headers;
+ * anything that does not parse as a run of whole packets stays one unit,
+ * as does every frame piece. The first @p alreadySent bytes are on the
+ * wire and not part of any unit.
+ */
+void TxScheduler::PushUnits(std::size_t laneIndex, const ByteSpan* spans, std::size_t count, std::size_t total,
+                            std::size_t alreadySent, Clock::time_point now, FramePart part) {
+    Lane& lane = m_lanes[laneIndex];
+    if (alreadySent > 0) {
+        m_startedLane = static_cast<int>(laneIndex);
+    }
+    if (part == FramePart::Begin) {
+        m_frameLane = static_cast<int>(laneIndex);
+        m_frameOpen = true;
+    } else if (part == FramePart::End) {
+        m_frameOpen = false;
+    }
+    if (laneIndex != kBulkLane || part != FramePart::Whole) {
+        PushUnit(lane, total - alreadySent, now, UnitFrameFlags(part));
+        return;
+    }
+
+    std::size_t spanIndex = 0;
+    std::size_t spanStart = 0;   // Offset of spans[spanIndex] in the concatenation
+    std::size_t offset = 0;
+    while (offset < total) {
+        uint8_t header[kHeaderSizeV3 + kCompressedLengthSize];
+        std::size_t copied = 0;
+        for (std::size_t i = spanIndex, start = spanStart; i < count && copied < sizeof(header); ++i) {
+            const std::size_t from = offset + copied - start;
+            if (from < spans[i].length) {
+                const std::size_t chunk = std::min(sizeof(header) - copied, spans[i].length - from);
+                std::memcpy(header + copied, spans[i].data + from, chunk);
+                copied += chunk;
+            }
+            start += spans[i].length;
+        }
+
+        std::size_t packet = PacketLength(header, copied);
+        if (packet == 0 || packet > total - offset) {
+            packet = total - offset;   // Not a run of whole packets: keep the rest together
+        }
+        const std::size_t end = offset + packet;
+        if (end > alreadySent) {
+            PushUnit(lane, end - std::max(offset, alreadySent), now);
+        }
+        offset = end;
+        while (spanIndex < count && spanStart + spans[spanIndex].length <= offset) {
+            spanStart += spans[spanIndex].length;
+            ++spanIndex;
+        }
+    }
+}
+
+void TxScheduler::PushUnit(Lane& lane, std::size_t length, Clock::time_point now, uint8_t frame) {
+    if (lane.unitCount == m_config.maxUnitsPerLane) {
+        // Out of unit slots: lose a unit boundary rather than data
+        Unit& last = lane.units[(lane.unitHead + lane.unitCount - 1) % m_config.maxUnitsPerLane];
+        last.length += length;
+        last.frame |= frame;
+        return;
+    }
+    lane.units[(lane.unitHead + lane.unitCount) % m_config.maxUnitsPerLane] = {length, now, frame};
+    ++lane.unitCount;
+}
+
+void TxScheduler::WriteTail(Lane& lane, const uint8_t* data, std::size_t length) {
+    const std::size_t firstChunk = std::min(length, m_laneCapacity - lane.tail);
+    std::memcpy(lane.data.get() + lane.tail, data, firstChunk);
+    if (length > firstChunk) {
+        std::memcpy(lane.data.get(), data + firstChunk, length - firstChunk);
+    }
+    lane.tail = (lane.tail + length) % m_laneCapacity;
+    lane.size += length;
+    m_queuedBytes += length;
+}
+
+/**
+ * @brief Drop the newest unit of @p lane unless it has started, is gathered,
+ *        or the lane holds an unfinished frame.
+ * @return true if a unit was dropped
+ */
+bool TxScheduler::EvictNewest(Lane& lane) {
+    const int index = static_cast<int>(&lane - m_lanes.data());
+    if (lane.unitCount == 0 || m_frameLane == index || m_heldLane == index) {
+        return false;
+    }
+    const std::size_t last = (lane.unitHead + lane.unitCount - 1) % m_config.maxUnitsPerLane;
+    const bool isHead = lane.unitCount == 1;
+    const std::size_t remaining = lane.units[last].length - (isHead ? lane.headSent : 0);
+    const bool started = isHead && (lane.headSent > 0 || m_startedLane == index);
+    if (started || lane.size - remaining < lane.gathered) {
+        return false;
+    }
+    lane.tail = (lane.tail + m_laneCapacity - remaining) % m_laneCapacity;
+    lane.size -= remaining;
+    m_queuedBytes -= remaining;
+    --lane.unitCount;
+    if (isHead) {
+        lane.headSent = 0;
+    }
+    ++lane.metrics.unitsEvicted;
+    lane.metrics.bytesEvicted += remaining;
+    if (m_metrics) {
+        m_metrics->Add(Metric::TxEvictions);
+    }
+    return true;
+}
+
+/// Pin up to @p bytes of @p laneIndex after what is already gathered; returns spans used
+std::size_t TxScheduler::GatherLane(std::size_t laneIndex, std::size_t bytes, ByteSpan* out,
+                                    std::size_t maxSpans) {
+    Lane& lane = m_lanes[laneIndex];
+    std::size_t position = (lane.head + lane.gathered) % m_laneCapacity;
+    std::size_t taken = 0;
+    std::size_t spans = 0;
+    while (taken < bytes && spans < maxSpans) {
+        const std::size_t chunk = std::min(bytes - taken, m_laneCapacity - position);
+        out[spans++] = {lane.data.get() + position, chunk};
+        taken += chunk;
+        position = (position + chunk) % m_laneCapacity;
+    }
+    lane.gathered += taken;
+    m_gather[m_gatherCount++] = {static_cast<uint8_t>(laneIndex), taken};
+    return spans;
+}
+
+void TxScheduler::ConsumeLane(std::size_t laneIndex, std::size_t bytes, Clock::time_point now) {
+    if (bytes == 0) {
+        return;
+    }
+    Lane& lane = m_lanes[laneIndex];
+    lane.head = (lane.head + bytes) % m_laneCapacity;
+    lane.size -= bytes;
+    m_queuedBytes -= bytes;
+    lane.metrics.bytesSent += bytes;
+    if (laneIndex == kBulkLane && m_config.bulkBytesPerSecond != 0) {
+        m_bulkTokens -= static_cast<int64_t>(bytes);
+    }
+
+    lane.headSent += bytes;
+    while (lane.unitCount > 0 && lane.headSent > 0) {
+        const Unit& unit = lane.units[lane.unitHead];
+        if (unit.frame & kUnitFrameBegin) {
+            m_frameLive = true;
+        }
+        if (lane.headSent < unit.length) {
+            break;
+        }
+        lane.headSent -= unit.length;
+        RecordDelay(laneIndex, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - unit.enqueued).count()));
+        if (unit.frame & kUnitFrameEnd) {
+            m_frameLane = -1;
+            m_frameLive = false;
+        }
+        lane.unitHead = (lane.unitHead + 1) % m_config.maxUnitsPerLane;
+        --lane.unitCount;
+        if (m_startedLane == static_cast<int>(laneIndex)) {
+            m_startedLane = -1;
+        }
+    }
+    if (lane.headSent > 0) {
+        m_startedLane = static_cast<int>(laneIndex);
+    }
+}
+
+/// Queued bytes of @p lane up to and including the frame's End unit (all of them if not queued yet)
+std::size_t TxScheduler::FrameRemainder(const Lane& lane) const {
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < lane.unitCount; ++i) {
+        const Unit& unit = lane.units[(lane.unitHead + i) % m_config.maxUnitsPerLane];
+        bytes += unit.length - (i == 0 ? lane.headSent : 0);
+        if (unit.frame & kUnitFrameEnd) {
+            break;
+        }
+    }
+    return bytes;
+}
+
+void TxScheduler::RecordDelay(std::size_t laneIndex, uint64_t delayNs) {
+    TxLaneMetrics& metrics = m_lanes[laneIndex].metrics;
+    ++metrics.unitsSent;
+    metrics.lastDelayNs = delayNs;
+    metrics.maxDelayNs = std::max(metrics.maxDelayNs, delayNs);
+    metrics.totalDelayNs += delayNs;
+    if (m_metrics) {
+        const auto offset = static_cast<uint8_t>(laneIndex);
+        m_metrics->Set(static_cast<Metric>(static_cast<uint8_t>(Metric::TxControlDelayUs) + offset),
+                       delayNs / 1000);
+        m_metrics->Max(static_cast<Metric>(static_cast<uint8_t>(Metric::TxControlDelayMaxUs) + offset),
+                       delayNs / 1000);
+    }
+}
+
+/**
+ * @brief Queued bulk bytes beyond the gathered ones that the token bucket allows.
+ *
+ * A unit goes once the bucket holds its length (or a full burst, for
+ * units larger than the burst), so bulk leaves in whole packets.
+ */
+std::size_t TxScheduler::BulkAllowance(const Lane& lane) const {
+    if (m_config.bulkBytesPerSecond == 0) {
+        return lane.size - lane.gathered;
+    }
+    int64_t budget = m_bulkTokens;
+    std::size_t allowed = 0;
+    std::size_t offset = 0;
+    for (std::size_t i = 0; i < lane.unitCount; ++i) {
+        const Unit& unit = lane.units[(lane.unitHead + i) % m_config.maxUnitsPerLane];
+        const std::size_t length = unit.length - (i == 0 ? lane.headSent : 0);
+        if (offset + length > lane.gathered) {
+            const std::size_t part = offset + length - std::max(offset, lane.gathered);
+            if (budget < static_cast<int64_t>(std::min(part, m_config.bulkBurstBytes))) {
+                break;
+            }
+            allowed += part;
+            budget -= static_cast<int64_t>(part);
+        }
+        offset += length;
+    }
+    return allowed;
+}
+
+void TxScheduler::RefillTokens(Clock::time_point now) {
+    if (m_config.bulkBytesPerSecond == 0) {
+        return;
+    }
+    const auto burst = static_cast<int64_t>(m_config.bulkBurstBytes);
+    if (m_lastRefill == Clock::time_point{} || m_bulkTokens >= burst) {
+        m_lastRefill = now;
+        m_tokenRemainder = 0.0;
+        return;
+    }
+    // Carry the fractional byte so frequent refills do not round the rate down
+    const double seconds = std::chrono::duration<double>(now - m_lastRefill).count();
+    const double earned = seconds * static_cast<double>(m_config.bulkBytesPerSecond) + m_tokenRemainder;
+    const double whole = std::floor(earned);
+    m_tokenRemainder = earned - whole;
+    m_lastRefill = now;
+    m_bulkTokens = std::min(burst, m_bulkTokens + static_cast<int64_t>(whole));
+}
+
+/**
+ * @brief Length of the BCNP packet at @p data, from its header.
+ * @return Frame length, or 0 if @p data does not start with a known packet header
+ */
+std::size_t TxScheduler::PacketLength(const uint8_t* data, std::size_t length) const {
+    if (length < kHeaderSizeV3 || data[kHeaderMajorIndex] != kProtocolMajorV3 ||
+        data[kHeaderMinorIndex] != kProtocolMinorV3) {
+        return 0;
+    }
+    if (data[kHeaderFlagsIndex] & kFlagCompressed) {
+        if (length < kHeaderSizeV3 + kCompressedLengthSize) {
+            return 0;
+        }
+        return kHeaderSizeV3 + kCompressedLengthSize + detail::LoadU16(&data[kHeaderSizeV3]) + kChecksumSize;
+    }
+    const auto typeId = static_cast<MessageTypeId>(detail::LoadU16(&data[kHeaderMsgTypeIndex]));
+    const std::size_t wireSize = m_wireSizeFn ? m_wireSizeFn(typeId) : GetWireSize(typeId);
+    if (wireSize == 0) {
+        return 0;
+    }
+    return kHeaderSizeV3 + detail::LoadU16(&data[kHeaderMsgCountIndex]) * wireSize + kChecksumSize;
+}
+
+} // namespace bcnp
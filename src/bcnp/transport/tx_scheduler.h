@@ -0,0 +1,273 @@
+#pragma once
+
+/**
+ * @file tx_scheduler.h
+ * @brief Priority lanes and scheduling for a stream transport's TX buffer.
+ */
+
+#include "bcnp/packet.h"
+#include "bcnp/transport/adapter.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace bcnp {
+
+class MetricsRegistry;
+
+/// Transmit lanes, highest priority first
+enum class TxPriority : uint8_t {
+    Control,     ///< Time-critical commands; always sent first
+    Telemetry,   ///< Periodic state
+    Bulk,        ///< Uploads and dumps; split on packet boundaries and rate-limited
+};
+
+inline constexpr std::size_t kTxPriorityCount = 3;
+
+/**
+ * @brief Configuration for TxScheduler.
+ *
+ * Admission never lets a lane hold more than congestionThreshold +
+ * maxAppendBytes, so each lane's ring is that size (at most capacity).
+ * Memory: 3 * min(capacity, congestionThreshold + maxAppendBytes) ring
+ * bytes plus 3 * maxUnitsPerLane unit slots of 16 bytes; about 1.2 MB for
+ * the defaults. capacity bounds what is queued at once, not the allocation.
+ */
+struct TxSchedulerConfig {
+    std::size_t capacity{8 * 65536};               ///< Bytes queued across all lanes
+    /// New data is refused while more than this many bytes would be sent ahead of it
+    std::size_t congestionThreshold{4 * 65536};
+    std::size_t maxAppendBytes{2 * 65536};         ///< Largest single Append()/CommitTail()
+    uint64_t bulkBytesPerSecond{0};                ///< Bulk lane rate limit (0 = unlimited)
+    std::size_t bulkBurstBytes{64 * 1024};         ///< Bulk bytes allowed at once after idling
+    std::size_t maxUnitsPerLane{1024};             ///< Queued units per lane; further units merge into the last
+};
+
+/**
+ * @brief Per-lane transmit statistics.
+ */
+struct TxLaneMetrics {
+    uint64_t unitsSent{0};          ///< Units (SendBytes() calls, spans, packets) fully sent
+    uint64_t bytesSent{0};
+    uint64_t unitsEvicted{0};       ///< Queued units dropped to admit higher-priority data
+    uint64_t bytesEvicted{0};
+    uint64_t unitsRejected{0};      ///< Admissions refused (lane congested or buffer full)
+    std::size_t queuedBytes{0};
+    std::size_t queuedUnits{0};
+    uint64_t lastDelayNs{0};        ///< Enqueue-to-sent time of the last unit
+    uint64_t maxDelayNs{0};
+    uint64_t totalDelayNs{0};
+
+    uint64_t MeanDelayNs() const { return unitsSent == 0 ? 0 : totalDelayNs / unitsSent; }
+};
+
+/**
+ * @brief Orders a stream transport's outbound bytes by priority.
+ *
+ * Each lane is a byte ring plus a ring of queued units. A unit is the data
+ * of one send call (all spans of a vectored send); bulk units are further
+ * split into one unit per BCNP packet, using the wire size lookup. The scheduler only switches lanes between units,
+ * so the stream never interleaves two packets, and once a unit has started
+ * transmitting its remainder goes out before anything else.
+ *
+ * Gather() returns the next bytes to write: the remainder of a started
+ * unit, then every queued control unit, then telemetry, then as many bulk
+ * units as the token bucket allows. Consume() reports how much of that the
+ * kernel took. With one send outstanding at a time (io_uring) the gathered
+ * bytes stay pinned until Consume().
+ *
+ * Admission: data is refused while more than congestionThreshold bytes are
+ * queued in its own and higher lanes (the bytes that would be sent ahead
+ * of it). When the buffer is full, queued units of lower lanes are evicted,
+ * lowest lane and newest unit first, to make room; started or gathered
+ * units are never evicted.
+ *
+ * Frames sent in pieces (FramePart Begin/Continue/End, one unit each) hold
+ * the wire: once the Begin unit starts transmitting, no other lane is sent
+ * until the End unit has been, and a lane holding an unfinished frame is
+ * never evicted. Other data for that lane is refused while the frame is
+ * open, since it would land inside the frame. Continue and End pieces skip
+ * the congestion threshold, because the lanes they hold back count
+ * towards it.
+ *
+ * Thread-safety: Not thread-safe. Owned by one adapter.
+ */
+class TxScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    /// Wire size per message type, for splitting bulk data into packets
+    using WireSizeFn = std::size_t (*)(MessageTypeId);
+
+    explicit TxScheduler(TxSchedulerConfig config = {});
+
+    TxScheduler(const TxScheduler&) = delete;
+    TxScheduler& operator=(const TxScheduler&) = delete;
+
+    /**
+     * @brief Make room for @p bytes more in @p lane, evicting lower lanes if needed.
+     * @return false if the data cannot be queued, or @p bytes exceeds
+     *         MaxAppendBytes() (counted as rejected)
+     */
+    bool Admit(TxPriority lane, std::size_t bytes, FramePart part = FramePart::Whole);
+
+    /// false if @p part cannot be queued in @p lane given the open frame, if any
+    bool FramePartAllowed(TxPriority lane, FramePart part) const;
+
+    /**
+     * @brief Queue the concatenation of @p spans as one unit (bulk: one unit per packet).
+     *
+     * Call after Admit() for the bytes being queued.
+     *
+     * @param alreadySent Leading bytes of the concatenation already written to
+     *        the socket; only valid while nothing is queued. The remainder is
+     *        sent before anything else.
+     * @param part Piece of a frame, kept as one unit (never split per packet)
+     */
+    void Append(TxPriority lane, const ByteSpan* spans, std::size_t count, Clock::time_point now,
+                std::size_t alreadySent = 0, FramePart part = FramePart::Whole);
+
+    /// Contiguous free ring bytes at the tail of @p lane, ignoring the buffer budget
+    std::size_t TailRoom(TxPriority lane);
+
+    /**
+     * @brief Contiguous free space at the tail of @p lane, for encoding in place.
+     * @return Span within the free buffer budget; may be shorter than needed
+     */
+    MutableByteSpan ReserveTail(TxPriority lane);
+
+    /**
+     * @brief Pin @p lane's tail while the caller encodes @p bytes for it.
+     *
+     * Until CommitTail() or ReleaseTail() the lane admits nothing, is never
+     * evicted and is not rewound, so ReserveTail()'s span stays where it is;
+     * the @p bytes count against the buffer budget for other lanes' Admit().
+     */
+    void HoldTail(TxPriority lane, std::size_t bytes);
+
+    /// Drop the hold without queueing anything
+    void ReleaseTail() {
+        m_heldLane = -1;
+        m_heldBytes = 0;
+    }
+
+    /**
+     * @brief Queue the first @p length bytes written into ReserveTail()'s span, as Append() would.
+     * @return false (nothing queued) if @p lane's tail was not held or has
+     *         moved since HoldTail(), e.g. after Clear()
+     */
+    bool CommitTail(TxPriority lane, std::size_t length, Clock::time_point now,
+                    FramePart part = FramePart::Whole);
+
+    /// true if @p lane may write straight to the socket: nothing queued, bulk not
+    /// rate-limited, and no other lane's frame in progress
+    bool MayWriteDirect(TxPriority lane) const;
+
+    /**
+     * @brief Account for @p bytes of @p part written straight to the socket.
+     * @param units 1 if all of it was written, 0 if the rest follows via Append()
+     */
+    void ChargeDirect(TxPriority lane, std::size_t bytes, std::size_t units, FramePart part = FramePart::Whole);
+
+    /**
+     * @brief Next bytes to write, in wire order.
+     *
+     * The bytes stay pinned (never evicted or reordered) until Consume().
+     *
+     * @param out Receives up to @p maxSpans spans
+     * @return Spans written; 0 if nothing is queued or bulk is out of tokens
+     */
+    std::size_t Gather(ByteSpan* out, std::size_t maxSpans, Clock::time_point now);
+
+    /// Release the first @p bytes of the last Gather() as sent (0 = none); ends the gather
+    void Consume(std::size_t bytes, Clock::time_point now);
+
+    /// true while a Gather() has not been consumed
+    bool HasPendingGather() const { return m_gatherCount > 0; }
+
+    /// Drop everything queued, including a started unit or frame (connection lost)
+    void Clear();
+
+    /// true from a frame's Begin piece until its End piece is sent
+    bool FrameInProgress() const { return m_frameLane >= 0; }
+
+    std::size_t QueuedBytes() const { return m_queuedBytes; }
+    bool Empty() const { return m_queuedBytes == 0; }
+    std::size_t Capacity() const { return m_config.capacity; }
+    /// Largest amount one Append() or CommitTail() may queue
+    std::size_t MaxAppendBytes() const { return m_config.maxAppendBytes; }
+
+    void SetBulkRateLimit(uint64_t bytesPerSecond, std::size_t burstBytes);
+
+    /// Wire size lookup for bulk packet splitting (default: generated GetWireSize())
+    void SetWireSizeFunction(WireSizeFn lookup) { m_wireSizeFn = lookup; }
+
+    /// Also record evictions and per-lane queueing delay into @p metrics (nullptr = off)
+    void SetMetrics(MetricsRegistry* metrics) { m_metrics = metrics; }
+
+    TxLaneMetrics GetLaneMetrics(TxPriority lane) const;
+    void ResetMetrics();
+
+private:
+    struct Unit {
+        std::size_t length;
+        Clock::time_point enqueued;
+        uint8_t frame;               // kUnitFrameBegin / kUnitFrameEnd bits
+    };
+
+    struct Lane {
+        std::unique_ptr<uint8_t[]> data;
+        std::size_t head{0};
+        std::size_t tail{0};
+        std::size_t size{0};
+        std::unique_ptr<Unit[]> units;
+        std::size_t unitHead{0};
+        std::size_t unitCount{0};
+        std::size_t headSent{0};     // Bytes of the head unit already consumed
+        std::size_t gathered{0};     // Bytes from head pinned by the pending gather
+        TxLaneMetrics metrics{};
+    };
+
+    struct GatherSegment {
+        uint8_t lane;
+        std::size_t bytes;
+    };
+
+    Lane& LaneAt(TxPriority lane) { return m_lanes[static_cast<std::size_t>(lane)]; }
+    void RewindIfIdle(Lane& lane);
+    void PushUnits(std::size_t laneIndex, const ByteSpan* spans, std::size_t count, std::size_t total,
+                   std::size_t alreadySent, Clock::time_point now, FramePart part);
+    void PushUnit(Lane& lane, std::size_t length, Clock::time_point now, uint8_t frame = 0);
+    void WriteTail(Lane& lane, const uint8_t* data, std::size_t length);
+    bool EvictNewest(Lane& lane);
+    std::size_t GatherLane(std::size_t laneIndex, std::size_t bytes, ByteSpan* out, std::size_t maxSpans);
+    void ConsumeLane(std::size_t laneIndex, std::size_t bytes, Clock::time_point now);
+    void RecordDelay(std::size_t laneIndex, uint64_t delayNs);
+    std::size_t BulkAllowance(const Lane& lane) const;
+    std::size_t FrameRemainder(const Lane& lane) const;
+    void RefillTokens(Clock::time_point now);
+    std::size_t PacketLength(const uint8_t* data, std::size_t length) const;
+
+    TxSchedulerConfig m_config;
+    std::size_t m_laneCapacity{0};   // Ring bytes per lane
+    std::array<Lane, kTxPriorityCount> m_lanes;
+    std::size_t m_queuedBytes{0};
+    int m_startedLane{-1};           // Lane whose head unit is partly on the wire
+    int m_heldLane{-1};              // Lane whose tail is pinned by HoldTail()
+    std::size_t m_heldTail{0};       // Its tail offset at HoldTail()
+    std::size_t m_heldBytes{0};      // Bytes promised to the hold
+    int m_frameLane{-1};             // Lane of a frame from Begin queued until End sent
+    bool m_frameOpen{false};         // Begin queued, End not yet queued
+    bool m_frameLive{false};         // Part of the frame is on the wire: other lanes wait
+    std::array<GatherSegment, 2 * kTxPriorityCount + 1> m_gather{};
+    std::size_t m_gatherCount{0};
+    int64_t m_bulkTokens{0};
+    Clock::time_point m_lastRefill{};
+    double m_tokenRemainder{0.0};    // Fraction of a token earned but not yet credited
+    WireSizeFn m_wireSizeFn{nullptr};
+    MetricsRegistry* m_metrics{nullptr};
+};
+
+} // namespace bcnp
@@ -15,14 +15,23 @@
  */
 #include "bcnp/transport/udp_posix.h"
 
+#include "bcnp/latency_trace.h"
+
+#include <algorithm>
 #include <arpa/inet.h>
+#include <array>
 #include <cerrno>
 #include <cstring>
 #include <fcntl.h>
 #include <iostream>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#define BCNP_UDP_HAS_MMSG 1
+#endif
+
 namespace bcnp {
 
 namespace {
@@ -62,6 +71,9 @@ void LogErr(const char* message) {
  * required before sending data.
  */
 UdpPosixAdapter::UdpPosixAdapter(uint16_t listenPort, const char* targetIp, uint16_t targetPort) {
+    SetReceiveBatch(kDefaultReceiveBatch);
+    m_txStaging.resize(kMaxDatagramPayload);
+
     m_socket = ::socket(AF_INET, SOCK_DGRAM, 0);
     if (m_socket < 0) {
         LogErr("socket");
@@ -137,7 +149,137 @@ bool UdpPosixAdapter::SendBytes(const uint8_t* data, std::size_t length) {
     }
     const auto sent = ::sendto(m_socket, data, length, 0,
                                reinterpret_cast<sockaddr*>(&m_lastPeer), sizeof(m_lastPeer));
-    return sent == static_cast<ssize_t>(length);
+    if (sent == static_cast<ssize_t>(length)) {
+        Count(Metric::TxBytes, length);
+        return true;
+    }
+    if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        Count(Metric::TxEagain);
+    }
+    Count(Metric::TxDrops);
+    return false;
+}
+
+/**
+ * @brief Sends a burst of datagrams to the current peer.
+ * 
+ * Uses sendmmsg() so a burst of N packets costs one syscall instead of N.
+ * Falls back to a sendto() loop on platforms without sendmmsg().
+ * 
+ * @param datagrams Datagrams to send, in order.
+ * @param count Number of datagrams.
+ * @return Number of datagrams sent; less than @p count if the socket would
+ *         block or an error occurred (the remainder was not sent).
+ */
+std::size_t UdpPosixAdapter::SendBatch(const ByteSpan* datagrams, std::size_t count) {
+    if (!datagrams || count == 0) {
+        return 0;
+    }
+    if (!m_hasPeer || m_socket < 0) {
+        return 0;
+    }
+
+    std::size_t sent = 0;
+#if defined(BCNP_UDP_HAS_MMSG)
+    std::array<mmsghdr, kMaxReceiveBatch> headers;
+    std::array<iovec, kMaxReceiveBatch> iovs;
+    while (sent < count) {
+        const std::size_t batch = std::min(count - sent, headers.size());
+        for (std::size_t i = 0; i < batch; ++i) {
+            iovs[i].iov_base = const_cast<uint8_t*>(datagrams[sent + i].data);
+            iovs[i].iov_len = datagrams[sent + i].length;
+            headers[i] = {};
+            headers[i].msg_hdr.msg_name = &m_lastPeer;
+            headers[i].msg_hdr.msg_namelen = sizeof(m_lastPeer);
+            headers[i].msg_hdr.msg_iov = &iovs[i];
+            headers[i].msg_hdr.msg_iovlen = 1;
+        }
+        const int result = ::sendmmsg(m_socket, headers.data(), static_cast<unsigned int>(batch), MSG_DONTWAIT);
+        if (result < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LogErr("sendmmsg");
+            } else {
+                Count(Metric::TxEagain);
+            }
+            break;
+        }
+        if (m_metrics) {
+            std::size_t bytes = 0;
+            for (int i = 0; i < result; ++i) {
+                bytes += datagrams[sent + static_cast<std::size_t>(i)].length;
+            }
+            m_metrics->Add(Metric::TxBytes, bytes);
+        }
+        sent += static_cast<std::size_t>(result);
+        if (static_cast<std::size_t>(result) < batch) {
+            break;
+        }
+    }
+    Count(Metric::TxDrops, count - sent);
+#else
+    for (; sent < count; ++sent) {
+        if (!SendBytes(datagrams[sent].data, datagrams[sent].length)) {
+            Count(Metric::TxDrops, count - sent - 1);   // SendBytes() counted the failed one
+            break;
+        }
+    }
+#endif
+    return sent;
+}
+
+/**
+ * @brief Reserves the datagram staging buffer for in-place encoding.
+ * 
+ * @param length Bytes required (at most kMaxDatagramPayload).
+ * @return Writable span of exactly @p length bytes, or empty if there is no peer, the datagram would be
+ *         too large, or a reservation is already outstanding.
+ */
+MutableByteSpan UdpPosixAdapter::ReserveTx(std::size_t length) {
+    if (m_txReserved || length == 0 || length > m_txStaging.size()) {
+        return {};
+    }
+    if (!m_hasPeer || m_socket < 0) {
+        return {};
+    }
+    m_txReserved = true;
+    m_txReservedLength = length;
+    return {m_txStaging.data(), length};
+}
+
+/**
+ * @brief Sends the reserved bytes to the current peer as one datagram.
+ * 
+ * @param length Bytes written into the span returned by ReserveTx().
+ * @return true if the datagram was sent, false if there was no reservation,
+ *         @p length exceeds it, or the send failed.
+ */
+bool UdpPosixAdapter::CommitTx(std::size_t length) {
+    if (!m_txReserved) {
+        return false;
+    }
+    m_txReserved = false;
+    if (length > m_txReservedLength) {
+        return false;
+    }
+    return SendBytes(m_txStaging.data(), length);
+}
+
+/**
+ * @brief Configures how many datagrams a single receive call may pull.
+ * 
+ * @param maxDatagrams Datagrams per recvmmsg(); 1 restores one-syscall-per-datagram.
+ * @param maxDatagramSize Per-slot capacity. Datagrams larger than this are
+ *        truncated by the kernel and dropped here (they would fail CRC anyway).
+ * 
+ * Any datagrams already received but not yet returned are discarded.
+ */
+void UdpPosixAdapter::SetReceiveBatch(std::size_t maxDatagrams, std::size_t maxDatagramSize) {
+    m_rxBatchSize = std::clamp<std::size_t>(maxDatagrams, 1, kMaxReceiveBatch);
+    m_rxSlotSize = std::max<std::size_t>(maxDatagramSize, kHandshakeSize);
+    m_rxSlab.assign(m_rxBatchSize * m_rxSlotSize, 0);
+    m_rxLengths.assign(m_rxBatchSize, 0);
+    m_rxNext = 0;
+    m_rxCount = 0;
 }
 
 /**
@@ -196,13 +338,17 @@ void UdpPosixAdapter::UnlockPeer() {
 }
 
 /**
- * @brief Receives a UDP datagram.
+ * @brief Receives a batch of UDP datagrams.
  * 
- * Performs non-blocking receive. Handles peer locking and pairing:
+ * Performs non-blocking receive. Handles peer locking and pairing per datagram:
  * In locked mode, packets from non-paired sources are ignored
  * Pairing packets are processed internally and not returned
  * Automatic peer timeout triggers re-pairing after kPeerTimeout
  * 
+ * Accepted datagrams are copied back to back into @p buffer. Each datagram is a
+ * complete BCNP packet, so the concatenation is a valid stream for StreamParser.
+ * Datagrams that do not fit are kept and returned by the next call.
+ * 
  * @param buffer Destination buffer for received data.
  * @param maxLength Maximum bytes to receive.
  * @return Number of bytes received (0 if no data, filtered, or error).
@@ -212,6 +358,8 @@ std::size_t UdpPosixAdapter::ReceiveChunk(uint8_t* buffer, std::size_t maxLength
         return 0;
     }
 
+    const uint64_t traceStart = trace::Now();
+
     // Auto-unlock peer after timeout to allow re-pairing
     const auto now = std::chrono::steady_clock::now();
     if (m_peerLocked && m_hasPeer && !m_fixedPeerConfigured &&
@@ -220,30 +368,137 @@ std::size_t UdpPosixAdapter::ReceiveChunk(uint8_t* buffer, std::size_t maxLength
         UnlockPeer();
     }
 
-    sockaddr_in src{};
-    socklen_t slen = sizeof(src);
-    const auto received = ::recvfrom(m_socket, buffer, maxLength, MSG_DONTWAIT,
-                                     reinterpret_cast<sockaddr*>(&src), &slen);
-    if (received < 0) {
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+    std::size_t written = 0;
+    for (;;) {
+        while (m_rxNext < m_rxCount) {
+            const std::size_t length = m_rxLengths[m_rxNext];
+            if (length == 0) {
+                ++m_rxNext;
+                continue;
+            }
+            if (length > maxLength - written) {
+                if (written > 0) {
+                    trace::MarkReceive(traceStart);
+                    Count(Metric::RxBytes, written);
+                    return written;
+                }
+                // Caller buffer smaller than one datagram: truncate like recvfrom() would
+                std::memcpy(buffer, &m_rxSlab[m_rxNext * m_rxSlotSize], maxLength);
+                ++m_rxNext;
+                trace::MarkReceive(traceStart);
+                Count(Metric::RxBytes, maxLength);
+                return maxLength;
+            }
+            std::memcpy(buffer + written, &m_rxSlab[m_rxNext * m_rxSlotSize], length);
+            written += length;
+            ++m_rxNext;
+        }
+        if (written > 0) {
+            trace::MarkReceive(traceStart);
+            Count(Metric::RxBytes, written);
+            return written;
+        }
+
+        // Refill; retry only while the kernel handed back a full batch of filtered datagrams
+        const std::size_t received = ReceiveBatch(now);
+        if (received == 0) {
+            return 0;
+        }
+        if (received < m_rxBatchSize &&
+            std::all_of(m_rxLengths.begin(), m_rxLengths.begin() + static_cast<std::ptrdiff_t>(received),
+                        [](std::size_t length) { return length == 0; })) {
             return 0;
         }
-        LogErr("recvfrom");
+    }
+}
+
+/**
+ * @brief Pulls up to m_rxBatchSize datagrams into the receive slab.
+ * 
+ * @param now Receive timestamp applied to accepted datagrams.
+ * @return Number of datagrams read from the socket (accepted or filtered).
+ */
+std::size_t UdpPosixAdapter::ReceiveBatch(std::chrono::steady_clock::time_point now) {
+    m_rxNext = 0;
+    m_rxCount = 0;
+
+    std::array<sockaddr_in, kMaxReceiveBatch> sources{};
+#if defined(BCNP_UDP_HAS_MMSG)
+    std::array<mmsghdr, kMaxReceiveBatch> headers;
+    std::array<iovec, kMaxReceiveBatch> iovs;
+    for (std::size_t i = 0; i < m_rxBatchSize; ++i) {
+        iovs[i].iov_base = &m_rxSlab[i * m_rxSlotSize];
+        iovs[i].iov_len = m_rxSlotSize;
+        headers[i] = {};
+        headers[i].msg_hdr.msg_name = &sources[i];
+        headers[i].msg_hdr.msg_namelen = sizeof(sources[i]);
+        headers[i].msg_hdr.msg_iov = &iovs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    const int result = ::recvmmsg(m_socket, headers.data(), static_cast<unsigned int>(m_rxBatchSize),
+                                  MSG_DONTWAIT, nullptr);
+    if (result < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            LogErr("recvmmsg");
+        }
         return 0;
     }
+    const std::size_t count = static_cast<std::size_t>(result);
+    for (std::size_t i = 0; i < count; ++i) {
+        m_rxLengths[i] = headers[i].msg_len;
+        if (headers[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            m_rxLengths[i] = 0; // Larger than a slot; partial packet would only fail CRC
+        }
+    }
+#else
+    std::size_t count = 0;
+    for (; count < m_rxBatchSize; ++count) {
+        socklen_t slen = sizeof(sources[count]);
+        const auto received = ::recvfrom(m_socket, &m_rxSlab[count * m_rxSlotSize], m_rxSlotSize, MSG_DONTWAIT,
+                                         reinterpret_cast<sockaddr*>(&sources[count]), &slen);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LogErr("recvfrom");
+            }
+            break;
+        }
+        m_rxLengths[count] = static_cast<std::size_t>(received);
+    }
+#endif
 
+    // Peer lock / pairing must see datagrams in arrival order, one at a time
+    for (std::size_t i = 0; i < count; ++i) {
+        if (m_rxLengths[i] > 0 &&
+            !AcceptDatagram(&m_rxSlab[i * m_rxSlotSize], m_rxLengths[i], sources[i], now)) {
+            m_rxLengths[i] = 0;
+        }
+    }
+    m_rxCount = count;
+    return count;
+}
+
+/**
+ * @brief Applies peer locking and pairing to a single received datagram.
+ * 
+ * @param data Datagram payload.
+ * @param length Datagram length.
+ * @param src Source address.
+ * @param now Receive timestamp.
+ * @return true if the datagram should be forwarded to the parser.
+ */
+bool UdpPosixAdapter::AcceptDatagram(const uint8_t* data, std::size_t length, const sockaddr_in& src,
+                                     std::chrono::steady_clock::time_point now) {
     if (m_peerLocked) {
         if (m_requirePairing && !m_pairingComplete && !m_fixedPeerConfigured) {
-            if (ProcessPairingPacket(buffer, static_cast<std::size_t>(received), src)) {
+            if (ProcessPairingPacket(data, length, src)) {
                 m_lastPeerRx = now;
-                return 0; // Handshake packets are not forwarded upwards
             }
-            return 0;
+            return false; // Handshake packets are not forwarded upwards
         }
 
         if (m_hasPeer && (src.sin_addr.s_addr != m_initialPeer.sin_addr.s_addr ||
                           src.sin_port != m_initialPeer.sin_port)) {
-            return 0;
+            return false;
         }
         if (!m_hasPeer) {
             m_initialPeer = src;
@@ -256,8 +511,7 @@ std::size_t UdpPosixAdapter::ReceiveChunk(uint8_t* buffer, std::size_t maxLength
         m_hasPeer = true;
         m_lastPeerRx = now;
     }
-
-    return static_cast<std::size_t>(received);
+    return true;
 }
 
 /**
@@ -1,11 +1,13 @@
 #pragma once
 
+#include "bcnp/metrics.h"
 #include "bcnp/transport/adapter.h"
 #include <bcnp/message_types.h>
 
 #include <chrono>
 #include <cstdint>
 #include <netinet/in.h>
+#include <vector>
 
 namespace bcnp {
 
@@ -15,6 +17,11 @@ namespace bcnp {
  * Connectionless transport with optional peer locking for security.
  * Supports pairing tokens and schema handshake validation.
  * 
+ * Receives are batched: one ReceiveChunk() pulls up to GetReceiveBatchSize()
+ * datagrams with a single recvmmsg() call (recvfrom loop where unavailable),
+ * filters each one against the peer lock, and returns the accepted datagrams
+ * back to back so the dispatcher sees them in a single PushBytes().
+ * 
  * Note: UDP does not guarantee delivery. Use TCP for reliable transport.
  */
 class UdpPosixAdapter : public DuplexAdapter {
@@ -30,6 +37,37 @@ public:
 
     bool SendBytes(const uint8_t* data, std::size_t length) override;
     std::size_t ReceiveChunk(uint8_t* buffer, std::size_t maxLength) override;
+    int ReadableFd() const override { return m_socket; }
+
+    /**
+     * @brief Send several datagrams to the current peer with one sendmmsg() call.
+     * @param datagrams Array of datagrams; each span becomes one datagram
+     * @param count Number of entries in @p datagrams
+     * @return Number of datagrams handed to the kernel (stops early on would-block or error)
+     */
+    std::size_t SendBatch(const ByteSpan* datagrams, std::size_t count);
+
+    /// Reservation is a reusable datagram staging buffer; CommitTx() sends it
+    MutableByteSpan ReserveTx(std::size_t length) override;
+    bool CommitTx(std::size_t length) override;
+
+    /// Each span is sent as its own datagram via SendBatch()
+    bool SendBytesV(const ByteSpan* spans, std::size_t count) override {
+        return SendBatch(spans, count) == count;
+    }
+
+    /**
+     * @brief Configure receive batching.
+     * @param maxDatagrams Datagrams pulled per syscall (clamped to [1, kMaxReceiveBatch])
+     * @param maxDatagramSize Largest datagram accepted; larger ones are dropped as truncated
+     */
+    void SetReceiveBatch(std::size_t maxDatagrams, std::size_t maxDatagramSize = kDefaultMaxDatagramSize);
+    std::size_t GetReceiveBatchSize() const { return m_rxBatchSize; }
+
+    static constexpr std::size_t kMaxReceiveBatch = 64;
+    static constexpr std::size_t kDefaultReceiveBatch = 16;
+    static constexpr std::size_t kDefaultMaxDatagramSize = 8192;
+    static constexpr std::size_t kMaxDatagramPayload = 65507; // IPv4 UDP limit
 
     bool IsValid() const { return m_socket >= 0; }
     
@@ -43,8 +81,19 @@ public:
     bool SendHandshake();  // Send schema hash to peer
     uint32_t GetRemoteSchemaHash() const { return m_remoteSchemaHash; }
 
+    /// Record bytes, send EAGAINs and datagrams not sent into @p metrics (nullptr = off)
+    void SetMetrics(MetricsRegistry* metrics) { m_metrics = metrics; }
+
 private:
     bool ProcessPairingPacket(const uint8_t* buffer, std::size_t length, const sockaddr_in& src);
+    bool AcceptDatagram(const uint8_t* data, std::size_t length, const sockaddr_in& src,
+                        std::chrono::steady_clock::time_point now);
+    std::size_t ReceiveBatch(std::chrono::steady_clock::time_point now);
+    void Count(Metric metric, std::size_t n = 1) {
+        if (m_metrics) {
+            m_metrics->Add(metric, n);
+        }
+    }
 
     int m_socket{-1};
     sockaddr_in m_bind{};
@@ -60,6 +109,19 @@ private:
     sockaddr_in m_initialPeer{};
     std::chrono::steady_clock::time_point m_lastPeerRx{};
     static constexpr std::chrono::milliseconds kPeerTimeout{5000};
+
+    // Receive batch: one slot per datagram; m_rxLengths[i] == 0 marks a filtered slot
+    std::vector<uint8_t> m_rxSlab;
+    std::vector<std::size_t> m_rxLengths;
+    std::size_t m_rxBatchSize{kDefaultReceiveBatch};
+    std::size_t m_rxSlotSize{kDefaultMaxDatagramSize};
+    std::size_t m_rxNext{0};
+    std::size_t m_rxCount{0};
+
+    std::vector<uint8_t> m_txStaging;
+    std::size_t m_txReservedLength{0};
+    bool m_txReserved{false};
+    MetricsRegistry* m_metrics{nullptr};
 };
 
 } // namespace bcnp
\ No newline at end of file
@@ -1,15 +1,33 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#define BCNP_ALLOCATION_GUARD_IMPLEMENT
+#include "bcnp/alloc_guard.h"
+
 #include <bcnp/message_types.h>
+#include "bcnp/capture.h"
 #include "bcnp/message_queue.h"
+#include "bcnp/mpsc_telemetry_accumulator.h"
+#include "bcnp/multi_stream_dispatcher.h"
 #include "bcnp/dispatcher.h"
+#include "bcnp/fixed_dispatcher.h"
+#include "bcnp/frame_arena.h"
+#include "bcnp/inplace_function.h"
+#include "bcnp/latency_trace.h"
+#include "bcnp/metrics.h"
 #include "bcnp/packet.h"
 #include "bcnp/packet_storage.h"
+#include "bcnp/realtime.h"
+#include "bcnp/spsc_message_queue.h"
+#include "bcnp/static_dispatcher.h"
 #include "bcnp/static_vector.h"
 #include "bcnp/stream_parser.h"
 #include "bcnp/telemetry_accumulator.h"
+#include "bcnp/telemetry_batcher.h"
+#include "bcnp/transport/controller_driver.h"
 #include "bcnp/transport/tcp_posix.h"
+#include "bcnp/transport/tcp_reactor.h"
+#include "bcnp/transport/tx_scheduler.h"
 #include "bcnp/transport/udp_posix.h"
 
 #include <algorithm>
@@ -17,7 +35,11 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <future>
+#include <limits>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -39,6 +61,23 @@ std::size_t TestWireSizeLookup(bcnp::MessageTypeId typeId) {
     }
     return 0;
 }
+
+// Counts instead of aborting so tests can observe violations
+void IgnoreAllocationViolation(std::size_t) {}
+
+// Drive both adapters until the V3 handshake completes on each side
+bool ConnectTcpPair(bcnp::TcpPosixAdapter& server, bcnp::TcpPosixAdapter& client) {
+    std::vector<uint8_t> rx(1024);
+    for (int i = 0; i < 200; ++i) {
+        server.ReceiveChunk(rx.data(), rx.size());
+        client.ReceiveChunk(rx.data(), rx.size());
+        if (server.IsHandshakeComplete() && client.IsHandshakeComplete()) {
+            return true;
+        }
+        std::this_thread::sleep_for(5ms);
+    }
+    return false;
+}
 }
 
 // ============================================================================
@@ -99,6 +138,38 @@ TEST_CASE("Packet: Reject unsupported version") {
     CHECK(result.error == bcnp::PacketError::UnsupportedVersion);
 }
 
+TEST_CASE("Packet: CRC32 matches reference across lengths and alignments") {
+    // Bitwise reference of the reflected 0xEDB88320 polynomial
+    const auto reference = [](const uint8_t* data, std::size_t length) {
+        uint32_t crc = 0xFFFFFFFFU;
+        for (std::size_t i = 0; i < length; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1U) ? (crc >> 1U) ^ 0xEDB88320U : crc >> 1U;
+            }
+        }
+        return crc ^ 0xFFFFFFFFU;
+    };
+
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    CHECK(bcnp::ComputeCrc32(check, sizeof(check)) == 0xCBF43926U);
+    CHECK(bcnp::ComputeCrc32(nullptr, 0) == 0U);
+
+    std::vector<uint8_t> data(4096 + 16);
+    uint32_t seed = 0x12345678U;
+    for (auto& b : data) {
+        seed = seed * 1664525U + 1013904223U;
+        b = static_cast<uint8_t>(seed >> 24);
+    }
+
+    for (std::size_t align = 0; align < 8; ++align) {
+        for (std::size_t length : {1u, 7u, 8u, 15u, 16u, 63u, 64u, 65u, 127u, 128u, 200u, 1000u, 4096u}) {
+            INFO("impl=" << bcnp::Crc32Implementation() << " align=" << align << " length=" << length);
+            CHECK(bcnp::ComputeCrc32(data.data() + align, length) == reference(data.data() + align, length));
+        }
+    }
+}
+
 // ============================================================================
 // Test Suite: MessageQueue (Logic Tests - No Sleep)
 // ============================================================================
@@ -232,6 +303,233 @@ TEST_CASE("MessageQueue: Sub-tick granularity handles short messages") {
     CHECK(queue.Size() == 0);
 }
 
+// ============================================================================
+// Test Suite: SpscMessageQueue
+// ============================================================================
+
+TEST_CASE("MessageQueue: Stall drops the whole stale run across the ring wrap") {
+    bcnp::MessageQueueConfig config{};
+    config.capacity = 8;
+    config.maxCommandLag = 100ms;
+    bcnp::MessageQueue<bcnp::TestCmd> queue(config);
+
+    auto now = bcnp::MessageQueue<bcnp::TestCmd>::Clock::time_point{} + 1000ms;
+    queue.NotifyReceived(now);
+    for (int i = 0; i < 6; ++i) {
+        queue.Push({static_cast<float>(i), 0.0f, 100});
+    }
+    queue.Update(now);
+    CHECK(queue.ActiveMessage().unwrap().value1 == 0.0f);
+    // Refill past the end of the ring
+    for (int i = 6; i < 9; ++i) {
+        CHECK(queue.Push({static_cast<float>(i), 0.0f, 100}));
+    }
+    CHECK(!queue.Push({99.0f, 0.0f, 100}));
+    CHECK(queue.GetMetrics().queueOverflows == 1);
+
+    // 1..5 end at or before the lag floor (t=1600); 6 runs from the floor and ends now
+    now += 700ms;
+    queue.NotifyReceived(now);
+    queue.Update(now);
+    REQUIRE(queue.ActiveMessage().is_some());
+    CHECK(queue.ActiveMessage().unwrap().value1 == 7.0f);
+    CHECK(queue.GetMetrics().messagesSkipped == 5);
+    CHECK(queue.Size() == 1);
+
+    // Zero-length messages behind a long one are kept until they are stale too
+    queue.Push({20.0f, 0.0f, 0});
+    queue.Push({21.0f, 0.0f, 0});
+    queue.Push({22.0f, 0.0f, 300});
+    now += 100ms;
+    queue.Update(now);
+    CHECK(queue.ActiveMessage().unwrap().value1 == 8.0f);
+    now += 300ms;
+    queue.NotifyReceived(now);
+    queue.Update(now);
+    CHECK(queue.ActiveMessage().unwrap().value1 == 22.0f);
+    CHECK(queue.GetMetrics().messagesSkipped == 7);
+}
+
+TEST_CASE("MessageQueue: Overflow policies") {
+    using Clock = bcnp::MessageQueue<bcnp::TestCmd>::Clock;
+    bcnp::MessageQueueConfig config{};
+    config.capacity = 3;
+    const auto start = Clock::time_point{} + 1000ms;
+
+    SUBCASE("DropOldest evicts the front") {
+        config.overflowPolicy = bcnp::QueueOverflowPolicy::DropOldest;
+        bcnp::MessageQueue<bcnp::TestCmd> queue(config);
+        queue.NotifyReceived(start);
+        for (int i = 0; i < 3; ++i) {
+            CHECK(queue.Push({static_cast<float>(i), 0.0f, 100}));
+        }
+        {
+            auto tx = queue.BeginTransaction();
+            CHECK(tx.Push({3.0f, 0.0f, 100}));
+            CHECK(tx.Push({4.0f, 0.0f, 100}));
+        }
+        CHECK(queue.Size() == 3);
+        queue.Update(start);
+        CHECK(queue.ActiveMessage().unwrap().value1 == 2.0f);
+        // Evicted messages never ran, so they take no time
+        queue.Update(start + 200ms);
+        CHECK(queue.ActiveMessage().unwrap().value1 == 4.0f);
+        const auto metrics = queue.GetMetrics();
+        CHECK(metrics.queueOverflows == 2);
+        CHECK(metrics.messagesEvicted == 2);
+        CHECK(metrics.messagesReceived == 5);
+    }
+
+    SUBCASE("CoalesceLatest replaces the newest") {
+        config.overflowPolicy = bcnp::QueueOverflowPolicy::CoalesceLatest;
+        bcnp::MessageQueue<bcnp::TestCmd> queue(config);
+        queue.NotifyReceived(start);
+        for (int i = 0; i < 3; ++i) {
+            CHECK(queue.Push({static_cast<float>(i), 0.0f, 100}));
+        }
+        CHECK(queue.Push({3.0f, 0.0f, 50}));
+        CHECK(queue.Push({4.0f, 0.0f, 50}));
+        CHECK(queue.Size() == 3);
+        queue.Update(start);
+        CHECK(queue.ActiveMessage().unwrap().value1 == 0.0f);
+        queue.NotifyReceived(start + 200ms);
+        queue.Update(start + 200ms);
+        CHECK(queue.ActiveMessage().unwrap().value1 == 4.0f);
+        queue.Update(start + 249ms);
+        CHECK(queue.ActiveMessage().is_some());
+        queue.Update(start + 250ms);
+        CHECK(!queue.ActiveMessage().is_some());
+        CHECK(queue.GetMetrics().messagesEvicted == 2);
+    }
+}
+
+TEST_CASE("SpscMessageQueue: Matches MessageQueue timing") {
+    bcnp::SpscMessageQueue<bcnp::TestCmd> queue;
+    auto now = bcnp::SpscMessageQueue<bcnp::TestCmd>::Clock::time_point{} + 1000ms;
+
+    queue.Push({1.0f, 0.0f, 100});
+    queue.Push({2.0f, 0.5f, 50});
+    queue.NotifyReceived(now);
+    queue.Update(now);
+    REQUIRE(queue.ActiveMessage().is_some());
+    CHECK(queue.ActiveMessage().unwrap().value1 == 1.0f);
+    CHECK(queue.Size() == 1);
+
+    now += 100ms;
+    queue.Update(now);
+    REQUIRE(queue.ActiveMessage().is_some());
+    CHECK(queue.ActiveMessage().unwrap().value1 == 2.0f);
+
+    now += 50ms;
+    queue.Update(now);
+    CHECK(!queue.ActiveMessage().is_some());
+    CHECK(queue.Size() == 0);
+}
+
+TEST_CASE("SpscMessageQueue: Lag skip and disconnect") {
+    bcnp::MessageQueueConfig config;
+    config.maxCommandLag = 100ms;
+    bcnp::SpscMessageQueue<bcnp::TestCmd> queue(config);
+    auto now = bcnp::SpscMessageQueue<bcnp::TestCmd>::Clock::time_point{} + 1000ms;
+    queue.NotifyReceived(now);
+
+    for (int i = 0; i < 10; ++i) {
+        queue.Push({static_cast<float>(i), 0.0f, 100});
+    }
+    queue.Update(now);
+    CHECK(queue.ActiveMessage().unwrap().value1 == 0.0f);
+
+    // 500ms stall: messages ending before the lag floor are skipped
+    now += 500ms;
+    queue.NotifyReceived(now);
+    queue.Update(now);
+    REQUIRE(queue.ActiveMessage().is_some());
+    CHECK(queue.ActiveMessage().unwrap().value1 == 5.0f);
+    CHECK(queue.GetMetrics().messagesSkipped == 3);
+
+    // No NotifyReceived for longer than connectionTimeout
+    now += 300ms;
+    queue.Update(now);
+    CHECK(!queue.ActiveMessage().is_some());
+    CHECK(queue.Size() == 0);
+}
+
+TEST_CASE("SpscMessageQueue: Transaction publishes clear and batch together") {
+    bcnp::MessageQueueConfig config;
+    config.capacity = 4;
+    bcnp::SpscMessageQueue<bcnp::TestCmd> queue(config);
+    auto now = bcnp::SpscMessageQueue<bcnp::TestCmd>::Clock::time_point{} + 1000ms;
+    queue.NotifyReceived(now);
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.Push({static_cast<float>(i), 0.0f, 100}));
+    }
+    CHECK(!queue.Push({9.0f, 0.0f, 100}));
+    CHECK(queue.GetMetrics().queueOverflows == 1);
+    queue.Update(now);
+    CHECK(queue.ActiveMessage().unwrap().value1 == 0.0f);
+
+    {
+        auto tx = queue.BeginTransaction();
+        tx.Clear();
+        // Full batch fits even though the consumer has not reclaimed the cleared slots
+        for (int i = 0; i < 4; ++i) {
+            CHECK(tx.Push({10.0f + i, 0.0f, 100}));
+        }
+        // Not visible until the transaction ends
+        queue.Update(now);
+        CHECK(queue.ActiveMessage().unwrap().value1 == 0.0f);
+    }
+
+    queue.Update(now);
+    REQUIRE(queue.ActiveMessage().is_some());
+    CHECK(queue.ActiveMessage().unwrap().value1 == 10.0f);
+    CHECK(queue.Size() == 3);
+}
+
+TEST_CASE("SpscMessageQueue: Concurrent producer and consumer") {
+    bcnp::MessageQueueConfig config;
+    config.capacity = 64;
+    config.connectionTimeout = std::chrono::hours(1);
+    bcnp::SpscMessageQueue<bcnp::TestCmd> queue(config);
+    using Clock = bcnp::SpscMessageQueue<bcnp::TestCmd>::Clock;
+
+    constexpr int kMessages = 20000;
+    std::atomic<bool> done{false};
+    auto now = Clock::now();
+    queue.NotifyReceived(now);
+
+    std::thread producer([&] {
+        for (int i = 0; i < kMessages;) {
+            if (queue.Push({static_cast<float>(i), static_cast<float>(-i), 1})) {
+                ++i;
+            }
+        }
+        done = true;
+    });
+
+    // Active values must only ever move forward; catch-up may retire several per Update
+    float last = -1.0f;
+    int seen = 0;
+    while (!done || queue.Size() > 0) {
+        now += 1ms;
+        queue.Update(now);
+        auto active = queue.ActiveMessage();
+        if (active.is_some() && active.unwrap().value1 != last) {
+            CHECK(active.unwrap().value1 > last);
+            CHECK(active.unwrap().value2 == -active.unwrap().value1);
+            last = active.unwrap().value1;
+            ++seen;
+        }
+    }
+    producer.join();
+
+    const auto metrics = queue.GetMetrics();
+    CHECK(seen > 0);
+    CHECK(metrics.messagesReceived == kMessages);
+    CHECK(metrics.messagesSkipped == 0);
+}
+
 // ============================================================================
 // Test Suite: StreamParser
 // ============================================================================
@@ -360,6 +658,53 @@ TEST_CASE("StreamParser: DoS protection - survives garbage flood") {
     CHECK(packetSeen);
 }
 
+TEST_CASE("StreamParser: Noisy burst resyncs in a few skips and reports them") {
+    std::vector<float> seen;
+    std::vector<bcnp::StreamParser::ErrorInfo> errors;
+    bcnp::StreamParser parser(
+        [&](const bcnp::PacketView& parsed) {
+            for (auto it = parsed.begin_as<bcnp::TestCmd>(); it != parsed.end_as<bcnp::TestCmd>(); ++it) {
+                seen.push_back((*it).value1);
+            }
+        },
+        [&](const bcnp::StreamParser::ErrorInfo& info) { errors.push_back(info); },
+        16 * 1024);
+    parser.SetWireSizeLookup(TestWireSizeLookup);
+
+    // Burst longer than the per-Push iteration budget, sprinkled with fake magic:
+    // valid major+minor pairs with an unknown type, and bare major bytes
+    std::vector<uint8_t> stream(3000, 0xA5);
+    for (std::size_t i = 100; i + bcnp::kHeaderSizeV3 < stream.size(); i += 97) {
+        stream[i] = bcnp::kProtocolMajorV3;
+        stream[i + 1] = (i % 2 == 0) ? bcnp::kProtocolMinorV3 : uint8_t{0xEE};
+        stream[i + 3] = 0x7F;  // Unknown type ID
+    }
+    const std::size_t garbage = stream.size();
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({1.0f, 0.0f, 10});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    std::vector<uint8_t> corrupt = encoded;
+    corrupt[bcnp::kHeaderSizeV3] ^= 0xFF;  // CRC mismatch
+    stream.insert(stream.end(), corrupt.begin(), corrupt.end());
+    for (int i = 0; i < 5; ++i) {
+        stream.insert(stream.end(), encoded.begin(), encoded.end());
+    }
+
+    parser.Push(stream.data(), stream.size());
+
+    // Every valid packet is delivered by the same Push() despite the burst
+    CHECK(seen.size() == 5);
+    REQUIRE(errors.size() == 2);
+    CHECK(errors[0].code == bcnp::PacketError::UnsupportedVersion);
+    CHECK(errors[0].bytesSkipped == garbage);
+    CHECK(errors[1].code == bcnp::PacketError::ChecksumMismatch);
+    CHECK(errors[1].bytesSkipped == corrupt.size());
+    CHECK(parser.ResyncCount() == 2);
+    CHECK(parser.BytesSkipped() == garbage + corrupt.size());
+}
+
 TEST_CASE("StreamParser: Error info provides diagnostics") {
     std::vector<bcnp::StreamParser::ErrorInfo> errors;
     bcnp::StreamParser parser(
@@ -391,6 +736,88 @@ TEST_CASE("StreamParser: Error info provides diagnostics") {
     CHECK(errors.back().consecutiveErrors == 1);
 }
 
+TEST_CASE("StreamParser: Zero-copy emits views into the Push buffer") {
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({0.3f, -0.3f, 120});
+    packet.messages.push_back({0.4f, -0.4f, 130});
+
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    stream.insert(stream.end(), encoded.begin(), encoded.end());
+    stream.insert(stream.end(), encoded.begin(), encoded.end());
+
+    std::vector<const uint8_t*> payloads;
+    bcnp::StreamParser parser(
+        [&](const bcnp::PacketView& view) {
+            payloads.push_back(view.payload.data());
+            auto decoded = bcnp::DecodeTypedPacket<bcnp::TestCmd>(view);
+            REQUIRE(decoded.is_some());
+            CHECK(decoded.unwrap().messages[1].value1 == 0.4f);
+        },
+        [](const bcnp::StreamParser::ErrorInfo&) { FAIL("Unexpected parse error"); });
+    parser.SetWireSizeLookup(TestWireSizeLookup);
+
+    parser.Push(stream.data(), stream.size());
+
+    REQUIRE(payloads.size() == 2);
+    CHECK(payloads[0] == stream.data() + bcnp::kHeaderSize);
+    CHECK(payloads[1] == stream.data() + encoded.size() + bcnp::kHeaderSize);
+    CHECK(parser.ScratchCopyCount() == 0);
+}
+
+TEST_CASE("StreamParser: Only frames wrapping the ring are copied") {
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({0.1f, 0.2f, 250});
+
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+
+    // Ring holds just over two frames so fragmented delivery eventually wraps
+    std::size_t seen = 0;
+    bcnp::StreamParser parser(
+        [&](const bcnp::PacketView& view) {
+            auto decoded = bcnp::DecodeTypedPacket<bcnp::TestCmd>(view);
+            REQUIRE(decoded.is_some());
+            CHECK(decoded.unwrap().messages[0].durationMs == 250);
+            ++seen;
+        },
+        [](const bcnp::StreamParser::ErrorInfo&) { FAIL("Unexpected parse error"); },
+        encoded.size() * 2 + 3);
+    parser.SetWireSizeLookup(TestWireSizeLookup);
+
+    constexpr std::size_t kFrames = 10;
+    for (std::size_t i = 0; i < kFrames; ++i) {
+        parser.Push(encoded.data(), 5);
+        parser.Push(encoded.data() + 5, encoded.size() - 5);
+    }
+
+    CHECK(seen == kFrames);
+    CHECK(parser.ScratchCopyCount() > 0);
+    CHECK(parser.ScratchCopyCount() < kFrames);
+}
+
+TEST_CASE("StreamParser: Copy mode decodes from scratch") {
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({0.6f, 0.7f, 90});
+
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+
+    const uint8_t* payload = nullptr;
+    bcnp::StreamParser parser(
+        [&](const bcnp::PacketView& view) { payload = view.payload.data(); },
+        [](const bcnp::StreamParser::ErrorInfo&) { FAIL("Unexpected parse error"); });
+    parser.SetWireSizeLookup(TestWireSizeLookup);
+    parser.SetZeroCopy(false);
+
+    parser.Push(encoded.data(), encoded.size());
+
+    REQUIRE(payload != nullptr);
+    CHECK(payload != encoded.data() + bcnp::kHeaderSize);
+    CHECK(parser.ScratchCopyCount() == 1);
+}
+
 // ============================================================================
 // Test Suite: PacketDispatcher
 // ============================================================================
@@ -425,6 +852,268 @@ TEST_CASE("PacketDispatcher: Routes packets to handlers") {
     CHECK(msg.unwrap().durationMs == 6000);
 }
 
+TEST_CASE("PacketDispatcher: Generated wire size table matches registry") {
+    for (const auto& info : bcnp::kMessageRegistry) {
+        CHECK(bcnp::GetWireSize(info.typeId) == info.wireSize);
+        auto lookup = bcnp::GetMessageInfo(info.typeId);
+        REQUIRE(lookup.has_value());
+        CHECK(lookup->name == info.name);
+    }
+    static_assert(bcnp::GetWireSize(bcnp::TestCmd::kTypeId) == bcnp::TestCmd::kWireSize);
+    CHECK(bcnp::GetWireSize(bcnp::MessageTypeId::Unknown) == 0);
+    CHECK(bcnp::GetWireSize(static_cast<bcnp::MessageTypeId>(2)) == 0);
+    CHECK(bcnp::GetWireSize(static_cast<bcnp::MessageTypeId>(60000)) == 0);
+    CHECK(!bcnp::GetMessageInfo(uint16_t{60000}).has_value());
+}
+
+TEST_CASE("PacketDispatcher: Large type IDs use the sparse handler path") {
+    bcnp::PacketDispatcher dispatcher;
+    // Route a schema type under an out-of-table ID through a custom wire size lookup
+    dispatcher.SetWireSizeLookup([](bcnp::MessageTypeId id) -> std::size_t {
+        return static_cast<uint16_t>(id) == 5000 ? bcnp::TestCmd::kWireSize : 0;
+    });
+    int calls = 0;
+    dispatcher.RegisterHandler(static_cast<bcnp::MessageTypeId>(5000), [&](const bcnp::PacketView&) { ++calls; });
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({1.0f, 2.0f, 10});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    bcnp::detail::StoreU16(5000, &encoded[bcnp::kHeaderMsgTypeIndex]);
+    const uint32_t crc = bcnp::ComputeCrc32(encoded.data(), encoded.size() - bcnp::kChecksumSize);
+    bcnp::detail::StoreU32(crc, &encoded[encoded.size() - bcnp::kChecksumSize]);
+
+    dispatcher.PushBytes(encoded.data(), encoded.size());
+    CHECK(calls == 1);
+    dispatcher.UnregisterHandler(static_cast<bcnp::MessageTypeId>(5000));
+    dispatcher.PushBytes(encoded.data(), encoded.size());
+    CHECK(calls == 1);
+}
+
+TEST_CASE("PacketDispatcher: Owned handlers keep frames after the callback") {
+    bcnp::DispatcherConfig config;
+    config.frameArenaBlocks = 2;
+    bcnp::PacketDispatcher dispatcher(config);
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    CHECK(dispatcher.Arena() == nullptr);
+
+    std::vector<bcnp::OwnedPacketView> deferred;
+    dispatcher.RegisterOwnedHandler<bcnp::TestCmd>([&](bcnp::OwnedPacketView frame) {
+        deferred.push_back(std::move(frame));
+    });
+    const bcnp::FrameArena* arena = dispatcher.Arena();
+    REQUIRE(arena != nullptr);
+    CHECK(arena->FreeBlockCount() == 2);
+
+    std::vector<uint8_t> stream;
+    for (int i = 0; i < 3; ++i) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({static_cast<float>(i), 0.0f, 10});
+        std::vector<uint8_t> encoded;
+        REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+        stream.insert(stream.end(), encoded.begin(), encoded.end());
+    }
+    dispatcher.PushBytes(stream.data(), stream.size());
+    std::fill(stream.begin(), stream.end(), uint8_t{0});  // Source bytes are gone
+
+    // Third frame exceeded the pool and fell back to the heap
+    REQUIRE(deferred.size() == 3);
+    CHECK(arena->FreeBlockCount() == 0);
+    CHECK(arena->GetMetrics().heapFallbacks == 1);
+
+    // Decode on another thread, long after the callbacks returned
+    std::vector<float> values;
+    std::thread planner([&, frames = std::move(deferred)]() mutable {
+        for (auto& frame : frames) {
+            for (auto it = frame->begin_as<bcnp::TestCmd>(); it != frame->end_as<bcnp::TestCmd>(); ++it) {
+                values.push_back((*it).value1);
+            }
+        }
+        frames.clear();
+    });
+    planner.join();
+    CHECK(values == std::vector<float>{0.0f, 1.0f, 2.0f});
+    CHECK(arena->FreeBlockCount() == 2);
+    CHECK(arena->GetMetrics().blocksInUse == 0);
+}
+
+TEST_CASE("FrameArena: Shared views recycle once and may outlive the arena") {
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({4.0f, 5.0f, 6});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    auto decoded = bcnp::DecodePacketViewAs<bcnp::TestCmd>(encoded.data(), encoded.size());
+    REQUIRE(decoded.view.is_some());
+
+    bcnp::OwnedPacketView survivor;
+    {
+        bcnp::FrameArena arena({64, 1});
+        auto first = arena.Retain(decoded.view.unwrap());
+        auto copy = first;
+        CHECK(copy.UseCount() == 2);
+        CHECK(arena.FreeBlockCount() == 0);
+        first.Reset();
+        CHECK(!first);
+        CHECK(arena.FreeBlockCount() == 0);
+        copy.Reset();
+        CHECK(arena.FreeBlockCount() == 1);
+
+        survivor = arena.Retain(decoded.view.unwrap());
+        CHECK(arena.GetMetrics().heapFallbacks == 0);
+    }
+    REQUIRE(survivor);
+    auto typed = bcnp::DecodeTypedPacket<bcnp::TestCmd>(survivor.View());
+    REQUIRE(typed.is_some());
+    CHECK(typed.unwrap().messages[0].value2 == 5.0f);
+    survivor.Reset();
+}
+
+TEST_CASE("StaticDispatcher: Routes typed and view handlers without registration") {
+    std::vector<float> commands;
+    int encoderPackets = 0;
+    bcnp::StaticDispatcher dispatcher(
+        bcnp::On<bcnp::TestCmd>([&](const bcnp::TestCmd& cmd) { commands.push_back(cmd.value1); }),
+        bcnp::On<bcnp::EncoderData>([&](const bcnp::PacketView& pkt) {
+            ++encoderPackets;
+            CHECK(pkt.header.messageCount == 2);
+        }));
+
+    std::vector<uint8_t> stream;
+    auto append = [&](const auto& packet) {
+        std::vector<uint8_t> encoded;
+        REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+        stream.insert(stream.end(), encoded.begin(), encoded.end());
+    };
+
+    bcnp::TypedPacket<bcnp::TestCmd> cmds;
+    cmds.messages.push_back({1.5f, 0.0f, 10});
+    cmds.messages.push_back({2.5f, 0.0f, 10});
+    append(cmds);
+    bcnp::TypedPacket<bcnp::EncoderData> encoders;
+    encoders.messages.push_back({1, 10, 0});
+    encoders.messages.push_back({2, 20, 0});
+    append(encoders);
+    bcnp::TypedPacket<bcnp::ProximityAlert> unhandled;  // Known to the schema, no handler
+    unhandled.messages.push_back({1, 100, 0});
+    append(unhandled);
+    append(cmds);
+
+    dispatcher.PushBytes(stream.data(), stream.size());
+
+    CHECK(commands == std::vector<float>{1.5f, 2.5f, 1.5f, 2.5f});
+    CHECK(encoderPackets == 1);
+    CHECK(dispatcher.ParseErrorCount() == 0);
+    CHECK(dispatcher.IsConnected(std::chrono::steady_clock::now()));
+}
+
+// ============================================================================
+// Test Suite: UDP Adapter (Integration Tests)
+// ============================================================================
+
+TEST_CASE("UDP: Batched send and receive deliver every datagram in one chunk") {
+    bcnp::UdpPosixAdapter a(12410, "127.0.0.1", 12411);
+    bcnp::UdpPosixAdapter b(12411, "127.0.0.1", 12410);
+    REQUIRE(a.IsValid());
+    REQUIRE(b.IsValid());
+
+    constexpr std::size_t kDatagrams = 12;
+    std::vector<std::vector<uint8_t>> packets;
+    std::vector<bcnp::ByteSpan> spans;
+    for (std::size_t i = 0; i < kDatagrams; ++i) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({static_cast<float>(i), 0.0f, 10});
+        packets.emplace_back();
+        REQUIRE(bcnp::EncodeTypedPacket(packet, packets.back()));
+    }
+    for (const auto& p : packets) {
+        spans.push_back({p.data(), p.size()});
+    }
+    CHECK(a.SendBatch(spans.data(), spans.size()) == kDatagrams);
+
+    std::vector<float> seen;
+    bcnp::StreamParser parser(
+        [&](const bcnp::PacketView& view) {
+            for (auto it = view.begin_as<bcnp::TestCmd>(); it != view.end_as<bcnp::TestCmd>(); ++it) {
+                seen.push_back((*it).value1);
+            }
+        });
+    parser.SetWireSizeLookup(TestWireSizeLookup);
+
+    std::vector<uint8_t> rx(8192);
+    std::size_t chunks = 0;
+    for (int i = 0; i < 50 && seen.size() < kDatagrams; ++i) {
+        const std::size_t bytes = b.ReceiveChunk(rx.data(), rx.size());
+        if (bytes > 0) {
+            ++chunks;
+            parser.Push(rx.data(), bytes);
+        } else {
+            std::this_thread::sleep_for(5ms);
+        }
+    }
+
+    REQUIRE(seen.size() == kDatagrams);
+    for (std::size_t i = 0; i < kDatagrams; ++i) {
+        CHECK(seen[i] == static_cast<float>(i));
+    }
+    CHECK(chunks < kDatagrams);
+}
+
+TEST_CASE("UDP: Datagrams that do not fit the caller buffer carry over") {
+    bcnp::UdpPosixAdapter a(12412, "127.0.0.1", 12413);
+    bcnp::UdpPosixAdapter b(12413, "127.0.0.1", 12412);
+    REQUIRE(a.IsValid());
+    REQUIRE(b.IsValid());
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({1.0f, 2.0f, 10});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    std::array<bcnp::ByteSpan, 3> spans{{{encoded.data(), encoded.size()},
+                                         {encoded.data(), encoded.size()},
+                                         {encoded.data(), encoded.size()}}};
+    REQUIRE(a.SendBatch(spans.data(), spans.size()) == spans.size());
+    std::this_thread::sleep_for(20ms);
+
+    // Room for exactly two datagrams per call
+    std::vector<uint8_t> rx(encoded.size() * 2 + 1);
+    std::size_t total = 0;
+    for (int i = 0; i < 20 && total < encoded.size() * 3; ++i) {
+        const std::size_t bytes = b.ReceiveChunk(rx.data(), rx.size());
+        CHECK(bytes <= encoded.size() * 2);
+        CHECK(bytes % encoded.size() == 0);
+        total += bytes;
+        if (bytes == 0) {
+            std::this_thread::sleep_for(5ms);
+        }
+    }
+    CHECK(total == encoded.size() * 3);
+}
+
+TEST_CASE("UDP: A reservation is exactly the requested length") {
+    bcnp::UdpPosixAdapter a(12416, "127.0.0.1", 12417);
+    bcnp::UdpPosixAdapter b(12417, "127.0.0.1", 12416);
+    REQUIRE(a.IsValid());
+    REQUIRE(b.IsValid());
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({1.0f, 2.0f, 10});
+    const bcnp::MutableByteSpan reserved = a.ReserveTx(bcnp::EncodedPacketSize(packet));
+    REQUIRE(reserved.data != nullptr);
+    CHECK(reserved.length == bcnp::EncodedPacketSize(packet));
+    CHECK_FALSE(a.CommitTx(reserved.length + 1));   // More than was reserved
+
+    REQUIRE(bcnp::EncodeTypedPacket(packet, static_cast<bcnp::ByteWriter&>(a)));
+    std::vector<uint8_t> rx(1024);
+    std::size_t bytes = 0;
+    for (int i = 0; i < 20 && bytes == 0; ++i) {
+        bytes = b.ReceiveChunk(rx.data(), rx.size());
+        if (bytes == 0) {
+            std::this_thread::sleep_for(5ms);
+        }
+    }
+    CHECK(bytes == bcnp::EncodedPacketSize(packet));
+}
+
 // ============================================================================
 // Test Suite: TCP Adapter (Integration Tests)
 // ============================================================================
@@ -559,14 +1248,188 @@ TEST_CASE("TCP: Client reconnects after connection loss") {
     CHECK(reconnected);
 }
 
-// ============================================================================
-// Test Suite: StaticVector (Rule of Five & API)
-// ============================================================================
+TEST_CASE("TCP: Vectored send preserves order across direct writes and ring spill") {
+    bcnp::TcpPosixAdapter server(12347);
+    REQUIRE(server.IsValid());
+    server.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", 12347);
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    REQUIRE(ConnectTcpPair(server, client));
 
-TEST_CASE("StaticVector: reserve() no-op for API compatibility") {
-    bcnp::StaticVector<int, 64> vec;
-    vec.reserve(32);  // Should be no-op (less than capacity)
-    CHECK(vec.capacity() == 64);
+    // Far more than the socket buffers hold, so later bursts hit would-block and spill
+    constexpr std::size_t kSpanSize = 12000;
+    constexpr std::size_t kSpansPerBurst = 4;
+    constexpr std::size_t kTotal = 8u * 1024u * 1024u;
+    std::vector<uint8_t> source(kTotal);
+    for (std::size_t i = 0; i < kTotal; ++i) {
+        source[i] = static_cast<uint8_t>((i * 7u) % 251u);
+    }
+
+    std::vector<uint8_t> received;
+    received.reserve(kTotal);
+    std::vector<uint8_t> rx(65536);
+    std::vector<uint8_t> clientRx(64);
+    auto drain = [&] {
+        const std::size_t bytes = server.ReceiveChunk(rx.data(), rx.size());
+        received.insert(received.end(), rx.begin(), rx.begin() + static_cast<std::ptrdiff_t>(bytes));
+        return bytes;
+    };
+
+    std::size_t offset = 0;
+    for (int guard = 0; offset < kTotal && guard < 100000; ++guard) {
+        std::array<bcnp::ByteSpan, kSpansPerBurst> spans{};
+        std::size_t burst = 0;
+        for (auto& span : spans) {
+            const std::size_t length = std::min(kSpanSize, kTotal - offset - burst);
+            span = {source.data() + offset + burst, length};
+            burst += length;
+        }
+        if (client.SendBytesV(spans.data(), spans.size())) {
+            offset += burst;
+        } else {
+            drain();
+        }
+    }
+    REQUIRE(offset == kTotal);
+
+    for (int guard = 0; received.size() < kTotal && guard < 2000; ++guard) {
+        client.ReceiveChunk(clientRx.data(), clientRx.size());  // Flushes queued TX data
+        if (drain() == 0) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    REQUIRE(received.size() == kTotal);
+    CHECK(received == source);
+}
+
+TEST_CASE("TCP: Packets encoded in place via ReserveTx arrive intact") {
+    bcnp::TcpPosixAdapter server(12348);
+    REQUIRE(server.IsValid());
+    server.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", 12348);
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    REQUIRE(ConnectTcpPair(server, client));
+
+    const bcnp::MutableByteSpan reserved = client.ReserveTx(16);
+    CHECK(reserved.data != nullptr);
+    CHECK(reserved.length == 16);                  // Capped at what was admitted
+    CHECK(client.ReserveTx(16).data == nullptr);  // Only one outstanding reservation
+    CHECK_FALSE(client.CommitTx(17));
+    CHECK(client.ReserveTx(16).data != nullptr);
+    CHECK(client.CommitTx(0));
+
+    std::vector<float> seen;
+    bcnp::StreamParser parser([&](const bcnp::PacketView& view) {
+        for (auto it = view.begin_as<bcnp::TestCmd>(); it != view.end_as<bcnp::TestCmd>(); ++it) {
+            seen.push_back((*it).value1);
+        }
+    });
+    parser.SetWireSizeLookup(TestWireSizeLookup);
+
+    for (int i = 0; i < 5; ++i) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({static_cast<float>(i), 0.0f, 5});
+        REQUIRE(bcnp::EncodeTypedPacket(packet, static_cast<bcnp::ByteWriter&>(client)));
+    }
+
+    std::vector<uint8_t> rx(1024);
+    for (int i = 0; i < 100 && seen.size() < 5; ++i) {
+        const std::size_t bytes = server.ReceiveChunk(rx.data(), rx.size());
+        parser.Push(rx.data(), bytes);
+        if (bytes == 0) {
+            std::this_thread::sleep_for(5ms);
+        }
+    }
+    REQUIRE(seen.size() == 5);
+    CHECK(seen.front() == 0.0f);
+    CHECK(seen.back() == 4.0f);
+}
+
+TEST_CASE("TCP: io_uring backend streams data in place and survives a reconnect") {
+    auto server = std::make_unique<bcnp::TcpPosixAdapter>(12349);
+    REQUIRE(server->IsValid());
+    server->SetExpectedSchemaHash(bcnp::kSchemaHash);
+    if (!server->EnableIoUring()) {
+        MESSAGE("io_uring unavailable; skipping");
+        return;
+    }
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", 12349);
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    REQUIRE(client.EnableIoUring());
+    CHECK(client.SupportsReceiveInPlace());
+    REQUIRE(ConnectTcpPair(*server, client));
+
+    // More than the TX ring and socket buffers hold, so sends complete asynchronously and congest
+    constexpr std::size_t kTotal = 4u * 1024u * 1024u;
+    std::vector<uint8_t> source(kTotal);
+    for (std::size_t i = 0; i < kTotal; ++i) {
+        source[i] = static_cast<uint8_t>((i * 13u) % 251u);
+    }
+    std::vector<uint8_t> received;
+    received.reserve(kTotal);
+    auto drain = [&](bcnp::TcpPosixAdapter& adapter) {
+        const bcnp::ByteSpan view = adapter.ReceiveInPlace();
+        received.insert(received.end(), view.data, view.data + view.length);
+        return view.length;
+    };
+
+    std::size_t offset = 0;
+    for (int guard = 0; offset < kTotal && guard < 200000; ++guard) {
+        const std::size_t length = std::min<std::size_t>(30000, kTotal - offset);
+        const std::array<bcnp::ByteSpan, 2> spans{{{source.data() + offset, length / 2},
+                                                   {source.data() + offset + length / 2, length - length / 2}}};
+        if (client.SendBytesV(spans.data(), spans.size())) {
+            offset += length;
+        }
+        drain(*server);
+        client.ReceiveInPlace();   // Applies send completions
+    }
+    REQUIRE(offset == kTotal);
+    for (int guard = 0; received.size() < kTotal && guard < 5000; ++guard) {
+        client.ReceiveInPlace();
+        if (drain(*server) == 0) {
+            std::this_thread::sleep_for(1ms);
+        }
+    }
+    REQUIRE(received.size() == kTotal);
+    CHECK(received == source);
+
+    // Restart the server: the client detaches, reconnects and handshakes again
+    server.reset();
+    server = std::make_unique<bcnp::TcpPosixAdapter>(12349);
+    server->SetExpectedSchemaHash(bcnp::kSchemaHash);
+    REQUIRE(server->EnableIoUring());
+    bool reconnected = false;
+    std::vector<uint8_t> rx(256);
+    for (int i = 0; i < 200 && !reconnected; ++i) {
+        client.ReceiveChunk(rx.data(), rx.size());
+        server->ReceiveChunk(rx.data(), rx.size());
+        reconnected = client.IsHandshakeComplete() && server->IsHandshakeComplete();
+        std::this_thread::sleep_for(10ms);
+    }
+    REQUIRE(reconnected);
+
+    const std::array<uint8_t, 4> ping{0x0B, 0xAD, 0xF0, 0x0D};
+    REQUIRE(client.SendBytes(ping.data(), ping.size()));
+    std::size_t got = 0;
+    for (int i = 0; i < 100 && got == 0; ++i) {
+        got = server->ReceiveChunk(rx.data(), rx.size());
+        if (got == 0) {
+            std::this_thread::sleep_for(5ms);
+        }
+    }
+    REQUIRE(got == ping.size());
+    CHECK(std::equal(ping.begin(), ping.end(), rx.begin()));
+}
+
+// ============================================================================
+// Test Suite: StaticVector (Rule of Five & API)
+// ============================================================================
+
+TEST_CASE("StaticVector: reserve() no-op for API compatibility") {
+    bcnp::StaticVector<int, 64> vec;
+    vec.reserve(32);  // Should be no-op (less than capacity)
+    CHECK(vec.capacity() == 64);
     CHECK(vec.size() == 0);
     
     // Reserve at capacity is also fine
@@ -700,6 +1563,56 @@ namespace {
     };
 }
 
+namespace {
+    // ByteWriter with a reservation area; SendBytes() is counted to prove it is bypassed
+    class ReservingWriter : public bcnp::ByteWriter {
+    public:
+        bool SendBytes(const uint8_t* data, std::size_t len) override {
+            ++sendBytesCalls;
+            committed.insert(committed.end(), data, data + len);
+            return true;
+        }
+        bcnp::MutableByteSpan ReserveTx(std::size_t length) override {
+            reservations.push_back(length);
+            if (length > area.size()) return {};
+            return {area.data(), area.size()};
+        }
+        bool CommitTx(std::size_t length) override {
+            committed.insert(committed.end(), area.begin(), area.begin() + static_cast<std::ptrdiff_t>(length));
+            return true;
+        }
+
+        std::array<uint8_t, 512> area{};
+        std::vector<uint8_t> committed;
+        std::vector<std::size_t> reservations;
+        int sendBytesCalls{0};
+    };
+}
+
+TEST_CASE("TelemetryAccumulator: Encodes in place when the adapter supports ReserveTx") {
+    bcnp::TelemetryAccumulator<bcnp::EncoderData> accum;
+    ReservingWriter writer;
+
+    accum.Record({1, 100, 10});
+    accum.Record({2, 200, 20});
+    REQUIRE(accum.ForceFlush(writer));
+    CHECK(writer.sendBytesCalls == 0);
+
+    auto result = bcnp::DecodePacketViewAs<bcnp::EncoderData>(writer.committed.data(), writer.committed.size());
+    REQUIRE(result.view.is_some());
+    CHECK(result.view.unwrap().header.messageCount == 2);
+
+    // Too large for the reservation area: falls back to SendBytes
+    for (int i = 0; i < 60; ++i) {
+        accum.Record({static_cast<uint8_t>(i), i, 0});
+    }
+    writer.committed.clear();
+    REQUIRE(accum.ForceFlush(writer));
+    CHECK(writer.sendBytesCalls == 1);
+    CHECK(bcnp::DecodePacketViewAs<bcnp::EncoderData>(writer.committed.data(), writer.committed.size())
+              .view.is_some());
+}
+
 TEST_CASE("TelemetryAccumulator: Record and flush") {
     bcnp::TelemetryAccumulator<bcnp::DrivetrainState> accum;
     MockAdapter adapter;
@@ -760,13 +1673,54 @@ TEST_CASE("TelemetryAccumulator: Buffer overflow clears and continues") {
         accum.Record({static_cast<uint8_t>(i), i * 100, 0});
     }
     
-    // Buffer should have been cleared when it hit capacity, then re-filled
-    // Exact behavior depends on implementation; check we didn't crash
+    // Each reading past capacity overwrites the oldest one
     auto metrics = accum.GetMetrics();
     CHECK(metrics.messagesRecorded == 10);
     CHECK(metrics.bufferOverflows >= 1);
 }
 
+TEST_CASE("TelemetryAccumulator: Overflow keeps the newest messages in order") {
+    bcnp::TelemetryAccumulatorConfig config;
+    config.maxBufferedMessages = 4;
+
+    bcnp::TelemetryAccumulator<bcnp::EncoderData> accum(config);
+    MockAdapter adapter;
+
+    // Wraps the ring twice and leaves the head mid-buffer
+    for (int i = 0; i < 10; ++i) {
+        accum.Record({static_cast<uint8_t>(i), i * 100, 0});
+    }
+    CHECK(accum.BufferedCount() == 4);
+    CHECK(accum.GetMetrics().bufferOverflows == 6);
+
+    REQUIRE(accum.ForceFlush(adapter));
+    auto result = bcnp::DecodePacketViewAs<bcnp::EncoderData>(adapter.sentBytes.data(), adapter.sentBytes.size());
+    REQUIRE(result.view.is_some());
+    auto packet = bcnp::DecodeTypedPacket<bcnp::EncoderData>(result.view.unwrap());
+    REQUIRE(packet.is_some());
+    REQUIRE(packet.unwrap().messages.size() == 4);
+    for (std::size_t i = 0; i < 4; ++i) {
+        CHECK(packet.unwrap().messages[i].moduleId == 6 + i);
+    }
+
+    // Shrinking keeps the newest readings
+    bcnp::DynamicTelemetryAccumulator<bcnp::EncoderData> dynamic({1, 1000});
+    for (int i = 0; i < 1500; ++i) {
+        dynamic.Record({static_cast<uint8_t>(i), i, 0});
+    }
+    dynamic.SetConfig({1, 2});
+    CHECK(dynamic.Capacity() == 2);
+    adapter.sentBytes.clear();
+    REQUIRE(dynamic.ForceFlush(adapter));
+    auto shrunk = bcnp::DecodePacketViewAs<bcnp::EncoderData>(adapter.sentBytes.data(), adapter.sentBytes.size());
+    REQUIRE(shrunk.view.is_some());
+    auto shrunkPacket = bcnp::DecodeTypedPacket<bcnp::EncoderData>(shrunk.view.unwrap());
+    REQUIRE(shrunkPacket.is_some());
+    REQUIRE(shrunkPacket.unwrap().messages.size() == 2);
+    CHECK(shrunkPacket.unwrap().messages[0].position == 1498);
+    CHECK(shrunkPacket.unwrap().messages[1].position == 1499);
+}
+
 TEST_CASE("TelemetryAccumulator: Send failure increments counter") {
     bcnp::TelemetryAccumulator<bcnp::DrivetrainState> accum;
     MockAdapter adapter;
@@ -803,6 +1757,234 @@ TEST_CASE("TelemetryAccumulator: Verify encoded packet is decodable") {
     CHECK(packet.unwrap().messages[1].timestampMs == 1000);
 }
 
+TEST_CASE("MpscTelemetryAccumulator: Overflow keeps the newest readings") {
+    bcnp::TelemetryAccumulatorConfig config;
+    config.maxBufferedMessages = 4;
+    bcnp::MpscTelemetryAccumulator<bcnp::EncoderData> accum(config);
+    MockAdapter adapter;
+
+    CHECK(!accum.ForceFlush(adapter));
+    for (int i = 0; i < 10; ++i) {
+        CHECK(accum.Record({static_cast<uint8_t>(i), i, 0}));
+    }
+    CHECK(accum.BufferedCount() == 4);
+
+    REQUIRE(accum.ForceFlush(adapter));
+    auto result = bcnp::DecodePacketViewAs<bcnp::EncoderData>(adapter.sentBytes.data(), adapter.sentBytes.size());
+    REQUIRE(result.view.is_some());
+    auto packet = bcnp::DecodeTypedPacket<bcnp::EncoderData>(result.view.unwrap());
+    REQUIRE(packet.is_some());
+    REQUIRE(packet.unwrap().messages.size() == 4);
+    for (std::size_t i = 0; i < 4; ++i) {
+        CHECK(packet.unwrap().messages[i].moduleId == 6 + i);
+    }
+
+    auto metrics = accum.GetMetrics();
+    CHECK(metrics.messagesRecorded == 10);
+    CHECK(metrics.bufferOverflows == 6);
+    CHECK(metrics.messagesSent == 4);
+    CHECK(metrics.packetsSent == 1);
+    CHECK(accum.BufferedCount() == 0);
+}
+
+TEST_CASE("MpscTelemetryAccumulator: Concurrent producers with a flushing thread") {
+    // Captures each packet separately; only the flushing thread calls it
+    struct PacketSink {
+        std::vector<std::vector<uint8_t>> packets;
+        bool SendBytes(const uint8_t* data, std::size_t len) {
+            packets.emplace_back(data, data + len);
+            return true;
+        }
+    };
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 5000;
+    bcnp::TelemetryAccumulatorConfig config;
+    config.flushIntervalTicks = 1;
+    config.maxBufferedMessages = 64;
+    bcnp::MpscTelemetryAccumulator<bcnp::EncoderData> accum(config);
+    PacketSink sink;
+
+    std::atomic<int> running{kProducers};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                accum.Record({static_cast<uint8_t>(p), i, 0});
+            }
+            running.fetch_sub(1);
+        });
+    }
+    while (running.load() > 0) {
+        accum.MaybeFlush(sink);
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    while (accum.ForceFlush(sink)) {
+    }
+
+    // Each producer's surviving readings arrive in order, no duplicates
+    std::array<int32_t, kProducers> last{};
+    last.fill(-1);
+    uint64_t received = 0;
+    for (const auto& bytes : sink.packets) {
+        auto result = bcnp::DecodePacketViewAs<bcnp::EncoderData>(bytes.data(), bytes.size());
+        REQUIRE(result.view.is_some());
+        for (auto it = result.view.unwrap().begin_as<bcnp::EncoderData>();
+             it != result.view.unwrap().end_as<bcnp::EncoderData>(); ++it) {
+            const auto msg = *it;
+            REQUIRE(msg.moduleId < kProducers);
+            CHECK(msg.position > last[msg.moduleId]);
+            last[msg.moduleId] = msg.position;
+            ++received;
+        }
+    }
+
+    auto metrics = accum.GetMetrics();
+    CHECK(metrics.messagesRecorded == kProducers * kPerProducer);
+    CHECK(metrics.messagesSent == received);
+    CHECK(metrics.messagesSent + metrics.bufferOverflows == metrics.messagesRecorded);
+    CHECK(metrics.packetsSent == sink.packets.size());
+}
+
+namespace {
+    // Records each send separately (one entry per syscall)
+    struct SendRecorder {
+        std::vector<std::vector<uint8_t>> sends;
+        bool SendBytes(const uint8_t* data, std::size_t len) {
+            sends.emplace_back(data, data + len);
+            return true;
+        }
+    };
+
+    // Parse a send buffer as concatenated packets; returns per-type message counts
+    std::vector<std::pair<bcnp::MessageTypeId, std::size_t>> ParsePackets(const std::vector<uint8_t>& bytes) {
+        std::vector<std::pair<bcnp::MessageTypeId, std::size_t>> packets;
+        bcnp::StreamParser parser(
+            [&](const bcnp::PacketView& view) {
+                packets.emplace_back(view.header.messageType, view.header.messageCount);
+            },
+            [&](const bcnp::StreamParser::ErrorInfo&) { FAIL("Unexpected parse error"); });
+        parser.SetWireSizeLookup([](bcnp::MessageTypeId typeId) -> std::size_t {
+            switch (typeId) {
+                case bcnp::MessageTypeId::DrivetrainState: return bcnp::DrivetrainState::kWireSize;
+                case bcnp::MessageTypeId::EncoderData: return bcnp::EncoderData::kWireSize;
+                case bcnp::MessageTypeId::ProximityAlert: return bcnp::ProximityAlert::kWireSize;
+                default: return 0;
+            }
+        });
+        parser.Push(bytes.data(), bytes.size());
+        return packets;
+    }
+}
+
+TEST_CASE("TelemetryBatcher: Coalesces several message types into one send") {
+    bcnp::TelemetryAccumulator<bcnp::DrivetrainState> drivetrain;
+    bcnp::TelemetryAccumulator<bcnp::EncoderData> encoders;
+    bcnp::MpscTelemetryAccumulator<bcnp::ProximityAlert> alerts;
+    bcnp::TelemetryAccumulator<bcnp::EncoderData> idle;
+
+    bcnp::TelemetryBatcherConfig config;
+    config.flushIntervalTicks = 2;
+    bcnp::TelemetryBatcher batcher(config);
+    REQUIRE(batcher.Add(drivetrain));
+    REQUIRE(batcher.Add(idle));
+    REQUIRE(batcher.Add(encoders));
+    REQUIRE(batcher.Add(alerts));
+
+    drivetrain.Record({0.5f, 0.1f, 100, 200, 1000});
+    encoders.Record({1, 100, 10});
+    encoders.Record({2, 200, 20});
+    alerts.Record({});
+
+    SendRecorder recorder;
+    CHECK(!batcher.MaybeFlush(recorder));
+    REQUIRE(batcher.MaybeFlush(recorder));
+    REQUIRE(recorder.sends.size() == 1);
+
+    const auto packets = ParsePackets(recorder.sends[0]);
+    REQUIRE(packets.size() == 3);
+    CHECK(packets[0] == std::make_pair(bcnp::MessageTypeId::DrivetrainState, std::size_t{1}));
+    CHECK(packets[1] == std::make_pair(bcnp::MessageTypeId::EncoderData, std::size_t{2}));
+    CHECK(packets[2].first == bcnp::MessageTypeId::ProximityAlert);
+
+    auto metrics = batcher.GetMetrics();
+    CHECK(metrics.sends == 1);
+    CHECK(metrics.packetsSent == 3);
+    CHECK(metrics.lastFlushBytes == recorder.sends[0].size());
+    CHECK(metrics.PacketsPerSend() == doctest::Approx(3.0));
+    CHECK(encoders.GetMetrics().messagesSent == 2);
+    CHECK(alerts.GetMetrics().packetsSent == 1);
+    CHECK(encoders.BufferedCount() == 0);
+
+    // Nothing buffered: nothing sent
+    CHECK(!batcher.ForceFlush(recorder));
+    CHECK(recorder.sends.size() == 1);
+}
+
+TEST_CASE("TelemetryBatcher: Reserves only the bytes pending, not the whole buffer") {
+    bcnp::TelemetryAccumulator<bcnp::DrivetrainState> drivetrain;
+    bcnp::TelemetryAccumulator<bcnp::EncoderData> encoders;
+    bcnp::TelemetryBatcher batcher;
+    REQUIRE(batcher.Add(drivetrain));
+    REQUIRE(batcher.Add(encoders));
+
+    drivetrain.Record({0.5f, 0.1f, 100, 200, 1000});
+    encoders.Record({1, 100, 10});
+    encoders.Record({2, 200, 20});
+
+    ReservingWriter writer;
+    REQUIRE(batcher.ForceFlush(writer));
+    const std::size_t expected =
+        bcnp::PacketSizeFor<bcnp::DrivetrainState>(1) + bcnp::PacketSizeFor<bcnp::EncoderData>(2);
+    REQUIRE(writer.reservations.size() == 1);
+    CHECK(writer.reservations[0] == expected);
+    CHECK(writer.sendBytesCalls == 0);   // Fits the writer's area, so encoded in place
+    CHECK(writer.committed.size() == expected);
+
+    // Nothing pending: no reservation at all
+    CHECK(!batcher.ForceFlush(writer));
+    CHECK(writer.reservations.size() == 1);
+}
+
+TEST_CASE("TelemetryBatcher: Datagrams never exceed the configured MTU") {
+    bcnp::DynamicTelemetryAccumulator<bcnp::EncoderData> encoders({1, 1000});
+    bcnp::TelemetryAccumulator<bcnp::DrivetrainState> drivetrain;
+
+    bcnp::TelemetryBatcherConfig config;
+    config.maxDatagramSize = 200;
+    bcnp::TelemetryBatcher batcher(config);
+    REQUIRE(batcher.Add(encoders));
+    REQUIRE(batcher.Add(drivetrain));
+
+    for (int i = 0; i < 100; ++i) {
+        encoders.Record({static_cast<uint8_t>(i), i, 0});
+    }
+    drivetrain.Record({0.5f, 0.1f, 100, 200, 1000});
+
+    SendRecorder recorder;
+    REQUIRE(batcher.ForceFlush(recorder));
+    REQUIRE(recorder.sends.size() > 1);
+
+    std::size_t encoderMessages = 0;
+    std::size_t drivetrainMessages = 0;
+    for (const auto& datagram : recorder.sends) {
+        CHECK(datagram.size() <= config.maxDatagramSize);
+        for (const auto& [type, count] : ParsePackets(datagram)) {
+            (type == bcnp::MessageTypeId::EncoderData ? encoderMessages : drivetrainMessages) += count;
+        }
+    }
+    CHECK(encoderMessages == 100);
+    CHECK(drivetrainMessages == 1);
+    CHECK(encoders.GetMetrics().messagesSent == 100);
+    CHECK(batcher.GetMetrics().sends == recorder.sends.size());
+
+    // A message that can never fit a datagram is rejected up front
+    bcnp::TelemetryBatcher tiny({1, 16 * 1024, 8});
+    CHECK(!tiny.Add(encoders));
+}
+
 // ============================================================================
 // Test Suite: Telemetry Message Types
 // ============================================================================
@@ -847,3 +2029,1860 @@ TEST_CASE("ProximityAlert: Encode and decode") {
     CHECK(decoded->distanceMm == 150);
     CHECK(decoded->triggered == 1);
 }
+
+// ============================================================================
+// Test Suite: Batch Codec
+// ============================================================================
+
+TEST_CASE("Batch codec: DrivetrainState EncodeBatch matches scalar Encode") {
+    std::vector<bcnp::DrivetrainState> states;
+    for (int i = 0; i < 37; ++i) {
+        const float step = static_cast<float>(i);
+        states.push_back({step * 0.25f - 3.0f, -step * 0.00005f, i * 1000 - 7, -i * 31, static_cast<uint32_t>(i) * 0x01020304u});
+    }
+    states[5].vxActual = 1.0e9f;   // Clamps to INT32_MAX
+    states[6].vxActual = -1.0e9f;  // Clamps to INT32_MIN
+    states[7].omegaActual = 0.00015f;
+
+    std::vector<uint8_t> scalar(states.size() * bcnp::DrivetrainState::kWireSize);
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        REQUIRE(states[i].Encode(&scalar[i * bcnp::DrivetrainState::kWireSize], bcnp::DrivetrainState::kWireSize));
+    }
+
+    std::vector<uint8_t> batch(scalar.size());
+    REQUIRE(bcnp::DrivetrainState::EncodeBatch(states.data(), states.size(), batch.data()));
+    CHECK(batch == scalar);
+
+    std::vector<bcnp::DrivetrainState> decoded(states.size());
+    bcnp::DrivetrainState::DecodeBatch(batch.data(), decoded.size(), decoded.data());
+    for (std::size_t i = 0; i < states.size(); ++i) {
+        auto expected = bcnp::DrivetrainState::Decode(&scalar[i * bcnp::DrivetrainState::kWireSize], bcnp::DrivetrainState::kWireSize);
+        REQUIRE(expected.has_value());
+        CHECK(std::memcmp(&decoded[i].vxActual, &expected->vxActual, sizeof(float)) == 0);
+        CHECK(std::memcmp(&decoded[i].omegaActual, &expected->omegaActual, sizeof(float)) == 0);
+        CHECK(decoded[i].leftPos == expected->leftPos);
+        CHECK(decoded[i].rightPos == expected->rightPos);
+        CHECK(decoded[i].timestampMs == expected->timestampMs);
+    }
+}
+
+TEST_CASE("Batch codec: EncodeBatch rejects non-finite floats") {
+    std::vector<bcnp::DrivetrainState> states(20);
+    states[17].omegaActual = std::numeric_limits<float>::quiet_NaN();
+    std::vector<uint8_t> out(states.size() * bcnp::DrivetrainState::kWireSize);
+    CHECK_FALSE(bcnp::DrivetrainState::EncodeBatch(states.data(), states.size(), out.data()));
+
+    states[17].omegaActual = 0.0f;
+    states[3].vxActual = std::numeric_limits<float>::infinity();
+    CHECK_FALSE(bcnp::DrivetrainState::EncodeBatch(states.data(), states.size(), out.data()));
+}
+
+TEST_CASE("Batch codec: Unaligned EncoderData round trip") {
+    std::vector<bcnp::EncoderData> data;
+    for (int i = 0; i < 21; ++i) {
+        data.push_back({static_cast<uint8_t>(i), -i * 40000, i * 3});
+    }
+    std::vector<uint8_t> scalar(data.size() * bcnp::EncoderData::kWireSize);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        REQUIRE(data[i].Encode(&scalar[i * bcnp::EncoderData::kWireSize], bcnp::EncoderData::kWireSize));
+    }
+    std::vector<uint8_t> batch(scalar.size());
+    REQUIRE(bcnp::EncoderData::EncodeBatch(data.data(), data.size(), batch.data()));
+    CHECK(batch == scalar);
+
+    std::vector<bcnp::EncoderData> decoded(data.size());
+    bcnp::EncoderData::DecodeBatch(batch.data(), decoded.size(), decoded.data());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        CHECK(decoded[i].moduleId == data[i].moduleId);
+        CHECK(decoded[i].position == data[i].position);
+        CHECK(decoded[i].velocity == data[i].velocity);
+    }
+}
+
+TEST_CASE("Batch codec: Typed packet decode uses batch path for all storage") {
+    bcnp::TypedPacket<bcnp::DrivetrainState> packet;
+    for (int i = 0; i < 40; ++i) {
+        packet.messages.push_back({static_cast<float>(i) * 0.1f, 0.5f, i, -i, static_cast<uint32_t>(i)});
+    }
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+
+    auto view = bcnp::DecodePacketViewAs<bcnp::DrivetrainState>(encoded.data(), encoded.size());
+    REQUIRE(view.error == bcnp::PacketError::None);
+
+    auto dynamic = bcnp::DecodeTypedPacket<bcnp::DrivetrainState>(view.view.unwrap());
+    REQUIRE(dynamic.is_some());
+    REQUIRE(dynamic.unwrap().messages.size() == 40);
+    CHECK(dynamic.unwrap().messages[39].leftPos == 39);
+    CHECK(dynamic.unwrap().messages[39].vxActual == doctest::Approx(3.9f));
+
+    auto fixed = bcnp::DecodeTypedPacketAs<bcnp::DrivetrainState, bcnp::StaticVector<bcnp::DrivetrainState, 64>>(view.view.unwrap());
+    REQUIRE(fixed.is_some());
+    REQUIRE(fixed.unwrap().messages.size() == 40);
+    CHECK(fixed.unwrap().messages[20].rightPos == -20);
+
+    using Small = bcnp::StaticVector<bcnp::DrivetrainState, 8>;
+    CHECK_THROWS_AS((bcnp::DecodeTypedPacketAs<bcnp::DrivetrainState, Small>(view.view.unwrap())), std::out_of_range);
+}
+
+TEST_CASE("Unchecked codec: Matches checked Encode/Decode bytes and values") {
+    static_assert(bcnp::DrivetrainState::kFields[2].offset == 8);
+    static_assert(bcnp::DrivetrainState::kFields[4].type == bcnp::FieldType::UInt32);
+    static_assert(bcnp::TestCmd::kFields[2].offset + bcnp::TestCmd::kFields[2].width == bcnp::TestCmd::kWireSize);
+    CHECK(std::string(bcnp::TestCmd::kFields[1].name) == "value2");
+    CHECK(bcnp::TestCmd::kFields[0].scale == 10000.0f);
+
+    // Half-way points after scaling, negatives, and values that clamp
+    const float values[] = {0.0f, -0.0f, 0.00005f, -0.00005f, 0.00015f, -0.00025f, 1.23456f,
+                            -7.77775f, 214748.3647f, 1.0e9f, -1.0e9f, 3.0e38f, -3.0e38f,
+                            std::numeric_limits<float>::denorm_min()};
+    for (float v1 : values) {
+        for (float v2 : values) {
+            const bcnp::TestCmd cmd{v1, -v2, static_cast<uint16_t>(v1 > 0 ? 65535 : 7)};
+            uint8_t checked[bcnp::TestCmd::kWireSize];
+            uint8_t unchecked[bcnp::TestCmd::kWireSize];
+            REQUIRE(cmd.Encode(checked, sizeof(checked)));
+            cmd.EncodeUnchecked(unchecked);
+            CHECK(std::memcmp(checked, unchecked, sizeof(checked)) == 0);
+
+            const auto expected = bcnp::TestCmd::Decode(checked, sizeof(checked));
+            REQUIRE(expected.has_value());
+            const auto decoded = bcnp::TestCmd::DecodeUnchecked(checked);
+            CHECK(std::memcmp(&decoded.value1, &expected->value1, sizeof(float)) == 0);
+            CHECK(std::memcmp(&decoded.value2, &expected->value2, sizeof(float)) == 0);
+            CHECK(decoded.durationMs == expected->durationMs);
+        }
+    }
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({0.5f, -0.25f, 10});
+    packet.messages.push_back({1.5f, 2.0f, 20});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    auto view = bcnp::DecodePacketViewAs<bcnp::TestCmd>(encoded.data(), encoded.size());
+    REQUIRE(view.error == bcnp::PacketError::None);
+    auto it = view.view.unwrap().begin_as<bcnp::TestCmd>();
+    const bcnp::TestCmd& first = *it;
+    CHECK(&first == &*it);   // Cached: no second decode
+    CHECK(it->durationMs == 10);
+    ++it;
+    CHECK(it->value1 == doctest::Approx(1.5f));
+    CHECK((*it).durationMs == 20);
+}
+
+// ============================================================================
+// Test Suite: Column Decode
+// ============================================================================
+
+TEST_CASE("DecodeColumns: Selected fields match AoS decode") {
+    bcnp::TypedPacket<bcnp::DrivetrainState> packet;
+    for (int i = 0; i < 35; ++i) {
+        packet.messages.push_back({static_cast<float>(i) * 0.125f, -0.5f, i * 7, -i, static_cast<uint32_t>(1000 + i)});
+    }
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    auto result = bcnp::DecodePacketViewAs<bcnp::DrivetrainState>(encoded.data(), encoded.size());
+    REQUIRE(result.error == bcnp::PacketError::None);
+    const auto& view = result.view.unwrap();
+
+    using Cols = bcnp::DrivetrainStateColumns;
+    Cols cols;
+    REQUIRE(bcnp::DecodeColumns(view, cols, Cols::kLeftPos | Cols::kTimestampMs | Cols::kVxActual));
+    CHECK(cols.count == 35);
+    CHECK(cols.fields == (Cols::kLeftPos | Cols::kTimestampMs | Cols::kVxActual));
+    CHECK(cols.omegaActual.empty());
+    CHECK(cols.rightPos.empty());
+    REQUIRE(cols.leftPos.size() == 35);
+    REQUIRE(cols.timestampMs.size() == 35);
+    REQUIRE(cols.vxActual.size() == 35);
+
+    auto aos = bcnp::DecodeTypedPacket<bcnp::DrivetrainState>(view);
+    REQUIRE(aos.is_some());
+    for (std::size_t i = 0; i < 35; ++i) {
+        CHECK(cols.leftPos[i] == aos.unwrap().messages[i].leftPos);
+        CHECK(cols.timestampMs[i] == aos.unwrap().messages[i].timestampMs);
+        CHECK(cols.vxActual[i] == aos.unwrap().messages[i].vxActual);
+    }
+
+    // Re-decoding with a narrower mask drops the other columns
+    REQUIRE(bcnp::DecodeColumns(view, cols, Cols::kRightPos));
+    CHECK(cols.leftPos.empty());
+    REQUIRE(cols.rightPos.size() == 35);
+    CHECK(cols.rightPos[34] == -34);
+}
+
+TEST_CASE("DecodeColumns: Type mismatch clears and fails") {
+    bcnp::TypedPacket<bcnp::EncoderData> packet;
+    packet.messages.push_back({1, 2, 3});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    auto result = bcnp::DecodePacketViewAs<bcnp::EncoderData>(encoded.data(), encoded.size());
+    REQUIRE(result.error == bcnp::PacketError::None);
+
+    bcnp::EncoderDataColumns encoderCols;
+    REQUIRE(bcnp::DecodeColumns(result.view.unwrap(), encoderCols));
+    CHECK(encoderCols.fields == bcnp::EncoderDataColumns::kAll);
+    CHECK(encoderCols.moduleId == std::vector<uint8_t>{1});
+    CHECK(encoderCols.velocity == std::vector<int32_t>{3});
+
+    bcnp::DrivetrainStateColumns cols;
+    cols.leftPos.push_back(5);
+    cols.count = 1;
+    CHECK_FALSE(bcnp::DecodeColumns(result.view.unwrap(), cols));
+    CHECK(cols.count == 0);
+    CHECK(cols.leftPos.empty());
+}
+
+// ============================================================================
+// Test Suite: TCP Reactor
+// ============================================================================
+
+namespace {
+// bcnp_core is built against the main schema; use the test schema's hash and sizes
+bcnp::TcpReactorConfig ReactorTestConfig() {
+    bcnp::TcpReactorConfig config;
+    config.expectedSchemaHash = bcnp::kSchemaHash;
+    config.wireSizeFn = &TestWireSizeLookup;
+    return config;
+}
+} // namespace
+
+TEST_CASE("TcpReactor: Serves several clients with per-connection parsing") {
+    bcnp::TcpReactor reactor(0, ReactorTestConfig());
+    REQUIRE(reactor.IsValid());
+    REQUIRE(reactor.Port() != 0);
+
+    std::mutex mutex;
+    std::vector<std::pair<bcnp::TcpReactor::ConnectionId, uint16_t>> received;
+    std::atomic<int> connects{0};
+    reactor.SetPacketHandler([&](bcnp::TcpReactor::ConnectionId id, const bcnp::PacketView& packet) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = packet.begin_as<bcnp::TestCmd>(); it != packet.end_as<bcnp::TestCmd>(); ++it) {
+            received.emplace_back(id, (*it).durationMs);
+        }
+    });
+    reactor.SetConnectionHandler([&](bcnp::TcpReactor::ConnectionId, bool connected) {
+        connects += connected ? 1 : -1;
+    });
+    REQUIRE(reactor.Start());
+
+    constexpr int kClients = 3;
+    std::vector<std::unique_ptr<bcnp::TcpPosixAdapter>> clients;
+    for (int i = 0; i < kClients; ++i) {
+        clients.push_back(std::make_unique<bcnp::TcpPosixAdapter>(0, "127.0.0.1", reactor.Port()));
+        clients.back()->SetExpectedSchemaHash(bcnp::kSchemaHash);
+    }
+    std::vector<uint8_t> rx(1024);
+    for (int attempt = 0; attempt < 200 && connects.load() < kClients; ++attempt) {
+        for (auto& client : clients) {
+            client->ReceiveChunk(rx.data(), rx.size());
+        }
+        std::this_thread::sleep_for(5ms);
+    }
+    REQUIRE(connects.load() == kClients);
+    CHECK(reactor.ConnectionCount() == kClients);
+
+    // Interleave fragments from every client: each stream must reassemble on its own
+    std::vector<std::vector<uint8_t>> encoded(kClients);
+    for (int i = 0; i < kClients; ++i) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({0.1f, 0.2f, static_cast<uint16_t>(100 + i)});
+        REQUIRE(bcnp::EncodeTypedPacket(packet, encoded[i]));
+    }
+    for (std::size_t offset = 0; offset < encoded[0].size(); offset += 5) {
+        for (int i = 0; i < kClients; ++i) {
+            const std::size_t len = std::min<std::size_t>(5, encoded[i].size() - offset);
+            REQUIRE(clients[i]->SendBytes(encoded[i].data() + offset, len));
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+
+    bool complete = false;
+    for (int attempt = 0; attempt < 200 && !complete; ++attempt) {
+        std::this_thread::sleep_for(5ms);
+        std::lock_guard<std::mutex> lock(mutex);
+        complete = received.size() == kClients;
+    }
+    REQUIRE(complete);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<uint16_t> durations;
+        std::vector<bcnp::TcpReactor::ConnectionId> ids;
+        for (const auto& entry : received) {
+            ids.push_back(entry.first);
+            durations.push_back(entry.second);
+        }
+        std::sort(durations.begin(), durations.end());
+        std::sort(ids.begin(), ids.end());
+        CHECK(durations == std::vector<uint16_t>{100, 101, 102});
+        CHECK(std::unique(ids.begin(), ids.end()) == ids.end());
+    }
+
+    // Reply to every client through the reactor
+    CHECK(reactor.Broadcast(encoded[0].data(), encoded[0].size()) == kClients);
+    for (auto& client : clients) {
+        std::size_t got = 0;
+        for (int attempt = 0; attempt < 200 && got < encoded[0].size(); ++attempt) {
+            got += client->ReceiveChunk(rx.data() + got, rx.size() - got);
+            std::this_thread::sleep_for(2ms);
+        }
+        REQUIRE(got == encoded[0].size());
+        CHECK(std::equal(encoded[0].begin(), encoded[0].end(), rx.begin()));
+    }
+
+    clients.clear();
+    for (int attempt = 0; attempt < 200 && connects.load() > 0; ++attempt) {
+        std::this_thread::sleep_for(5ms);
+    }
+    CHECK(connects.load() == 0);
+    reactor.Stop();
+    CHECK_FALSE(reactor.IsRunning());
+}
+
+TEST_CASE("TcpReactor: Drops clients with a mismatched schema") {
+    bcnp::TcpReactor reactor(0, ReactorTestConfig());
+    REQUIRE(reactor.IsValid());
+    std::atomic<int> connects{0};
+    reactor.SetConnectionHandler([&](bcnp::TcpReactor::ConnectionId, bool connected) {
+        if (connected) {
+            ++connects;
+        }
+    });
+
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", reactor.Port());
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash ^ 0x5A5A5A5Au);
+    std::vector<uint8_t> rx(256);
+    for (int attempt = 0; attempt < 40; ++attempt) {
+        client.ReceiveChunk(rx.data(), rx.size());
+        reactor.PollOnce(5ms);
+    }
+    CHECK(connects.load() == 0);
+    CHECK(reactor.ConnectionCount() == 0);
+}
+
+TEST_CASE("TcpReactor: PollOnce returns as soon as data arrives") {
+    bcnp::TcpReactor reactor(0, ReactorTestConfig());
+    REQUIRE(reactor.IsValid());
+    std::size_t packets = 0;
+    reactor.SetPacketHandler([&](bcnp::TcpReactor::ConnectionId, const bcnp::PacketView&) { ++packets; });
+
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", reactor.Port());
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    std::vector<uint8_t> rx(256);
+    for (int attempt = 0; attempt < 200 && !client.IsHandshakeComplete(); ++attempt) {
+        reactor.PollOnce(5ms);
+        client.ReceiveChunk(rx.data(), rx.size());
+    }
+    REQUIRE(client.IsHandshakeComplete());
+    for (int attempt = 0; attempt < 20 && reactor.ConnectionCount() == 0; ++attempt) {
+        reactor.PollOnce(5ms);
+    }
+    REQUIRE(reactor.ConnectionCount() == 1);
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({0.0f, 0.0f, 7});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+
+    auto sender = std::async(std::launch::async, [&]() {
+        std::this_thread::sleep_for(20ms);
+        return client.SendBytes(encoded.data(), encoded.size());
+    });
+    const auto start = std::chrono::steady_clock::now();
+    while (packets == 0 && std::chrono::steady_clock::now() - start < 5s) {
+        reactor.PollOnce(10s);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    REQUIRE(sender.get());
+    CHECK(packets == 1);
+    CHECK(elapsed < 2s);
+}
+
+// ============================================================================
+// Test Suite: Capture / replay
+// ============================================================================
+
+namespace {
+// Hands out scripted chunks from ReceiveChunk(); sends are discarded
+class ScriptedAdapter : public bcnp::DuplexAdapter {
+public:
+    std::vector<std::vector<uint8_t>> chunks;
+    std::vector<uint8_t> sent;
+
+    std::size_t ReceiveChunk(uint8_t* buffer, std::size_t maxLength) override {
+        if (m_next >= chunks.size()) {
+            return 0;
+        }
+        const auto& chunk = chunks[m_next++];
+        const std::size_t length = std::min(chunk.size(), maxLength);
+        std::memcpy(buffer, chunk.data(), length);
+        return length;
+    }
+    bool SendBytes(const uint8_t* data, std::size_t length) override {
+        sent.insert(sent.end(), data, data + length);
+        return true;
+    }
+
+private:
+    std::size_t m_next{0};
+};
+
+std::string CapturePath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+} // namespace
+
+TEST_CASE("Capture: Driver chunks replay through the parser and index by type") {
+    const std::string path = CapturePath("bcnp_capture_test.bcnpcap");
+
+    std::vector<uint8_t> stream;
+    for (uint16_t i = 0; i < 4; ++i) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({static_cast<float>(i), 0.0f, static_cast<uint16_t>(100 + i)});
+        std::vector<uint8_t> encoded;
+        REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+        stream.insert(stream.end(), encoded.begin(), encoded.end());
+    }
+    const std::size_t packetSize = stream.size() / 4;
+
+    // Chunk boundaries: packet 1 is split across the first two chunks
+    ScriptedAdapter adapter;
+    const std::size_t split = packetSize + 5;
+    adapter.chunks.emplace_back(stream.begin(), stream.begin() + split);
+    adapter.chunks.emplace_back(stream.begin() + split, stream.begin() + 3 * packetSize);
+    adapter.chunks.emplace_back(stream.begin() + 3 * packetSize, stream.end());
+
+    bcnp::PacketDispatcher dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    bcnp::DispatcherDriver driver(dispatcher, adapter);
+
+    // Small buffers force several hand-offs to the writer thread
+    bcnp::CaptureWriter writer({64, 4});
+    REQUIRE(writer.Open(path));
+    driver.SetCapture(&writer, 3);
+    driver.PollOnce();
+    writer.Close();
+
+    const auto written = writer.GetMetrics();
+    CHECK(written.chunksRecorded == 3);
+    CHECK(written.bytesRecorded == stream.size());
+    CHECK(written.chunksDropped == 0);
+    CHECK(written.writeErrors == 0);
+    CHECK(written.bytesWritten == bcnp::kCaptureHeaderSize + 3 * bcnp::kCaptureRecordHeaderSize + stream.size());
+
+    bcnp::CaptureReader reader;
+    REQUIRE(reader.Open(path));
+    CHECK(reader.SchemaHash() == bcnp::kSchemaHash);
+    CHECK(reader.StartWallClockNs() > 0);
+
+    std::vector<uint16_t> durations;
+    bcnp::StreamParser parser([&](const bcnp::PacketView& packet) {
+        for (auto it = packet.begin_as<bcnp::TestCmd>(); it != packet.end_as<bcnp::TestCmd>(); ++it) {
+            durations.push_back((*it).durationMs);
+        }
+    });
+    parser.SetWireSizeLookup(TestWireSizeLookup);
+    CHECK(reader.Replay(parser) == 3);
+    CHECK(durations == std::vector<uint16_t>{100, 101, 102, 103});
+    CHECK(parser.ScratchCopyCount() == 0);  // Only the split packet was buffered, and it was contiguous
+
+    bcnp::CaptureReplayConfig otherStream;
+    otherStream.streamId = 7;
+    CHECK(reader.Replay(parser, otherStream) == 0);
+
+    CHECK(reader.BuildIndex(TestWireSizeLookup) == 4);
+    const auto& refs = reader.PacketsOfType(bcnp::TestCmd::kTypeId);
+    REQUIRE(refs.size() == 4);
+    CHECK(refs[1].recordOffset == refs[0].recordOffset);
+    CHECK(refs[1].byteOffset == packetSize);
+    CHECK(refs[2].recordOffset > refs[1].recordOffset);
+    CHECK(refs[2].byteOffset == 2 * packetSize - split);
+    CHECK(refs[1].streamId == 3);
+    CHECK(reader.PacketsOfType(bcnp::MessageTypeId::Unknown).empty());
+
+    // Seek: replay from the split packet, paced in real time
+    durations.clear();
+    parser.Reset();
+    bcnp::CaptureReplayConfig realTime;
+    realTime.pacing = bcnp::ReplayPacing::RealTime;
+    realTime.speed = 4.0;
+    CHECK(reader.Replay(parser, realTime, refs[1]) == 3);
+    CHECK(durations == std::vector<uint16_t>{101, 102, 103});
+
+    // The offset only applies to the position's own stream
+    CHECK(reader.Replay(parser, otherStream, refs[1]) == 0);
+    durations.clear();
+    parser.Reset();
+    bcnp::CapturePacketRef elsewhere = refs[1];
+    elsewhere.streamId = 9;
+    CHECK(reader.Replay(parser, {}, elsewhere) == 3);
+    CHECK(durations == std::vector<uint16_t>{100, 101, 102, 103});
+
+    reader.Close();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Capture: Writer drops instead of blocking and reader stops at a torn record") {
+    const std::string path = CapturePath("bcnp_capture_torn.bcnpcap");
+    std::vector<uint8_t> chunk(40, 0xAB);
+    {
+        bcnp::CaptureWriter writer({128, 2});
+        CHECK(!writer.Record(chunk.data(), chunk.size()));  // Not open
+        REQUIRE(writer.Open(path));
+        CHECK(!writer.Record(chunk.data(), 200));           // Larger than a buffer
+        for (int i = 0; i < 6; ++i) {
+            writer.Record(chunk.data(), chunk.size(), 1);
+        }
+        writer.Close();
+        const auto metrics = writer.GetMetrics();
+        CHECK(metrics.chunksDropped >= 2);
+        CHECK(metrics.chunksRecorded + metrics.chunksDropped == 8);
+        CHECK(metrics.bytesWritten ==
+              bcnp::kCaptureHeaderSize + metrics.chunksRecorded * (bcnp::kCaptureRecordHeaderSize + chunk.size()));
+    }
+
+    // Chop the last record in half as a crash would
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 10);
+
+    bcnp::CaptureReader reader;
+    REQUIRE(reader.Open(path));
+    std::size_t offset = reader.Begin();
+    bcnp::CaptureChunk record;
+    std::size_t records = 0;
+    while (reader.Next(offset, record)) {
+        CHECK(record.streamId == 1);
+        CHECK(record.length == chunk.size());
+        CHECK(record.data[0] == 0xAB);
+        ++records;
+    }
+    CHECK(records * (bcnp::kCaptureRecordHeaderSize + chunk.size()) + bcnp::kCaptureHeaderSize < size);
+    CHECK(records > 0);
+    reader.Close();
+
+    std::remove(path.c_str());
+    CHECK(!reader.Open(path));
+}
+
+// ============================================================================
+// Test Suite: DispatcherDriver
+// ============================================================================
+
+TEST_CASE("DispatcherDriver: I/O thread dispatches on readiness and stops promptly") {
+    bcnp::UdpPosixAdapter sender(12414, "127.0.0.1", 12415);
+    bcnp::UdpPosixAdapter receiver(12415, "127.0.0.1", 12414);
+    REQUIRE(sender.IsValid());
+    REQUIRE(receiver.IsValid());
+    CHECK(receiver.ReadableFd() >= 0);
+
+    bcnp::PacketDispatcher dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<uint16_t> received;
+    std::thread::id handlerThread;
+    dispatcher.RegisterHandler<bcnp::TestCmd>([&](const bcnp::PacketView& packet) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handlerThread = std::this_thread::get_id();
+        for (auto it = packet.begin_as<bcnp::TestCmd>(); it != packet.end_as<bcnp::TestCmd>(); ++it) {
+            received.push_back((*it).durationMs);
+        }
+        cv.notify_all();
+    });
+
+    bcnp::DispatcherDriver driver(dispatcher, receiver);
+    bcnp::DispatcherDriverThreadConfig io;
+    io.idleTimeout = 5s;  // Only readiness can wake the thread in time
+    REQUIRE(driver.Start(io));
+    CHECK(!driver.Start(io));
+    CHECK(driver.IsRunning());
+    std::this_thread::sleep_for(20ms);  // Let the thread block in poll()
+
+    // More datagrams than PollOnce() would drain in one call
+    constexpr uint16_t kPackets = 40;
+    const auto sent = std::chrono::steady_clock::now();
+    for (uint16_t i = 0; i < kPackets; ++i) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({0.0f, 0.0f, i});
+        std::vector<uint8_t> encoded;
+        REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+        REQUIRE(sender.SendBytes(encoded.data(), encoded.size()));
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        CHECK(cv.wait_for(lock, 2s, [&]() { return received.size() == kPackets; }));
+        CHECK(handlerThread != std::this_thread::get_id());
+    }
+    CHECK(std::chrono::steady_clock::now() - sent < 2s);
+
+    driver.PollOnce();  // No-op while the thread owns the adapter
+    const auto stopStart = std::chrono::steady_clock::now();
+    driver.Stop();
+    CHECK(std::chrono::steady_clock::now() - stopStart < 1s);
+    CHECK(!driver.IsRunning());
+    CHECK(received.size() == kPackets);
+}
+
+// ============================================================================
+// Test Suite: Latency trace
+// ============================================================================
+
+TEST_CASE("LatencyHistogram: Percentiles stay within one sub-bucket") {
+    bcnp::LatencyHistogram histogram;
+    CHECK(histogram.Snapshot().count == 0);
+
+    for (uint64_t ns = 1; ns <= 10000; ++ns) {
+        histogram.Record(ns);
+    }
+    histogram.Record(3);
+
+    const bcnp::LatencyStageMetrics metrics = histogram.Snapshot();
+    CHECK(metrics.count == 10001);
+    CHECK(metrics.maxNs == 10000);
+    CHECK(metrics.meanNs == 5000);
+    const auto within = [](uint64_t reported, uint64_t exact) {
+        return reported >= exact && reported <= exact + exact / 8;
+    };
+    CHECK(within(metrics.p50Ns, 5000));
+    CHECK(within(metrics.p90Ns, 9000));
+    CHECK(within(metrics.p99Ns, 9900));
+    CHECK(metrics.p999Ns == 10000);  // Clamped to the recorded maximum
+
+    for (uint64_t ns : {0ull, 7ull, 8ull, 15ull, 16ull, 1000ull, 123456789ull}) {
+        const std::size_t index = bcnp::LatencyHistogram::BucketIndex(ns);
+        CHECK(bcnp::LatencyHistogram::BucketUpperBound(index) >= ns);
+        CHECK(bcnp::LatencyHistogram::BucketIndex(bcnp::LatencyHistogram::BucketUpperBound(index)) == index);
+    }
+    CHECK(bcnp::LatencyHistogram::BucketIndex(~0ull) == bcnp::LatencyHistogram::kBucketCount - 1);
+
+    histogram.Reset();
+    CHECK(histogram.Snapshot().count == 0);
+}
+
+#if BCNP_LATENCY_TRACE
+TEST_CASE("Latency trace: Records every stage per message type") {
+    bcnp::ResetLatencyMetrics();
+
+    bcnp::PacketDispatcher dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    bcnp::MessageQueue<bcnp::TestCmd> queue;
+    dispatcher.RegisterHandler<bcnp::TestCmd>([&](const bcnp::PacketView& pkt) {
+        for (auto it = pkt.begin_as<bcnp::TestCmd>(); it != pkt.end_as<bcnp::TestCmd>(); ++it) {
+            queue.Push(*it);
+        }
+    });
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    for (int i = 0; i < 3; ++i) {
+        packet.messages.push_back({static_cast<float>(i), 0.0f, 10});
+    }
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+
+    bcnp::trace::MarkReceive(bcnp::trace::Now());  // As an adapter's ReceiveChunk() would
+    dispatcher.PushBytes(encoded.data(), encoded.size());
+
+    auto now = bcnp::MessageQueue<bcnp::TestCmd>::Clock::time_point{} + 1000ms;
+    queue.NotifyReceived(now);
+    queue.Update(now);           // First command promoted
+    now += 500ms;
+    queue.NotifyReceived(now);
+    queue.Update(now);           // Remaining two are stale and skipped
+    REQUIRE(queue.GetMetrics().messagesSkipped == 2);
+
+    const bcnp::LatencyMetrics cmd = bcnp::GetLatencyMetrics(bcnp::TestCmd::kTypeId);
+    CHECK(cmd[bcnp::LatencyStage::Buffering].count == 1);
+    CHECK(cmd[bcnp::LatencyStage::Dispatch].count == 1);
+    CHECK(cmd[bcnp::LatencyStage::QueueWait].count == 1);
+    CHECK(cmd[bcnp::LatencyStage::LagSkip].count == 2);
+    CHECK(cmd[bcnp::LatencyStage::Receive].count == 0);  // Not tied to a type
+
+    const bcnp::LatencyMetrics all = bcnp::GetLatencyMetrics();
+    CHECK(all[bcnp::LatencyStage::Receive].count == 1);
+    CHECK(all[bcnp::LatencyStage::Dispatch].count == 1);
+    CHECK(all[bcnp::LatencyStage::QueueWait].maxNs >= all[bcnp::LatencyStage::QueueWait].p50Ns);
+    CHECK(bcnp::GetLatencyMetrics(uint16_t{5000})[bcnp::LatencyStage::Dispatch].count == 0);
+
+    bcnp::ResetLatencyMetrics();
+    CHECK(bcnp::GetLatencyMetrics()[bcnp::LatencyStage::Dispatch].count == 0);
+}
+#else
+TEST_CASE("Latency trace: Compiled out reports nothing") {
+    CHECK(!bcnp::kLatencyTraceEnabled);
+    CHECK(bcnp::GetLatencyMetrics()[bcnp::LatencyStage::Dispatch].count == 0);
+}
+#endif
+
+TEST_CASE("InplaceFunction: Copies, moves and resets inline callables") {
+    int calls = 0;
+    bcnp::InplaceFunction<int(int)> fn = [&calls](int value) { return value + ++calls; };
+    REQUIRE(static_cast<bool>(fn));
+    CHECK(fn(10) == 11);
+
+    auto copy = fn;
+    CHECK(copy(10) == 12);
+
+    bcnp::InplaceFunction<int(int)> moved = std::move(fn);
+    CHECK(!static_cast<bool>(fn));
+    CHECK(moved(10) == 13);
+
+    moved = nullptr;
+    CHECK(!static_cast<bool>(moved));
+    CHECK(copy(0) == 4);
+}
+
+TEST_CASE("FixedDispatcher: Receive path allocates nothing after setup") {
+    REQUIRE(bcnp::AllocationGuardInstalled());
+    bcnp::SetAllocationViolationHandler(&IgnoreAllocationViolation);
+
+    bcnp::FixedDispatcher<2, 256> dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    bcnp::MessageQueue<bcnp::TestCmd> queue;
+    CHECK(dispatcher.RegisterHandler<bcnp::TestCmd>([&queue](const bcnp::PacketView& pkt) {
+        for (auto it = pkt.begin_as<bcnp::TestCmd>(); it != pkt.end_as<bcnp::TestCmd>(); ++it) {
+            queue.Push(*it);
+        }
+        queue.NotifyReceived(bcnp::MessageQueue<bcnp::TestCmd>::Clock::now());
+    }));
+    CHECK(dispatcher.RegisterHandler(static_cast<bcnp::MessageTypeId>(500), [](const bcnp::PacketView&) {}));
+    CHECK(!dispatcher.RegisterHandler(static_cast<bcnp::MessageTypeId>(501), [](const bcnp::PacketView&) {}));
+    CHECK(dispatcher.Parser().Capacity() == 256);
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({1.0f, 2.0f, 50});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    const std::vector<uint8_t> garbage(7, 0xEE);
+
+    const uint64_t violationsBefore = bcnp::AllocationViolations();
+    {
+        bcnp::NoAllocationScope realtime;
+        for (int i = 0; i < 20; ++i) {
+            // Split frames exercise the ring copy path, garbage the resync path
+            dispatcher.PushBytes(encoded.data(), 5);
+            dispatcher.PushBytes(encoded.data() + 5, encoded.size() - 5);
+            if (i % 5 == 0) {
+                dispatcher.PushBytes(garbage.data(), garbage.size());
+            }
+        }
+        queue.Update(bcnp::MessageQueue<bcnp::TestCmd>::Clock::now());
+        dispatcher.UnregisterHandler(static_cast<bcnp::MessageTypeId>(500));
+    }
+    CHECK(bcnp::AllocationViolations() == violationsBefore);
+    CHECK(queue.ActiveMessage().is_some());
+    CHECK(dispatcher.HandlerCount() == 1);
+    CHECK(dispatcher.ParseErrorCount() > 0);
+
+    static int* volatile leaked = nullptr;
+    {
+        bcnp::NoAllocationScope realtime;
+        leaked = new int(42);
+    }
+    CHECK(bcnp::AllocationViolations() == violationsBefore + 1);
+    delete leaked;
+    bcnp::SetAllocationViolationHandler(nullptr);
+}
+
+TEST_CASE("LockedBuffer: Usable whether or not locking is permitted") {
+    bcnp::LockedBuffer buffer(10000);
+    REQUIRE(buffer.Data() != nullptr);
+    CHECK(buffer.Size() == 10000);
+    buffer.Data()[0] = 1;
+    buffer.Data()[buffer.Size() - 1] = 2;
+    CHECK(buffer.Data()[buffer.Size() - 1] == 2);
+    bcnp::PrefaultStack(16 * 1024);
+}
+
+TEST_CASE("Compressed encoding: EncoderData batch round trips through the dispatcher") {
+    bcnp::TypedPacket<bcnp::EncoderData> packet;
+    for (int32_t i = 0; i < 20; ++i) {
+        packet.messages.push_back({1, 1000 + i, -5 * i});
+    }
+    std::vector<uint8_t> fixed;
+    std::vector<uint8_t> compressed;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, fixed));
+    REQUIRE(bcnp::EncodeCompressedTypedPacket(packet, compressed));
+    CHECK(fixed.size() == 191);
+    CHECK(compressed.size() == 74);
+    CHECK(compressed.size() <= bcnp::MaxCompressedPacketSize<bcnp::EncoderData>(20));
+    // Same bytes as the generated Python encode_compressed_packet()
+    CHECK(compressed[bcnp::kHeaderFlagsIndex] == (bcnp::kFlagCompressed | bcnp::kFlagAcceptsCompressed));
+    CHECK(compressed[9] == 0x02);                 // moduleId 1 against zero
+    CHECK(compressed[10] == 0xD0);                // position 1000 zigzag = 2000 -> D0 0F
+    CHECK(compressed[11] == 0x0F);
+    CHECK(compressed[14] == 0x02);                // next position +1
+    CHECK(compressed[15] == 0x09);                // next velocity -5
+
+    bcnp::PacketDispatcher dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::EncoderData>();
+    std::vector<bcnp::EncoderData> received;
+    dispatcher.RegisterHandler<bcnp::EncoderData>([&](const bcnp::PacketView& pkt) {
+        CHECK((pkt.header.flags & bcnp::kFlagCompressed) == 0);
+        for (auto it = pkt.begin_as<bcnp::EncoderData>(); it != pkt.end_as<bcnp::EncoderData>(); ++it) {
+            received.push_back(*it);
+        }
+    });
+    CHECK(!dispatcher.PeerAcceptsCompressed());
+    // Byte at a time: the length prefix and payload straddle every push
+    for (uint8_t byte : compressed) {
+        dispatcher.PushBytes(&byte, 1);
+    }
+    dispatcher.PushBytes(compressed.data(), compressed.size());
+    REQUIRE(received.size() == 40);
+    for (std::size_t i = 0; i < received.size(); ++i) {
+        const auto& expected = packet.messages[i % 20];
+        CHECK(received[i].moduleId == expected.moduleId);
+        CHECK(received[i].position == expected.position);
+        CHECK(received[i].velocity == expected.velocity);
+    }
+    CHECK(dispatcher.PeerAcceptsCompressed());
+    CHECK(dispatcher.Parser().CompressedFrameCount() == 2);
+    CHECK(dispatcher.ParseErrorCount() == 0);
+
+    // Deltas wrap at the field width: INT32_MAX -> INT32_MIN costs one byte
+    bcnp::TypedPacket<bcnp::EncoderData> wrap;
+    wrap.messages.push_back({0, std::numeric_limits<int32_t>::max(), 0});
+    wrap.messages.push_back({0, std::numeric_limits<int32_t>::min(), 0});
+    REQUIRE(bcnp::EncodeCompressedTypedPacket(wrap, compressed));
+    received.clear();
+    dispatcher.PushBytes(compressed.data(), compressed.size());
+    REQUIRE(received.size() == 2);
+    CHECK(received[1].position == std::numeric_limits<int32_t>::min());
+}
+
+
+TEST_CASE("DispatcherDriver: Advertises compressed decoding on uncompressed sends") {
+    bcnp::PacketDispatcher local;
+    ScriptedAdapter adapter;
+    bcnp::DispatcherDriver driver(local, adapter);
+    bcnp::PacketDispatcher peer;
+    peer.RegisterMessageTypes<bcnp::EncoderData>();
+
+    bcnp::TypedPacket<bcnp::EncoderData> packet;
+    packet.messages.push_back({1, 1000, 10});
+    REQUIRE(driver.SendPacket(packet));
+    peer.PushBytes(adapter.sent.data(), adapter.sent.size());
+    CHECK(!peer.PeerAcceptsCompressed());
+
+    driver.SetAdvertiseCompressed(true);
+    adapter.sent.clear();
+    REQUIRE(driver.SendPacket(packet));
+    CHECK(adapter.sent[bcnp::kHeaderFlagsIndex] == bcnp::kFlagAcceptsCompressed);
+    peer.PushBytes(adapter.sent.data(), adapter.sent.size());
+    CHECK(peer.PeerAcceptsCompressed());
+    CHECK(peer.ParseErrorCount() == 0);
+}
+
+TEST_CASE("Compressed encoding: Malformed frames are rejected and the stream recovers") {
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({1.0f, 2.0f, 50});
+    packet.messages.push_back({1.5f, 2.0f, 60});
+    std::vector<uint8_t> compressed;
+    std::vector<uint8_t> fixed;
+    REQUIRE(bcnp::EncodeCompressedTypedPacket(packet, compressed));
+    REQUIRE(bcnp::EncodeTypedPacket(packet, fixed));
+
+    // Trailing payload byte with a valid CRC
+    std::vector<uint8_t> trailing(compressed.begin(), compressed.end() - bcnp::kChecksumSize);
+    trailing.push_back(0x00);
+    trailing[bcnp::kHeaderSizeV3 + 1] = static_cast<uint8_t>(trailing[bcnp::kHeaderSizeV3 + 1] + 1);
+    const uint32_t crc = bcnp::ComputeCrc32(trailing.data(), trailing.size());
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        trailing.push_back(static_cast<uint8_t>(crc >> shift));
+    }
+    std::vector<uint8_t> corrupted = compressed;
+    corrupted[bcnp::kHeaderSizeV3 + bcnp::kCompressedLengthSize] ^= 0x01;
+
+    std::vector<bcnp::PacketError> errors;
+    int packets = 0;
+    bcnp::StreamParser parser(
+        [&](const bcnp::PacketView& pkt) {
+            ++packets;
+            CHECK(pkt.header.messageCount == 2);
+        },
+        [&](const bcnp::StreamParser::ErrorInfo& info) { errors.push_back(info.code); });
+    parser.SetWireSizeFunction(&TestWireSizeLookup);
+    parser.SetFieldLayoutFunction(&bcnp::FieldLayoutFor<bcnp::TestCmd>);
+
+    parser.Push(trailing.data(), trailing.size());
+    parser.Push(corrupted.data(), corrupted.size());
+    parser.Push(fixed.data(), fixed.size());
+    parser.Push(compressed.data(), compressed.size());
+    CHECK(packets == 2);
+    REQUIRE(!errors.empty());
+    CHECK(errors.front() == bcnp::PacketError::InvalidCompression);
+    CHECK(std::find(errors.begin(), errors.end(), bcnp::PacketError::ChecksumMismatch) != errors.end());
+
+    // Without a field layout the frame is skipped, not misparsed
+    errors.clear();
+    packets = 0;
+    parser.Reset();
+    parser.SetFieldLayoutFunction([](bcnp::MessageTypeId) { return bcnp::FieldLayout{}; });
+    parser.Push(compressed.data(), compressed.size());
+    parser.Push(fixed.data(), fixed.size());
+    CHECK(packets == 1);
+    CHECK(errors == std::vector<bcnp::PacketError>{bcnp::PacketError::InvalidCompression});
+    CHECK(parser.PeerAcceptsCompressed() == false);
+}
+
+TEST_CASE("MultiStreamDispatcher: Streams parse concurrently with per-stream state") {
+    bcnp::MultiStreamDispatcher dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    const auto control = dispatcher.AddStream();
+    const auto telemetry = dispatcher.AddStream();
+    REQUIRE(dispatcher.StreamCount() == 2);
+
+    std::mutex seenMutex;
+    std::array<std::vector<uint16_t>, 2> seen;
+    dispatcher.RegisterHandler<bcnp::TestCmd>([&](const bcnp::PacketView& pkt, bcnp::MultiStreamDispatcher::StreamId stream) {
+        std::lock_guard<std::mutex> lock(seenMutex);
+        for (auto it = pkt.begin_as<bcnp::TestCmd>(); it != pkt.end_as<bcnp::TestCmd>(); ++it) {
+            seen[stream].push_back((*it).durationMs);
+        }
+    });
+    std::atomic<int> errors{0};
+    dispatcher.SetErrorHandler([&](bcnp::MultiStreamDispatcher::StreamId stream, const bcnp::StreamParser::ErrorInfo&) {
+        CHECK(stream == telemetry);
+        ++errors;
+    });
+
+    constexpr int kPackets = 200;
+    auto feed = [&](bcnp::MultiStreamDispatcher::StreamId id, bool injectGarbage) {
+        auto& stream = dispatcher.GetStream(id);
+        const std::vector<uint8_t> garbage(9, 0xEE);
+        for (int i = 0; i < kPackets; ++i) {
+            bcnp::TypedPacket<bcnp::TestCmd> packet;
+            packet.messages.push_back({0.0f, 0.0f, static_cast<uint16_t>(i)});
+            std::vector<uint8_t> encoded;
+            REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+            // Split every frame so a partial frame sits in each parser while the other runs
+            stream.PushBytes(encoded.data(), 3);
+            stream.PushBytes(encoded.data() + 3, encoded.size() - 3);
+            if (injectGarbage && i == 50) {
+                stream.PushBytes(garbage.data(), garbage.size());
+            }
+        }
+    };
+    std::thread controlThread(feed, control, false);
+    std::thread telemetryThread(feed, telemetry, true);
+    controlThread.join();
+    telemetryThread.join();
+
+    for (const auto& values : seen) {
+        REQUIRE(values.size() == kPackets);
+        for (int i = 0; i < kPackets; ++i) {
+            CHECK(values[i] == i);
+        }
+    }
+    CHECK(errors.load() > 0);
+    CHECK(dispatcher.GetStream(control).ParseErrorCount() == 0);
+    CHECK(dispatcher.GetStream(telemetry).ParseErrorCount() == static_cast<uint64_t>(errors.load()));
+    CHECK(dispatcher.ParseErrorCount() == static_cast<uint64_t>(errors.load()));
+
+    const auto now = bcnp::MultiStreamDispatcher::Clock::now();
+    CHECK(dispatcher.GetStream(control).IsConnected(now));
+    CHECK(dispatcher.IsConnected(now));
+    const auto idle = dispatcher.AddStream();
+    CHECK(!dispatcher.GetStream(idle).IsConnected(now));
+    CHECK(dispatcher.LastReceiveTime() == std::max(dispatcher.GetStream(control).LastReceiveTime(),
+                                                   dispatcher.GetStream(telemetry).LastReceiveTime()));
+    CHECK(!dispatcher.IsConnected(now + 1s));
+}
+
+TEST_CASE("MultiStreamDispatcher: Executor-bound handlers run off the parsing thread in order") {
+    bcnp::MultiStreamDispatcherConfig config;
+    config.executorQueueDepth = 4;
+    bcnp::MultiStreamDispatcher dispatcher(config);
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    const auto stream = dispatcher.AddStream();
+    const auto executor = dispatcher.AddExecutor();
+    CHECK_THROWS_AS(dispatcher.RegisterHandler<bcnp::TestCmd>({}, executor + 1), std::out_of_range);
+
+    std::vector<uint16_t> order;
+    std::thread::id handlerThread;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    dispatcher.RegisterHandler<bcnp::TestCmd>([&](const bcnp::PacketView& pkt, bcnp::MultiStreamDispatcher::StreamId id) {
+        entered = true;
+        while (!release.load()) {   // Holds the executor in its first handler call
+            std::this_thread::yield();
+        }
+        CHECK(id == stream);
+        handlerThread = std::this_thread::get_id();
+        order.push_back((*pkt.begin_as<bcnp::TestCmd>()).durationMs);
+    }, executor);
+
+    auto push = [&](uint16_t value) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({0.0f, 0.0f, value});
+        std::vector<uint8_t> encoded;
+        REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+        dispatcher.GetStream(stream).PushBytes(encoded.data(), encoded.size());
+    };
+
+    // One packet is taken by the blocked executor, four fill its queue, the rest drop
+    push(0);
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+    for (uint16_t value = 1; value < 10; ++value) {
+        push(value);
+    }
+    release = true;
+    dispatcher.Stop();
+
+    const auto metrics = dispatcher.GetExecutorMetrics(executor);
+    CHECK(metrics.executed == 5);
+    CHECK(metrics.dropped == 5);
+    CHECK(order == std::vector<uint16_t>{0, 1, 2, 3, 4});
+    CHECK(handlerThread != std::this_thread::get_id());
+    CHECK(dispatcher.Arena().GetMetrics().blocksInUse == 0);
+}
+
+TEST_CASE("MultiStreamDispatcher: Queued packets keep the handler they were routed to") {
+    bcnp::MultiStreamDispatcher dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    const auto stream = dispatcher.AddStream();
+    const auto executor = dispatcher.AddExecutor();
+
+    std::vector<uint16_t> deferred;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    dispatcher.RegisterHandler<bcnp::TestCmd>([&](const bcnp::PacketView& pkt, bcnp::MultiStreamDispatcher::StreamId) {
+        entered = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+        deferred.push_back((*pkt.begin_as<bcnp::TestCmd>()).durationMs);
+    }, executor);
+
+    auto push = [&](uint16_t value) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({0.0f, 0.0f, value});
+        std::vector<uint8_t> encoded;
+        REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+        dispatcher.GetStream(stream).PushBytes(encoded.data(), encoded.size());
+    };
+    push(0);
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+    push(1);   // Queued behind the blocked handler
+
+    // Registration does not wait for the running handler, and the queued
+    // packet is not handed to the inline replacement on the executor thread
+    std::vector<std::pair<uint16_t, std::thread::id>> inlineCalls;
+    dispatcher.RegisterHandler<bcnp::TestCmd>([&](const bcnp::PacketView& pkt, bcnp::MultiStreamDispatcher::StreamId) {
+        inlineCalls.emplace_back((*pkt.begin_as<bcnp::TestCmd>()).durationMs, std::this_thread::get_id());
+    });
+    release = true;
+    dispatcher.Stop();
+    CHECK(deferred == std::vector<uint16_t>{0});
+    CHECK(inlineCalls.empty());
+    CHECK(dispatcher.GetExecutorMetrics(executor).executed == 2);
+
+    push(2);
+    REQUIRE(inlineCalls.size() == 1);
+    CHECK(inlineCalls[0] == std::make_pair(uint16_t{2}, std::this_thread::get_id()));
+}
+
+TEST_CASE("Metrics: Parser and queue counters agree with their own statistics") {
+    bcnp::MetricsRegistry metrics;
+    bcnp::PacketDispatcher dispatcher;
+    dispatcher.RegisterMessageTypes<bcnp::TestCmd>();
+    dispatcher.SetMetrics(&metrics);
+    bcnp::MessageQueueConfig config;
+    config.capacity = 4;
+    bcnp::MessageQueue<bcnp::TestCmd> queue(config);
+    queue.SetMetricsRegistry(&metrics);
+    dispatcher.RegisterHandler<bcnp::TestCmd>([&](const bcnp::PacketView& pkt) {
+        for (auto it = pkt.begin_as<bcnp::TestCmd>(); it != pkt.end_as<bcnp::TestCmd>(); ++it) {
+            queue.Push(*it);
+        }
+    });
+
+    // A reader snapshotting throughout must never block or race the writer
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        uint64_t lastFrames = 0;
+        while (!done.load()) {
+            const bcnp::MetricsSnapshot snapshot = metrics.Snapshot();
+            CHECK(snapshot[bcnp::Metric::ParserFrames] >= lastFrames);
+            lastFrames = snapshot[bcnp::Metric::ParserFrames];
+        }
+    });
+
+    constexpr int kPackets = 6;
+    const std::vector<uint8_t> garbage(9, 0xEE);
+    std::size_t pushed = 0;
+    for (int i = 0; i < kPackets; ++i) {
+        bcnp::TypedPacket<bcnp::TestCmd> packet;
+        packet.messages.push_back({0.0f, 0.0f, 10});
+        std::vector<uint8_t> encoded;
+        REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+        dispatcher.PushBytes(encoded.data(), encoded.size());
+        pushed += encoded.size();
+        if (i == 2) {
+            dispatcher.PushBytes(garbage.data(), garbage.size());
+            pushed += garbage.size();
+        }
+    }
+    done = true;
+    reader.join();
+
+    const bcnp::MetricsSnapshot snapshot = metrics.Snapshot();
+    CHECK(snapshot[bcnp::Metric::ParserBytes] == pushed);
+    CHECK(snapshot[bcnp::Metric::ParserFrames] == kPackets);
+    CHECK(snapshot.Packets(static_cast<uint16_t>(bcnp::TestCmd::kTypeId)) == kPackets);
+    CHECK(snapshot.packetsOtherTypes == 0);
+    CHECK(snapshot[bcnp::Metric::ParserErrors] == dispatcher.ParseErrorCount());
+    CHECK(snapshot[bcnp::Metric::ParserErrors] > 0);
+    CHECK(snapshot[bcnp::Metric::ParserResyncBytes] == dispatcher.Parser().BytesSkipped());
+    CHECK(snapshot[bcnp::Metric::QueueDepth] == 4);
+    CHECK(snapshot[bcnp::Metric::QueueHighWater] == 4);
+    CHECK(snapshot[bcnp::Metric::QueueOverflows] == queue.GetMetrics().queueOverflows);
+    CHECK(snapshot[bcnp::Metric::QueueOverflows] == 2);
+
+    auto now = bcnp::MessageQueue<bcnp::TestCmd>::Clock::time_point{} + 1000ms;
+    queue.NotifyReceived(now);
+    queue.Update(now);
+    now += 500ms;
+    queue.NotifyReceived(now);
+    queue.Update(now);           // Remaining three are stale
+    CHECK(metrics.Get(bcnp::Metric::QueueLagSkips) == 3);
+    CHECK(metrics.Get(bcnp::Metric::QueueDepth) == 0);
+    CHECK(metrics.Get(bcnp::Metric::QueueHighWater) == 4);
+
+    metrics.Reset();
+    CHECK(metrics.Snapshot()[bcnp::Metric::ParserBytes] == 0);
+    CHECK(metrics.Snapshot().Packets(static_cast<uint16_t>(bcnp::TestCmd::kTypeId)) == 0);
+}
+
+namespace {
+struct MetricSampleForTest {
+    uint16_t metricId{0};
+    uint32_t value{0};
+};
+} // namespace
+
+TEST_CASE("Metrics: TCP adapter counters and the periodic exporter") {
+    bcnp::MetricsRegistry serverMetrics;
+    bcnp::MetricsRegistry clientMetrics;
+    bcnp::TcpPosixAdapter server(12420);
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", 12420);
+    REQUIRE(server.IsValid());
+    server.SetMetrics(&serverMetrics);
+    client.SetMetrics(&clientMetrics);
+    server.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    REQUIRE(ConnectTcpPair(server, client));
+
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    packet.messages.push_back({1.0f, 2.0f, 10});
+    std::vector<uint8_t> encoded;
+    REQUIRE(bcnp::EncodeTypedPacket(packet, encoded));
+    REQUIRE(client.SendBytes(encoded.data(), encoded.size()));
+
+    std::vector<uint8_t> rx(1024);
+    std::size_t received = 0;
+    for (int i = 0; i < 100 && received < encoded.size(); ++i) {
+        received += server.ReceiveChunk(rx.data(), rx.size());
+        if (received < encoded.size()) {
+            std::this_thread::sleep_for(5ms);
+        }
+    }
+    REQUIRE(received == encoded.size());
+
+    const bcnp::MetricsSnapshot serverSnapshot = serverMetrics.Snapshot();
+    const bcnp::MetricsSnapshot clientSnapshot = clientMetrics.Snapshot();
+    CHECK(serverSnapshot[bcnp::Metric::Connects] == 1);
+    CHECK(clientSnapshot[bcnp::Metric::Connects] == 1);
+    CHECK(serverSnapshot[bcnp::Metric::RxBytes] == encoded.size());  // Handshake bytes are not returned
+    CHECK(clientSnapshot[bcnp::Metric::TxBytes] == encoded.size() + bcnp::kHandshakeSize);
+    CHECK(clientSnapshot[bcnp::Metric::TxDrops] == 0);
+    CHECK(clientSnapshot[bcnp::Metric::TxQueuedBytes] == 0);
+
+    bcnp::MetricsExporter exporter(clientMetrics, std::chrono::seconds(1));
+    const auto start = bcnp::MetricsExporter::Clock::time_point{} + 10s;
+    std::string text;
+    REQUIRE(exporter.MaybeFormatText(start, text));
+    CHECK(text.find("# TYPE bcnp_tx_bytes_total counter\n") != std::string::npos);
+    CHECK(text.find("bcnp_tx_bytes_total " + std::to_string(encoded.size() + bcnp::kHandshakeSize) + "\n") !=
+          std::string::npos);
+    CHECK(text.find("bcnp_tx_queued_high_water ") != std::string::npos);
+    CHECK(text.find("bcnp_packets_total{") == std::string::npos);  // No packets parsed on this registry
+    CHECK(!exporter.MaybeFormatText(start + 500ms, text));
+    CHECK(exporter.ExportCount() == 1);
+
+    bcnp::MetricsSnapshot snapshot;
+    REQUIRE(exporter.Poll(start + 1s, snapshot));
+    std::vector<MetricSampleForTest> samples;
+    snapshot.packetsByType[3] = 7;
+    snapshot.packetsOtherTypes = 2;
+    CHECK(bcnp::AppendMetricSamples<MetricSampleForTest>(snapshot, samples) == bcnp::kMetricCount + 2);
+    REQUIRE(samples.size() == bcnp::kMetricCount + 2);
+    CHECK(samples[static_cast<std::size_t>(bcnp::Metric::Connects)].value == 1);
+    CHECK(samples[bcnp::kMetricCount].metricId == bcnp::kMetricPacketsIdBase + 3);
+    CHECK(samples[bcnp::kMetricCount].value == 7);
+    CHECK(samples.back().metricId == bcnp::kMetricPacketsOtherId);
+}
+
+namespace {
+std::vector<uint8_t> EncodeTestCmds(std::size_t count, uint16_t durationMs) {
+    bcnp::TypedPacket<bcnp::TestCmd> packet;
+    for (std::size_t i = 0; i < count; ++i) {
+        packet.messages.push_back({1.0f, 2.0f, durationMs});
+    }
+    std::vector<uint8_t> encoded;
+    bcnp::EncodeTypedPacket(packet, encoded);
+    return encoded;
+}
+
+// Send and consume everything the scheduler hands out at @p now
+std::vector<uint8_t> DrainScheduler(bcnp::TxScheduler& scheduler, bcnp::TxScheduler::Clock::time_point now,
+                                    std::size_t maxBytes = std::numeric_limits<std::size_t>::max()) {
+    std::vector<uint8_t> wire;
+    bcnp::ByteSpan spans[8];
+    const std::size_t count = scheduler.Gather(spans, 8, now);
+    for (std::size_t i = 0; i < count && wire.size() < maxBytes; ++i) {
+        const std::size_t take = std::min(spans[i].length, maxBytes - wire.size());
+        wire.insert(wire.end(), spans[i].data, spans[i].data + take);
+    }
+    scheduler.Consume(wire.size(), now);
+    return wire;
+}
+} // namespace
+
+TEST_CASE("TxScheduler: Lane order, started packets, eviction and the bulk rate limit") {
+    using Clock = bcnp::TxScheduler::Clock;
+    const auto t0 = Clock::now();
+    const std::vector<uint8_t> bulk1 = EncodeTestCmds(4, 1);
+    const std::vector<uint8_t> bulk2 = EncodeTestCmds(4, 2);
+    const std::vector<uint8_t> telemetry = EncodeTestCmds(1, 3);
+    const std::vector<uint8_t> control = EncodeTestCmds(1, 4);
+    std::vector<uint8_t> bulkBoth = bulk1;
+    bulkBoth.insert(bulkBoth.end(), bulk2.begin(), bulk2.end());
+    const auto concat = [](std::initializer_list<const std::vector<uint8_t>*> parts) {
+        std::vector<uint8_t> out;
+        for (const auto* part : parts) {
+            out.insert(out.end(), part->begin(), part->end());
+        }
+        return out;
+    };
+
+    SUBCASE("Higher lanes first, and a started packet finishes before a lane switch") {
+        bcnp::TxScheduler scheduler;
+        scheduler.SetWireSizeFunction(TestWireSizeLookup);
+        const bcnp::ByteSpan bulkSpan{bulkBoth.data(), bulkBoth.size()};
+        const bcnp::ByteSpan telemetrySpan{telemetry.data(), telemetry.size()};
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Bulk, bulkBoth.size()));
+        scheduler.Append(bcnp::TxPriority::Bulk, &bulkSpan, 1, t0);
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Telemetry, telemetry.size()));
+        scheduler.Append(bcnp::TxPriority::Telemetry, &telemetrySpan, 1, t0);
+        CHECK(scheduler.GetLaneMetrics(bcnp::TxPriority::Bulk).queuedUnits == 2);   // Split per packet
+
+        // The kernel takes the telemetry packet and half of the first bulk packet
+        std::vector<uint8_t> wire = DrainScheduler(scheduler, t0, telemetry.size() + bulk1.size() / 2);
+        CHECK(wire.size() == telemetry.size() + bulk1.size() / 2);
+        const bcnp::ByteSpan controlSpan{control.data(), control.size()};
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Control, control.size()));
+        scheduler.Append(bcnp::TxPriority::Control, &controlSpan, 1, t0);
+
+        const std::vector<uint8_t> rest = DrainScheduler(scheduler, t0 + 5ms);
+        wire.insert(wire.end(), rest.begin(), rest.end());
+        CHECK(wire == concat({&telemetry, &bulk1, &control, &bulk2}));
+        CHECK(scheduler.Empty());
+
+        const bcnp::TxLaneMetrics controlMetrics = scheduler.GetLaneMetrics(bcnp::TxPriority::Control);
+        CHECK(controlMetrics.unitsSent == 1);
+        CHECK(controlMetrics.lastDelayNs == static_cast<uint64_t>(std::chrono::nanoseconds(5ms).count()));
+        CHECK(scheduler.GetLaneMetrics(bcnp::TxPriority::Bulk).unitsSent == 2);
+    }
+
+    SUBCASE("A full buffer evicts the newest lower-priority packets") {
+        bcnp::MetricsRegistry metrics;
+        bcnp::TxSchedulerConfig config;
+        config.capacity = bulkBoth.size() + control.size() / 2;
+        config.congestionThreshold = config.capacity;
+        bcnp::TxScheduler scheduler(config);
+        scheduler.SetWireSizeFunction(TestWireSizeLookup);
+        scheduler.SetMetrics(&metrics);
+        const bcnp::ByteSpan bulkSpan{bulkBoth.data(), bulkBoth.size()};
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Bulk, bulkBoth.size()));
+        scheduler.Append(bcnp::TxPriority::Bulk, &bulkSpan, 1, t0);
+
+        // Bulk never evicts bulk, and telemetry cannot fit twice the buffer
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Bulk, control.size()));
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Telemetry, config.capacity + 1));
+
+        const bcnp::ByteSpan controlSpan{control.data(), control.size()};
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Control, control.size()));
+        scheduler.Append(bcnp::TxPriority::Control, &controlSpan, 1, t0);
+        const bcnp::TxLaneMetrics bulkMetrics = scheduler.GetLaneMetrics(bcnp::TxPriority::Bulk);
+        CHECK(bulkMetrics.unitsEvicted == 1);
+        CHECK(bulkMetrics.bytesEvicted == bulk2.size());
+        CHECK(bulkMetrics.unitsRejected == 1);
+        CHECK(metrics.Get(bcnp::Metric::TxEvictions) == 1);
+        CHECK(DrainScheduler(scheduler, t0) == concat({&control, &bulk1}));
+    }
+
+    SUBCASE("The token bucket releases whole bulk packets at the configured rate") {
+        bcnp::TxScheduler scheduler;
+        scheduler.SetWireSizeFunction(TestWireSizeLookup);
+        scheduler.SetBulkRateLimit(bulk1.size() * 10, bulk1.size());   // 10 packets per second
+        CHECK_FALSE(scheduler.MayWriteDirect(bcnp::TxPriority::Bulk));
+        CHECK(scheduler.MayWriteDirect(bcnp::TxPriority::Control));
+        const bcnp::ByteSpan bulkSpan{bulkBoth.data(), bulkBoth.size()};
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Bulk, bulkBoth.size()));
+        scheduler.Append(bcnp::TxPriority::Bulk, &bulkSpan, 1, t0);
+
+        CHECK(DrainScheduler(scheduler, t0) == bulk1);
+        CHECK(DrainScheduler(scheduler, t0 + 50ms).empty());
+        CHECK(DrainScheduler(scheduler, t0 + 100ms) == bulk2);
+        CHECK(scheduler.Empty());
+    }
+
+    SUBCASE("Lanes are sized for the threshold plus one append and wrap in place") {
+        bcnp::TxSchedulerConfig config;
+        config.capacity = 4096;
+        config.congestionThreshold = 2 * control.size();
+        config.maxAppendBytes = control.size();
+        bcnp::TxScheduler scheduler(config);
+        CHECK(scheduler.MaxAppendBytes() == control.size());
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Control, control.size() + 1));
+        CHECK(scheduler.ReserveTail(bcnp::TxPriority::Control).length == control.size());
+
+        const std::vector<uint8_t> other = EncodeTestCmds(1, 5);
+        const bcnp::ByteSpan controlSpan{control.data(), control.size()};
+        const bcnp::ByteSpan otherSpan{other.data(), other.size()};
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(scheduler.Admit(bcnp::TxPriority::Control, control.size()));
+            scheduler.Append(bcnp::TxPriority::Control, &controlSpan, 1, t0);
+        }
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Control, control.size()));   // Congested; the ring is full too
+
+        // Sending part of the head frees room at the front; the next unit wraps
+        std::vector<uint8_t> wire = DrainScheduler(scheduler, t0, control.size() + 3);
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Control, other.size()));
+        scheduler.Append(bcnp::TxPriority::Control, &otherSpan, 1, t0);
+        const std::vector<uint8_t> rest = DrainScheduler(scheduler, t0);
+        wire.insert(wire.end(), rest.begin(), rest.end());
+        CHECK(wire == concat({&control, &control, &control, &other}));
+        CHECK(scheduler.Empty());
+    }
+
+    SUBCASE("A held tail is neither overwritten nor evicted and fails its commit once cleared") {
+        bcnp::TxSchedulerConfig config;
+        config.capacity = 3 * control.size();
+        config.congestionThreshold = config.capacity;
+        config.maxAppendBytes = control.size();
+        bcnp::TxScheduler scheduler(config);
+        const bcnp::ByteSpan controlSpan{control.data(), control.size()};
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Bulk, control.size()));
+        scheduler.Append(bcnp::TxPriority::Bulk, &controlSpan, 1, t0);
+
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Bulk, control.size()));
+        const bcnp::MutableByteSpan tail = scheduler.ReserveTail(bcnp::TxPriority::Bulk);
+        REQUIRE(tail.length >= control.size());
+        scheduler.HoldTail(bcnp::TxPriority::Bulk, control.size());
+        std::memcpy(tail.data, control.data(), control.size());
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Bulk, control.size()));   // Held lane takes nothing else
+
+        // The held bytes count against the budget, and the held lane cannot be evicted for them
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Control, control.size()));
+        scheduler.Append(bcnp::TxPriority::Control, &controlSpan, 1, t0);
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Control, control.size()));
+        CHECK(scheduler.CommitTail(bcnp::TxPriority::Bulk, control.size(), t0));
+        CHECK(DrainScheduler(scheduler, t0) == concat({&control, &control, &control}));
+
+        scheduler.HoldTail(bcnp::TxPriority::Bulk, control.size());
+        scheduler.Clear();
+        CHECK_FALSE(scheduler.CommitTail(bcnp::TxPriority::Bulk, control.size(), t0));
+        CHECK(scheduler.Empty());
+    }
+
+    SUBCASE("A frame sent in pieces holds the wire from its first byte to its last") {
+        bcnp::TxScheduler scheduler;
+        scheduler.SetWireSizeFunction(TestWireSizeLookup);
+        const std::vector<uint8_t> frame = EncodeTestCmds(40, 6);
+        const bcnp::ByteSpan pieces[3] = {{frame.data(), 150},
+                                          {frame.data() + 150, 150},
+                                          {frame.data() + 300, frame.size() - 300}};
+        const bcnp::ByteSpan controlSpan{control.data(), control.size()};
+        const bcnp::ByteSpan telemetrySpan{telemetry.data(), telemetry.size()};
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Bulk, 150, bcnp::FramePart::Continue));
+
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Bulk, 150, bcnp::FramePart::Begin));
+        scheduler.Append(bcnp::TxPriority::Bulk, &pieces[0], 1, t0, 0, bcnp::FramePart::Begin);
+        CHECK(scheduler.FrameInProgress());
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Bulk, bulk1.size()));   // Would land inside the frame
+        CHECK_FALSE(scheduler.Admit(bcnp::TxPriority::Telemetry, 150, bcnp::FramePart::Begin));
+
+        // Queued ahead of the frame: telemetry still goes first
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Telemetry, telemetry.size()));
+        scheduler.Append(bcnp::TxPriority::Telemetry, &telemetrySpan, 1, t0);
+        std::vector<uint8_t> wire = DrainScheduler(scheduler, t0, telemetry.size() + 10);
+
+        // The frame is on the wire: control waits until its last piece is sent
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Control, control.size()));
+        scheduler.Append(bcnp::TxPriority::Control, &controlSpan, 1, t0);
+        CHECK_FALSE(scheduler.MayWriteDirect(bcnp::TxPriority::Control));
+        std::vector<uint8_t> more = DrainScheduler(scheduler, t0);
+        wire.insert(wire.end(), more.begin(), more.end());
+        CHECK(wire.size() == telemetry.size() + 150);
+        CHECK(DrainScheduler(scheduler, t0).empty());
+
+        CHECK_FALSE(scheduler.MayWriteDirect(bcnp::TxPriority::Bulk));   // Control is queued
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Bulk, 150, bcnp::FramePart::Continue));
+        scheduler.Append(bcnp::TxPriority::Bulk, &pieces[1], 1, t0, 0, bcnp::FramePart::Continue);
+        REQUIRE(scheduler.Admit(bcnp::TxPriority::Bulk, pieces[2].length, bcnp::FramePart::End));
+        scheduler.Append(bcnp::TxPriority::Bulk, &pieces[2], 1, t0, 0, bcnp::FramePart::End);
+        CHECK(scheduler.Admit(bcnp::TxPriority::Bulk, bulk1.size()));   // After the End piece is fine
+        more = DrainScheduler(scheduler, t0, 200);
+        wire.insert(wire.end(), more.begin(), more.end());
+        for (int guard = 0; guard < 10 && !scheduler.Empty(); ++guard) {
+            more = DrainScheduler(scheduler, t0);
+            wire.insert(wire.end(), more.begin(), more.end());
+        }
+        CHECK(wire == concat({&telemetry, &frame, &control}));
+        CHECK_FALSE(scheduler.FrameInProgress());
+        CHECK(scheduler.GetLaneMetrics(bcnp::TxPriority::Bulk).unitsSent == 3);
+    }
+}
+
+TEST_CASE("TCP adapter: Control packets overtake rate-limited bulk data") {
+    bcnp::MetricsRegistry metrics;
+    bcnp::TcpPosixAdapter server(12421);
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", 12421);
+    REQUIRE(server.IsValid());
+    server.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    client.SetWireSizeFunction(TestWireSizeLookup);
+    client.SetMetrics(&metrics);
+    REQUIRE(ConnectTcpPair(server, client));
+
+    const std::vector<uint8_t> control = EncodeTestCmds(1, 100);
+    bcnp::TypedPacket<bcnp::TestCmd> bulkPacket;
+    bulkPacket.messages.assign(8, bcnp::TestCmd{0.0f, 0.0f, 7});
+    const std::size_t bulkSize = bcnp::EncodedPacketSize(bulkPacket);
+    client.SetBulkRateLimit(bulkSize * 20, bulkSize);   // 20 packets per second, one at a time
+
+    auto bulk = client.Lane(bcnp::TxPriority::Bulk);
+    std::vector<uint8_t> scratch;
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(bcnp::SendTypedPacket(bulk, bulkPacket, scratch));
+    }
+    REQUIRE(client.SendBytes(control.data(), control.size()));
+
+    const std::size_t expected = 3 * bulkSize + control.size();
+    std::vector<uint8_t> wire;
+    std::vector<uint8_t> rx(4096);
+    for (int i = 0; i < 200 && wire.size() < expected; ++i) {
+        client.ReceiveChunk(rx.data(), rx.size());   // Flushes whatever the bucket allows
+        const std::size_t received = server.ReceiveChunk(rx.data(), rx.size());
+        wire.insert(wire.end(), rx.begin(), rx.begin() + static_cast<std::ptrdiff_t>(received));
+        std::this_thread::sleep_for(5ms);
+    }
+    REQUIRE(wire.size() == expected);
+
+    // The first bulk packet had the tokens; the control packet went straight after it
+    CHECK(std::equal(control.begin(), control.end(), wire.begin() + static_cast<std::ptrdiff_t>(bulkSize)));
+    const bcnp::TxLaneMetrics bulkMetrics = client.GetTxLaneMetrics(bcnp::TxPriority::Bulk);
+    CHECK(bulkMetrics.unitsSent == 3);
+    CHECK(bulkMetrics.maxDelayNs >= static_cast<uint64_t>(std::chrono::nanoseconds(50ms).count()));
+    CHECK(client.GetTxLaneMetrics(bcnp::TxPriority::Control).unitsSent >= 2);   // Handshake and packet
+    CHECK(metrics.Get(bcnp::Metric::TxBulkDelayMaxUs) == bulkMetrics.maxDelayNs / 1000);
+}
+
+namespace {
+// Collects sends; refuses the next `refusals` of them
+class FlakyWriter : public bcnp::ByteWriter {
+public:
+    bool SendBytes(const uint8_t* data, std::size_t length) override {
+        ++sends;
+        if (refusals > 0) {
+            --refusals;
+            return false;
+        }
+        bytes.insert(bytes.end(), data, data + length);
+        return true;
+    }
+
+    std::vector<uint8_t> bytes;
+    int refusals{0};
+    int sends{0};
+};
+} // namespace
+
+TEST_CASE("Streaming: Batches larger than the parser buffer arrive in chunks with an incremental CRC") {
+    constexpr std::size_t kBatch = 2000;
+    std::vector<bcnp::TestCmd> commands(kBatch);
+    for (std::size_t i = 0; i < kBatch; ++i) {
+        commands[i] = {static_cast<float>(i), -1.0f, static_cast<uint16_t>(i)};
+    }
+
+    // Chunked encoding matches the one-shot encoder byte for byte, even across refused sends
+    FlakyWriter writer;
+    bcnp::ChunkedPacketWriter<bcnp::TestCmd, 256> upload(writer, kBatch, bcnp::kFlagClearQueue);
+    REQUIRE(upload.IsValid());
+    std::size_t written = 0;
+    for (int attempt = 0; attempt < 1000 && written < kBatch; ++attempt) {
+        if (attempt == 3) {
+            writer.refusals = 2;
+        }
+        written += upload.Write(&commands[written], std::min<std::size_t>(kBatch - written, 70));
+    }
+    REQUIRE(written == kBatch);
+    CHECK(upload.Write(commands.data(), 1) == 0);   // Packet is full
+    writer.refusals = 1;
+    CHECK_FALSE(upload.Finish());
+    REQUIRE(upload.Finish());
+    CHECK(upload.IsComplete());
+
+    bcnp::TypedPacket<bcnp::TestCmd> whole;
+    whole.header.flags = bcnp::kFlagClearQueue;
+    whole.messages = commands;
+    std::vector<uint8_t> expected;
+    REQUIRE(bcnp::EncodeTypedPacket(whole, expected));
+    REQUIRE(writer.bytes == expected);
+    CHECK(writer.sends > static_cast<int>(expected.size() / 256));
+
+    const std::vector<uint8_t> trailer = EncodeTestCmds(1, 9);
+    std::vector<uint8_t> stream = expected;
+    stream.insert(stream.end(), trailer.begin(), trailer.end());
+
+    std::vector<bcnp::TestCmd> received;
+    std::vector<bool> ends;
+    std::size_t begins = 0;
+    std::size_t chunks = 0;
+    std::size_t smallPackets = 0;
+    std::vector<bcnp::PacketError> errors;
+    bcnp::StreamParser parser(
+        [&](const bcnp::PacketView& packet) {
+            smallPackets += packet.header.messageCount == 1 ? 1 : 0;
+        },
+        [&](const bcnp::StreamParser::ErrorInfo& error) { errors.push_back(error.code); },
+        512);
+    parser.SetWireSizeFunction(TestWireSizeLookup);
+
+    bcnp::StreamParser::StreamingCallbacks callbacks;
+    callbacks.onPacketBegin = [&](const bcnp::PacketHeader& header) {
+        ++begins;
+        CHECK(header.messageCount == kBatch);
+        CHECK(header.flags == bcnp::kFlagClearQueue);
+    };
+    callbacks.onMessages = [&](const bcnp::PacketView& chunk) {
+        ++chunks;
+        for (auto it = chunk.begin_as<bcnp::TestCmd>(); it != chunk.end_as<bcnp::TestCmd>(); ++it) {
+            received.push_back(*it);
+        }
+    };
+    callbacks.onPacketEnd = [&](const bcnp::PacketHeader&, bool crcOk) { ends.push_back(crcOk); };
+
+    SUBCASE("Without streaming the frame is rejected") {
+        parser.Push(stream.data(), stream.size());
+        REQUIRE_FALSE(errors.empty());
+        CHECK(errors.front() == bcnp::PacketError::TooManyMessages);
+        CHECK(smallPackets == 1);
+        CHECK(received.empty());
+    }
+
+    SUBCASE("Fragmented input is delivered whole-message by whole-message") {
+        parser.SetStreamingCallbacks(callbacks);
+        std::size_t offset = 0;
+        std::size_t step = 1;
+        while (offset < stream.size()) {
+            const std::size_t n = std::min(step, stream.size() - offset);
+            parser.Push(stream.data() + offset, n);
+            offset += n;
+            step = step * 7 % 1021 + 1;   // Mix of tiny and buffer-sized pushes
+        }
+        CHECK(begins == 1);
+        CHECK(chunks > 1);
+        REQUIRE(ends.size() == 1);
+        CHECK(ends.front());
+        CHECK(errors.empty());
+        REQUIRE(received.size() == kBatch);
+        CHECK(received[1999].durationMs == 1999);
+        CHECK(received[1234].value1 == 1234.0f);
+        CHECK(smallPackets == 1);
+        CHECK(parser.StreamedFrameCount() == 1);
+        CHECK_FALSE(parser.IsStreaming());
+    }
+
+    SUBCASE("One large push streams straight from the caller's buffer") {
+        parser.SetStreamingCallbacks(callbacks);
+        parser.Push(stream.data(), stream.size());
+        CHECK(chunks == 1);
+        CHECK(received.size() == kBatch);
+        REQUIRE(ends.size() == 1);
+        CHECK(ends.front());
+        CHECK(smallPackets == 1);
+    }
+
+    SUBCASE("A corrupt payload fails the CRC at the end and parsing carries on") {
+        parser.SetStreamingCallbacks(callbacks);
+        stream[bcnp::kHeaderSizeV3 + 100 * bcnp::TestCmd::kWireSize] ^= 0x40;
+        for (std::size_t offset = 0; offset < stream.size(); offset += 300) {
+            parser.Push(stream.data() + offset, std::min<std::size_t>(300, stream.size() - offset));
+        }
+        REQUIRE(ends.size() == 1);
+        CHECK_FALSE(ends.front());
+        REQUIRE(errors.size() == 1);
+        CHECK(errors.front() == bcnp::PacketError::ChecksumMismatch);
+        CHECK(smallPackets == 1);
+        CHECK(parser.StreamedFrameCount() == 0);
+    }
+
+    SUBCASE("Reset aborts a partial stream") {
+        parser.SetStreamingCallbacks(callbacks);
+        parser.Push(stream.data(), 1000);
+        CHECK(parser.IsStreaming());
+        parser.Reset();
+        REQUIRE(ends.size() == 1);
+        CHECK_FALSE(ends.front());
+        CHECK_FALSE(parser.IsStreaming());
+    }
+}
+
+namespace {
+// TestCmd on the wire, but its encoder refuses a marked message
+struct PoisonCmd {
+    static constexpr bcnp::MessageTypeId kTypeId = bcnp::TestCmd::kTypeId;
+    static constexpr std::size_t kWireSize = bcnp::TestCmd::kWireSize;
+
+    bcnp::TestCmd command{};
+    bool poisoned{false};
+
+    bool Encode(uint8_t* out, std::size_t capacity) const {
+        return !poisoned && command.Encode(out, capacity);
+    }
+};
+} // namespace
+
+TEST_CASE("Streaming: An aborted chunked packet keeps its length and fails the CRC") {
+    constexpr std::size_t kBatch = 100;
+    std::vector<PoisonCmd> commands(kBatch);
+    for (std::size_t i = 0; i < kBatch; ++i) {
+        commands[i].command.durationMs = static_cast<uint16_t>(i);
+    }
+    commands[60].poisoned = true;
+
+    SUBCASE("Nothing sent yet: the packet is discarded") {
+        FlakyWriter writer;
+        bcnp::ChunkedPacketWriter<PoisonCmd, 256> upload(writer, kBatch);
+        CHECK(upload.Write(&commands[55], 10) == 0);
+        CHECK(upload.HasFailed());
+        CHECK(upload.Abort());
+        CHECK(upload.IsClosed());
+        CHECK_FALSE(upload.IsComplete());
+        CHECK(writer.bytes.empty());
+    }
+
+    SUBCASE("Part way through: the rest is padded and the receiver drops exactly this frame") {
+        FlakyWriter writer;
+        {
+            bcnp::ChunkedPacketWriter<PoisonCmd, 256> upload(writer, kBatch);
+            std::size_t written = 0;
+            for (int attempt = 0; attempt < 10 && !upload.HasFailed(); ++attempt) {
+                written += upload.Write(&commands[written], kBatch - written);
+            }
+            CHECK(written < 60);
+            CHECK(upload.HasFailed());
+            CHECK(upload.Write(&commands[written], 1) == 0);
+            CHECK_FALSE(upload.Finish());
+            writer.refusals = 1;
+            CHECK_FALSE(upload.Abort());
+            REQUIRE(upload.Abort());
+            CHECK(upload.IsClosed());
+            CHECK_FALSE(upload.IsComplete());
+        }
+        REQUIRE(writer.bytes.size() == bcnp::PacketSizeFor<bcnp::TestCmd>(kBatch));
+
+        const std::vector<uint8_t> trailer = EncodeTestCmds(1, 9);
+        std::vector<uint8_t> stream = writer.bytes;
+        stream.insert(stream.end(), trailer.begin(), trailer.end());
+        std::vector<uint16_t> packets;
+        std::vector<bcnp::PacketError> errors;
+        std::vector<bool> ends;
+        bcnp::StreamParser parser(
+            [&](const bcnp::PacketView& packet) {
+                for (auto it = packet.begin_as<bcnp::TestCmd>(); it != packet.end_as<bcnp::TestCmd>(); ++it) {
+                    packets.push_back((*it).durationMs);
+                }
+            },
+            [&](const bcnp::StreamParser::ErrorInfo& error) { errors.push_back(error.code); }, 512);
+        parser.SetWireSizeFunction(TestWireSizeLookup);
+        bcnp::StreamParser::StreamingCallbacks callbacks;
+        callbacks.onMessages = [](const bcnp::PacketView&) {};
+        callbacks.onPacketEnd = [&](const bcnp::PacketHeader&, bool crcOk) { ends.push_back(crcOk); };
+        parser.SetStreamingCallbacks(callbacks);
+        parser.Push(stream.data(), stream.size());
+
+        REQUIRE(ends.size() == 1);
+        CHECK_FALSE(ends.front());
+        REQUIRE(errors.size() == 1);
+        CHECK(errors.front() == bcnp::PacketError::ChecksumMismatch);
+        CHECK(packets == std::vector<uint16_t>{9});   // Still in sync after the frame
+    }
+
+    SUBCASE("A writer destroyed part way through aborts") {
+        FlakyWriter writer;
+        {
+            bcnp::ChunkedPacketWriter<PoisonCmd, 256> upload(writer, kBatch);
+            CHECK(upload.Write(commands.data(), 50) == 50);
+        }
+        CHECK(writer.bytes.size() == bcnp::PacketSizeFor<bcnp::TestCmd>(kBatch));
+    }
+}
+
+TEST_CASE("TCP adapter: Control sends wait for a bulk frame written in chunks") {
+    bcnp::TcpPosixAdapter server(12422);
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", 12422);
+    REQUIRE(server.IsValid());
+    server.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    client.SetWireSizeFunction(TestWireSizeLookup);
+    REQUIRE(ConnectTcpPair(server, client));
+    client.SetBulkRateLimit(100000, 1024);   // Chunks queue, so control sends fall between them
+
+    constexpr std::size_t kBatch = 300;
+    std::vector<bcnp::TestCmd> commands(kBatch);
+    for (std::size_t i = 0; i < kBatch; ++i) {
+        commands[i] = {static_cast<float>(i), 0.0f, 7};
+    }
+
+    std::vector<uint16_t> controlSeen;
+    std::size_t streamed = 0;
+    std::vector<bool> ends;
+    bcnp::StreamParser parser(
+        [&](const bcnp::PacketView& packet) {
+            for (auto it = packet.begin_as<bcnp::TestCmd>(); it != packet.end_as<bcnp::TestCmd>(); ++it) {
+                controlSeen.push_back((*it).durationMs);
+            }
+        },
+        {}, 512);
+    parser.SetWireSizeFunction(TestWireSizeLookup);
+    bcnp::StreamParser::StreamingCallbacks callbacks;
+    callbacks.onMessages = [&](const bcnp::PacketView& chunk) { streamed += chunk.header.messageCount; };
+    callbacks.onPacketEnd = [&](const bcnp::PacketHeader&, bool crcOk) { ends.push_back(crcOk); };
+    parser.SetStreamingCallbacks(callbacks);
+
+    std::vector<uint8_t> rx(4096);
+    const auto pump = [&] {
+        client.ReceiveChunk(rx.data(), rx.size());   // Flushes what the bucket allows
+        parser.Push(rx.data(), server.ReceiveChunk(rx.data(), rx.size()));
+    };
+
+    auto bulk = client.Lane(bcnp::TxPriority::Bulk);
+    const std::vector<uint8_t> bulkPacket = EncodeTestCmds(1, 50);
+    {
+        bcnp::ChunkedPacketWriter<bcnp::TestCmd, 256> upload(bulk, kBatch);
+        std::size_t written = 0;
+        uint16_t controlSent = 0;
+        for (int guard = 0; guard < 2000 && !upload.IsComplete(); ++guard) {
+            if (written < kBatch) {
+                written += upload.Write(&commands[written], std::min<std::size_t>(kBatch - written, 30));
+            } else {
+                upload.Finish();
+            }
+            if (controlSent < 10) {
+                const std::vector<uint8_t> control = EncodeTestCmds(1, static_cast<uint16_t>(100 + controlSent));
+                controlSent += client.SendBytes(control.data(), control.size()) ? 1 : 0;
+                CHECK_FALSE(bulk.SendBytes(bulkPacket.data(), bulkPacket.size()));   // Inside the frame
+            }
+            pump();
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE(upload.IsComplete());
+        CHECK(controlSent == 10);
+    }
+    CHECK(bulk.SendBytes(bulkPacket.data(), bulkPacket.size()));
+    for (int guard = 0; guard < 500 && controlSeen.size() < 11; ++guard) {
+        pump();
+        std::this_thread::sleep_for(1ms);
+    }
+
+    REQUIRE(ends.size() == 1);
+    CHECK(ends.front());
+    CHECK(streamed == kBatch);
+    REQUIRE(controlSeen.size() == 11);
+    for (uint16_t i = 0; i < 10; ++i) {
+        CHECK(controlSeen[i] == 100 + i);
+    }
+    CHECK(controlSeen.back() == 50);
+}
+
+TEST_CASE("Capture: Frames larger than the index parser's ring are indexed") {
+    const std::string path = CapturePath("bcnp_capture_large.bcnpcap");
+    const std::vector<uint8_t> small = EncodeTestCmds(1, 1);
+    const std::vector<uint8_t> large = EncodeTestCmds(8000, 2);   // ~80 KB, past the 64 KiB ring
+    REQUIRE(large.size() > 64 * 1024);
+    std::vector<uint8_t> stream = small;
+    stream.insert(stream.end(), large.begin(), large.end());
+    stream.insert(stream.end(), small.begin(), small.end());
+    {
+        bcnp::CaptureWriter writer;
+        REQUIRE(writer.Open(path));
+        for (std::size_t offset = 0; offset < stream.size(); offset += 16 * 1024) {
+            REQUIRE(writer.Record(stream.data() + offset, std::min<std::size_t>(16 * 1024, stream.size() - offset), 2));
+        }
+        writer.Close();
+    }
+
+    bcnp::CaptureReader reader;
+    REQUIRE(reader.Open(path));
+    CHECK(reader.BuildIndex(TestWireSizeLookup) == 3);
+    const auto& refs = reader.PacketsOfType(bcnp::TestCmd::kTypeId);
+    REQUIRE(refs.size() == 3);
+    CHECK(refs[0].byteOffset == 0);
+    CHECK(refs[1].byteOffset == small.size());
+    CHECK(refs[2].byteOffset == small.size() + large.size() - 4 * 16 * 1024);
+    CHECK(refs[2].recordOffset > refs[1].recordOffset);
+    CHECK(refs[1].streamId == 2);
+    reader.Close();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("TCP: A reservation keeps its lane until committed") {
+    bcnp::TcpPosixAdapter server(12423);
+    REQUIRE(server.IsValid());
+    server.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    bcnp::TcpPosixAdapter client(0, "127.0.0.1", 12423);
+    client.SetExpectedSchemaHash(bcnp::kSchemaHash);
+    REQUIRE(ConnectTcpPair(server, client));
+
+    const std::vector<uint8_t> reservedPacket = EncodeTestCmds(1, 7);
+    const std::vector<uint8_t> otherPacket = EncodeTestCmds(2, 9);
+    const bcnp::MutableByteSpan reserved = client.ReserveTx(reservedPacket.size(), bcnp::TxPriority::Control);
+    REQUIRE(reserved.data != nullptr);
+    std::memcpy(reserved.data, reservedPacket.data(), reservedPacket.size());
+
+    // Same-lane sends would land on the bytes being encoded; other lanes go ahead
+    CHECK_FALSE(client.SendBytes(otherPacket.data(), otherPacket.size(), bcnp::TxPriority::Control));
+    const bcnp::ByteSpan otherSpan{otherPacket.data(), otherPacket.size()};
+    CHECK_FALSE(client.SendBytesV(&otherSpan, 1, bcnp::TxPriority::Control));
+    CHECK(client.SendBytes(otherPacket.data(), otherPacket.size(), bcnp::TxPriority::Bulk));
+    REQUIRE(client.CommitTx(reservedPacket.size()));
+    CHECK(client.SendBytes(otherPacket.data(), otherPacket.size(), bcnp::TxPriority::Control));
+
+    std::vector<uint16_t> durations;
+    bcnp::StreamParser parser([&](const bcnp::PacketView& view) {
+        for (auto it = view.begin_as<bcnp::TestCmd>(); it != view.end_as<bcnp::TestCmd>(); ++it) {
+            durations.push_back((*it).durationMs);
+        }
+    });
+    parser.SetWireSizeLookup(TestWireSizeLookup);
+    std::vector<uint8_t> rx(1024);
+    for (int i = 0; i < 100 && durations.size() < 5; ++i) {
+        client.ReceiveChunk(rx.data(), rx.size());  // Flushes queued TX data
+        const std::size_t bytes = server.ReceiveChunk(rx.data(), rx.size());
+        parser.Push(rx.data(), bytes);
+        if (bytes == 0) {
+            std::this_thread::sleep_for(5ms);
+        }
+    }
+    REQUIRE(durations.size() == 5);
+    CHECK(std::count(durations.begin(), durations.end(), uint16_t{7}) == 1);
+    CHECK(std::count(durations.begin(), durations.end(), uint16_t{9}) == 4);
+}
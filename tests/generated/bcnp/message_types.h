@@ -13,6 +13,24 @@
 #include <limits>
 #include <optional>
 #include <variant>
+#include <vector>
+
+// Batch codec SIMD selection (define BCNP_NO_SIMD to force the scalar kernels)
+#if !defined(BCNP_NO_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__))
+#define BCNP_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#define BCNP_SIMD_SSSE3 1
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX__)
+#define BCNP_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+#elif !defined(BCNP_NO_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#define BCNP_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
 
 namespace bcnp {
 
@@ -106,8 +124,214 @@ inline float DequantizeFloat(int32_t fixed, float scale) {
     return static_cast<float>(static_cast<double>(fixed) / static_cast<double>(scale));
 }
 
+/// QuantizeFloat() for a finite value without the llround() call (same result)
+inline int32_t QuantizeFloatUnchecked(float value, float scale) {
+    const double scaled = static_cast<double>(value) * static_cast<double>(scale);
+    const double clamped = std::clamp(scaled,
+        static_cast<double>(std::numeric_limits<int32_t>::min()),
+        static_cast<double>(std::numeric_limits<int32_t>::max()));
+    const auto truncated = static_cast<int32_t>(clamped);
+    const double frac = clamped - static_cast<double>(truncated);   // Exact within int32 range
+    return truncated + static_cast<int32_t>(frac >= 0.5) - static_cast<int32_t>(frac <= -0.5);
+}
+
+// ----------------------------------------------------------------------------
+// Batch kernels used by the generated DecodeBatch()/EncodeBatch().
+// Results are bit-identical to Decode()/Encode(): dequantization divides in
+// double like DequantizeFloat, quantization reproduces llround on the clamp.
+// ----------------------------------------------------------------------------
+
+/// Messages processed per DecodeBatch()/EncodeBatch() block
+constexpr std::size_t kBatchBlock = 16;
+
+/// Load `words` big-endian 32-bit words from `in` into host order
+inline void LoadBlockU32(const uint8_t* in, uint32_t* out, std::size_t words) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_SSSE3)
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= words; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(v, swap));
+    }
+#elif defined(BCNP_SIMD_SSE2)
+    for (; i + 4 <= words; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), v);
+    }
+#elif defined(BCNP_SIMD_NEON)
+    for (; i + 4 <= words; i += 4) {
+        vst1q_u32(out + i, vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in + i * 4))));
+    }
+#endif
+    for (; i < words; ++i) {
+        out[i] = LoadU32(in + i * 4);
+    }
+}
+
+/// Store `words` host-order 32-bit words to `out` as big-endian
+inline void StoreBlockU32(const uint32_t* in, uint8_t* out, std::size_t words) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_SSSE3)
+    const __m128i swap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    for (; i + 4 <= words; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), _mm_shuffle_epi8(v, swap));
+    }
+#elif defined(BCNP_SIMD_SSE2)
+    for (; i + 4 <= words; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), v);
+    }
+#elif defined(BCNP_SIMD_NEON)
+    for (; i + 4 <= words; i += 4) {
+        vst1q_u8(out + i * 4, vrev32q_u8(vreinterpretq_u8_u32(vld1q_u32(in + i))));
+    }
+#endif
+    for (; i < words; ++i) {
+        StoreU32(in[i], out + i * 4);
+    }
+}
+
+/// DequantizeFloat() over `n` values
+inline void DequantizeBlock(const int32_t* in, std::size_t n, float scale, float* out) {
+    std::size_t i = 0;
+#if defined(BCNP_SIMD_AVX)
+    const __m256d s4 = _mm256_set1_pd(static_cast<double>(scale));
+    for (; i + 4 <= n; i += 4) {
+        const __m256d d = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+        _mm_storeu_ps(out + i, _mm256_cvtpd_ps(_mm256_div_pd(d, s4)));
+    }
+#endif
+#if defined(BCNP_SIMD_SSE2)
+    const __m128d s2 = _mm_set1_pd(static_cast<double>(scale));
+    for (; i + 2 <= n; i += 2) {
+        const __m128d d = _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i)));
+        _mm_storel_pi(reinterpret_cast<__m64*>(out + i), _mm_cvtpd_ps(_mm_div_pd(d, s2)));
+    }
+#elif defined(BCNP_SIMD_NEON)
+    const float64x2_t s2 = vdupq_n_f64(static_cast<double>(scale));
+    for (; i + 2 <= n; i += 2) {
+        const float64x2_t d = vcvtq_f64_s64(vmovl_s32(vld1_s32(in + i)));
+        vst1_f32(out + i, vcvt_f32_f64(vdivq_f64(d, s2)));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = DequantizeFloat(in[i], scale);
+    }
+}
+
+/// QuantizeFloat() over `n` values; false if any value is not finite
+inline bool QuantizeBlock(const float* in, std::size_t n, float scale, int32_t* out) {
+    std::size_t i = 0;
+    constexpr double kMin = static_cast<double>(std::numeric_limits<int32_t>::min());
+    constexpr double kMax = static_cast<double>(std::numeric_limits<int32_t>::max());
+#if defined(BCNP_SIMD_AVX)
+    {
+        const __m256d s = _mm256_set1_pd(static_cast<double>(scale));
+        const __m256d lo = _mm256_set1_pd(kMin);
+        const __m256d hi = _mm256_set1_pd(kMax);
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d one = _mm256_set1_pd(1.0);
+        for (; i + 4 <= n; i += 4) {
+            const __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(in + i));
+            if (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_sub_pd(x, x), _mm256_setzero_pd(), _CMP_EQ_OQ)) != 0xF) {
+                return false;
+            }
+            const __m256d v = _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(x, s), lo), hi);
+            const __m256d t = _mm256_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m256d frac = _mm256_sub_pd(v, t);
+            const __m256d up = _mm256_and_pd(_mm256_cmp_pd(frac, half, _CMP_GE_OQ), one);
+            const __m256d down = _mm256_and_pd(_mm256_cmp_pd(frac, _mm256_sub_pd(_mm256_setzero_pd(), half), _CMP_LE_OQ), one);
+            const __m256d r = _mm256_sub_pd(_mm256_add_pd(t, up), down);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvttpd_epi32(r));
+        }
+    }
+#endif
+#if defined(BCNP_SIMD_SSE2)
+    {
+        const __m128d s = _mm_set1_pd(static_cast<double>(scale));
+        const __m128d lo = _mm_set1_pd(kMin);
+        const __m128d hi = _mm_set1_pd(kMax);
+        const __m128d half = _mm_set1_pd(0.5);
+        const __m128d negHalf = _mm_set1_pd(-0.5);
+        const __m128d one = _mm_set1_pd(1.0);
+        for (; i + 2 <= n; i += 2) {
+            const __m128d x = _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in + i))));
+            if (_mm_movemask_pd(_mm_cmpeq_pd(_mm_sub_pd(x, x), _mm_setzero_pd())) != 0x3) {
+                return false;
+            }
+            const __m128d v = _mm_min_pd(_mm_max_pd(_mm_mul_pd(x, s), lo), hi);
+            const __m128d t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(v));
+            const __m128d frac = _mm_sub_pd(v, t);
+            const __m128d up = _mm_and_pd(_mm_cmpge_pd(frac, half), one);
+            const __m128d down = _mm_and_pd(_mm_cmple_pd(frac, negHalf), one);
+            const __m128d r = _mm_sub_pd(_mm_add_pd(t, up), down);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i), _mm_cvttpd_epi32(r));
+        }
+    }
+#elif defined(BCNP_SIMD_NEON)
+    {
+        const float64x2_t s = vdupq_n_f64(static_cast<double>(scale));
+        const float64x2_t lo = vdupq_n_f64(kMin);
+        const float64x2_t hi = vdupq_n_f64(kMax);
+        const float64x2_t half = vdupq_n_f64(0.5);
+        const float64x2_t negHalf = vdupq_n_f64(-0.5);
+        const float64x2_t one = vdupq_n_f64(1.0);
+        const float64x2_t zero = vdupq_n_f64(0.0);
+        for (; i + 2 <= n; i += 2) {
+            const float64x2_t x = vcvt_f64_f32(vld1_f32(in + i));
+            const uint64x2_t finite = vceqq_f64(vsubq_f64(x, x), zero);
+            if ((vgetq_lane_u64(finite, 0) & vgetq_lane_u64(finite, 1)) == 0) {
+                return false;
+            }
+            const float64x2_t v = vminq_f64(vmaxq_f64(vmulq_f64(x, s), lo), hi);
+            const float64x2_t t = vrndq_f64(v);
+            const float64x2_t frac = vsubq_f64(v, t);
+            const float64x2_t up = vbslq_f64(vcgeq_f64(frac, half), one, zero);
+            const float64x2_t down = vbslq_f64(vcleq_f64(frac, negHalf), one, zero);
+            const float64x2_t r = vsubq_f64(vaddq_f64(t, up), down);
+            vst1_s32(out + i, vmovn_s64(vcvtq_s64_f64(r)));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        if (!std::isfinite(in[i])) return false;
+        out[i] = QuantizeFloat(in[i], scale);
+    }
+    return true;
+}
+
+
 } // namespace detail
 
+/// Bit set selecting message fields for column decoding (bit i = field i)
+using FieldMask = uint64_t;
+
+/// Select every field of a message
+constexpr FieldMask kAllFields = ~FieldMask{0};
+
+/// Wire byte width of each field in order, for the compressed (delta) encoding
+struct FieldLayout {
+    const uint8_t* widths{nullptr};
+    std::size_t count{0};   ///< 0 = unknown message type
+};
+
+/// Wire type of a message field
+enum class FieldType : uint8_t { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32 };
+
+/// Compile-time description of one field (see <Message>::kFields)
+struct FieldDescriptor {
+    const char* name;
+    FieldType type;
+    uint16_t offset;   ///< Byte offset within the message
+    uint8_t width;     ///< Wire bytes
+    float scale;       ///< Fixed-point scale for Float32, 1 otherwise
+};
+
 // ============================================================================
 // Message Structs
 // ============================================================================
@@ -116,6 +340,12 @@ inline float DequantizeFloat(int32_t fixed, float scale) {
 struct TestCmd {
     static constexpr MessageTypeId kTypeId = MessageTypeId::TestCmd;
     static constexpr std::size_t kWireSize = kTestCmdSize;
+    static constexpr std::array<uint8_t, 3> kFieldWidths = {{4, 4, 2}};
+    static constexpr std::array<FieldDescriptor, 3> kFields = {{
+        {"value1", FieldType::Float32, 0, 4, 10000.0f},
+        {"value2", FieldType::Float32, 4, 4, 10000.0f},
+        {"durationMs", FieldType::UInt16, 8, 2, 1.0f},
+    }};
 
     float value1{0}; // First test value
     float value2{0}; // Second test value
@@ -124,29 +354,150 @@ struct TestCmd {
     bool Encode(uint8_t* out, std::size_t capacity) const {
         if (capacity < kWireSize) return false;
         if (!std::isfinite(value1)) return false;
-        detail::StoreS32(detail::QuantizeFloat(value1, 10000.0f), &out[0]);
         if (!std::isfinite(value2)) return false;
-        detail::StoreS32(detail::QuantizeFloat(value2, 10000.0f), &out[4]);
-        detail::StoreU16(durationMs, &out[8]);
+        EncodeUnchecked(out);
         return true;
     }
 
+    /// Encode() without checks: `out` holds kWireSize bytes and float fields are finite
+    void EncodeUnchecked(uint8_t* out) const {
+        detail::StoreS32(detail::QuantizeFloatUnchecked(value1, 10000.0f), &out[0]);
+        detail::StoreS32(detail::QuantizeFloatUnchecked(value2, 10000.0f), &out[4]);
+        detail::StoreU16(durationMs, &out[8]);
+    }
+
     static std::optional<TestCmd> Decode(const uint8_t* data, std::size_t length) {
         if (length < kWireSize) return std::nullopt;
+        TestCmd msg = DecodeUnchecked(data);
+        if (!std::isfinite(msg.value1)) return std::nullopt;
+        if (!std::isfinite(msg.value2)) return std::nullopt;
+        return msg;
+    }
+
+    /// Decode() without checks, for payloads whose length and CRC were already validated
+    static TestCmd DecodeUnchecked(const uint8_t* data) {
         TestCmd msg;
         msg.value1 = detail::DequantizeFloat(detail::LoadS32(&data[0]), 10000.0f);
-        if (!std::isfinite(msg.value1)) return std::nullopt;
         msg.value2 = detail::DequantizeFloat(detail::LoadS32(&data[4]), 10000.0f);
-        if (!std::isfinite(msg.value2)) return std::nullopt;
         msg.durationMs = detail::LoadU16(&data[8]);
         return msg;
     }
+
+    /// Decode `count` consecutive messages (count * kWireSize bytes) into `out`.
+    /// Same results as Decode() per message; float fields are always finite.
+    static void DecodeBatch(const uint8_t* data, std::size_t count, TestCmd* out) {
+        constexpr std::size_t kBlock = detail::kBatchBlock;
+        int32_t raw[kBlock];
+        float values[kBlock];
+        for (std::size_t base = 0; base < count; base += kBlock) {
+            const std::size_t n = std::min(kBlock, count - base);
+            const uint8_t* block = data + base * kWireSize;
+            TestCmd* dst = out + base;
+            for (std::size_t i = 0; i < n; ++i) raw[i] = detail::LoadS32(block + i * kWireSize + 0);
+            detail::DequantizeBlock(raw, n, 10000.0f, values);
+            for (std::size_t i = 0; i < n; ++i) dst[i].value1 = values[i];
+            for (std::size_t i = 0; i < n; ++i) raw[i] = detail::LoadS32(block + i * kWireSize + 4);
+            detail::DequantizeBlock(raw, n, 10000.0f, values);
+            for (std::size_t i = 0; i < n; ++i) dst[i].value2 = values[i];
+            for (std::size_t i = 0; i < n; ++i) dst[i].durationMs = detail::LoadU16(block + i * kWireSize + 8);
+        }
+    }
+
+    /// Encode `count` messages from `in` into `out` (count * kWireSize bytes).
+    /// Same bytes as Encode() per message; false if any float field is not finite.
+    static bool EncodeBatch(const TestCmd* in, std::size_t count, uint8_t* out) {
+        constexpr std::size_t kBlock = detail::kBatchBlock;
+        int32_t raw[kBlock];
+        float values[kBlock];
+        for (std::size_t base = 0; base < count; base += kBlock) {
+            const std::size_t n = std::min(kBlock, count - base);
+            uint8_t* block = out + base * kWireSize;
+            const TestCmd* src = in + base;
+            for (std::size_t i = 0; i < n; ++i) values[i] = src[i].value1;
+            if (!detail::QuantizeBlock(values, n, 10000.0f, raw)) return false;
+            for (std::size_t i = 0; i < n; ++i) detail::StoreS32(raw[i], block + i * kWireSize + 0);
+            for (std::size_t i = 0; i < n; ++i) values[i] = src[i].value2;
+            if (!detail::QuantizeBlock(values, n, 10000.0f, raw)) return false;
+            for (std::size_t i = 0; i < n; ++i) detail::StoreS32(raw[i], block + i * kWireSize + 4);
+            for (std::size_t i = 0; i < n; ++i) detail::StoreU16(src[i].durationMs, block + i * kWireSize + 8);
+        }
+        return true;
+    }
+};
+
+/// Structure-of-arrays storage for TestCmd, filled by DecodeColumns()
+struct TestCmdColumns {
+    using Message = TestCmd;
+
+    static constexpr FieldMask kValue1 = FieldMask{1} << 0;
+    static constexpr FieldMask kValue2 = FieldMask{1} << 1;
+    static constexpr FieldMask kDurationMs = FieldMask{1} << 2;
+    static constexpr FieldMask kAll = kValue1 | kValue2 | kDurationMs;
+
+    std::vector<float> value1;
+    std::vector<float> value2;
+    std::vector<uint16_t> durationMs;
+    std::size_t count{0};  ///< Messages decoded by the last Assign()
+    FieldMask fields{0};   ///< Columns populated by the last Assign()
+
+    /// Empty every column (capacity is kept for reuse)
+    void clear() {
+        value1.clear();
+        value2.clear();
+        durationMs.clear();
+        count = 0;
+        fields = 0;
+    }
+
+    /// Decode `n` consecutive messages; columns outside `mask` are left empty
+    void Assign(const uint8_t* data, std::size_t n, FieldMask mask) {
+        count = n;
+        fields = mask & kAll;
+        int32_t raw[detail::kBatchBlock];
+        if (mask & kValue1) {
+            value1.resize(n);
+            for (std::size_t base = 0; base < n; base += detail::kBatchBlock) {
+                const std::size_t block = std::min(detail::kBatchBlock, n - base);
+                for (std::size_t i = 0; i < block; ++i) raw[i] = detail::LoadS32(data + (base + i) * kStride + 0);
+                detail::DequantizeBlock(raw, block, 10000.0f, value1.data() + base);
+            }
+        } else {
+            value1.clear();
+        }
+        if (mask & kValue2) {
+            value2.resize(n);
+            for (std::size_t base = 0; base < n; base += detail::kBatchBlock) {
+                const std::size_t block = std::min(detail::kBatchBlock, n - base);
+                for (std::size_t i = 0; i < block; ++i) raw[i] = detail::LoadS32(data + (base + i) * kStride + 4);
+                detail::DequantizeBlock(raw, block, 10000.0f, value2.data() + base);
+            }
+        } else {
+            value2.clear();
+        }
+        if (mask & kDurationMs) {
+            durationMs.resize(n);
+            for (std::size_t i = 0; i < n; ++i) durationMs[i] = detail::LoadU16(data + i * kStride + 8);
+        } else {
+            durationMs.clear();
+        }
+    }
+
+private:
+    static constexpr std::size_t kStride = TestCmd::kWireSize;
 };
 
-/// Drivetrain telemetry - absolute state snapshot
+/// Drivetrain telemetry: absolute state snapshot
 struct DrivetrainState {
     static constexpr MessageTypeId kTypeId = MessageTypeId::DrivetrainState;
     static constexpr std::size_t kWireSize = kDrivetrainStateSize;
+    static constexpr std::array<uint8_t, 5> kFieldWidths = {{4, 4, 4, 4, 4}};
+    static constexpr std::array<FieldDescriptor, 5> kFields = {{
+        {"vxActual", FieldType::Float32, 0, 4, 10000.0f},
+        {"omegaActual", FieldType::Float32, 4, 4, 10000.0f},
+        {"leftPos", FieldType::Int32, 8, 4, 1.0f},
+        {"rightPos", FieldType::Int32, 12, 4, 1.0f},
+        {"timestampMs", FieldType::UInt32, 16, 4, 1.0f},
+    }};
 
     float vxActual{0}; // Actual linear velocity (m/s)
     float omegaActual{0}; // Actual angular velocity (rad/s)
@@ -157,33 +508,180 @@ struct DrivetrainState {
     bool Encode(uint8_t* out, std::size_t capacity) const {
         if (capacity < kWireSize) return false;
         if (!std::isfinite(vxActual)) return false;
-        detail::StoreS32(detail::QuantizeFloat(vxActual, 10000.0f), &out[0]);
         if (!std::isfinite(omegaActual)) return false;
-        detail::StoreS32(detail::QuantizeFloat(omegaActual, 10000.0f), &out[4]);
+        EncodeUnchecked(out);
+        return true;
+    }
+
+    /// Encode() without checks: `out` holds kWireSize bytes and float fields are finite
+    void EncodeUnchecked(uint8_t* out) const {
+        detail::StoreS32(detail::QuantizeFloatUnchecked(vxActual, 10000.0f), &out[0]);
+        detail::StoreS32(detail::QuantizeFloatUnchecked(omegaActual, 10000.0f), &out[4]);
         detail::StoreS32(leftPos, &out[8]);
         detail::StoreS32(rightPos, &out[12]);
         detail::StoreU32(timestampMs, &out[16]);
-        return true;
     }
 
     static std::optional<DrivetrainState> Decode(const uint8_t* data, std::size_t length) {
         if (length < kWireSize) return std::nullopt;
+        DrivetrainState msg = DecodeUnchecked(data);
+        if (!std::isfinite(msg.vxActual)) return std::nullopt;
+        if (!std::isfinite(msg.omegaActual)) return std::nullopt;
+        return msg;
+    }
+
+    /// Decode() without checks, for payloads whose length and CRC were already validated
+    static DrivetrainState DecodeUnchecked(const uint8_t* data) {
         DrivetrainState msg;
         msg.vxActual = detail::DequantizeFloat(detail::LoadS32(&data[0]), 10000.0f);
-        if (!std::isfinite(msg.vxActual)) return std::nullopt;
         msg.omegaActual = detail::DequantizeFloat(detail::LoadS32(&data[4]), 10000.0f);
-        if (!std::isfinite(msg.omegaActual)) return std::nullopt;
         msg.leftPos = detail::LoadS32(&data[8]);
         msg.rightPos = detail::LoadS32(&data[12]);
         msg.timestampMs = detail::LoadU32(&data[16]);
         return msg;
     }
+
+    /// Decode `count` consecutive messages (count * kWireSize bytes) into `out`.
+    /// Same results as Decode() per message; float fields are always finite.
+    static void DecodeBatch(const uint8_t* data, std::size_t count, DrivetrainState* out) {
+        constexpr std::size_t kBlock = detail::kBatchBlock;
+        constexpr std::size_t kWords = kWireSize / 4;
+        uint32_t words[kBlock * kWords];
+        int32_t raw[kBlock];
+        float values[kBlock];
+        for (std::size_t base = 0; base < count; base += kBlock) {
+            const std::size_t n = std::min(kBlock, count - base);
+            const uint8_t* block = data + base * kWireSize;
+            DrivetrainState* dst = out + base;
+            detail::LoadBlockU32(block, words, n * kWords);
+            for (std::size_t i = 0; i < n; ++i) raw[i] = static_cast<int32_t>(words[i * kWords + 0]);
+            detail::DequantizeBlock(raw, n, 10000.0f, values);
+            for (std::size_t i = 0; i < n; ++i) dst[i].vxActual = values[i];
+            for (std::size_t i = 0; i < n; ++i) raw[i] = static_cast<int32_t>(words[i * kWords + 1]);
+            detail::DequantizeBlock(raw, n, 10000.0f, values);
+            for (std::size_t i = 0; i < n; ++i) dst[i].omegaActual = values[i];
+            for (std::size_t i = 0; i < n; ++i) dst[i].leftPos = static_cast<int32_t>(words[i * kWords + 2]);
+            for (std::size_t i = 0; i < n; ++i) dst[i].rightPos = static_cast<int32_t>(words[i * kWords + 3]);
+            for (std::size_t i = 0; i < n; ++i) dst[i].timestampMs = words[i * kWords + 4];
+        }
+    }
+
+    /// Encode `count` messages from `in` into `out` (count * kWireSize bytes).
+    /// Same bytes as Encode() per message; false if any float field is not finite.
+    static bool EncodeBatch(const DrivetrainState* in, std::size_t count, uint8_t* out) {
+        constexpr std::size_t kBlock = detail::kBatchBlock;
+        constexpr std::size_t kWords = kWireSize / 4;
+        uint32_t words[kBlock * kWords];
+        int32_t raw[kBlock];
+        float values[kBlock];
+        for (std::size_t base = 0; base < count; base += kBlock) {
+            const std::size_t n = std::min(kBlock, count - base);
+            uint8_t* block = out + base * kWireSize;
+            const DrivetrainState* src = in + base;
+            for (std::size_t i = 0; i < n; ++i) values[i] = src[i].vxActual;
+            if (!detail::QuantizeBlock(values, n, 10000.0f, raw)) return false;
+            for (std::size_t i = 0; i < n; ++i) words[i * kWords + 0] = static_cast<uint32_t>(raw[i]);
+            for (std::size_t i = 0; i < n; ++i) values[i] = src[i].omegaActual;
+            if (!detail::QuantizeBlock(values, n, 10000.0f, raw)) return false;
+            for (std::size_t i = 0; i < n; ++i) words[i * kWords + 1] = static_cast<uint32_t>(raw[i]);
+            for (std::size_t i = 0; i < n; ++i) words[i * kWords + 2] = static_cast<uint32_t>(src[i].leftPos);
+            for (std::size_t i = 0; i < n; ++i) words[i * kWords + 3] = static_cast<uint32_t>(src[i].rightPos);
+            for (std::size_t i = 0; i < n; ++i) words[i * kWords + 4] = src[i].timestampMs;
+            detail::StoreBlockU32(words, block, n * kWords);
+        }
+        return true;
+    }
+};
+
+/// Structure-of-arrays storage for DrivetrainState, filled by DecodeColumns()
+struct DrivetrainStateColumns {
+    using Message = DrivetrainState;
+
+    static constexpr FieldMask kVxActual = FieldMask{1} << 0;
+    static constexpr FieldMask kOmegaActual = FieldMask{1} << 1;
+    static constexpr FieldMask kLeftPos = FieldMask{1} << 2;
+    static constexpr FieldMask kRightPos = FieldMask{1} << 3;
+    static constexpr FieldMask kTimestampMs = FieldMask{1} << 4;
+    static constexpr FieldMask kAll = kVxActual | kOmegaActual | kLeftPos | kRightPos | kTimestampMs;
+
+    std::vector<float> vxActual;
+    std::vector<float> omegaActual;
+    std::vector<int32_t> leftPos;
+    std::vector<int32_t> rightPos;
+    std::vector<uint32_t> timestampMs;
+    std::size_t count{0};  ///< Messages decoded by the last Assign()
+    FieldMask fields{0};   ///< Columns populated by the last Assign()
+
+    /// Empty every column (capacity is kept for reuse)
+    void clear() {
+        vxActual.clear();
+        omegaActual.clear();
+        leftPos.clear();
+        rightPos.clear();
+        timestampMs.clear();
+        count = 0;
+        fields = 0;
+    }
+
+    /// Decode `n` consecutive messages; columns outside `mask` are left empty
+    void Assign(const uint8_t* data, std::size_t n, FieldMask mask) {
+        count = n;
+        fields = mask & kAll;
+        int32_t raw[detail::kBatchBlock];
+        if (mask & kVxActual) {
+            vxActual.resize(n);
+            for (std::size_t base = 0; base < n; base += detail::kBatchBlock) {
+                const std::size_t block = std::min(detail::kBatchBlock, n - base);
+                for (std::size_t i = 0; i < block; ++i) raw[i] = detail::LoadS32(data + (base + i) * kStride + 0);
+                detail::DequantizeBlock(raw, block, 10000.0f, vxActual.data() + base);
+            }
+        } else {
+            vxActual.clear();
+        }
+        if (mask & kOmegaActual) {
+            omegaActual.resize(n);
+            for (std::size_t base = 0; base < n; base += detail::kBatchBlock) {
+                const std::size_t block = std::min(detail::kBatchBlock, n - base);
+                for (std::size_t i = 0; i < block; ++i) raw[i] = detail::LoadS32(data + (base + i) * kStride + 4);
+                detail::DequantizeBlock(raw, block, 10000.0f, omegaActual.data() + base);
+            }
+        } else {
+            omegaActual.clear();
+        }
+        if (mask & kLeftPos) {
+            leftPos.resize(n);
+            for (std::size_t i = 0; i < n; ++i) leftPos[i] = detail::LoadS32(data + i * kStride + 8);
+        } else {
+            leftPos.clear();
+        }
+        if (mask & kRightPos) {
+            rightPos.resize(n);
+            for (std::size_t i = 0; i < n; ++i) rightPos[i] = detail::LoadS32(data + i * kStride + 12);
+        } else {
+            rightPos.clear();
+        }
+        if (mask & kTimestampMs) {
+            timestampMs.resize(n);
+            for (std::size_t i = 0; i < n; ++i) timestampMs[i] = detail::LoadU32(data + i * kStride + 16);
+        } else {
+            timestampMs.clear();
+        }
+    }
+
+private:
+    static constexpr std::size_t kStride = DrivetrainState::kWireSize;
 };
 
-/// Generic encoder telemetry - batch multiple in one packet
+/// Generic encoder telemetry: batch multiple in one packet
 struct EncoderData {
     static constexpr MessageTypeId kTypeId = MessageTypeId::EncoderData;
     static constexpr std::size_t kWireSize = kEncoderDataSize;
+    static constexpr std::array<uint8_t, 3> kFieldWidths = {{1, 4, 4}};
+    static constexpr std::array<FieldDescriptor, 3> kFields = {{
+        {"moduleId", FieldType::UInt8, 0, 1, 1.0f},
+        {"position", FieldType::Int32, 1, 4, 1.0f},
+        {"velocity", FieldType::Int32, 5, 4, 1.0f},
+    }};
 
     uint8_t moduleId{0}; // Module/motor identifier (0-255)
     int32_t position{0}; // Absolute encoder position (ticks)
@@ -191,26 +689,124 @@ struct EncoderData {
 
     bool Encode(uint8_t* out, std::size_t capacity) const {
         if (capacity < kWireSize) return false;
+        EncodeUnchecked(out);
+        return true;
+    }
+
+    /// Encode() without checks: `out` holds kWireSize bytes and float fields are finite
+    void EncodeUnchecked(uint8_t* out) const {
         out[0] = static_cast<uint8_t>(moduleId);
         detail::StoreS32(position, &out[1]);
         detail::StoreS32(velocity, &out[5]);
-        return true;
     }
 
     static std::optional<EncoderData> Decode(const uint8_t* data, std::size_t length) {
         if (length < kWireSize) return std::nullopt;
+        EncoderData msg = DecodeUnchecked(data);
+        return msg;
+    }
+
+    /// Decode() without checks, for payloads whose length and CRC were already validated
+    static EncoderData DecodeUnchecked(const uint8_t* data) {
         EncoderData msg;
         msg.moduleId = data[0];
         msg.position = detail::LoadS32(&data[1]);
         msg.velocity = detail::LoadS32(&data[5]);
         return msg;
     }
+
+    /// Decode `count` consecutive messages (count * kWireSize bytes) into `out`.
+    /// Same results as Decode() per message; float fields are always finite.
+    static void DecodeBatch(const uint8_t* data, std::size_t count, EncoderData* out) {
+        constexpr std::size_t kBlock = detail::kBatchBlock;
+        for (std::size_t base = 0; base < count; base += kBlock) {
+            const std::size_t n = std::min(kBlock, count - base);
+            const uint8_t* block = data + base * kWireSize;
+            EncoderData* dst = out + base;
+            for (std::size_t i = 0; i < n; ++i) dst[i].moduleId = block[i * kWireSize + 0];
+            for (std::size_t i = 0; i < n; ++i) dst[i].position = detail::LoadS32(block + i * kWireSize + 1);
+            for (std::size_t i = 0; i < n; ++i) dst[i].velocity = detail::LoadS32(block + i * kWireSize + 5);
+        }
+    }
+
+    /// Encode `count` messages from `in` into `out` (count * kWireSize bytes).
+    /// Same bytes as Encode() per message; false if any float field is not finite.
+    static bool EncodeBatch(const EncoderData* in, std::size_t count, uint8_t* out) {
+        constexpr std::size_t kBlock = detail::kBatchBlock;
+        for (std::size_t base = 0; base < count; base += kBlock) {
+            const std::size_t n = std::min(kBlock, count - base);
+            uint8_t* block = out + base * kWireSize;
+            const EncoderData* src = in + base;
+            for (std::size_t i = 0; i < n; ++i) block[i * kWireSize + 0] = static_cast<uint8_t>(src[i].moduleId);
+            for (std::size_t i = 0; i < n; ++i) detail::StoreS32(src[i].position, block + i * kWireSize + 1);
+            for (std::size_t i = 0; i < n; ++i) detail::StoreS32(src[i].velocity, block + i * kWireSize + 5);
+        }
+        return true;
+    }
+};
+
+/// Structure-of-arrays storage for EncoderData, filled by DecodeColumns()
+struct EncoderDataColumns {
+    using Message = EncoderData;
+
+    static constexpr FieldMask kModuleId = FieldMask{1} << 0;
+    static constexpr FieldMask kPosition = FieldMask{1} << 1;
+    static constexpr FieldMask kVelocity = FieldMask{1} << 2;
+    static constexpr FieldMask kAll = kModuleId | kPosition | kVelocity;
+
+    std::vector<uint8_t> moduleId;
+    std::vector<int32_t> position;
+    std::vector<int32_t> velocity;
+    std::size_t count{0};  ///< Messages decoded by the last Assign()
+    FieldMask fields{0};   ///< Columns populated by the last Assign()
+
+    /// Empty every column (capacity is kept for reuse)
+    void clear() {
+        moduleId.clear();
+        position.clear();
+        velocity.clear();
+        count = 0;
+        fields = 0;
+    }
+
+    /// Decode `n` consecutive messages; columns outside `mask` are left empty
+    void Assign(const uint8_t* data, std::size_t n, FieldMask mask) {
+        count = n;
+        fields = mask & kAll;
+        if (mask & kModuleId) {
+            moduleId.resize(n);
+            for (std::size_t i = 0; i < n; ++i) moduleId[i] = data[i * kStride + 0];
+        } else {
+            moduleId.clear();
+        }
+        if (mask & kPosition) {
+            position.resize(n);
+            for (std::size_t i = 0; i < n; ++i) position[i] = detail::LoadS32(data + i * kStride + 1);
+        } else {
+            position.clear();
+        }
+        if (mask & kVelocity) {
+            velocity.resize(n);
+            for (std::size_t i = 0; i < n; ++i) velocity[i] = detail::LoadS32(data + i * kStride + 5);
+        } else {
+            velocity.clear();
+        }
+    }
+
+private:
+    static constexpr std::size_t kStride = EncoderData::kWireSize;
 };
 
 /// Proximity sensor telemetry
 struct ProximityAlert {
     static constexpr MessageTypeId kTypeId = MessageTypeId::ProximityAlert;
     static constexpr std::size_t kWireSize = kProximityAlertSize;
+    static constexpr std::array<uint8_t, 3> kFieldWidths = {{1, 2, 1}};
+    static constexpr std::array<FieldDescriptor, 3> kFields = {{
+        {"sensorId", FieldType::UInt8, 0, 1, 1.0f},
+        {"distanceMm", FieldType::UInt16, 1, 2, 1.0f},
+        {"triggered", FieldType::UInt8, 3, 1, 1.0f},
+    }};
 
     uint8_t sensorId{0}; // Sensor identifier
     uint16_t distanceMm{0}; // Distance reading in millimeters (mm)
@@ -218,20 +814,112 @@ struct ProximityAlert {
 
     bool Encode(uint8_t* out, std::size_t capacity) const {
         if (capacity < kWireSize) return false;
+        EncodeUnchecked(out);
+        return true;
+    }
+
+    /// Encode() without checks: `out` holds kWireSize bytes and float fields are finite
+    void EncodeUnchecked(uint8_t* out) const {
         out[0] = static_cast<uint8_t>(sensorId);
         detail::StoreU16(distanceMm, &out[1]);
         out[3] = static_cast<uint8_t>(triggered);
-        return true;
     }
 
     static std::optional<ProximityAlert> Decode(const uint8_t* data, std::size_t length) {
         if (length < kWireSize) return std::nullopt;
+        ProximityAlert msg = DecodeUnchecked(data);
+        return msg;
+    }
+
+    /// Decode() without checks, for payloads whose length and CRC were already validated
+    static ProximityAlert DecodeUnchecked(const uint8_t* data) {
         ProximityAlert msg;
         msg.sensorId = data[0];
         msg.distanceMm = detail::LoadU16(&data[1]);
         msg.triggered = data[3];
         return msg;
     }
+
+    /// Decode `count` consecutive messages (count * kWireSize bytes) into `out`.
+    /// Same results as Decode() per message; float fields are always finite.
+    static void DecodeBatch(const uint8_t* data, std::size_t count, ProximityAlert* out) {
+        constexpr std::size_t kBlock = detail::kBatchBlock;
+        for (std::size_t base = 0; base < count; base += kBlock) {
+            const std::size_t n = std::min(kBlock, count - base);
+            const uint8_t* block = data + base * kWireSize;
+            ProximityAlert* dst = out + base;
+            for (std::size_t i = 0; i < n; ++i) dst[i].sensorId = block[i * kWireSize + 0];
+            for (std::size_t i = 0; i < n; ++i) dst[i].distanceMm = detail::LoadU16(block + i * kWireSize + 1);
+            for (std::size_t i = 0; i < n; ++i) dst[i].triggered = block[i * kWireSize + 3];
+        }
+    }
+
+    /// Encode `count` messages from `in` into `out` (count * kWireSize bytes).
+    /// Same bytes as Encode() per message; false if any float field is not finite.
+    static bool EncodeBatch(const ProximityAlert* in, std::size_t count, uint8_t* out) {
+        constexpr std::size_t kBlock = detail::kBatchBlock;
+        for (std::size_t base = 0; base < count; base += kBlock) {
+            const std::size_t n = std::min(kBlock, count - base);
+            uint8_t* block = out + base * kWireSize;
+            const ProximityAlert* src = in + base;
+            for (std::size_t i = 0; i < n; ++i) block[i * kWireSize + 0] = static_cast<uint8_t>(src[i].sensorId);
+            for (std::size_t i = 0; i < n; ++i) detail::StoreU16(src[i].distanceMm, block + i * kWireSize + 1);
+            for (std::size_t i = 0; i < n; ++i) block[i * kWireSize + 3] = static_cast<uint8_t>(src[i].triggered);
+        }
+        return true;
+    }
+};
+
+/// Structure-of-arrays storage for ProximityAlert, filled by DecodeColumns()
+struct ProximityAlertColumns {
+    using Message = ProximityAlert;
+
+    static constexpr FieldMask kSensorId = FieldMask{1} << 0;
+    static constexpr FieldMask kDistanceMm = FieldMask{1} << 1;
+    static constexpr FieldMask kTriggered = FieldMask{1} << 2;
+    static constexpr FieldMask kAll = kSensorId | kDistanceMm | kTriggered;
+
+    std::vector<uint8_t> sensorId;
+    std::vector<uint16_t> distanceMm;
+    std::vector<uint8_t> triggered;
+    std::size_t count{0};  ///< Messages decoded by the last Assign()
+    FieldMask fields{0};   ///< Columns populated by the last Assign()
+
+    /// Empty every column (capacity is kept for reuse)
+    void clear() {
+        sensorId.clear();
+        distanceMm.clear();
+        triggered.clear();
+        count = 0;
+        fields = 0;
+    }
+
+    /// Decode `n` consecutive messages; columns outside `mask` are left empty
+    void Assign(const uint8_t* data, std::size_t n, FieldMask mask) {
+        count = n;
+        fields = mask & kAll;
+        if (mask & kSensorId) {
+            sensorId.resize(n);
+            for (std::size_t i = 0; i < n; ++i) sensorId[i] = data[i * kStride + 0];
+        } else {
+            sensorId.clear();
+        }
+        if (mask & kDistanceMm) {
+            distanceMm.resize(n);
+            for (std::size_t i = 0; i < n; ++i) distanceMm[i] = detail::LoadU16(data + i * kStride + 1);
+        } else {
+            distanceMm.clear();
+        }
+        if (mask & kTriggered) {
+            triggered.resize(n);
+            for (std::size_t i = 0; i < n; ++i) triggered[i] = data[i * kStride + 3];
+        } else {
+            triggered.clear();
+        }
+    }
+
+private:
+    static constexpr std::size_t kStride = ProximityAlert::kWireSize;
 };
 
 // ============================================================================
@@ -257,17 +945,45 @@ inline constexpr std::array<MessageInfo, 4> kMessageRegistry = {{
     {MessageTypeId::ProximityAlert, 4, "ProximityAlert"},
 }};
 
+/// Largest message type ID defined by the schema
+inline constexpr uint16_t kMaxMessageTypeId = 12;
+
+/// Wire size per type ID (0 = unknown type)
+inline constexpr std::array<uint16_t, 13> kWireSizeTable = {{0, 10, 0, 0, 0, 0, 0, 0, 0, 0, 20, 9, 4}};
+
+/// kMessageRegistry index per type ID (kNoMessageIndex = unknown type)
+inline constexpr uint16_t kNoMessageIndex = 0xFFFF;
+inline constexpr std::array<uint16_t, 13> kMessageIndexTable = {{kNoMessageIndex, 0, kNoMessageIndex, kNoMessageIndex, kNoMessageIndex, kNoMessageIndex, kNoMessageIndex, kNoMessageIndex, kNoMessageIndex, kNoMessageIndex, 1, 2, 3}};
+
+/// Wire size for a message type, or 0 if the type is unknown
+inline constexpr std::size_t GetWireSize(MessageTypeId typeId) {
+    const auto index = static_cast<uint16_t>(typeId);
+    return index < kWireSizeTable.size() ? kWireSizeTable[index] : 0;
+}
+
 inline std::optional<MessageInfo> GetMessageInfo(MessageTypeId typeId) {
-    for (const auto& info : kMessageRegistry) {
-        if (info.typeId == typeId) return info;
+    const auto index = static_cast<uint16_t>(typeId);
+    if (index >= kMessageIndexTable.size() || kMessageIndexTable[index] == kNoMessageIndex) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    return kMessageRegistry[kMessageIndexTable[index]];
 }
 
 inline std::optional<MessageInfo> GetMessageInfo(uint16_t typeId) {
     return GetMessageInfo(static_cast<MessageTypeId>(typeId));
 }
 
+/// Field widths for a message type (count 0 if the type is unknown)
+inline FieldLayout GetFieldLayout(MessageTypeId typeId) {
+    switch (typeId) {
+        case MessageTypeId::TestCmd: return {TestCmd::kFieldWidths.data(), TestCmd::kFieldWidths.size()};
+        case MessageTypeId::DrivetrainState: return {DrivetrainState::kFieldWidths.data(), DrivetrainState::kFieldWidths.size()};
+        case MessageTypeId::EncoderData: return {EncoderData::kFieldWidths.data(), EncoderData::kFieldWidths.size()};
+        case MessageTypeId::ProximityAlert: return {ProximityAlert::kFieldWidths.data(), ProximityAlert::kFieldWidths.size()};
+        default: return {};
+    }
+}
+
 // ============================================================================
 // Handshake Utilities
 // ============================================================================